@@ -0,0 +1,296 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#include "Arduino.h"
+#include "ucnl_nmea.h"
+#include "ucnl_mux.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* Initializes a multiplexer
+   "mux" multiplexer state
+   "ports" array for the ports, owned by the caller like parser buffers
+   "ports_size" number of elements in "ports", up to 254
+   "callback" is called for every complete sentence on any port that has no handler
+   in the sentence IDs table of the port's parser state
+   "param" user parameter passed to the callbacks
+   returns false if the epoll instance cannot be created (Linux only)
+*/
+bool UCNL_MUX_InitStruct(UCNL_MUX_State_Struct* mux, UCNL_MUX_Port_Struct* ports, byte ports_size, UCNL_MUX_Sentence_Callback callback, void* param)
+{
+  mux->ports = ports;
+  mux->ports_size = ports_size;
+  mux->num = 0;
+  mux->open = 0;
+  mux->next = 0;
+  mux->current = UCNL_MUX_INVALID_PORT;
+  mux->callback = callback;
+  mux->closed = NULL;
+  mux->param = param;
+
+#ifdef __linux__
+  mux->epfd = epoll_create1(0);
+  return (mux->epfd >= 0);
+#else
+  return true;
+#endif
+}
+
+void UCNL_MUX_Release(UCNL_MUX_State_Struct* mux)
+{
+#ifdef __linux__
+  if (mux->epfd >= 0)
+    close(mux->epfd);
+  mux->epfd = -1;
+#endif
+  mux->num = 0;
+  mux->open = 0;
+}
+
+// "closed" is called with the "param" given to UCNL_MUX_InitStruct
+void UCNL_MUX_Set_Closed_Callback(UCNL_MUX_State_Struct* mux, UCNL_MUX_Closed_Callback closed)
+{
+  mux->closed = closed;
+}
+
+/* Adds a port
+   "uState" parser state of the port, initialized with UCNL_NMEA_InitStruct
+   "read" non-blocking read function of the port
+   "param" user parameter passed to the read function, e.g. a Stream* for UCNL_MUX_Stream_Read
+   returns port ID or UCNL_MUX_INVALID_PORT if there is no room for the port
+*/
+byte UCNL_MUX_Add_Port(UCNL_MUX_State_Struct* mux, UCNL_NMEA_State_Struct* uState, UCNL_MUX_Read_Func read, void* param)
+{
+  UCNL_MUX_Port_Struct* port;
+
+  if ((mux->num >= mux->ports_size) || (mux->num >= UCNL_MUX_INVALID_PORT))
+    return UCNL_MUX_INVALID_PORT;
+
+  port = &mux->ports[mux->num];
+  port->uState = uState;
+  port->read = read;
+  port->param = param;
+  port->fd = -1;
+  port->isOpen = true;
+  mux->open++;
+
+  return mux->num++;
+}
+
+bool UCNL_MUX_Is_Open(const UCNL_MUX_State_Struct* mux, byte portID)
+{
+  return (portID < mux->num) && mux->ports[portID].isOpen;
+}
+
+// Stops reading the port, the descriptor is left to the caller
+static void UCNL_MUX_Close_Port(UCNL_MUX_State_Struct* mux, byte portID)
+{
+  UCNL_MUX_Port_Struct* port = &mux->ports[portID];
+
+  if (!port->isOpen)
+    return;
+
+  port->isOpen = false;
+  mux->open--;
+
+#ifdef __linux__
+  if (port->fd >= 0)
+    epoll_ctl(mux->epfd, EPOLL_CTL_DEL, port->fd, NULL);
+#endif
+
+  if (mux->closed != NULL)
+    mux->closed(portID, mux->param);
+}
+
+static void UCNL_MUX_OnSentence(UCNL_NMEA_State_Struct* uState, void* param)
+{
+  UCNL_MUX_State_Struct* mux = (UCNL_MUX_State_Struct*)param;
+
+  if (mux->callback != NULL)
+    mux->callback(mux->current, uState, mux->param);
+}
+
+/* Takes one chunk of pending bytes from a port and frames it, returns number of complete sentences
+   "isHungUp" the port is closed if it has nothing more to read
+*/
+static int UCNL_MUX_Drain(UCNL_MUX_State_Struct* mux, byte portID, byte* chunk, bool isHungUp)
+{
+  UCNL_MUX_Port_Struct* port = &mux->ports[portID];
+  int n;
+
+  if (!port->isOpen)
+    return 0;
+
+  n = port->read(chunk, UCNL_MUX_CHUNK_SIZE, port->param);
+
+  if ((n < 0) || ((n == 0) && isHungUp))
+  {
+    UCNL_MUX_Close_Port(mux, portID);
+    return 0;
+  }
+
+  if (n == 0)
+    return 0;
+
+  mux->current = portID;
+  return (int)UCNL_NMEA_Process_Buffer(port->uState, chunk, (size_t)n, UCNL_MUX_OnSentence, mux);
+}
+
+/* Makes one round over all the ports: every port gives up to UCNL_MUX_CHUNK_SIZE pending bytes,
+   so a busy port can not starve the others. Every round starts from the next port
+   returns number of complete sentences
+*/
+int UCNL_MUX_Poll(UCNL_MUX_State_Struct* mux)
+{
+  byte chunk[UCNL_MUX_CHUNK_SIZE];
+  byte i, portID;
+  int result = 0;
+
+  if (mux->num == 0)
+    return 0;
+
+  portID = mux->next;
+  for (i = 0; i < mux->num; i++)
+  {
+    result += UCNL_MUX_Drain(mux, portID, chunk, false);
+    if (++portID >= mux->num)
+      portID = 0;
+  }
+
+  if (++mux->next >= mux->num)
+    mux->next = 0;
+
+  return result;
+}
+
+#ifdef ARDUINO
+// Read function for Arduino streams (HardwareSerial, SoftwareSerial etc.), "param" is a Stream*
+int UCNL_MUX_Stream_Read(byte* data, int size, void* param)
+{
+  Stream* stream = (Stream*)param;
+  int n = stream->available();
+
+  if (n > size)
+    n = size;
+
+  return (n > 0) ? (int)stream->readBytes(data, n) : 0;
+}
+#endif
+
+#ifdef __linux__
+
+// End of file and read errors close the port, a pty whose peer is gone fails with EIO
+static int UCNL_MUX_FD_Read(byte* data, int size, void* param)
+{
+  UCNL_MUX_Port_Struct* port = (UCNL_MUX_Port_Struct*)param;
+  ssize_t n = read(port->fd, data, size);
+
+  if (n > 0)
+    return (int)n;
+
+  if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)))
+    return 0;
+
+  return -1;
+}
+
+/* Adds a file descriptor port, e.g. an open serial device or a pty.
+   The descriptor is switched to non-blocking mode, as UCNL_MUX_Poll reads every port
+   returns port ID or UCNL_MUX_INVALID_PORT if there is no room or the descriptor can not be watched
+*/
+byte UCNL_MUX_Add_FD(UCNL_MUX_State_Struct* mux, UCNL_NMEA_State_Struct* uState, int fd)
+{
+  struct epoll_event ev;
+  int flags = fcntl(fd, F_GETFL);
+  byte portID;
+
+  if ((flags < 0) || (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0))
+    return UCNL_MUX_INVALID_PORT;
+
+  portID = UCNL_MUX_Add_Port(mux, uState, UCNL_MUX_FD_Read, NULL);
+  if (portID == UCNL_MUX_INVALID_PORT)
+    return UCNL_MUX_INVALID_PORT;
+
+  mux->ports[portID].param = &mux->ports[portID];
+  mux->ports[portID].fd = fd;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.u32 = portID;
+  if (epoll_ctl(mux->epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+  {
+    mux->num--;
+    mux->open--;
+    return UCNL_MUX_INVALID_PORT;
+  }
+
+  return portID;
+}
+
+/* Waits for data on the file descriptor ports and drains every ready port once, in round-robin order.
+   The descriptors are level-triggered, so a port with more pending data is reported again by the next call.
+   A hung up port is drained to the end and then closed: it is removed from the epoll set and reported
+   by the closed callback
+   "timeout_ms" max waiting time, -1 to wait forever, 0 to return at once
+   returns number of complete sentences, -1 on epoll error or if there are no open ports to wait for
+*/
+int UCNL_MUX_Wait(UCNL_MUX_State_Struct* mux, int timeout_ms)
+{
+  struct epoll_event events[16];
+  uint32_t ready[(UCNL_MUX_INVALID_PORT + 31) / 32];
+  uint32_t hup[(UCNL_MUX_INVALID_PORT + 31) / 32];
+  byte chunk[UCNL_MUX_CHUNK_SIZE];
+  byte i, portID;
+  int n, k, result = 0;
+
+  if (mux->open == 0)
+    return -1;
+
+  n = epoll_wait(mux->epfd, events, 16, timeout_ms);
+  if (n < 0)
+    return -1;
+
+  memset(ready, 0, sizeof(ready));
+  memset(hup, 0, sizeof(hup));
+  for (k = mux->num; n > 0; k -= 16)
+  {
+    for (i = 0; i < n; i++)
+    {
+      ready[events[i].data.u32 >> 5] |= ((uint32_t)1) << (events[i].data.u32 & 31);
+      if (events[i].events & (EPOLLHUP | EPOLLERR))
+        hup[events[i].data.u32 >> 5] |= ((uint32_t)1) << (events[i].data.u32 & 31);
+    }
+
+    // more ready ports than events in one call: ready descriptors are rotated by epoll,
+    // so the next calls report the rest of them
+    n = ((n == 16) && (k > 16)) ? epoll_wait(mux->epfd, events, 16, 0) : 0;
+  }
+
+  portID = mux->next;
+  for (i = 0; i < mux->num; i++)
+  {
+    if (ready[portID >> 5] & (((uint32_t)1) << (portID & 31)))
+      result += UCNL_MUX_Drain(mux, portID, chunk, (hup[portID >> 5] & (((uint32_t)1) << (portID & 31))) != 0);
+
+    if (++portID >= mux->num)
+      portID = 0;
+  }
+
+  if (++mux->next >= mux->num)
+    mux->next = 0;
+
+  return result;
+}
+
+#endif
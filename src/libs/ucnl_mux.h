@@ -0,0 +1,78 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#ifndef _UCNL_MUX_
+#define _UCNL_MUX_
+
+#include "ucnl_nmea.h"
+
+#ifndef UCNL_MUX_CHUNK_SIZE
+#ifdef __AVR__
+#define UCNL_MUX_CHUNK_SIZE     (32)       // max bytes taken from a port per round
+#else
+#define UCNL_MUX_CHUNK_SIZE     (1024)
+#endif
+#endif
+
+#define UCNL_MUX_INVALID_PORT   (0xFF)
+
+// Reads up to "size" pending bytes from a port without blocking, returns number of bytes read, 0 if nothing is pending,
+// a negative value if the port is closed or failed: the port is not read anymore
+typedef int (*UCNL_MUX_Read_Func)(byte* data, int size, void* param);
+
+typedef struct {
+  UCNL_NMEA_State_Struct* uState;
+  UCNL_MUX_Read_Func read;
+  void* param;
+  int fd;
+  bool isOpen;
+} UCNL_MUX_Port_Struct;
+
+struct UCNL_MUX_State_Struct_t;
+
+// Called for every complete sentence, "portID" is the port number returned by UCNL_MUX_Add_Port
+typedef void (*UCNL_MUX_Sentence_Callback)(byte portID, UCNL_NMEA_State_Struct* uState, void* param);
+
+// Called once a port is closed: its read function failed or its descriptor was hung up
+typedef void (*UCNL_MUX_Closed_Callback)(byte portID, void* param);
+
+typedef struct UCNL_MUX_State_Struct_t {
+  UCNL_MUX_Port_Struct* ports;
+  byte ports_size;
+  byte num;
+  byte open;
+  byte next;
+  byte current;
+  UCNL_MUX_Sentence_Callback callback;
+  UCNL_MUX_Closed_Callback closed;
+  void* param;
+#ifdef __linux__
+  int epfd;
+#endif
+} UCNL_MUX_State_Struct;
+
+
+bool UCNL_MUX_InitStruct(UCNL_MUX_State_Struct* mux, UCNL_MUX_Port_Struct* ports, byte ports_size, UCNL_MUX_Sentence_Callback callback, void* param);
+void UCNL_MUX_Release(UCNL_MUX_State_Struct* mux);
+void UCNL_MUX_Set_Closed_Callback(UCNL_MUX_State_Struct* mux, UCNL_MUX_Closed_Callback closed);
+
+byte UCNL_MUX_Add_Port(UCNL_MUX_State_Struct* mux, UCNL_NMEA_State_Struct* uState, UCNL_MUX_Read_Func read, void* param);
+int  UCNL_MUX_Poll(UCNL_MUX_State_Struct* mux);
+bool UCNL_MUX_Is_Open(const UCNL_MUX_State_Struct* mux, byte portID);
+
+#ifdef ARDUINO
+int  UCNL_MUX_Stream_Read(byte* data, int size, void* param);
+#endif
+
+#ifdef __linux__
+byte UCNL_MUX_Add_FD(UCNL_MUX_State_Struct* mux, UCNL_NMEA_State_Struct* uState, int fd);
+int  UCNL_MUX_Wait(UCNL_MUX_State_Struct* mux, int timeout_ms);
+#endif
+
+#endif
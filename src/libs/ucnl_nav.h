@@ -1,47 +1,112 @@
-/*
-Copyright (C) 2021, Underwater communication & navigation laboratory
-All rights reserved.
-
-www.unavlab.com
-hello@unavlab.com
-
-*/
-
-#ifndef _UCNL_NAV_
-#define _UCNL_NAV_
-
-#define _PI                   (3.1415926535897932384626433832795)
-#define PI2                   (_PI * 2.0)
-#define PI_DBY_180            (_PI / 180.0)
-#define D180_DBY_PI           (180.0 / _PI)
-
-#define WGS84_MJ_SEMIAXIS_M   (6378137)
-#define WGS84_IN_FLATTENING   (298.257223563)
-#define WGS84_FLATTENING      (1.0 / WGS84_IN_FLATTENING)
-#define WGS84_MN_SEMIAXIS_M   (WGS84_MJ_SEMIAXIS_M * (1 - WGS84_FLATTENING))
-#define WGS84_ECCENTRICITY    (((WGS84_MJ_SEMIAXIS_M * WGS84_MJ_SEMIAXIS_M) - (WGS84_MN_SEMIAXIS_M * WGS84_MN_SEMIAXIS_M)) / (WGS84_MJ_SEMIAXIS_M * WGS84_MJ_SEMIAXIS_M))
-#define WGS84_ECCENTRICITY_SQ (WGS84_ECCENTRICITY * WGS84_ECCENTRICITY)
-
-#define UCNL_NAV_DEG2RAD(val) ((val) * PI_DBY_180)
-#define UCNL_NAV_RAD2DEG(val) ((val) * D180_DBY_PI)
-
-
-
-float UCNL_NAV_Wrap(float val, float lim);
-float UCNL_NAV_Wrap2PI(float angle_rad);
-float UCNL_NAV_Wrap360(float angle_deg);
-float UCNL_NAV_Dist3D(float x1, float y1, float z1, float x2, float y2, float z2);
-float UCNL_NAV_Dist2D(float x1, float y1, float x2, float y2);
-
-void UCNL_NAV_PointOffset_WGS84(float lat_rad, float lon_rad, float lat_offset_m, float lon_offset_m, float* e_lat_rad,  float* e_lon_rad);
-void UCNL_NAV_GetDeltasByGeopoints_WGS84(float sp_lat_rad, float sp_lon_rad, float ep_lat_rad, float ep_lon_rad, float* delta_lat_m, float* delta_lon_m);
-
-float UCNL_NAV_HaversineInverse(float sp_lat_rad, float sp_lon_rad, float ep_lat_rad, float ep_lon_rad);
-void UCNL_NAV_HaversineDirect(float sp_lat_rad, float sp_lon_rad, float dst_m, float fwd_az_rad, float* ep_lat_rad, float* ep_lon_rad);
-float UCNL_NAV_HaversineInitialBearing(float sp_lat_rad, float sp_lon_rad, float ep_lat_rad, float ep_lon_rad);
-float UCNL_NAV_HaversineFinalBearing(float sp_lat_rad, float sp_lon_rad, float ep_lat_rad, float ep_lon_rad);
-
-bool UCNL_NAV_CirclesIntersection(float x1, float y1, float r1, float x2, float y2, float r2, float* ix1, float* iy1, float* ix2, float* iy2);
-
-
-#endif
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#ifndef _UCNL_NAV_
+#define _UCNL_NAV_
+
+#define _PI                   (3.1415926535897932384626433832795)
+#define PI2                   (_PI * 2.0)
+#define PI_DBY_180            (_PI / 180.0)
+#define D180_DBY_PI           (180.0 / _PI)
+
+#define WGS84_MJ_SEMIAXIS_M   (6378137)
+#define WGS84_IN_FLATTENING   (298.257223563)
+#define WGS84_FLATTENING      (1.0 / WGS84_IN_FLATTENING)
+#define WGS84_MN_SEMIAXIS_M   (WGS84_MJ_SEMIAXIS_M * (1 - WGS84_FLATTENING))
+#define WGS84_ECCENTRICITY    ((((double)WGS84_MJ_SEMIAXIS_M * WGS84_MJ_SEMIAXIS_M) - (WGS84_MN_SEMIAXIS_M * WGS84_MN_SEMIAXIS_M)) / ((double)WGS84_MJ_SEMIAXIS_M * WGS84_MJ_SEMIAXIS_M))
+#define WGS84_ECCENTRICITY_SQ (WGS84_ECCENTRICITY * WGS84_ECCENTRICITY)
+#define WGS84_SND_ECCENTRICITY_SQ ((((double)WGS84_MJ_SEMIAXIS_M * WGS84_MJ_SEMIAXIS_M) - (WGS84_MN_SEMIAXIS_M * WGS84_MN_SEMIAXIS_M)) / (WGS84_MN_SEMIAXIS_M * WGS84_MN_SEMIAXIS_M))
+
+#define UCNL_NAV_DEG2RAD(val) ((val) * PI_DBY_180)
+#define UCNL_NAV_RAD2DEG(val) ((val) * D180_DBY_PI)
+
+// Local frame around a fixed origin: cached meters per radian coefficients and their latitude derivatives
+typedef struct {
+  float lat_rad;
+  float lon_rad;
+  float m0, m1, m2;          // meters per radian of latitude and its series by the middle latitude offset
+  float n0, n1, n2;          // the same for longitude
+  float ia, ic, im0;         // inverse series coefficients
+  float in0, ip, iq;
+} UCNL_NAV_LocalFrame_Struct;
+
+typedef struct {
+  double lat_rad;
+  double lon_rad;
+  double m0, m1, m2;
+  double n0, n1, n2;
+  double ia, ic, im0;
+  double in0, ip, iq;
+} UCNL_NAV_LocalFrame_D_Struct;
+
+
+
+float UCNL_NAV_Wrap(float val, float lim);
+float UCNL_NAV_Wrap2PI(float angle_rad);
+float UCNL_NAV_Wrap360(float angle_deg);
+float UCNL_NAV_WrapPI(float angle_rad);
+float UCNL_NAV_Wrap180(float angle_deg);
+void UCNL_NAV_Wrap_Batch(float* vals, int n, float lim);
+void UCNL_NAV_WrapPI_Batch(float* angles_rad, int n);
+float UCNL_NAV_Dist3D(float x1, float y1, float z1, float x2, float y2, float z2);
+float UCNL_NAV_Dist2D(float x1, float y1, float x2, float y2);
+
+void UCNL_NAV_PointOffset_WGS84(float lat_rad, float lon_rad, float lat_offset_m, float lon_offset_m, float* e_lat_rad,  float* e_lon_rad);
+void UCNL_NAV_GetDeltasByGeopoints_WGS84(float sp_lat_rad, float sp_lon_rad, float ep_lat_rad, float ep_lon_rad, float* delta_lat_m, float* delta_lon_m);
+
+float UCNL_NAV_HaversineInverse(float sp_lat_rad, float sp_lon_rad, float ep_lat_rad, float ep_lon_rad);
+void UCNL_NAV_HaversineDirect(float sp_lat_rad, float sp_lon_rad, float dst_m, float fwd_az_rad, float* ep_lat_rad, float* ep_lon_rad);
+float UCNL_NAV_HaversineInitialBearing(float sp_lat_rad, float sp_lon_rad, float ep_lat_rad, float ep_lon_rad);
+float UCNL_NAV_HaversineFinalBearing(float sp_lat_rad, float sp_lon_rad, float ep_lat_rad, float ep_lon_rad);
+
+// Double precision geodesy: sub-centimetre on 64-bit double targets, the same as float ones where double is 32-bit (AVR)
+double UCNL_NAV_Wrap_D(double val, double lim);
+double UCNL_NAV_Wrap2PI_D(double angle_rad);
+double UCNL_NAV_WrapPI_D(double angle_rad);
+void UCNL_NAV_Wrap_Batch_D(double* vals, int n, double lim);
+void UCNL_NAV_WrapPI_Batch_D(double* angles_rad, int n);
+
+void UCNL_NAV_PointOffset_WGS84_D(double lat_rad, double lon_rad, double lat_offset_m, double lon_offset_m, double* e_lat_rad, double* e_lon_rad);
+void UCNL_NAV_GetDeltasByGeopoints_WGS84_D(double sp_lat_rad, double sp_lon_rad, double ep_lat_rad, double ep_lon_rad, double* delta_lat_m, double* delta_lon_m);
+
+double UCNL_NAV_HaversineInverse_D(double sp_lat_rad, double sp_lon_rad, double ep_lat_rad, double ep_lon_rad);
+void UCNL_NAV_HaversineDirect_D(double sp_lat_rad, double sp_lon_rad, double dst_m, double fwd_az_rad, double* ep_lat_rad, double* ep_lon_rad);
+double UCNL_NAV_HaversineInitialBearing_D(double sp_lat_rad, double sp_lon_rad, double ep_lat_rad, double ep_lon_rad);
+double UCNL_NAV_HaversineFinalBearing_D(double sp_lat_rad, double sp_lon_rad, double ep_lat_rad, double ep_lon_rad);
+
+void UCNL_NAV_LocalFrame_Init(UCNL_NAV_LocalFrame_Struct* frame, float lat_rad, float lon_rad);
+void UCNL_NAV_LocalFrame_Forward(const UCNL_NAV_LocalFrame_Struct* frame, float lat_rad, float lon_rad, float* delta_lat_m, float* delta_lon_m);
+void UCNL_NAV_LocalFrame_Inverse(const UCNL_NAV_LocalFrame_Struct* frame, float delta_lat_m, float delta_lon_m, float* lat_rad, float* lon_rad);
+void UCNL_NAV_LocalFrame_Forward_Batch(const UCNL_NAV_LocalFrame_Struct* frame, const float* lat_rad, const float* lon_rad, float* delta_lat_m, float* delta_lon_m, int n);
+void UCNL_NAV_LocalFrame_Inverse_Batch(const UCNL_NAV_LocalFrame_Struct* frame, const float* delta_lat_m, const float* delta_lon_m, float* lat_rad, float* lon_rad, int n);
+
+void UCNL_NAV_LocalFrame_Init_D(UCNL_NAV_LocalFrame_D_Struct* frame, double lat_rad, double lon_rad);
+void UCNL_NAV_LocalFrame_Forward_D(const UCNL_NAV_LocalFrame_D_Struct* frame, double lat_rad, double lon_rad, double* delta_lat_m, double* delta_lon_m);
+void UCNL_NAV_LocalFrame_Inverse_D(const UCNL_NAV_LocalFrame_D_Struct* frame, double delta_lat_m, double delta_lon_m, double* lat_rad, double* lon_rad);
+void UCNL_NAV_LocalFrame_Forward_Batch_D(const UCNL_NAV_LocalFrame_D_Struct* frame, const double* lat_rad, const double* lon_rad, double* delta_lat_m, double* delta_lon_m, int n);
+void UCNL_NAV_LocalFrame_Inverse_Batch_D(const UCNL_NAV_LocalFrame_D_Struct* frame, const double* delta_lat_m, const double* delta_lon_m, double* lat_rad, double* lon_rad, int n);
+
+// Batch haversine for one start point and many end points, vectorized with AVX2 where available
+void UCNL_NAV_Haversine_Batch(float sp_lat_rad, float sp_lon_rad, const float* ep_lat_rad, const float* ep_lon_rad, float* dst_m, float* fwd_az_rad, int n);
+void UCNL_NAV_HaversineInverse_Batch(float sp_lat_rad, float sp_lon_rad, const float* ep_lat_rad, const float* ep_lon_rad, float* dst_m, int n);
+void UCNL_NAV_HaversineInitialBearing_Batch(float sp_lat_rad, float sp_lon_rad, const float* ep_lat_rad, const float* ep_lon_rad, float* fwd_az_rad, int n);
+
+// Vincenty's solutions on the WGS84 ellipsoid, converge to 1e-12 rad (double) or 1e-6 rad (float)
+#define UCNL_NAV_VINCENTY_RT_ITERATIONS  (4)     // real time bound: converges on lines up to ~1000 km, within meters on the longest ones
+#define UCNL_NAV_VINCENTY_MAX_ITERATIONS (200)
+
+bool UCNL_NAV_VincentyInverse(float sp_lat_rad, float sp_lon_rad, float ep_lat_rad, float ep_lon_rad, int max_iterations, bool accelerate, float* dst_m, float* fwd_az_rad, float* fin_az_rad);
+bool UCNL_NAV_VincentyDirect(float sp_lat_rad, float sp_lon_rad, float dst_m, float fwd_az_rad, int max_iterations, float* ep_lat_rad, float* ep_lon_rad, float* fin_az_rad);
+bool UCNL_NAV_VincentyInverse_D(double sp_lat_rad, double sp_lon_rad, double ep_lat_rad, double ep_lon_rad, int max_iterations, bool accelerate, double* dst_m, double* fwd_az_rad, double* fin_az_rad);
+bool UCNL_NAV_VincentyDirect_D(double sp_lat_rad, double sp_lon_rad, double dst_m, double fwd_az_rad, int max_iterations, double* ep_lat_rad, double* ep_lon_rad, double* fin_az_rad);
+
+bool UCNL_NAV_CirclesIntersection(float x1, float y1, float r1, float x2, float y2, float r2, float* ix1, float* iy1, float* ix2, float* iy2);
+
+
+#endif
@@ -1,901 +1,2176 @@
-/*
-Copyright (C) 2021, Underwater communication & navigation laboratory
-All rights reserved.
-
-www.unavlab.com
-hello@unavlab.com
-
-*/
-
-#include "Arduino.h"
-#include "ucnl_str.h"
-#include "ucnl_nmea.h"
-
-
-void UCNL_NMEA_InitStruct(UCNL_NMEA_State_Struct* uState, byte* buffer, byte buffer_size, long* sntIDs, byte sntIDs_size)
-{
-  uState->isReady = false;
-  uState->buffer = buffer;
-  uState->buffer_size = buffer_size;
-  uState->sntIDs = sntIDs;
-  uState->sntIDs_size = sntIDs_size;
-}
-
-void UCNL_NMEA_Release(UCNL_NMEA_State_Struct* uState)
-{
-  uState->isReady = false;
-}
-
-UCNL_NMEA_Result_Enum UCNL_NMEA_Process_Byte(UCNL_NMEA_State_Struct* uState, byte newByte)
-{
-  UCNL_NMEA_Result_Enum result = UCNL_NMEA_RESULT_BYPASS_BYTE;
-
-  if (!uState->isReady)
-  {
-    if (newByte == UCNL_NMEA_SNT_STR)
-    {
-      uState->isStarted = true;
-      result = UCNL_NMEA_RESULT_PACKET_STARTED;
-
-      for (int i = 0; i < uState->buffer_size; i++)
-        uState->buffer[i] = 0;
-
-      uState->chk_act     = 0;
-      uState->chk_dcl     = 0;
-      uState->chk_dcl_idx = 0;
-      uState->idx         = 0;
-
-      uState->tkrID       = 0;
-      uState->sntID       = 0;
-
-      uState->buffer[uState->idx] = newByte;
-      uState->idx++;
-    }
-    else
-    {
-      if (uState->isStarted)
-      {
-        result = UCNL_NMEA_RESULT_PACKET_PROCESS;
-        uState->buffer[uState->idx] = newByte;
-
-        if (newByte == UCNL_NMEA_SNT_END)
-        {
-          uState->isStarted = false;
-          uState->isReady = true;
-          result = UCNL_NMEA_RESULT_PACKET_READY;
-        }
-        else if (newByte == UCNL_NMEA_CHK_SEP)
-        {
-          uState->chk_dcl_idx = 1;
-          uState->chk_present = true;
-        }
-        else
-        {
-          if (uState->idx >= uState->buffer_size)
-          {
-            uState->isStarted = false;
-            result = UCNL_NMEA_RESULT_PACKET_TOO_BIG;
-          }
-          else
-          {
-            if (uState->chk_dcl_idx == 0)
-            {
-              uState->chk_act ^= newByte;
-              if      (uState->idx == 1)
-                if (newByte == UCNL_NMEA_PSENTENCE_SYMBOL)
-                  uState->isPSentence = true;
-                else
-                  uState->tkrID = ((int)newByte) << 8;
-              else if (uState->idx == 2)
-                if (uState->isPSentence)
-                  uState->sntID = ((long)newByte) << 24;
-                else
-                  uState->tkrID |= newByte;
-              else if (uState->idx == 3)
-                if (uState->isPSentence)
-                  uState->sntID |= (((long)newByte) << 16);
-                else
-                  uState->sntID = (((long)newByte) << 16);
-              else if (uState->idx == 4)
-                uState->sntID |= (((long)newByte) << 8);
-              else if (uState->idx == 5)
-              {
-                uState->sntID |= newByte;
-
-                byte i = 0;
-                while ((i < uState->sntIDs_size) && (uState->sntID != uState->sntIDs[i]))
-                  i++;
-
-                if (i >= uState->sntIDs_size)
-                {
-                  uState->isStarted = false;
-                  result = UCNL_NMEA_RESULT_PACKET_SKIPPING;
-                }
-              }
-            }
-            else if (uState->chk_dcl_idx == 1)
-            {
-              uState->chk_dcl = 16 * UCNL_STR_HEXDIGIT2B(newByte);
-              uState->chk_dcl_idx++;
-            }
-            else if (uState->chk_dcl_idx == 2)
-            {
-              uState->chk_dcl += UCNL_STR_HEXDIGIT2B(newByte);
-              if (uState->chk_act != uState->chk_dcl)
-              {
-                uState->isStarted = false;
-                result = UCNL_NMEA_RESULT_PACKET_CHECKSUM_ERROR;
-              }
-              uState->chk_dcl_idx++;
-            }
-          }
-        }
-        uState->idx++;
-      }
-    }
-  }
-  return result;
-}
-
-bool UCNL_NMEA_Get_NextParam(const byte* buffer, byte fromIdx, byte size, byte* stIdx, byte* ndIdx)
-{
-  byte i = fromIdx + 1;
-  *stIdx = fromIdx;
-  *ndIdx = *stIdx;
-
-  while ((i <= size) && (*ndIdx == *stIdx))
-  {
-    if ((buffer[i] == UCNL_NMEA_PAR_SEP) ||
-        (buffer[i] == UCNL_NMEA_CHK_SEP) ||
-        (buffer[i] == UCNL_NMEA_SNT_END1) ||
-        (i == size))
-    {
-      *ndIdx = i;
-    }
-    else
-    {
-      i++;
-    }
-  }
-  (*stIdx)++;
-  (*ndIdx)--;
-
-  return ((buffer[i] != UCNL_NMEA_CHK_SEP) && (i != size) && (buffer[i] != UCNL_NMEA_SNT_END1));
-}
-
-void UCNL_NMEA_CheckSum_Update(byte* buffer, byte size)
-{
-  byte i;
-  byte acc = 0, b1, b2;
-  for (i = 0; i < size; i++)
-  {
-    if      (buffer[i] == UCNL_NMEA_SNT_STR)
-      acc = 0;
-    else if (buffer[i] == UCNL_NMEA_CHK_SEP)
-    {
-      buffer[i + 1] = UCNL_STR_DIGIT_2HEX(acc / 16);
-      buffer[i + 2] = UCNL_STR_DIGIT_2HEX(acc % 16);
-    }
-    else
-    {
-      acc ^= buffer[i];
-    }
-  }
-}
-
-bool UCNL_NMEA_Parse_RMC(UCNL_NMEA_RMC_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  // Sentence example:
-  // $GPRMC,230540.00,A,5312.1329616,N,15942.6950884,E,4.9,217.1,290421,999.9,E,D*3C
-
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1: // Time
-        if (ndIdx < stIdx)
-          result = false;
-        else
-        {
-          rdata->hour = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
-          rdata->minute = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
-          rdata->second = UCNL_STR_ParseFloat(buffer, stIdx + 4, ndIdx);
-
-          if (!UCNL_NMEA_IS_VALID_HOUR(rdata->hour) ||
-              !UCNL_NMEA_IS_VALID_MINSEC(rdata->minute) ||
-              !UCNL_NMEA_IS_VALID_MINSEC(rdata->second))
-            result = false;
-        }
-        break;
-      case 2: // Time validity flag
-        if ((ndIdx < stIdx) || (buffer[stIdx] != UCNL_NMEA_TD_VALID))
-          result = false;
-        break;
-      case 3: // Latitude
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->latitude_deg = (float)UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]) +
-                                UCNL_STR_ParseFloat(buffer, stIdx + 2, ndIdx) / 60.0;
-
-        if (!UCNL_NMEA_IS_VALID_LATDEG(rdata->latitude_deg))
-          result = false;
-        break;
-      case 4: // Latitude hemisphere
-        if (ndIdx < stIdx)
-          result = false;
-        else if (buffer[stIdx] == UCNL_NMEA_SOUTH_SIGN)
-          rdata->latitude_deg = -rdata->latitude_deg;
-        break;
-      case 5: // Longitude
-        if (ndIdx <= stIdx)
-          result = false;
-        else
-          rdata->longitude_deg = (float)UCNL_STR_CCC2B(buffer[stIdx], buffer[stIdx + 1], buffer[stIdx + 2]) +
-                                 UCNL_STR_ParseFloat(buffer, stIdx + 3, ndIdx) / 60.0;
-
-        if (!UCNL_NMEA_IS_VALID_LONDEG(rdata->longitude_deg))
-          result = false;
-
-        break;
-      case 6: // Longitude hemisphere
-        if (ndIdx < stIdx)
-          result = false;
-        else if (buffer[stIdx] == UCNL_NMEA_WEST_SIGN)
-          rdata->longitude_deg = -rdata->longitude_deg;
-        break;
-      case 7: // Speed in knots
-        if (ndIdx >= stIdx)
-          rdata->speed_kmh = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx) * 1.852; //
-        break;
-      case 8: // Course in degrees
-        if (ndIdx >= stIdx)
-          rdata->course_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 9: // Date
-        if (ndIdx < stIdx)
-          result = false;
-        else
-        {
-          rdata->date = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
-          rdata->month = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
-          rdata->year = UCNL_STR_CC2B(buffer[stIdx + 4], buffer[stIdx + 5]);
-          if (!UCNL_NMEA_IS_VALID_DATE(rdata->date) ||
-              !UCNL_NMEA_IS_VALID_MONTH(rdata->month) ||
-              !UCNL_NMEA_IS_VALID_YEAR(rdata->year))
-            result = false;
-        }
-        break;
-      case 12: // Data validity flag
-        if ((ndIdx < stIdx) || (buffer[stIdx] == UCNL_NMEA_DATA_NOT_VALID))
-          result = false;
-        break;
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result);
-
-  rdata->isValid = result;
-  return result;
-}
-
-bool UCNL_NMEA_Parse_GGA(UCNL_NMEA_GGA_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $GNGGA,054157.013,2307.1261,N,12016.4308, E,1, 6,1.93,34.9,    M,17.8,M,,*76
-  // $GPGGA,025346.726,5311.9987,N,15942.6717, E,1,04,    ,-11.4228,M,    ,M,,*49
-  // $GPGGA,123143.00,4831.45878,N,04430.24139,E,1,05,3.68,19.0,    M,1.8, M,,*55
-
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1: // Time
-        if (ndIdx < stIdx)
-          result = false;
-        else
-        {
-          rdata->hour = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
-          rdata->minute = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
-          rdata->second = UCNL_STR_ParseFloat(buffer, stIdx + 4, ndIdx);
-
-          if (!UCNL_NMEA_IS_VALID_HOUR(rdata->hour) ||
-              !UCNL_NMEA_IS_VALID_MINSEC(rdata->minute) ||
-              !UCNL_NMEA_IS_VALID_MINSEC(rdata->second))
-            result = false;
-        }
-        break;
-      case 2: // Latitude
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->latitude_deg = (float)UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]) +
-                                UCNL_STR_ParseFloat(buffer, stIdx + 2, ndIdx) / 60.0;
-
-        if (!UCNL_NMEA_IS_VALID_LATDEG(rdata->latitude_deg))
-          result = false;
-        break;
-      case 3: // Latitude hemisphere
-        if (ndIdx < stIdx)
-          result = false;
-        else if (buffer[stIdx] == UCNL_NMEA_SOUTH_SIGN)
-          rdata->latitude_deg = -rdata->latitude_deg;
-        break;
-      case 4: // Longitude
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->longitude_deg = (float)UCNL_STR_CCC2B(buffer[stIdx], buffer[stIdx + 1], buffer[stIdx + 2]) +
-                                 UCNL_STR_ParseFloat(buffer, stIdx + 3, ndIdx) / 60.0;
-
-        if (!UCNL_NMEA_IS_VALID_LONDEG(rdata->longitude_deg))
-          result = false;
-        break;
-      case 5: // Longitude hemisphere
-        if (ndIdx < stIdx)
-          result = false;
-        else if (buffer[stIdx] == UCNL_NMEA_WEST_SIGN)
-          rdata->longitude_deg = -rdata->longitude_deg;
-        break;
-      case 6:
-        // GNSS quality indicator
-        if (ndIdx >= stIdx)
-          rdata->gnss_qly_ind = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 7:
-        // satellites in use
-        if (ndIdx >= stIdx)
-          rdata->sats_in_use = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 8:
-        // HDOP
-        if (ndIdx >= stIdx)
-          rdata->hdop = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 9:
-        // orthometricHeight
-        if (ndIdx >= stIdx)
-          rdata->orth_height = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      //case 10:
-      // orthometricHeight units
-      //     break;
-      case 11:
-        // geoidal separation
-        if (ndIdx >= stIdx)
-          rdata->gsep = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      //case 12:
-      // geoidal separation units
-      //     break;
-      case 13:
-        // dgps_rec_age
-        if (ndIdx >= stIdx)
-          rdata->dgps_rec_age = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 14:
-        // datum id
-        if (ndIdx >= stIdx)
-          rdata->datumID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result);
-
-  rdata->isValid = result;
-  return result;
-}
-
-bool UCNL_NMEA_Parse_GLL(UCNL_NMEA_GLL_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $GPGLL,4831.45336,N,04430.22910,E,131116.00,A,A*6E
-  // $GNGLL,4831.4600,N,04430.2750,E,125414.000,A,A*4F
-
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1: // Latitude
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->latitude_deg = (float)UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]) +
-                                UCNL_STR_ParseFloat(buffer, stIdx + 2, ndIdx) / 60.0;
-        break;
-      case 2: // Latitude hemisphere
-        if (ndIdx < stIdx)
-          result = false;
-        else if (buffer[stIdx] == UCNL_NMEA_SOUTH_SIGN)
-          rdata->latitude_deg = -rdata->latitude_deg;
-        break;
-      case 3: // Longitude
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->longitude_deg = (float)UCNL_STR_CCC2B(buffer[stIdx], buffer[stIdx + 1], buffer[stIdx + 2]) +
-                                 UCNL_STR_ParseFloat(buffer, stIdx + 3, ndIdx) / 60.0;
-        break;
-      case 4: // Longitude hemisphere
-        if (ndIdx < stIdx)
-          result = false;
-        else if (buffer[stIdx] == UCNL_NMEA_WEST_SIGN)
-          rdata->longitude_deg = -rdata->longitude_deg;
-        break;
-      case 5: // Time
-        if (ndIdx < stIdx)
-          result = false;
-        else
-        {
-          rdata->hour = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
-          rdata->minute = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
-          rdata->second = UCNL_STR_ParseFloat(buffer, stIdx + 4, ndIdx);
-
-          if (!UCNL_NMEA_IS_VALID_HOUR(rdata->hour) ||
-              !UCNL_NMEA_IS_VALID_MINSEC(rdata->minute) ||
-              !UCNL_NMEA_IS_VALID_MINSEC(rdata->second))
-            result = false;
-        }
-        break;
-      case 6:
-        if ((ndIdx < stIdx) || (buffer[stIdx] == UCNL_NMEA_DATA_NOT_VALID))
-          result = false;
-        break;
-      case 7:
-        if ((ndIdx < stIdx) || (buffer[stIdx] == UCNL_NMEA_PMODE_DATA_NOT_VALID))
-          result = false;
-        break;
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result);
-
-  rdata->isValid = result;
-  return result;
-}
-
-bool UCNL_NMEA_Parse_VTG(UCNL_NMEA_VTG_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $GPVTG,,T,,M,0.338,N,0.627,K,A*28
-  // $GPVTG,59.58,T,,M,1.43,N,2.65,K,A*0B
-
-
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1: // trackTrue
-        if (ndIdx >= stIdx)
-          rdata->track_true_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        else
-          result = false;
-        break;
-      case 3: // trackMagnetic
-        if (ndIdx >= stIdx)
-        {
-          rdata->is_magnetic = true;
-          rdata->track_magnetic_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-      case 5: // speedKnots
-        if (ndIdx >= stIdx)
-          rdata->speed_knots = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 7: // speedKmh
-        if (ndIdx >= stIdx)
-          rdata->speed_kmh = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 8:
-        if ((ndIdx < stIdx) || (buffer[stIdx] == UCNL_NMEA_DATA_NOT_VALID))
-          result = false;
-        break;
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result);
-
-  rdata->isValid = result;
-  return result;
-}
-
-bool UCNL_NMEA_Parse_HDT(UCNL_NMEA_HDT_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  // $GPHDT,253.423,T*34
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx >= stIdx)
-          rdata->track_true_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        else
-          result = false;
-        break;
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result);
-
-  rdata->isValid = result;
-  return result;
-}
-
-bool UCNL_NMEA_Parse_HDG(UCNL_NMEA_HDG_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  // $GPHDG,253.423,,,*34
-
-  float magnetic_heading_deg;
-  bool is_magnetic_variation;
-  float magnetic_variation;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx >= stIdx)
-          rdata->magnetic_heading_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        else
-          result = false;
-        break;
-      case 3:
-        if (ndIdx >= stIdx)
-        {
-          rdata->is_magnetic_variation = true;
-          rdata->magnetic_variation = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        else
-          rdata->is_magnetic_variation = false;
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result);
-
-  rdata->isValid = result;
-  return result;
-}
-
-bool UCNL_NMEA_Parse_MTW(UCNL_NMEA_MTW_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  // $GPMTW,253.423,C*34
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx >= stIdx)
-          rdata->mean_water_temperature_c = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        else
-          result = false;
-        break;
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result);
-
-  rdata->isValid = result;
-  return result;
-}
-
-bool UCNL_NMEA_Parse_GSA(UCNL_NMEA_GSA_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $GPGSA,A,3,18,26,23,16,27,10,,,,,,,3.51,1.83,2.99*02
-
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1: // Mode
-        if (ndIdx >= stIdx)
-          rdata->mode = buffer[stIdx];
-        break;
-      case 2: // fixType
-        if (ndIdx >= stIdx)
-          rdata->fix_type = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 3: // PRNs
-      case 4:
-      case 5:
-      case 6:
-      case 7:
-      case 8:
-      case 9:
-      case 10:
-      case 11:
-      case 12:
-      case 13:
-      case 14:
-        if (ndIdx >= stIdx)
-          rdata->prns[pIdx - 3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        else
-          rdata->prns[pIdx - 3] = 0;
-        break;
-      case 15: // PDOP
-        if (ndIdx >= stIdx)
-          rdata->pdop = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 16:
-        if (ndIdx >= stIdx)
-          rdata->hdop = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 17:
-        if (ndIdx >= stIdx)
-          rdata->vdop = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 18:
-        rdata->systemID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result);
-
-  rdata->isValid = result;
-  return result;
-}
-
-bool UCNL_NMEA_Parse_GSV(UCNL_NMEA_GSV_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $GPGSV,3,1,12,08,15,313,15,10,56,213,35,13,14,037,14,15,31,064,20*75
-  // $GPGSV,3,2,12,16,35,250,31,18,56,078,21,20,03,055,,23,81,113,18*7A
-  // $GPGSV,3,3,12,26,19,225,26,27,47,303,18,29,10,140,08,32,00,176,*7E
-
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  rdata->satDataNum = 0;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx >= stIdx)
-          rdata->total_messages = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        else
-          result = false;
-        break;
-
-      case 2:
-        if (ndIdx >= stIdx)
-          rdata->current_message = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        else
-          result = false;
-        break;
-
-      case 3:
-        if (ndIdx >= stIdx)
-          rdata->sats_in_view = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        else
-          result = false;
-        break;
-
-// Sat 1 section
-      case 4:
-        if (ndIdx >= stIdx)
-          rdata->PRNNumbers[0] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 5:
-        if (ndIdx >= stIdx)
-          rdata->Elevations[0] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 6:
-        if (ndIdx >= stIdx)
-          rdata->Azimuths[0] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 7:
-        if (ndIdx >= stIdx)
-        {
-          rdata->SNRs[0] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-          rdata->satDataNum = 1;
-        }
-        break;
-        
-// Sat 2 section
-      case 8:
-        if (ndIdx >= stIdx)
-          rdata->PRNNumbers[1] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 9:
-        if (ndIdx >= stIdx)
-          rdata->Elevations[1] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 10:
-        if (ndIdx >= stIdx)
-          rdata->Azimuths[1] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 11:
-        if (ndIdx >= stIdx)
-        {
-          rdata->SNRs[1] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-          rdata->satDataNum = 2;
-        }
-
-// Sat 3 section
-      case 12:
-        if (ndIdx >= stIdx)
-          rdata->PRNNumbers[2] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 13:
-        if (ndIdx >= stIdx)
-          rdata->Elevations[2] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 14:
-        if (ndIdx >= stIdx)
-          rdata->Azimuths[2] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 15:
-        if (ndIdx >= stIdx)
-        {
-          rdata->SNRs[2] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-          rdata->satDataNum = 3;
-        }
-
-// Sat 4 section
-      case 16:
-        if (ndIdx >= stIdx)
-          rdata->PRNNumbers[3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 17:
-        if (ndIdx >= stIdx)
-          rdata->Elevations[3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 18:
-        if (ndIdx >= stIdx)
-          rdata->Azimuths[3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 19:
-        if (ndIdx >= stIdx)
-        {
-          rdata->SNRs[3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-          rdata->satDataNum = 4;
-        }
-
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result); 
-
-  rdata->isValid = result;
-  return result;
-}
-
-bool UCNL_NMEA_Parse_ZDA(UCNL_NMEA_ZDA_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  bool isNotLastParam = false;
-  bool result = true;
-  byte pIdx = 0, ndIdx = 0, stIdx = 0;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-        {
-          rdata->hour = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
-          rdata->minute = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
-          rdata->second = UCNL_STR_ParseFloat(buffer, stIdx + 4, ndIdx);
-
-          if (!UCNL_NMEA_IS_VALID_HOUR(rdata->hour) ||
-              !UCNL_NMEA_IS_VALID_MINSEC(rdata->minute) ||
-              !UCNL_NMEA_IS_VALID_MINSEC(rdata->second))
-            result = false;
-        }
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->day = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 3:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->month = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 4:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->year = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 5:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->t_zone_offset_hours = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 6:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->t_zone_offset_minutes = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      default:
-        break;
-    }
-    pIdx++;
-  } while (isNotLastParam && result);
-
-  rdata->isValid = result;
-  return result;
-}
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+#include "ucnl_nmea.h"
+
+// Adds a field separator to the field index, fields over UCNL_NMEA_MAX_FIELDS are dropped
+static void UCNL_NMEA_Fields_Add(UCNL_NMEA_Fields_Struct* fields, byte pos)
+{
+  if (fields->num < UCNL_NMEA_MAX_FIELDS)
+    fields->sepIdx[fields->num++] = pos;
+}
+
+
+void UCNL_NMEA_InitStruct(UCNL_NMEA_State_Struct* uState, byte* buffer, byte buffer_size, long* sntIDs, byte sntIDs_size)
+{
+  uState->isReady = false;
+  uState->isStarted = false;
+  uState->buffer = buffer;
+  uState->buffer_size = buffer_size;
+  uState->sntIDs = sntIDs;
+  uState->sntIDs_size = sntIDs_size;
+  uState->fields.num = 0;
+  uState->fields.isDone = false;
+  uState->sntTable = NULL;
+  uState->sntEntry = NULL;
+}
+
+void UCNL_NMEA_Release(UCNL_NMEA_State_Struct* uState)
+{
+  uState->isReady = false;
+}
+
+static byte UCNL_NMEA_SntIDs_Hash(long sntID)
+{
+  uint32_t h = (uint32_t)sntID * (uint32_t)UCNL_NMEA_SNTIDS_HASH_MUL;
+  return (byte)(h >> (32 - UCNL_NMEA_SNTIDS_TABLE_BITS));
+}
+
+void UCNL_NMEA_SntIDs_Init(UCNL_NMEA_SntIDs_Table_Struct* table)
+{
+  memset(table, 0, sizeof(UCNL_NMEA_SntIDs_Table_Struct));
+}
+
+/* Adds a sentence ID to the table or updates its handler if the ID is already there
+   "table" sentence IDs table
+   "sntID" packed sentence ID, e.g. UCNL_NMEA_RMC_SNT_ID or uWAVE_NMEA_UWV0_SNT_ID
+   "handler" is called by UCNL_NMEA_Dispatch for sentences with this ID, may be NULL
+   "param" user parameter passed to the handler
+   returns false if the table is full
+*/
+bool UCNL_NMEA_SntIDs_Add(UCNL_NMEA_SntIDs_Table_Struct* table, long sntID, UCNL_NMEA_Sentence_Callback handler, void* param)
+{
+  byte i = UCNL_NMEA_SntIDs_Hash(sntID);
+
+  while ((table->entries[i].sntID != 0) && (table->entries[i].sntID != sntID))
+    i = (i + 1) & (UCNL_NMEA_SNTIDS_TABLE_SIZE - 1);
+
+  if (table->entries[i].sntID == 0)
+  {
+    // one slot is always kept free, so lookups of unknown IDs stop
+    if (table->num >= UCNL_NMEA_SNTIDS_TABLE_SIZE - 1)
+      return false;
+
+    table->entries[i].sntID = sntID;
+    table->num++;
+  }
+
+  table->entries[i].handler = handler;
+  table->entries[i].param = param;
+  return true;
+}
+
+// Looks up a sentence ID, returns its entry or NULL if the ID is not in the table
+const UCNL_NMEA_SntIDs_Entry_Struct* UCNL_NMEA_SntIDs_Find(const UCNL_NMEA_SntIDs_Table_Struct* table, long sntID)
+{
+  byte i = UCNL_NMEA_SntIDs_Hash(sntID);
+
+  while (table->entries[i].sntID != sntID)
+  {
+    if (table->entries[i].sntID == 0)
+      return NULL;
+    i = (i + 1) & (UCNL_NMEA_SNTIDS_TABLE_SIZE - 1);
+  }
+
+  return &table->entries[i];
+}
+
+// Makes the parser state filter sentences by the table instead of its sntIDs list
+void UCNL_NMEA_Set_SntIDs_Table(UCNL_NMEA_State_Struct* uState, const UCNL_NMEA_SntIDs_Table_Struct* table)
+{
+  uState->sntTable = table;
+  uState->sntEntry = NULL;
+}
+
+/* Calls the handler registered for the ID of a ready sentence
+   returns false if there is no sentences IDs table or no handler for the ID
+*/
+bool UCNL_NMEA_Dispatch(UCNL_NMEA_State_Struct* uState)
+{
+  if ((uState->sntEntry == NULL) || (uState->sntEntry->handler == NULL))
+    return false;
+
+  uState->sntEntry->handler(uState, uState->sntEntry->param);
+  return true;
+}
+
+// Checks the ID of a new sentence, the table lookup also finds the sentence handler
+static bool UCNL_NMEA_Is_SntID_Accepted(UCNL_NMEA_State_Struct* uState)
+{
+  byte i = 0;
+
+  if (uState->sntTable != NULL)
+  {
+    uState->sntEntry = UCNL_NMEA_SntIDs_Find(uState->sntTable, uState->sntID);
+    return (uState->sntEntry != NULL);
+  }
+
+  while ((i < uState->sntIDs_size) && (uState->sntID != uState->sntIDs[i]))
+    i++;
+
+  return (i < uState->sntIDs_size);
+}
+
+// A start symbol: only the sentence length and state are reset, parsers never read the buffer past "idx"
+static void UCNL_NMEA_Start(UCNL_NMEA_State_Struct* uState)
+{
+  uState->isStarted = true;
+
+  uState->chk_act     = 0;
+  uState->chk_dcl     = 0;
+  uState->chk_dcl_idx = 0;
+
+  uState->isPSentence = false;
+  uState->tkrID       = 0;
+  uState->sntID       = 0;
+  uState->sntEntry    = NULL;
+
+  uState->fields.num    = 0;
+  uState->fields.isDone = false;
+
+  uState->buffer[0] = UCNL_NMEA_SNT_STR;
+  uState->idx = 1;
+}
+
+UCNL_NMEA_Result_Enum UCNL_NMEA_Process_Byte(UCNL_NMEA_State_Struct* uState, byte newByte)
+{
+  UCNL_NMEA_Result_Enum result = UCNL_NMEA_RESULT_BYPASS_BYTE;
+
+  if (!uState->isReady)
+  {
+    if (newByte == UCNL_NMEA_SNT_STR)
+    {
+      UCNL_NMEA_Start(uState);
+      result = UCNL_NMEA_RESULT_PACKET_STARTED;
+    }
+    else
+    {
+      if (uState->isStarted)
+      {
+        result = UCNL_NMEA_RESULT_PACKET_PROCESS;
+        uState->buffer[uState->idx] = newByte;
+
+        if (newByte == UCNL_NMEA_SNT_END)
+        {
+          uState->isStarted = false;
+          uState->isReady = true;
+          result = UCNL_NMEA_RESULT_PACKET_READY;
+
+          // no checksum and no CR: the last field runs up to the sentence end
+          if (!uState->fields.isDone)
+          {
+            UCNL_NMEA_Fields_Add(&uState->fields, uState->idx + 1);
+            uState->fields.isDone = true;
+          }
+        }
+        else if (newByte == UCNL_NMEA_CHK_SEP)
+        {
+          uState->chk_dcl_idx = 1;
+          uState->chk_present = true;
+
+          if (!uState->fields.isDone)
+          {
+            UCNL_NMEA_Fields_Add(&uState->fields, uState->idx);
+            uState->fields.isDone = true;
+          }
+        }
+        else
+        {
+          if (uState->idx >= uState->buffer_size)
+          {
+            uState->isStarted = false;
+            result = UCNL_NMEA_RESULT_PACKET_TOO_BIG;
+          }
+          else
+          {
+            if (uState->chk_dcl_idx == 0)
+            {
+              uState->chk_act ^= newByte;
+
+              if ((uState->idx > 1) && !uState->fields.isDone)
+              {
+                if (newByte == UCNL_NMEA_PAR_SEP)
+                  UCNL_NMEA_Fields_Add(&uState->fields, uState->idx);
+                else if (newByte == UCNL_NMEA_SNT_END1)
+                {
+                  UCNL_NMEA_Fields_Add(&uState->fields, uState->idx);
+                  uState->fields.isDone = true;
+                }
+              }
+
+              if      (uState->idx == 1)
+                if (newByte == UCNL_NMEA_PSENTENCE_SYMBOL)
+                  uState->isPSentence = true;
+                else
+                  uState->tkrID = ((int)newByte) << 8;
+              else if (uState->idx == 2)
+                if (uState->isPSentence)
+                  uState->sntID = ((long)newByte) << 24;
+                else
+                  uState->tkrID |= newByte;
+              else if (uState->idx == 3)
+                if (uState->isPSentence)
+                  uState->sntID |= (((long)newByte) << 16);
+                else
+                  uState->sntID = (((long)newByte) << 16);
+              else if (uState->idx == 4)
+                uState->sntID |= (((long)newByte) << 8);
+              else if (uState->idx == 5)
+              {
+                uState->sntID |= newByte;
+
+                if (!UCNL_NMEA_Is_SntID_Accepted(uState))
+                {
+                  uState->isStarted = false;
+                  result = UCNL_NMEA_RESULT_PACKET_SKIPPING;
+                }
+              }
+            }
+            else if (uState->chk_dcl_idx == 1)
+            {
+              uState->chk_dcl = 16 * UCNL_STR_HEXDIGIT2B(newByte);
+              uState->chk_dcl_idx++;
+            }
+            else if (uState->chk_dcl_idx == 2)
+            {
+              uState->chk_dcl += UCNL_STR_HEXDIGIT2B(newByte);
+              if (uState->chk_act != uState->chk_dcl)
+              {
+                uState->isStarted = false;
+                result = UCNL_NMEA_RESULT_PACKET_CHECKSUM_ERROR;
+              }
+              uState->chk_dcl_idx++;
+            }
+          }
+        }
+        uState->idx++;
+      }
+    }
+  }
+  return result;
+}
+
+// Framing kernels: delimiter search, XOR reduction and field separators mask, all three at once for a sentence span
+// On x86 SSE2/AVX2 versions are chosen at runtime, elsewhere a portable scalar version is used
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(UCNL_NMEA_NO_SIMD)
+#define UCNL_NMEA_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#define UCNL_NMEA_WORD_ONES      ((size_t)-1 / 0xFF)
+#define UCNL_NMEA_WORD_HIGHS     (UCNL_NMEA_WORD_ONES * 0x80)
+#define UCNL_NMEA_WORD_HAS(w, c) ((((w) ^ (UCNL_NMEA_WORD_ONES * (c))) - UCNL_NMEA_WORD_ONES) & ~((w) ^ (UCNL_NMEA_WORD_ONES * (c))) & UCNL_NMEA_WORD_HIGHS)
+
+#define UCNL_NMEA_IS_SEP(c)      (((c) == UCNL_NMEA_PAR_SEP) || ((c) == UCNL_NMEA_CHK_SEP) || ((c) == UCNL_NMEA_SNT_END1))
+#define UCNL_NMEA_IS_FRAMING(c)  (((c) == UCNL_NMEA_SNT_STR) || ((c) == UCNL_NMEA_CHK_SEP) || ((c) == UCNL_NMEA_SNT_END))
+#define UCNL_NMEA_IS_SPAN_END(c) (UCNL_NMEA_IS_FRAMING(c) || ((c) == UCNL_NMEA_SNT_END1))
+
+typedef size_t (*UCNL_NMEA_Find_Func)(const byte* data, size_t size, byte d1, byte d2, byte d3);
+typedef byte   (*UCNL_NMEA_Scan_Func)(const byte* data, byte size, uint32_t* sepMask);
+typedef size_t (*UCNL_NMEA_Span_Func)(const byte* data, size_t size, size_t avail, byte* dst, byte* acc, uint32_t* sepMask);
+
+static size_t UCNL_NMEA_Find_Scalar(const byte* data, size_t size, byte d1, byte d2, byte d3)
+{
+  size_t i = 0, w;
+
+  // a machine word at a time
+  while (i + sizeof(size_t) <= size)
+  {
+    memcpy(&w, data + i, sizeof(size_t));
+    if (UCNL_NMEA_WORD_HAS(w, d1) | UCNL_NMEA_WORD_HAS(w, d2) | UCNL_NMEA_WORD_HAS(w, d3))
+      break;
+    i += sizeof(size_t);
+  }
+
+  while ((i < size) && (data[i] != d1) && (data[i] != d2) && (data[i] != d3))
+    i++;
+
+  return i;
+}
+
+static byte UCNL_NMEA_Scan_Scalar(const byte* data, byte size, uint32_t* sepMask)
+{
+  byte i, c, acc = 0;
+  uint32_t bit = 1, word = 0;
+
+  if (sepMask == NULL)
+  {
+    for (i = 0; i < size; i++)
+      acc ^= data[i];
+  }
+  else
+  {
+    for (i = 0; i < size; i++)
+    {
+      c = data[i];
+      acc ^= c;
+      if (UCNL_NMEA_IS_SEP(c))
+        word |= bit;
+
+      bit <<= 1;
+      if (bit == 0)
+      {
+        sepMask[i >> 5] = word;
+        word = 0;
+        bit = 1;
+      }
+    }
+
+    if (bit != 1)
+      sepMask[i >> 5] = word;
+  }
+
+  return acc;
+}
+
+// Span kernel bytes from "i" on, the mask bits go to their positions from the span start
+static size_t UCNL_NMEA_Span_Bytes(const byte* data, size_t i, size_t size, byte* dst, byte* acc, uint32_t* sepMask)
+{
+  byte c, x = *acc;
+  uint32_t word = ((i & 31) != 0) ? sepMask[i >> 5] : 0;
+
+  for (; i < size; i++)
+  {
+    c = data[i];
+    if (UCNL_NMEA_IS_SPAN_END(c))
+      break;
+
+    dst[i] = c;
+    x ^= c;
+    if (c == UCNL_NMEA_PAR_SEP)
+      word |= ((uint32_t)1) << (i & 31);
+
+    if ((i & 31) == 31)
+    {
+      sepMask[i >> 5] = word;
+      word = 0;
+    }
+  }
+
+  if ((i & 31) != 0)
+    sepMask[i >> 5] = word;
+
+  *acc = x;
+  return i;
+}
+
+/* A sentence body span in one pass: copies data to "dst" up to the first framing symbol, CR or "size" bytes,
+   XORs the copied bytes into "acc" and builds their parameter separators mask, bit n is set for a comma at dst[n].
+   "avail" bytes of data may be read, avail >= size; returns number of bytes copied
+*/
+static size_t UCNL_NMEA_Span_Scalar(const byte* data, size_t size, size_t avail, byte* dst, byte* acc, uint32_t* sepMask)
+{
+  return UCNL_NMEA_Span_Bytes(data, 0, size, dst, acc, sepMask);
+}
+
+#ifdef UCNL_NMEA_X86_SIMD
+
+__attribute__((target("sse2")))
+static size_t UCNL_NMEA_Find_SSE2(const byte* data, size_t size, byte d1, byte d2, byte d3)
+{
+  size_t i = 0;
+  const __m128i v1 = _mm_set1_epi8((char)d1);
+  const __m128i v2 = _mm_set1_epi8((char)d2);
+  const __m128i v3 = _mm_set1_epi8((char)d3);
+  __m128i v;
+  unsigned int m;
+
+  for (; i + 16 <= size; i += 16)
+  {
+    v = _mm_loadu_si128((const __m128i*)(data + i));
+    m = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, v1), _mm_cmpeq_epi8(v, v2)), _mm_cmpeq_epi8(v, v3)));
+    if (m != 0)
+      return i + __builtin_ctz(m);
+  }
+
+  return i + UCNL_NMEA_Find_Scalar(data + i, size - i, d1, d2, d3);
+}
+
+__attribute__((target("avx2")))
+static size_t UCNL_NMEA_Find_AVX2(const byte* data, size_t size, byte d1, byte d2, byte d3)
+{
+  size_t i = 0;
+  const __m256i v1 = _mm256_set1_epi8((char)d1);
+  const __m256i v2 = _mm256_set1_epi8((char)d2);
+  const __m256i v3 = _mm256_set1_epi8((char)d3);
+  __m256i v;
+  unsigned int m;
+
+  for (; i + 32 <= size; i += 32)
+  {
+    v = _mm256_loadu_si256((const __m256i*)(data + i));
+    m = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, v1), _mm256_cmpeq_epi8(v, v2)), _mm256_cmpeq_epi8(v, v3)));
+    if (m != 0)
+      return i + __builtin_ctz(m);
+  }
+
+  return i + UCNL_NMEA_Find_SSE2(data + i, size - i, d1, d2, d3);
+}
+
+__attribute__((target("sse2")))
+static byte UCNL_NMEA_Scan_SSE2(const byte* data, byte size, uint32_t* sepMask)
+{
+  int i = 0;
+  const __m128i vp = _mm_set1_epi8(UCNL_NMEA_PAR_SEP);
+  const __m128i vc = _mm_set1_epi8(UCNL_NMEA_CHK_SEP);
+  const __m128i ve = _mm_set1_epi8(UCNL_NMEA_SNT_END1);
+  __m128i v, acc = _mm_setzero_si128();
+  byte tail[16];
+
+  if (sepMask != NULL)
+    memset(sepMask, 0, ((size + 31) >> 5) * sizeof(uint32_t));
+
+  // the rest goes zero padded as one more iteration, zeros change neither the XOR nor the mask
+  for (; i < size; i += 16)
+  {
+    if (i + 16 <= size)
+      v = _mm_loadu_si128((const __m128i*)(data + i));
+    else
+    {
+      memset(tail, 0, sizeof(tail));
+      memcpy(tail, data + i, size - i);
+      v = _mm_loadu_si128((const __m128i*)tail);
+    }
+
+    acc = _mm_xor_si128(acc, v);
+    if (sepMask != NULL)
+      sepMask[i >> 5] |= ((uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, vp), _mm_cmpeq_epi8(v, vc)), _mm_cmpeq_epi8(v, ve)))) << (i & 31);
+  }
+
+  acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 8));
+  acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 4));
+  acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 2));
+  acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 1));
+
+  return (byte)_mm_cvtsi128_si32(acc);
+}
+
+__attribute__((target("avx2")))
+static byte UCNL_NMEA_Scan_AVX2(const byte* data, byte size, uint32_t* sepMask)
+{
+  int i = 0;
+  const __m256i vp = _mm256_set1_epi8(UCNL_NMEA_PAR_SEP);
+  const __m256i vc = _mm256_set1_epi8(UCNL_NMEA_CHK_SEP);
+  const __m256i ve = _mm256_set1_epi8(UCNL_NMEA_SNT_END1);
+  __m256i v, acc = _mm256_setzero_si256();
+  byte tail[32];
+  int r;
+
+  // a whole mask word per iteration, the rest goes zero padded as one more iteration
+  for (; i < size; i += 32)
+  {
+    if (i + 32 <= size)
+      v = _mm256_loadu_si256((const __m256i*)(data + i));
+    else
+    {
+      memset(tail, 0, sizeof(tail));
+      memcpy(tail, data + i, size - i);
+      v = _mm256_loadu_si256((const __m256i*)tail);
+    }
+
+    acc = _mm256_xor_si256(acc, v);
+    if (sepMask != NULL)
+      sepMask[i >> 5] = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, vp), _mm256_cmpeq_epi8(v, vc)), _mm256_cmpeq_epi8(v, ve)));
+  }
+
+  __m128i acc128 = _mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  acc128 = _mm_xor_si128(acc128, _mm_srli_si128(acc128, 8));
+  acc128 = _mm_xor_si128(acc128, _mm_srli_si128(acc128, 4));
+  r = _mm_cvtsi128_si32(acc128);
+
+  return (byte)(r ^ (r >> 8) ^ (r >> 16) ^ (r >> 24));
+}
+
+// Span kernels read whole blocks while "avail" allows, the block with the span end is cut by a lane mask,
+// zeros change neither the XOR nor the mask. The rest goes byte by byte
+__attribute__((target("sse2")))
+static size_t UCNL_NMEA_Span_SSE2(const byte* data, size_t size, size_t avail, byte* dst, byte* acc, uint32_t* sepMask)
+{
+  size_t i = 0;
+  const __m128i vs = _mm_set1_epi8(UCNL_NMEA_SNT_STR);
+  const __m128i vc = _mm_set1_epi8(UCNL_NMEA_CHK_SEP);
+  const __m128i ve = _mm_set1_epi8(UCNL_NMEA_SNT_END);
+  const __m128i vr = _mm_set1_epi8(UCNL_NMEA_SNT_END1);
+  const __m128i vp = _mm_set1_epi8(UCNL_NMEA_PAR_SEP);
+  const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  __m128i v, x = _mm_setzero_si128();
+  unsigned int d, n = 16, m;
+  byte r;
+
+  for (; (i < size) && (i + 16 <= avail); i += n)
+  {
+    v = _mm_loadu_si128((const __m128i*)(data + i));
+    d = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, vs), _mm_cmpeq_epi8(v, vc)),
+                                                     _mm_or_si128(_mm_cmpeq_epi8(v, ve), _mm_cmpeq_epi8(v, vr))));
+    if (size - i < 16)
+      d |= 0xFFFFu << (size - i);
+
+    n = 16;
+    if (d != 0)
+    {
+      n = __builtin_ctz(d);
+      v = _mm_and_si128(v, _mm_cmpgt_epi8(_mm_set1_epi8((char)n), lanes));
+    }
+
+    if (i + 16 <= size)
+      _mm_storeu_si128((__m128i*)(dst + i), v);
+    else
+      memcpy(dst + i, data + i, n);
+
+    x = _mm_xor_si128(x, v);
+    m = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(v, vp));
+    if ((i & 31) == 0)
+      sepMask[i >> 5] = m;
+    else
+      sepMask[i >> 5] |= m << 16;
+
+    if (n < 16)
+    {
+      i += n;
+      break;
+    }
+  }
+
+  x = _mm_xor_si128(x, _mm_srli_si128(x, 8));
+  x = _mm_xor_si128(x, _mm_srli_si128(x, 4));
+  x = _mm_xor_si128(x, _mm_srli_si128(x, 2));
+  x = _mm_xor_si128(x, _mm_srli_si128(x, 1));
+  r = *acc ^ (byte)_mm_cvtsi128_si32(x);
+
+  if ((n == 16) && (i < size))
+    i = UCNL_NMEA_Span_Bytes(data, i, size, dst, &r, sepMask);
+
+  *acc = r;
+  return i;
+}
+
+__attribute__((target("avx2")))
+static size_t UCNL_NMEA_Span_AVX2(const byte* data, size_t size, size_t avail, byte* dst, byte* acc, uint32_t* sepMask)
+{
+  size_t i = 0;
+  const __m256i vs = _mm256_set1_epi8(UCNL_NMEA_SNT_STR);
+  const __m256i vc = _mm256_set1_epi8(UCNL_NMEA_CHK_SEP);
+  const __m256i ve = _mm256_set1_epi8(UCNL_NMEA_SNT_END);
+  const __m256i vr = _mm256_set1_epi8(UCNL_NMEA_SNT_END1);
+  const __m256i vp = _mm256_set1_epi8(UCNL_NMEA_PAR_SEP);
+  const __m256i lanes = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                         16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+  __m256i v, x = _mm256_setzero_si256();
+  __m128i x128;
+  unsigned int d, n = 32;
+  byte r;
+  int k;
+
+  for (; (i < size) && (i + 32 <= avail); i += n)
+  {
+    v = _mm256_loadu_si256((const __m256i*)(data + i));
+    d = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, vs), _mm256_cmpeq_epi8(v, vc)),
+                                                           _mm256_or_si256(_mm256_cmpeq_epi8(v, ve), _mm256_cmpeq_epi8(v, vr))));
+    if (size - i < 32)
+      d |= 0xFFFFFFFFu << (size - i);
+
+    n = 32;
+    if (d != 0)
+    {
+      n = __builtin_ctz(d);
+      v = _mm256_and_si256(v, _mm256_cmpgt_epi8(_mm256_set1_epi8((char)n), lanes));
+    }
+
+    if (i + 32 <= size)
+      _mm256_storeu_si256((__m256i*)(dst + i), v);
+    else
+      memcpy(dst + i, data + i, n);
+
+    x = _mm256_xor_si256(x, v);
+    sepMask[i >> 5] = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vp));
+
+    if (n < 32)
+    {
+      i += n;
+      break;
+    }
+  }
+
+  x128 = _mm_xor_si128(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+  x128 = _mm_xor_si128(x128, _mm_srli_si128(x128, 8));
+  x128 = _mm_xor_si128(x128, _mm_srli_si128(x128, 4));
+  k = _mm_cvtsi128_si32(x128);
+  r = *acc ^ (byte)(k ^ (k >> 8) ^ (k >> 16) ^ (k >> 24));
+
+  if ((n == 32) && (i < size))
+    i = UCNL_NMEA_Span_Bytes(data, i, size, dst, &r, sepMask);
+
+  *acc = r;
+  return i;
+}
+
+#endif
+
+static size_t UCNL_NMEA_Find_Select(const byte* data, size_t size, byte d1, byte d2, byte d3);
+static byte   UCNL_NMEA_Scan_Select(const byte* data, byte size, uint32_t* sepMask);
+static size_t UCNL_NMEA_Span_Select(const byte* data, size_t size, size_t avail, byte* dst, byte* acc, uint32_t* sepMask);
+
+static UCNL_NMEA_Find_Func UCNL_NMEA_Find_Impl = UCNL_NMEA_Find_Select;
+static UCNL_NMEA_Scan_Func UCNL_NMEA_Scan_Impl = UCNL_NMEA_Scan_Select;
+static UCNL_NMEA_Span_Func UCNL_NMEA_Span_Impl = UCNL_NMEA_Span_Select;
+
+/* Picks the best framing kernels for the CPU, every kernel pointer is written once with its final value
+   Otherwise this is done on the first use, call it before starting threads that use the parsers
+*/
+void UCNL_NMEA_Kernels_Init()
+{
+  UCNL_NMEA_Find_Func find = UCNL_NMEA_Find_Scalar;
+  UCNL_NMEA_Scan_Func scan = UCNL_NMEA_Scan_Scalar;
+  UCNL_NMEA_Span_Func span = UCNL_NMEA_Span_Scalar;
+
+#ifdef UCNL_NMEA_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+  {
+    find = UCNL_NMEA_Find_AVX2;
+    scan = UCNL_NMEA_Scan_AVX2;
+    span = UCNL_NMEA_Span_AVX2;
+  }
+  else if (__builtin_cpu_supports("sse2"))
+  {
+    find = UCNL_NMEA_Find_SSE2;
+    scan = UCNL_NMEA_Scan_SSE2;
+    span = UCNL_NMEA_Span_SSE2;
+  }
+#endif
+
+  UCNL_NMEA_Find_Impl = find;
+  UCNL_NMEA_Scan_Impl = scan;
+  UCNL_NMEA_Span_Impl = span;
+}
+
+static size_t UCNL_NMEA_Find_Select(const byte* data, size_t size, byte d1, byte d2, byte d3)
+{
+  UCNL_NMEA_Kernels_Init();
+  return UCNL_NMEA_Find_Impl(data, size, d1, d2, d3);
+}
+
+static byte UCNL_NMEA_Scan_Select(const byte* data, byte size, uint32_t* sepMask)
+{
+  UCNL_NMEA_Kernels_Init();
+  return UCNL_NMEA_Scan_Impl(data, size, sepMask);
+}
+
+static size_t UCNL_NMEA_Span_Select(const byte* data, size_t size, size_t avail, byte* dst, byte* acc, uint32_t* sepMask)
+{
+  UCNL_NMEA_Kernels_Init();
+  return UCNL_NMEA_Span_Impl(data, size, avail, dst, acc, sepMask);
+}
+
+/* Searches for the first occurrence of any of three delimiters
+   "data" data to search in
+   "size" data size, bytes
+   "d1", "d2", "d3" delimiters to search for, may repeat
+   returns index of the first delimiter or "size" if there is none
+*/
+size_t UCNL_NMEA_Find_Delimiter(const byte* data, size_t size, byte d1, byte d2, byte d3)
+{
+  return UCNL_NMEA_Find_Impl(data, size, d1, d2, d3);
+}
+
+/* Scans a sentence or its part in one pass
+   "data" data to scan
+   "size" data size, bytes
+   "sepMask" field separators mask, UCNL_NMEA_SEP_MASK_SIZE words or NULL if not needed:
+   bit n is set when data[n] is a field separator (parameter separator, checksum separator or CR),
+   the same symbols UCNL_NMEA_Get_NextParam stops at
+   returns XOR of all the data bytes
+*/
+byte UCNL_NMEA_Scan(const byte* data, byte size, uint32_t* sepMask)
+{
+  return UCNL_NMEA_Scan_Impl(data, size, sepMask);
+}
+
+// Adds separators of a buffer span to the field index
+// "sepMask" is the span separators mask, "offset" and "size" are the span position and size in the buffer
+static void UCNL_NMEA_Fields_Append(UCNL_NMEA_Fields_Struct* fields, const byte* buffer, const uint32_t* sepMask, byte offset, byte size)
+{
+  int w_idx, pos;
+  uint32_t w;
+
+  for (w_idx = 0; (w_idx << 5) < size; w_idx++)
+  {
+    w = sepMask[w_idx];
+    while (w != 0)
+    {
+      pos = (w_idx << 5) + __builtin_ctzl(w);
+      if (pos >= size)
+        return;
+
+      pos += offset;
+      UCNL_NMEA_Fields_Add(fields, pos);
+      if (buffer[pos] != UCNL_NMEA_PAR_SEP)
+      {
+        fields->isDone = true;
+        return;
+      }
+      w &= w - 1;
+    }
+  }
+}
+
+// Field positions go by a table a mask byte at a time, the table takes 2 KB of RAM on AVR, so it is not used there
+#if !defined(__AVR__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define UCNL_NMEA_POS_TABLE
+#endif
+
+#ifdef UCNL_NMEA_POS_TABLE
+
+// Bit positions of a byte, one per byte from the lowest one, and their number
+static const uint64_t UCNL_NMEA_Byte_Pos[256] = {
+  0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000001ULL, 0x0000000000000100ULL,
+  0x0000000000000002ULL, 0x0000000000000200ULL, 0x0000000000000201ULL, 0x0000000000020100ULL,
+  0x0000000000000003ULL, 0x0000000000000300ULL, 0x0000000000000301ULL, 0x0000000000030100ULL,
+  0x0000000000000302ULL, 0x0000000000030200ULL, 0x0000000000030201ULL, 0x0000000003020100ULL,
+  0x0000000000000004ULL, 0x0000000000000400ULL, 0x0000000000000401ULL, 0x0000000000040100ULL,
+  0x0000000000000402ULL, 0x0000000000040200ULL, 0x0000000000040201ULL, 0x0000000004020100ULL,
+  0x0000000000000403ULL, 0x0000000000040300ULL, 0x0000000000040301ULL, 0x0000000004030100ULL,
+  0x0000000000040302ULL, 0x0000000004030200ULL, 0x0000000004030201ULL, 0x0000000403020100ULL,
+  0x0000000000000005ULL, 0x0000000000000500ULL, 0x0000000000000501ULL, 0x0000000000050100ULL,
+  0x0000000000000502ULL, 0x0000000000050200ULL, 0x0000000000050201ULL, 0x0000000005020100ULL,
+  0x0000000000000503ULL, 0x0000000000050300ULL, 0x0000000000050301ULL, 0x0000000005030100ULL,
+  0x0000000000050302ULL, 0x0000000005030200ULL, 0x0000000005030201ULL, 0x0000000503020100ULL,
+  0x0000000000000504ULL, 0x0000000000050400ULL, 0x0000000000050401ULL, 0x0000000005040100ULL,
+  0x0000000000050402ULL, 0x0000000005040200ULL, 0x0000000005040201ULL, 0x0000000504020100ULL,
+  0x0000000000050403ULL, 0x0000000005040300ULL, 0x0000000005040301ULL, 0x0000000504030100ULL,
+  0x0000000005040302ULL, 0x0000000504030200ULL, 0x0000000504030201ULL, 0x0000050403020100ULL,
+  0x0000000000000006ULL, 0x0000000000000600ULL, 0x0000000000000601ULL, 0x0000000000060100ULL,
+  0x0000000000000602ULL, 0x0000000000060200ULL, 0x0000000000060201ULL, 0x0000000006020100ULL,
+  0x0000000000000603ULL, 0x0000000000060300ULL, 0x0000000000060301ULL, 0x0000000006030100ULL,
+  0x0000000000060302ULL, 0x0000000006030200ULL, 0x0000000006030201ULL, 0x0000000603020100ULL,
+  0x0000000000000604ULL, 0x0000000000060400ULL, 0x0000000000060401ULL, 0x0000000006040100ULL,
+  0x0000000000060402ULL, 0x0000000006040200ULL, 0x0000000006040201ULL, 0x0000000604020100ULL,
+  0x0000000000060403ULL, 0x0000000006040300ULL, 0x0000000006040301ULL, 0x0000000604030100ULL,
+  0x0000000006040302ULL, 0x0000000604030200ULL, 0x0000000604030201ULL, 0x0000060403020100ULL,
+  0x0000000000000605ULL, 0x0000000000060500ULL, 0x0000000000060501ULL, 0x0000000006050100ULL,
+  0x0000000000060502ULL, 0x0000000006050200ULL, 0x0000000006050201ULL, 0x0000000605020100ULL,
+  0x0000000000060503ULL, 0x0000000006050300ULL, 0x0000000006050301ULL, 0x0000000605030100ULL,
+  0x0000000006050302ULL, 0x0000000605030200ULL, 0x0000000605030201ULL, 0x0000060503020100ULL,
+  0x0000000000060504ULL, 0x0000000006050400ULL, 0x0000000006050401ULL, 0x0000000605040100ULL,
+  0x0000000006050402ULL, 0x0000000605040200ULL, 0x0000000605040201ULL, 0x0000060504020100ULL,
+  0x0000000006050403ULL, 0x0000000605040300ULL, 0x0000000605040301ULL, 0x0000060504030100ULL,
+  0x0000000605040302ULL, 0x0000060504030200ULL, 0x0000060504030201ULL, 0x0006050403020100ULL,
+  0x0000000000000007ULL, 0x0000000000000700ULL, 0x0000000000000701ULL, 0x0000000000070100ULL,
+  0x0000000000000702ULL, 0x0000000000070200ULL, 0x0000000000070201ULL, 0x0000000007020100ULL,
+  0x0000000000000703ULL, 0x0000000000070300ULL, 0x0000000000070301ULL, 0x0000000007030100ULL,
+  0x0000000000070302ULL, 0x0000000007030200ULL, 0x0000000007030201ULL, 0x0000000703020100ULL,
+  0x0000000000000704ULL, 0x0000000000070400ULL, 0x0000000000070401ULL, 0x0000000007040100ULL,
+  0x0000000000070402ULL, 0x0000000007040200ULL, 0x0000000007040201ULL, 0x0000000704020100ULL,
+  0x0000000000070403ULL, 0x0000000007040300ULL, 0x0000000007040301ULL, 0x0000000704030100ULL,
+  0x0000000007040302ULL, 0x0000000704030200ULL, 0x0000000704030201ULL, 0x0000070403020100ULL,
+  0x0000000000000705ULL, 0x0000000000070500ULL, 0x0000000000070501ULL, 0x0000000007050100ULL,
+  0x0000000000070502ULL, 0x0000000007050200ULL, 0x0000000007050201ULL, 0x0000000705020100ULL,
+  0x0000000000070503ULL, 0x0000000007050300ULL, 0x0000000007050301ULL, 0x0000000705030100ULL,
+  0x0000000007050302ULL, 0x0000000705030200ULL, 0x0000000705030201ULL, 0x0000070503020100ULL,
+  0x0000000000070504ULL, 0x0000000007050400ULL, 0x0000000007050401ULL, 0x0000000705040100ULL,
+  0x0000000007050402ULL, 0x0000000705040200ULL, 0x0000000705040201ULL, 0x0000070504020100ULL,
+  0x0000000007050403ULL, 0x0000000705040300ULL, 0x0000000705040301ULL, 0x0000070504030100ULL,
+  0x0000000705040302ULL, 0x0000070504030200ULL, 0x0000070504030201ULL, 0x0007050403020100ULL,
+  0x0000000000000706ULL, 0x0000000000070600ULL, 0x0000000000070601ULL, 0x0000000007060100ULL,
+  0x0000000000070602ULL, 0x0000000007060200ULL, 0x0000000007060201ULL, 0x0000000706020100ULL,
+  0x0000000000070603ULL, 0x0000000007060300ULL, 0x0000000007060301ULL, 0x0000000706030100ULL,
+  0x0000000007060302ULL, 0x0000000706030200ULL, 0x0000000706030201ULL, 0x0000070603020100ULL,
+  0x0000000000070604ULL, 0x0000000007060400ULL, 0x0000000007060401ULL, 0x0000000706040100ULL,
+  0x0000000007060402ULL, 0x0000000706040200ULL, 0x0000000706040201ULL, 0x0000070604020100ULL,
+  0x0000000007060403ULL, 0x0000000706040300ULL, 0x0000000706040301ULL, 0x0000070604030100ULL,
+  0x0000000706040302ULL, 0x0000070604030200ULL, 0x0000070604030201ULL, 0x0007060403020100ULL,
+  0x0000000000070605ULL, 0x0000000007060500ULL, 0x0000000007060501ULL, 0x0000000706050100ULL,
+  0x0000000007060502ULL, 0x0000000706050200ULL, 0x0000000706050201ULL, 0x0000070605020100ULL,
+  0x0000000007060503ULL, 0x0000000706050300ULL, 0x0000000706050301ULL, 0x0000070605030100ULL,
+  0x0000000706050302ULL, 0x0000070605030200ULL, 0x0000070605030201ULL, 0x0007060503020100ULL,
+  0x0000000007060504ULL, 0x0000000706050400ULL, 0x0000000706050401ULL, 0x0000070605040100ULL,
+  0x0000000706050402ULL, 0x0000070605040200ULL, 0x0000070605040201ULL, 0x0007060504020100ULL,
+  0x0000000706050403ULL, 0x0000070605040300ULL, 0x0000070605040301ULL, 0x0007060504030100ULL,
+  0x0000070605040302ULL, 0x0007060504030200ULL, 0x0007060504030201ULL, 0x0706050403020100ULL
+};
+
+static const byte UCNL_NMEA_Byte_Num[256] = {
+  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+  1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+  1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+  1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+  3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+  4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8
+};
+
+#endif
+
+// Adds parameter separators of a span to the field index, "sepMask" is the span mask of a span kernel
+static void UCNL_NMEA_Fields_Append_Commas(UCNL_NMEA_Fields_Struct* fields, const uint32_t* sepMask, byte offset, byte size)
+{
+  int w_idx;
+  uint32_t w;
+  byte num = fields->num, base;
+#ifdef UCNL_NMEA_POS_TABLE
+  uint64_t pos;
+  byte m;
+  int k;
+#endif
+
+  for (w_idx = 0; (w_idx << 5) < size; w_idx++)
+  {
+    w = sepMask[w_idx];
+    base = offset + (w_idx << 5);
+
+#ifdef UCNL_NMEA_POS_TABLE
+    // no branch per field: positions of the bytes past the span are written to the free part of the index, but not counted
+    for (k = 0; k < 4; k++, base += 8, w >>= 8)
+    {
+      m = (byte)w;
+      if (num > UCNL_NMEA_MAX_FIELDS - 8)
+      {
+        for (; (m != 0) && (num < UCNL_NMEA_MAX_FIELDS); m &= m - 1)
+          fields->sepIdx[num++] = base + __builtin_ctz(m);
+        continue;
+      }
+
+      pos = UCNL_NMEA_Byte_Pos[m] + 0x0101010101010101ULL * base;
+      memcpy(fields->sepIdx + num, &pos, sizeof(pos));
+      num += UCNL_NMEA_Byte_Num[m];
+    }
+#else
+    for (; (w != 0) && (num < UCNL_NMEA_MAX_FIELDS); w &= w - 1)
+      fields->sepIdx[num++] = base + __builtin_ctzl(w);
+#endif
+  }
+
+  fields->num = num;
+}
+
+/* Builds the field index of a sentence, the same one the parser state gets while framing
+   "fields" field index to build
+   "buffer" sentence
+   "size" sentence size, bytes
+*/
+void UCNL_NMEA_Fields_Build(UCNL_NMEA_Fields_Struct* fields, const byte* buffer, byte size)
+{
+  uint32_t sepMask[UCNL_NMEA_SEP_MASK_SIZE];
+
+  fields->num = 0;
+  fields->isDone = false;
+
+  // the field #0 (talker & sentence ID) starts right after the start symbol
+  if (size > 2)
+  {
+    UCNL_NMEA_Scan_Impl(buffer + 2, size - 2, sepMask);
+    UCNL_NMEA_Fields_Append(fields, buffer, sepMask, 2, size - 2);
+  }
+
+  if (!fields->isDone)
+  {
+    UCNL_NMEA_Fields_Add(fields, size);
+    fields->isDone = true;
+  }
+}
+
+/* Gets bounds of a field by its number
+   "fields" field index of the sentence
+   "n" field number, should be less than fields->num
+   "stIdx", "ndIdx" the first and the last symbol of the field, ndIdx < stIdx for an empty field
+*/
+void UCNL_NMEA_Get_Field(const UCNL_NMEA_Fields_Struct* fields, byte n, byte* stIdx, byte* ndIdx)
+{
+  *stIdx = (n == 0) ? 1 : fields->sepIdx[n - 1] + 1;
+  *ndIdx = fields->sepIdx[n] - 1;
+}
+
+// A checksum tail "*hh<CR><LF>" at once, the same state Process_Byte gets after these bytes
+// returns number of bytes taken: 5 for a ready sentence, 3 for a checksum error, 0 if the tail
+// is cut by the chunk end, has no CR or does not fit the buffer, it goes per byte then
+static byte UCNL_NMEA_Process_Tail(UCNL_NMEA_State_Struct* uState, const byte* data, size_t size)
+{
+  if ((size < 5) || ((int)uState->idx + 5 > (int)uState->buffer_size) ||
+      (data[3] != UCNL_NMEA_SNT_END1) || (data[4] != UCNL_NMEA_SNT_END) ||
+      UCNL_NMEA_IS_FRAMING(data[1]) || UCNL_NMEA_IS_FRAMING(data[2]))
+    return 0;
+
+  memcpy(uState->buffer + uState->idx, data, 5);
+
+  uState->chk_present = true;
+  if (!uState->fields.isDone)
+  {
+    UCNL_NMEA_Fields_Add(&uState->fields, uState->idx);
+    uState->fields.isDone = true;
+  }
+
+  uState->chk_dcl = 16 * UCNL_STR_HEXDIGIT2B(data[1]);
+  uState->chk_dcl += UCNL_STR_HEXDIGIT2B(data[2]);
+  uState->chk_dcl_idx = 3;
+
+  if (uState->chk_act != uState->chk_dcl)
+  {
+    uState->isStarted = false;
+    uState->idx += 3;
+    return 3;
+  }
+
+  uState->isStarted = false;
+  uState->isReady = true;
+  uState->idx += 5;
+  return 5;
+}
+
+/* A sentence from its start symbol: the header and the body go in one span pass, the checksum tail at once
+   returns number of bytes taken, the state is the same Process_Byte gets after these bytes. A header cut by
+   the chunk end or having delimiters takes only the start symbol, the rest goes per byte then
+*/
+static size_t UCNL_NMEA_Process_Sentence(UCNL_NMEA_State_Struct* uState, const byte* data, size_t size)
+{
+  uint32_t sepMask[UCNL_NMEA_SEP_MASK_SIZE];
+  size_t n;
+
+  UCNL_NMEA_Start(uState);
+  if ((size < 6) || (uState->buffer_size < 6))
+    return 1;
+
+  n = uState->buffer_size - 1;
+  if (n > size - 1)
+    n = size - 1;
+
+  n = UCNL_NMEA_Span_Impl(data + 1, n, size - 1, uState->buffer + 1, &uState->chk_act, sepMask);
+
+  // the sentence ID may not have separators, a CR stops the span
+  if ((n < 5) || ((sepMask[0] & 0x1F) != 0))
+  {
+    UCNL_NMEA_Start(uState);
+    return 1;
+  }
+
+  if (data[1] == UCNL_NMEA_PSENTENCE_SYMBOL)
+  {
+    uState->isPSentence = true;
+    uState->sntID = (((long)data[2]) << 24) | (((long)data[3]) << 16) | (((long)data[4]) << 8) | data[5];
+  }
+  else
+  {
+    uState->tkrID = (((int)data[1]) << 8) | data[2];
+    uState->sntID = (((long)data[3]) << 16) | (((long)data[4]) << 8) | data[5];
+  }
+
+  // bytes of a skipped sentence are ignored up to the next start symbol, so the span is just passed
+  if (!UCNL_NMEA_Is_SntID_Accepted(uState))
+  {
+    uState->isStarted = false;
+    return n + 1;
+  }
+
+  UCNL_NMEA_Fields_Append_Commas(&uState->fields, sepMask, 1, (byte)n);
+  uState->idx = n + 1;
+  n++;
+
+  if ((n < size) && (data[n] == UCNL_NMEA_CHK_SEP))
+    n += UCNL_NMEA_Process_Tail(uState, data + n, size - n);
+
+  return n;
+}
+
+// Hands a ready sentence to its handler or to the callback and releases it
+static void UCNL_NMEA_Deliver(UCNL_NMEA_State_Struct* uState, UCNL_NMEA_Sentence_Callback callback, void* param)
+{
+  if (!UCNL_NMEA_Dispatch(uState) && (callback != NULL))
+    callback(uState, param);
+  UCNL_NMEA_Release(uState);
+}
+
+/* Processes a whole chunk of incoming data, e.g. a result of a single read() call
+   Gives the same results as feeding the chunk to UCNL_NMEA_Process_Byte byte by byte, but
+   skips the garbage between sentences with memchr, takes a sentence from its start symbol up to
+   the checksum in one pass of a span kernel, which also gives the checksum and the field index,
+   and the checksum tail at once. Sentence IDs are looked up in the table if the state has one,
+   see UCNL_NMEA_Set_SntIDs_Table, a list is searched through. Only headers and tails cut by the
+   chunk end, sentences without a checksum and overflows are processed per byte
+   "uState" parser state
+   "data" data chunk
+   "size" data chunk size, bytes
+   "callback" is called for every complete sentence that has no handler in the sentence IDs table,
+   the sentence is released after the call
+   "param" user parameter passed to the callback
+   returns number of complete sentences found
+*/
+size_t UCNL_NMEA_Process_Buffer(UCNL_NMEA_State_Struct* uState, const byte* data, size_t size,
+                                UCNL_NMEA_Sentence_Callback callback, void* param)
+{
+  size_t i = 0, n, sntNum = 0;
+  const byte* src;
+  uint32_t sepMask[UCNL_NMEA_SEP_MASK_SIZE];
+
+  while (i < size)
+  {
+    if (!uState->isStarted)
+    {
+      // outside of a sentence only a start symbol matters, it mostly follows the previous sentence
+      if (data[i] != UCNL_NMEA_SNT_STR)
+      {
+        src = (const byte*)memchr(data + i, UCNL_NMEA_SNT_STR, size - i);
+        if (src == NULL)
+          break;
+
+        i = src - data;
+      }
+
+      if (!uState->isReady)
+      {
+        i += UCNL_NMEA_Process_Sentence(uState, data + i, size - i);
+        if (uState->isReady)
+        {
+          sntNum++;
+          UCNL_NMEA_Deliver(uState, callback, param);
+        }
+        continue;
+      }
+    }
+    else if ((uState->chk_dcl_idx == 0) && (uState->idx > 5))
+    {
+      // sentence body after the ID: everything up to a delimiter is just stored and XORed
+      n = uState->buffer_size - uState->idx;
+      if (n > size - i)
+        n = size - i;
+
+      // the same pass copies the span, takes its checksum and separators, they go to the field index
+      n = UCNL_NMEA_Span_Impl(data + i, n, size - i, uState->buffer + uState->idx, &uState->chk_act, sepMask);
+      if (n > 0)
+      {
+        if (!uState->fields.isDone)
+          UCNL_NMEA_Fields_Append_Commas(&uState->fields, sepMask, uState->idx, (byte)n);
+
+        uState->idx += n;
+        i += n;
+        continue;
+      }
+
+      // a sentence cut short by the next one
+      if (data[i] == UCNL_NMEA_SNT_STR)
+      {
+        i += UCNL_NMEA_Process_Sentence(uState, data + i, size - i);
+        if (uState->isReady)
+        {
+          sntNum++;
+          UCNL_NMEA_Deliver(uState, callback, param);
+        }
+        continue;
+      }
+
+      if ((data[i] == UCNL_NMEA_CHK_SEP) && ((n = UCNL_NMEA_Process_Tail(uState, data + i, size - i)) != 0))
+      {
+        i += n;
+        if (uState->isReady)
+        {
+          sntNum++;
+          UCNL_NMEA_Deliver(uState, callback, param);
+        }
+        continue;
+      }
+    }
+
+    // the rest goes per byte
+    if (UCNL_NMEA_Process_Byte(uState, data[i++]) == UCNL_NMEA_RESULT_PACKET_READY)
+    {
+      sntNum++;
+      UCNL_NMEA_Deliver(uState, callback, param);
+    }
+  }
+
+  return sntNum;
+}
+
+bool UCNL_NMEA_Get_NextParam(const byte* buffer, byte fromIdx, byte size, byte* stIdx, byte* ndIdx)
+{
+  byte i = fromIdx + 1;
+  *stIdx = fromIdx;
+  *ndIdx = *stIdx;
+
+  while ((i <= size) && (*ndIdx == *stIdx))
+  {
+    if ((buffer[i] == UCNL_NMEA_PAR_SEP) ||
+        (buffer[i] == UCNL_NMEA_CHK_SEP) ||
+        (buffer[i] == UCNL_NMEA_SNT_END1) ||
+        (i == size))
+    {
+      *ndIdx = i;
+    }
+    else
+    {
+      i++;
+    }
+  }
+  (*stIdx)++;
+  (*ndIdx)--;
+
+  return ((buffer[i] != UCNL_NMEA_CHK_SEP) && (i != size) && (buffer[i] != UCNL_NMEA_SNT_END1));
+}
+
+/* The same as UCNL_NMEA_Get_NextParam, but jumps to the next field separator by the
+   mask built with UCNL_NMEA_Scan(buffer, size, sepMask) instead of walking the bytes
+*/
+bool UCNL_NMEA_Get_NextParam_Masked(const byte* buffer, const uint32_t* sepMask, byte fromIdx, byte size, byte* stIdx, byte* ndIdx)
+{
+  byte i = fromIdx + 1;
+  int b = i;
+  uint32_t w;
+
+  *stIdx = fromIdx;
+  *ndIdx = *stIdx;
+
+  if (i <= size)
+  {
+    w = sepMask[b >> 5] & (((uint32_t)0xFFFFFFFF) << (b & 31));
+    while ((w == 0) && (((b | 31) + 1) <= size))
+    {
+      b = (b | 31) + 1;
+      w = sepMask[b >> 5];
+    }
+
+    if (w != 0)
+      b = (b & ~31) + __builtin_ctzl((unsigned long)w);
+
+    i = ((w == 0) || (b > size)) ? size : (byte)b;
+    *ndIdx = i;
+  }
+
+  (*stIdx)++;
+  (*ndIdx)--;
+
+  return ((buffer[i] != UCNL_NMEA_CHK_SEP) && (i != size) && (buffer[i] != UCNL_NMEA_SNT_END1));
+}
+
+void UCNL_NMEA_CheckSum_Update(byte* buffer, byte size)
+{
+  byte i = 0, n, acc = 0;
+
+  while (i < size)
+  {
+    n = UCNL_NMEA_Find_Impl(buffer + i, size - i, UCNL_NMEA_SNT_STR, UCNL_NMEA_CHK_SEP, UCNL_NMEA_CHK_SEP);
+    acc ^= UCNL_NMEA_Scan_Impl(buffer + i, n, NULL);
+    i += n;
+
+    if (i < size)
+    {
+      if (buffer[i] == UCNL_NMEA_SNT_STR)
+        acc = 0;
+      else
+      {
+        buffer[i + 1] = UCNL_STR_DIGIT_2HEX(acc / 16);
+        buffer[i + 2] = UCNL_STR_DIGIT_2HEX(acc % 16);
+      }
+      i++;
+    }
+  }
+}
+
+// Sentence writer
+// Starts a sentence in "buffer" of "size" bytes, the buffer is not cleared
+void UCNL_NMEA_Writer_Init(UCNL_NMEA_Writer_Struct* writer, byte* buffer, byte size)
+{
+  writer->buffer = buffer;
+  writer->limit = (size > UCNL_NMEA_WRITER_TAIL_SIZE) ? size - UCNL_NMEA_WRITER_TAIL_SIZE : 0;
+  writer->idx = 0;
+  writer->chk = 0;
+  writer->isOverflow = (writer->limit == 0);
+
+  // the start symbol is not a part of the checksum
+  if (!writer->isOverflow)
+    buffer[writer->idx++] = UCNL_NMEA_SNT_STR;
+}
+
+void UCNL_NMEA_Writer_Byte(UCNL_NMEA_Writer_Struct* writer, byte c)
+{
+  if (writer->idx < writer->limit)
+  {
+    writer->buffer[writer->idx++] = c;
+    writer->chk ^= c;
+  }
+  else
+    writer->isOverflow = true;
+}
+
+void UCNL_NMEA_Writer_Bytes(UCNL_NMEA_Writer_Struct* writer, const byte* src, byte srcSize)
+{
+  byte i;
+
+  if (srcSize > writer->limit - writer->idx)
+  {
+    writer->isOverflow = true;
+    srcSize = writer->limit - writer->idx;
+  }
+
+  for (i = 0; i < srcSize; i++)
+  {
+    writer->buffer[writer->idx++] = src[i];
+    writer->chk ^= src[i];
+  }
+}
+
+void UCNL_NMEA_Writer_Str(UCNL_NMEA_Writer_Struct* writer, const char* src)
+{
+  while (*src != '\0')
+    UCNL_NMEA_Writer_Byte(writer, (byte)*src++);
+}
+
+void UCNL_NMEA_Writer_IntDec(UCNL_NMEA_Writer_Struct* writer, long src, byte zPad)
+{
+  byte num[UCNL_NMEA_WRITER_NUM_SIZE], n = 0;
+
+  UCNL_STR_WriteIntDec(num, &n, src, (zPad > 10) ? 10 : zPad);
+  UCNL_NMEA_Writer_Bytes(writer, num, n);
+}
+
+void UCNL_NMEA_Writer_Float(UCNL_NMEA_Writer_Struct* writer, float f, byte dPlaces, byte zPad)
+{
+  byte num[UCNL_NMEA_WRITER_NUM_SIZE], n = 0;
+
+  UCNL_STR_WriteFloat(num, &n, f, (dPlaces > 9) ? 9 : dPlaces, (zPad > 10) ? 10 : zPad);
+  UCNL_NMEA_Writer_Bytes(writer, num, n);
+}
+
+// "0x" prefixed hex string, encoded in place and added to the checksum in one scan
+void UCNL_NMEA_Writer_HexArray(UCNL_NMEA_Writer_Struct* writer, const byte* src, byte srcSize)
+{
+  byte* dst;
+
+  if (2 + 2 * (int)srcSize > writer->limit - writer->idx)
+  {
+    writer->isOverflow = true;
+    return;
+  }
+
+  dst = &writer->buffer[writer->idx];
+  dst[0] = '0';
+  dst[1] = 'x';
+  UCNL_STR_EncodeHex(dst + 2, src, srcSize);
+
+  writer->chk ^= UCNL_NMEA_Scan_Impl(dst, 2 + 2 * srcSize, NULL);
+  writer->idx += 2 + 2 * srcSize;
+}
+
+/* Appends the checksum and the sentence end
+   "size" takes the sentence size, 0 if it did not fit into the buffer
+   returns false if the sentence did not fit
+*/
+bool UCNL_NMEA_Writer_Finish(UCNL_NMEA_Writer_Struct* writer, byte* size)
+{
+  if (writer->isOverflow)
+  {
+    *size = 0;
+    return false;
+  }
+
+  writer->buffer[writer->idx++] = UCNL_NMEA_CHK_SEP;
+  writer->buffer[writer->idx++] = UCNL_STR_DIGIT_2HEX(writer->chk / 16);
+  writer->buffer[writer->idx++] = UCNL_STR_DIGIT_2HEX(writer->chk % 16);
+  writer->buffer[writer->idx++] = UCNL_NMEA_SNT_END1;
+  writer->buffer[writer->idx++] = UCNL_NMEA_SNT_END;
+
+  *size = writer->idx;
+  return true;
+}
+
+/* Copies a compile-time sentence, see UCNL_NMEA_Const_Sentence and UCNL_NMEA_WRITE_CONST
+   "size" takes the sentence size, 0 if it did not fit into the buffer
+*/
+bool UCNL_NMEA_Write_Const(byte* buffer, byte bufferSize, byte* size, const char* sentence, byte sentenceSize)
+{
+  if (sentenceSize > bufferSize)
+  {
+    *size = 0;
+    return false;
+  }
+
+  memcpy(buffer, sentence, sentenceSize);
+  *size = sentenceSize;
+  return true;
+}
+
+bool UCNL_NMEA_Parse_RMC_Fields(UCNL_NMEA_RMC_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // Sentence example:
+  // $GPRMC,230540.00,A,5312.1329616,N,15942.6950884,E,4.9,217.1,290421,999.9,E,D*3C
+
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1: // Time
+        if (ndIdx < stIdx)
+          result = false;
+        else
+        {
+          rdata->hour = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
+          rdata->minute = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
+          rdata->second = UCNL_STR_ParseFloat(buffer, stIdx + 4, ndIdx);
+
+          if (!UCNL_NMEA_IS_VALID_HOUR(rdata->hour) ||
+              !UCNL_NMEA_IS_VALID_MINSEC(rdata->minute) ||
+              !UCNL_NMEA_IS_VALID_MINSEC(rdata->second))
+            result = false;
+        }
+        break;
+      case 2: // Time validity flag
+        if ((ndIdx < stIdx) || (buffer[stIdx] != UCNL_NMEA_TD_VALID))
+          result = false;
+        break;
+      case 3: // Latitude
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->latitude_deg = (double)UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]) +
+                                UCNL_STR_ParseDouble(buffer, stIdx + 2, ndIdx) / 60.0;
+
+        if (!UCNL_NMEA_IS_VALID_LATDEG(rdata->latitude_deg))
+          result = false;
+        break;
+      case 4: // Latitude hemisphere
+        if (ndIdx < stIdx)
+          result = false;
+        else if (buffer[stIdx] == UCNL_NMEA_SOUTH_SIGN)
+          rdata->latitude_deg = -rdata->latitude_deg;
+        break;
+      case 5: // Longitude
+        if (ndIdx <= stIdx)
+          result = false;
+        else
+          rdata->longitude_deg = (double)UCNL_STR_CCC2B(buffer[stIdx], buffer[stIdx + 1], buffer[stIdx + 2]) +
+                                 UCNL_STR_ParseDouble(buffer, stIdx + 3, ndIdx) / 60.0;
+
+        if (!UCNL_NMEA_IS_VALID_LONDEG(rdata->longitude_deg))
+          result = false;
+
+        break;
+      case 6: // Longitude hemisphere
+        if (ndIdx < stIdx)
+          result = false;
+        else if (buffer[stIdx] == UCNL_NMEA_WEST_SIGN)
+          rdata->longitude_deg = -rdata->longitude_deg;
+        break;
+      case 7: // Speed in knots
+        if (ndIdx >= stIdx)
+          rdata->speed_kmh = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx) * 1.852; //
+        break;
+      case 8: // Course in degrees
+        if (ndIdx >= stIdx)
+          rdata->course_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 9: // Date
+        if (ndIdx < stIdx)
+          result = false;
+        else
+        {
+          rdata->date = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
+          rdata->month = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
+          rdata->year = UCNL_STR_CC2B(buffer[stIdx + 4], buffer[stIdx + 5]);
+          if (!UCNL_NMEA_IS_VALID_DATE(rdata->date) ||
+              !UCNL_NMEA_IS_VALID_MONTH(rdata->month) ||
+              !UCNL_NMEA_IS_VALID_YEAR(rdata->year))
+            result = false;
+        }
+        break;
+      case 12: // Data validity flag
+        if ((ndIdx < stIdx) || (buffer[stIdx] == UCNL_NMEA_DATA_NOT_VALID))
+          result = false;
+        break;
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_RMC(UCNL_NMEA_RMC_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_RMC_Fields(rdata, buffer, &fields);
+}
+
+bool UCNL_NMEA_Parse_GGA_Fields(UCNL_NMEA_GGA_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $GNGGA,054157.013,2307.1261,N,12016.4308, E,1, 6,1.93,34.9,    M,17.8,M,,*76
+  // $GPGGA,025346.726,5311.9987,N,15942.6717, E,1,04,    ,-11.4228,M,    ,M,,*49
+  // $GPGGA,123143.00,4831.45878,N,04430.24139,E,1,05,3.68,19.0,    M,1.8, M,,*55
+
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1: // Time
+        if (ndIdx < stIdx)
+          result = false;
+        else
+        {
+          rdata->hour = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
+          rdata->minute = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
+          rdata->second = UCNL_STR_ParseFloat(buffer, stIdx + 4, ndIdx);
+
+          if (!UCNL_NMEA_IS_VALID_HOUR(rdata->hour) ||
+              !UCNL_NMEA_IS_VALID_MINSEC(rdata->minute) ||
+              !UCNL_NMEA_IS_VALID_MINSEC(rdata->second))
+            result = false;
+        }
+        break;
+      case 2: // Latitude
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->latitude_deg = (double)UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]) +
+                                UCNL_STR_ParseDouble(buffer, stIdx + 2, ndIdx) / 60.0;
+
+        if (!UCNL_NMEA_IS_VALID_LATDEG(rdata->latitude_deg))
+          result = false;
+        break;
+      case 3: // Latitude hemisphere
+        if (ndIdx < stIdx)
+          result = false;
+        else if (buffer[stIdx] == UCNL_NMEA_SOUTH_SIGN)
+          rdata->latitude_deg = -rdata->latitude_deg;
+        break;
+      case 4: // Longitude
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->longitude_deg = (double)UCNL_STR_CCC2B(buffer[stIdx], buffer[stIdx + 1], buffer[stIdx + 2]) +
+                                 UCNL_STR_ParseDouble(buffer, stIdx + 3, ndIdx) / 60.0;
+
+        if (!UCNL_NMEA_IS_VALID_LONDEG(rdata->longitude_deg))
+          result = false;
+        break;
+      case 5: // Longitude hemisphere
+        if (ndIdx < stIdx)
+          result = false;
+        else if (buffer[stIdx] == UCNL_NMEA_WEST_SIGN)
+          rdata->longitude_deg = -rdata->longitude_deg;
+        break;
+      case 6:
+        // GNSS quality indicator
+        if (ndIdx >= stIdx)
+          rdata->gnss_qly_ind = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 7:
+        // satellites in use
+        if (ndIdx >= stIdx)
+          rdata->sats_in_use = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 8:
+        // HDOP
+        if (ndIdx >= stIdx)
+          rdata->hdop = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 9:
+        // orthometricHeight
+        if (ndIdx >= stIdx)
+          rdata->orth_height = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      //case 10:
+      // orthometricHeight units
+      //     break;
+      case 11:
+        // geoidal separation
+        if (ndIdx >= stIdx)
+          rdata->gsep = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      //case 12:
+      // geoidal separation units
+      //     break;
+      case 13:
+        // dgps_rec_age
+        if (ndIdx >= stIdx)
+          rdata->dgps_rec_age = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 14:
+        // datum id
+        if (ndIdx >= stIdx)
+          rdata->datumID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_GGA(UCNL_NMEA_GGA_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_GGA_Fields(rdata, buffer, &fields);
+}
+
+bool UCNL_NMEA_Parse_GLL_Fields(UCNL_NMEA_GLL_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $GPGLL,4831.45336,N,04430.22910,E,131116.00,A,A*6E
+  // $GNGLL,4831.4600,N,04430.2750,E,125414.000,A,A*4F
+
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1: // Latitude
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->latitude_deg = (double)UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]) +
+                                UCNL_STR_ParseDouble(buffer, stIdx + 2, ndIdx) / 60.0;
+        break;
+      case 2: // Latitude hemisphere
+        if (ndIdx < stIdx)
+          result = false;
+        else if (buffer[stIdx] == UCNL_NMEA_SOUTH_SIGN)
+          rdata->latitude_deg = -rdata->latitude_deg;
+        break;
+      case 3: // Longitude
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->longitude_deg = (double)UCNL_STR_CCC2B(buffer[stIdx], buffer[stIdx + 1], buffer[stIdx + 2]) +
+                                 UCNL_STR_ParseDouble(buffer, stIdx + 3, ndIdx) / 60.0;
+        break;
+      case 4: // Longitude hemisphere
+        if (ndIdx < stIdx)
+          result = false;
+        else if (buffer[stIdx] == UCNL_NMEA_WEST_SIGN)
+          rdata->longitude_deg = -rdata->longitude_deg;
+        break;
+      case 5: // Time
+        if (ndIdx < stIdx)
+          result = false;
+        else
+        {
+          rdata->hour = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
+          rdata->minute = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
+          rdata->second = UCNL_STR_ParseFloat(buffer, stIdx + 4, ndIdx);
+
+          if (!UCNL_NMEA_IS_VALID_HOUR(rdata->hour) ||
+              !UCNL_NMEA_IS_VALID_MINSEC(rdata->minute) ||
+              !UCNL_NMEA_IS_VALID_MINSEC(rdata->second))
+            result = false;
+        }
+        break;
+      case 6:
+        if ((ndIdx < stIdx) || (buffer[stIdx] == UCNL_NMEA_DATA_NOT_VALID))
+          result = false;
+        break;
+      case 7:
+        if ((ndIdx < stIdx) || (buffer[stIdx] == UCNL_NMEA_PMODE_DATA_NOT_VALID))
+          result = false;
+        break;
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_GLL(UCNL_NMEA_GLL_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_GLL_Fields(rdata, buffer, &fields);
+}
+
+bool UCNL_NMEA_Parse_VTG_Fields(UCNL_NMEA_VTG_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $GPVTG,,T,,M,0.338,N,0.627,K,A*28
+  // $GPVTG,59.58,T,,M,1.43,N,2.65,K,A*0B
+
+
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1: // trackTrue
+        if (ndIdx >= stIdx)
+          rdata->track_true_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        else
+          result = false;
+        break;
+      case 3: // trackMagnetic
+        if (ndIdx >= stIdx)
+        {
+          rdata->is_magnetic = true;
+          rdata->track_magnetic_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+      case 5: // speedKnots
+        if (ndIdx >= stIdx)
+          rdata->speed_knots = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 7: // speedKmh
+        if (ndIdx >= stIdx)
+          rdata->speed_kmh = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 8:
+        if ((ndIdx < stIdx) || (buffer[stIdx] == UCNL_NMEA_DATA_NOT_VALID))
+          result = false;
+        break;
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_VTG(UCNL_NMEA_VTG_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_VTG_Fields(rdata, buffer, &fields);
+}
+
+bool UCNL_NMEA_Parse_HDT_Fields(UCNL_NMEA_HDT_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  // $GPHDT,253.423,T*34
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx >= stIdx)
+          rdata->track_true_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        else
+          result = false;
+        break;
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_HDT(UCNL_NMEA_HDT_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_HDT_Fields(rdata, buffer, &fields);
+}
+
+bool UCNL_NMEA_Parse_HDG_Fields(UCNL_NMEA_HDG_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  // $GPHDG,253.423,,,*34
+
+  float magnetic_heading_deg;
+  bool is_magnetic_variation;
+  float magnetic_variation;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx >= stIdx)
+          rdata->magnetic_heading_deg = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        else
+          result = false;
+        break;
+      case 3:
+        if (ndIdx >= stIdx)
+        {
+          rdata->is_magnetic_variation = true;
+          rdata->magnetic_variation = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        else
+          rdata->is_magnetic_variation = false;
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_HDG(UCNL_NMEA_HDG_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_HDG_Fields(rdata, buffer, &fields);
+}
+
+bool UCNL_NMEA_Parse_MTW_Fields(UCNL_NMEA_MTW_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  // $GPMTW,253.423,C*34
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx >= stIdx)
+          rdata->mean_water_temperature_c = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        else
+          result = false;
+        break;
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_MTW(UCNL_NMEA_MTW_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_MTW_Fields(rdata, buffer, &fields);
+}
+
+bool UCNL_NMEA_Parse_GSA_Fields(UCNL_NMEA_GSA_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $GPGSA,A,3,18,26,23,16,27,10,,,,,,,3.51,1.83,2.99*02
+
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1: // Mode
+        if (ndIdx >= stIdx)
+          rdata->mode = buffer[stIdx];
+        break;
+      case 2: // fixType
+        if (ndIdx >= stIdx)
+          rdata->fix_type = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 3: // PRNs
+      case 4:
+      case 5:
+      case 6:
+      case 7:
+      case 8:
+      case 9:
+      case 10:
+      case 11:
+      case 12:
+      case 13:
+      case 14:
+        if (ndIdx >= stIdx)
+          rdata->prns[pIdx - 3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        else
+          rdata->prns[pIdx - 3] = 0;
+        break;
+      case 15: // PDOP
+        if (ndIdx >= stIdx)
+          rdata->pdop = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 16:
+        if (ndIdx >= stIdx)
+          rdata->hdop = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 17:
+        if (ndIdx >= stIdx)
+          rdata->vdop = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 18:
+        rdata->systemID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_GSA(UCNL_NMEA_GSA_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_GSA_Fields(rdata, buffer, &fields);
+}
+
+bool UCNL_NMEA_Parse_GSV_Fields(UCNL_NMEA_GSV_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $GPGSV,3,1,12,08,15,313,15,10,56,213,35,13,14,037,14,15,31,064,20*75
+  // $GPGSV,3,2,12,16,35,250,31,18,56,078,21,20,03,055,,23,81,113,18*7A
+  // $GPGSV,3,3,12,26,19,225,26,27,47,303,18,29,10,140,08,32,00,176,*7E
+
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  rdata->satDataNum = 0;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx >= stIdx)
+          rdata->total_messages = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        else
+          result = false;
+        break;
+
+      case 2:
+        if (ndIdx >= stIdx)
+          rdata->current_message = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        else
+          result = false;
+        break;
+
+      case 3:
+        if (ndIdx >= stIdx)
+          rdata->sats_in_view = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        else
+          result = false;
+        break;
+
+// Sat 1 section
+      case 4:
+        if (ndIdx >= stIdx)
+          rdata->PRNNumbers[0] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 5:
+        if (ndIdx >= stIdx)
+          rdata->Elevations[0] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 6:
+        if (ndIdx >= stIdx)
+          rdata->Azimuths[0] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 7:
+        if (ndIdx >= stIdx)
+        {
+          rdata->SNRs[0] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+          rdata->satDataNum = 1;
+        }
+        break;
+        
+// Sat 2 section
+      case 8:
+        if (ndIdx >= stIdx)
+          rdata->PRNNumbers[1] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 9:
+        if (ndIdx >= stIdx)
+          rdata->Elevations[1] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 10:
+        if (ndIdx >= stIdx)
+          rdata->Azimuths[1] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 11:
+        if (ndIdx >= stIdx)
+        {
+          rdata->SNRs[1] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+          rdata->satDataNum = 2;
+        }
+
+// Sat 3 section
+      case 12:
+        if (ndIdx >= stIdx)
+          rdata->PRNNumbers[2] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 13:
+        if (ndIdx >= stIdx)
+          rdata->Elevations[2] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 14:
+        if (ndIdx >= stIdx)
+          rdata->Azimuths[2] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 15:
+        if (ndIdx >= stIdx)
+        {
+          rdata->SNRs[2] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+          rdata->satDataNum = 3;
+        }
+
+// Sat 4 section
+      case 16:
+        if (ndIdx >= stIdx)
+          rdata->PRNNumbers[3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 17:
+        if (ndIdx >= stIdx)
+          rdata->Elevations[3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 18:
+        if (ndIdx >= stIdx)
+          rdata->Azimuths[3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 19:
+        if (ndIdx >= stIdx)
+        {
+          rdata->SNRs[3] = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+          rdata->satDataNum = 4;
+        }
+
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_GSV(UCNL_NMEA_GSV_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_GSV_Fields(rdata, buffer, &fields);
+}
+
+bool UCNL_NMEA_Parse_ZDA_Fields(UCNL_NMEA_ZDA_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  bool result = true;
+  byte pIdx = 0, ndIdx = 0, stIdx = 0;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+        {
+          rdata->hour = UCNL_STR_CC2B(buffer[stIdx], buffer[stIdx + 1]);
+          rdata->minute = UCNL_STR_CC2B(buffer[stIdx + 2], buffer[stIdx + 3]);
+          rdata->second = UCNL_STR_ParseFloat(buffer, stIdx + 4, ndIdx);
+
+          if (!UCNL_NMEA_IS_VALID_HOUR(rdata->hour) ||
+              !UCNL_NMEA_IS_VALID_MINSEC(rdata->minute) ||
+              !UCNL_NMEA_IS_VALID_MINSEC(rdata->second))
+            result = false;
+        }
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->day = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 3:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->month = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 4:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->year = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 5:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->t_zone_offset_hours = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 6:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->t_zone_offset_minutes = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      default:
+        break;
+    }
+  }
+
+  rdata->isValid = result;
+  return result;
+}
+
+bool UCNL_NMEA_Parse_ZDA(UCNL_NMEA_ZDA_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return UCNL_NMEA_Parse_ZDA_Fields(rdata, buffer, &fields);
+}
+
+
+// Sentence dispatcher
+static void UCNL_NMEA_Dispatcher_Handler(UCNL_NMEA_State_Struct* uState, void* param)
+{
+  UCNL_NMEA_Binding_Struct* binding = (UCNL_NMEA_Binding_Struct*)param;
+
+  if (binding->parser(binding->rdata, uState->buffer, &uState->fields))
+    binding->callback(uState, binding->rdata, binding->param);
+}
+
+void UCNL_NMEA_Dispatcher_Init(UCNL_NMEA_Dispatcher_Struct* dispatcher)
+{
+  UCNL_NMEA_SntIDs_Init(&dispatcher->table);
+  memset(dispatcher->bindings, 0, sizeof(dispatcher->bindings));
+}
+
+/* Registers a sentence ID with its parser, result structure and callback
+   "dispatcher" sentence dispatcher
+   "sntID" packed sentence ID
+   "parser" parser for the sentence, e.g. UCNL_NMEA_Get_Parser(sntID)
+   "rdata" result structure of the type the parser expects, it is filled before the callback is called
+   "callback" is called for every successfully parsed sentence with this ID
+   "param" user parameter passed to the callback
+   returns false if the parser or the callback is NULL or the sentence IDs table is full
+*/
+bool UCNL_NMEA_Dispatcher_Add(UCNL_NMEA_Dispatcher_Struct* dispatcher, long sntID, UCNL_NMEA_Parser_Func parser,
+                              void* rdata, UCNL_NMEA_Result_Callback callback, void* param)
+{
+  const UCNL_NMEA_SntIDs_Entry_Struct* entry;
+  UCNL_NMEA_Binding_Struct* binding;
+
+  if ((parser == NULL) || (callback == NULL) ||
+      !UCNL_NMEA_SntIDs_Add(&dispatcher->table, sntID, UCNL_NMEA_Dispatcher_Handler, NULL))
+    return false;
+
+  entry = UCNL_NMEA_SntIDs_Find(&dispatcher->table, sntID);
+  binding = &dispatcher->bindings[entry - dispatcher->table.entries];
+
+  binding->parser = parser;
+  binding->rdata = rdata;
+  binding->callback = callback;
+  binding->param = param;
+
+  dispatcher->table.entries[entry - dispatcher->table.entries].param = binding;
+  return true;
+}
+
+#define UCNL_NMEA_PARSER(name, type) \
+static bool UCNL_NMEA_Parser_##name(void* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields) \
+{ \
+  return UCNL_NMEA_Parse_##name##_Fields((type*)rdata, buffer, fields); \
+}
+
+UCNL_NMEA_PARSER(RMC, UCNL_NMEA_RMC_RESULT_Struct)
+UCNL_NMEA_PARSER(GGA, UCNL_NMEA_GGA_RESULT_Struct)
+UCNL_NMEA_PARSER(GLL, UCNL_NMEA_GLL_RESULT_Struct)
+UCNL_NMEA_PARSER(GSA, UCNL_NMEA_GSA_RESULT_Struct)
+UCNL_NMEA_PARSER(GSV, UCNL_NMEA_GSV_RESULT_Struct)
+UCNL_NMEA_PARSER(VTG, UCNL_NMEA_VTG_RESULT_Struct)
+UCNL_NMEA_PARSER(HDT, UCNL_NMEA_HDT_RESULT_Struct)
+UCNL_NMEA_PARSER(HDG, UCNL_NMEA_HDG_RESULT_Struct)
+UCNL_NMEA_PARSER(ZDA, UCNL_NMEA_ZDA_RESULT_Struct)
+UCNL_NMEA_PARSER(MTW, UCNL_NMEA_MTW_RESULT_Struct)
+
+/* Gets the parser of a standard sentence, "rdata" of the parser is the UCNL_NMEA_xxx_RESULT_Struct of the sentence
+   returns NULL for unknown sentence IDs
+*/
+UCNL_NMEA_Parser_Func UCNL_NMEA_Get_Parser(long sntID)
+{
+  switch (sntID)
+  {
+    case UCNL_NMEA_RMC_SNT_ID: return UCNL_NMEA_Parser_RMC;
+    case UCNL_NMEA_GGA_SNT_ID: return UCNL_NMEA_Parser_GGA;
+    case UCNL_NMEA_GLL_SNT_ID: return UCNL_NMEA_Parser_GLL;
+    case UCNL_NMEA_GSA_SNT_ID: return UCNL_NMEA_Parser_GSA;
+    case UCNL_NMEA_GSV_SNT_ID: return UCNL_NMEA_Parser_GSV;
+    case UCNL_NMEA_VTG_SNT_ID: return UCNL_NMEA_Parser_VTG;
+    case UCNL_NMEA_HDT_SNT_ID: return UCNL_NMEA_Parser_HDT;
+    case UCNL_NMEA_HDG_SNT_ID: return UCNL_NMEA_Parser_HDG;
+    case UCNL_NMEA_ZDA_SNT_ID: return UCNL_NMEA_Parser_ZDA;
+    case UCNL_NMEA_MTW_SNT_ID: return UCNL_NMEA_Parser_MTW;
+    default: return NULL;
+  }
+}
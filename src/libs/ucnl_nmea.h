@@ -1,226 +1,395 @@
-/*
-Copyright (C) 2021, Underwater communication & navigation laboratory
-All rights reserved.
-
-www.unavlab.com
-hello@unavlab.com
-
-*/
-
-#ifndef _UCNL_NMEA_
-#define _UCNL_NMEA_
-
-#define UCNL_NMEA_SNT_STR              '$'
-#define UCNL_NMEA_SNT_END              '\n'
-#define UCNL_NMEA_SNT_END1             '\r'
-#define UCNL_NMEA_PAR_SEP              ','
-#define UCNL_NMEA_CHK_SEP              '*'
-
-#define UCNL_NMEA_DATA_NOT_VALID       'V'
-#define UCNL_NMEA_SOUTH_SIGN           'S'
-#define UCNL_NMEA_WEST_SIGN            'W'
-#define UCNL_NMEA_TD_VALID             'A'
-#define UCNL_NMEA_PSENTENCE_SYMBOL     'P'
-#define UCNL_NMEA_PMODE_DATA_NOT_VALID 'N'
-
-#define UCNL_NMEA_MIN_LEN              (8)
-
-#define NMEA_GSA_PRNS_NUM              (12)
-#define NMEA_GSV_SATS_NUM              (4)
-
-typedef struct {
-  byte* buffer;
-  byte  buffer_size;
-  byte  idx;
-  bool  isReady;
-  bool  isStarted;
-  bool  isPSentence;
-  byte  chk_act;
-  byte  chk_dcl;
-  byte  chk_dcl_idx;
-  bool  chk_present;
-  int   tkrID;
-  long  sntID;
-  long* sntIDs;
-  byte  sntIDs_size;
-
-} UCNL_NMEA_State_Struct;
-
-typedef enum {
-  UCNL_NMEA_RESULT_PACKET_READY          = 0,
-  UCNL_NMEA_RESULT_BYPASS_BYTE           = 1,
-  UCNL_NMEA_RESULT_PACKET_STARTED        = 2,
-  UCNL_NMEA_RESULT_PACKET_PROCESS        = 3,
-  UCNL_NMEA_RESULT_PACKET_CHECKSUM_ERROR = 4,
-  UCNL_NMEA_RESULT_PACKET_TOO_BIG        = 5,
-  UCNL_NMEA_RESULT_PACKET_SKIPPING       = 6,
-  UCNL_NMEA_RESULT_UNKNOWN
-} UCNL_NMEA_Result_Enum;
-
-typedef enum {
-  NMEA_GGA_QTY_NO_FIX              = 0,
-  NMEA_GGA_QTY_SINGLE_POINT        = 1,
-  NMEA_GGA_QTY_PRANGE_DIFFERENTIAL = 2,
-  NMEA_GGA_QTY_RTK_FIXED           = 4,
-  NMEA_GGA_QTY_RTK_FLOATING        = 5,
-  NMEA_GGA_QTY_DEAD_RECKONING      = 6,
-  NMEA_GGA_QTY_MANUAL              = 7,
-  NMEA_GGA_QTY_SIMULATOR           = 8,
-  NMEA_GGA_QTY_WAAS_SBAS           = 9,
-  NMEA_GGA_QTY_UNKNOWN
-} NMEA_GGA_QTY_IND_Enum;
-
-typedef enum {
-  NMEA_PSMODE_AUTONOMOUS     = 'A',
-  NMEA_PSMODE_DIFFERENTIAL   = 'D',
-  NMEA_PSMODE_DEAD_RECKONING = 'E',
-  NMEA_PSMODE_MANUAL         = 'M',
-  NMEA_PSMODE_INVALID        = 'N',
-  NMEA_PSMODE_UNKNOWN  
-} NMEA_PSMODE_IND_Enum;
-
-// Standard known sentences result structures
-typedef struct {
-  bool isValid;
-  byte hour;
-  byte minute;
-  float second;
-  byte date;
-  byte month;
-  byte year;
-  float latitude_deg;
-  float longitude_deg;
-  float speed_kmh;
-  float course_deg;
-} UCNL_NMEA_RMC_RESULT_Struct;
-
-typedef struct {
-  bool isValid;
-  byte hour;
-  byte minute;
-  float second;
-  float latitude_deg;
-  float longitude_deg;
-  float hdop;
-  float gsep;
-  float dgps_rec_age;
-  byte sats_in_use;
-  byte gnss_qly_ind;
-  float orth_height;
-  byte datumID;
-} UCNL_NMEA_GGA_RESULT_Struct;
-
-typedef struct {
-  bool isValid;
-  byte hour;
-  byte minute;
-  float second;
-  float latitude_deg;
-  float longitude_deg;
-} UCNL_NMEA_GLL_RESULT_Struct;
-
-typedef struct {
-  bool isValid;
-  byte mode;
-  byte fix_type;
-  byte prns[NMEA_GSA_PRNS_NUM];
-  float pdop;
-  float hdop;
-  float vdop;
-  byte systemID;
-} UCNL_NMEA_GSA_RESULT_Struct;
-
-typedef struct {
-  bool isValid;
-  byte total_messages;
-  byte current_message;
-  byte sats_in_view;
-  
-  int PRNNumbers[NMEA_GSV_SATS_NUM];
-  int Elevations[NMEA_GSV_SATS_NUM];
-  int Azimuths[NMEA_GSV_SATS_NUM];
-  int SNRs[NMEA_GSV_SATS_NUM];
-
-  byte satDataNum;  
-  
-} UCNL_NMEA_GSV_RESULT_Struct;
-
-typedef struct {
-  bool isValid;
-  float track_true_deg;
-  bool is_magnetic;
-  float track_magnetic_deg;
-  float speed_knots;
-  float speed_kmh;
-} UCNL_NMEA_VTG_RESULT_Struct;
-
-typedef struct {
-  bool isValid;
-  float track_true_deg;
-} UCNL_NMEA_HDT_RESULT_Struct;
-
-typedef struct {
-  bool isValid;
-  float magnetic_heading_deg;
-  bool is_magnetic_variation;
-  float magnetic_variation;
-} UCNL_NMEA_HDG_RESULT_Struct;
-
-typedef struct {
-  bool isValid;
-  byte hour;
-  byte minute;
-  float second;
-  byte day; // 01..31
-  byte month;
-  int year; // 4-digit
-  int t_zone_offset_hours; // +/- 13 hours
-  byte t_zone_offset_minutes; // 0..59
-} UCNL_NMEA_ZDA_RESULT_Struct;
-
-typedef struct {
-  bool isValid;
-  float mean_water_temperature_c;
-} UCNL_NMEA_MTW_RESULT_Struct;
-
-
-#define UCNL_NMEA_RMC_SNT_ID (0x524D43)
-#define UCNL_NMEA_GGA_SNT_ID (0x474741)
-#define UCNL_NMEA_GLL_SNT_ID (0x474C4C)
-#define UCNL_NMEA_GSA_SNT_ID (0x475341)
-#define UCNL_NMEA_GSV_SNT_ID (0x475356)
-#define UCNL_NMEA_VTG_SNT_ID (0x565447)
-#define UCNL_NMEA_HDT_SNT_ID (0x484454)
-#define UCNL_NMEA_HDG_SNT_ID (0x484447)
-#define UCNL_NMEA_ZDA_SNT_ID (0x5A4441)
-#define UCNL_NMEA_MTW_SNT_ID (0x4D5457)
-
-#define UCNL_NMEA_IS_VALID_DATE(b)    (((b) >= 1) && ((b) <= 31))
-#define UCNL_NMEA_IS_VALID_MONTH(b)   (((b) >= 1) && ((b) <= 12))
-#define UCNL_NMEA_IS_VALID_YEAR(b)    (((b) >= 0) && ((b) <= 99))
-#define UCNL_NMEA_IS_VALID_HOUR(b)    (((b) >= 0) && ((b) <= 23))
-#define UCNL_NMEA_IS_VALID_MINSEC(b)  (((b) >= 0) && ((b) < 60))
-#define UCNL_NMEA_IS_VALID_LATDEG(l)  (((l) >= -90) && ((l) <= 90))
-#define UCNL_NMEA_IS_VALID_LONDEG(l)  (((l) >= -180) && ((l) <= 180))
-
-
-void UCNL_NMEA_InitStruct(UCNL_NMEA_State_Struct* uState, byte* buffer, byte buffer_size, long* sntIDs, byte sntIDs_size);
-void UCNL_NMEA_Release(UCNL_NMEA_State_Struct* uState);
-
-UCNL_NMEA_Result_Enum UCNL_NMEA_Process_Byte(UCNL_NMEA_State_Struct* uState, byte newByte);
-bool                  UCNL_NMEA_Get_NextParam(const byte* buffer, byte fromIdx, byte size, byte* stIdx, byte* ndIdx);
-void                  UCNL_NMEA_CheckSum_Update(byte* buffer, byte size);
-
-// Standard parsers
-bool                  UCNL_NMEA_Parse_RMC(UCNL_NMEA_RMC_RESULT_Struct* rdata, const byte* buffer, byte idx);
-bool                  UCNL_NMEA_Parse_GGA(UCNL_NMEA_GGA_RESULT_Struct* rdata, const byte* buffer, byte idx);
-bool                  UCNL_NMEA_Parse_GLL(UCNL_NMEA_GLL_RESULT_Struct* rdata, const byte* buffer, byte idx);
-bool                  UCNL_NMEA_Parse_VTG(UCNL_NMEA_VTG_RESULT_Struct* rdata, const byte* buffer, byte idx);
-bool                  UCNL_NMEA_Parse_HDT(UCNL_NMEA_HDT_RESULT_Struct* rdata, const byte* buffer, byte idx);
-bool                  UCNL_NMEA_Parse_HDG(UCNL_NMEA_HDG_RESULT_Struct* rdata, const byte* buffer, byte idx);
-bool                  UCNL_NMEA_Parse_MTW(UCNL_NMEA_MTW_RESULT_Struct* rdata, const byte* buffer, byte idx);
-bool                  UCNL_NMEA_Parse_GSA(UCNL_NMEA_GSA_RESULT_Struct* rdata, const byte* buffer, byte idx);
-bool                  UCNL_NMEA_Parse_GSV(UCNL_NMEA_GSV_RESULT_Struct* rdata, const byte* buffer, byte idx);
-bool                  UCNL_NMEA_Parse_ZDA(UCNL_NMEA_ZDA_RESULT_Struct* rdata, const byte* buffer, byte idx);
-
-#endif
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#ifndef _UCNL_NMEA_
+#define _UCNL_NMEA_
+
+#define UCNL_NMEA_SNT_STR              '$'
+#define UCNL_NMEA_SNT_END              '\n'
+#define UCNL_NMEA_SNT_END1             '\r'
+#define UCNL_NMEA_PAR_SEP              ','
+#define UCNL_NMEA_CHK_SEP              '*'
+
+#define UCNL_NMEA_DATA_NOT_VALID       'V'
+#define UCNL_NMEA_SOUTH_SIGN           'S'
+#define UCNL_NMEA_WEST_SIGN            'W'
+#define UCNL_NMEA_TD_VALID             'A'
+#define UCNL_NMEA_PSENTENCE_SYMBOL     'P'
+#define UCNL_NMEA_PMODE_DATA_NOT_VALID 'N'
+
+#define UCNL_NMEA_MIN_LEN              (8)
+#define UCNL_NMEA_SEP_MASK_SIZE        (8)      // 32-bit words of a field separators mask, covers a whole byte-indexed buffer
+
+#ifndef UCNL_NMEA_MAX_FIELDS
+#define UCNL_NMEA_MAX_FIELDS           (32)     // max fields in a sentence field index
+#endif
+
+#ifndef UCNL_NMEA_SNTIDS_TABLE_BITS
+#define UCNL_NMEA_SNTIDS_TABLE_BITS    (5)      // sentence IDs table has 2^bits slots
+#endif
+#define UCNL_NMEA_SNTIDS_TABLE_SIZE    (1 << UCNL_NMEA_SNTIDS_TABLE_BITS)
+
+#ifndef UCNL_NMEA_SNTIDS_HASH_MUL
+#define UCNL_NMEA_SNTIDS_HASH_MUL      (0x384C3123UL) // places all standard and uWave IDs into 32 slots without collisions
+#endif
+
+#define NMEA_GSA_PRNS_NUM              (12)
+#define NMEA_GSV_SATS_NUM              (4)
+
+// Field index of a sentence: field #n ends right before sepIdx[n],
+// field #0 is talker & sentence ID, the last field ends before the checksum
+typedef struct {
+  byte sepIdx[UCNL_NMEA_MAX_FIELDS];
+  byte num;
+  bool isDone;
+} UCNL_NMEA_Fields_Struct;
+
+struct UCNL_NMEA_State_Struct_t;
+
+// Called for every complete sentence found by UCNL_NMEA_Process_Buffer,
+// sentence is in uState->buffer (uState->idx bytes), ID is in uState->sntID
+typedef void (*UCNL_NMEA_Sentence_Callback)(struct UCNL_NMEA_State_Struct_t* uState, void* param);
+
+// Sentence IDs table: open addressing over packed sentence IDs, a free slot has sntID = 0
+typedef struct {
+  long sntID;
+  UCNL_NMEA_Sentence_Callback handler;
+  void* param;
+} UCNL_NMEA_SntIDs_Entry_Struct;
+
+typedef struct {
+  UCNL_NMEA_SntIDs_Entry_Struct entries[UCNL_NMEA_SNTIDS_TABLE_SIZE];
+  byte num;
+} UCNL_NMEA_SntIDs_Table_Struct;
+
+typedef struct UCNL_NMEA_State_Struct_t {
+  byte* buffer;
+  byte  buffer_size;
+  byte  idx;
+  bool  isReady;
+  bool  isStarted;
+  bool  isPSentence;
+  byte  chk_act;
+  byte  chk_dcl;
+  byte  chk_dcl_idx;
+  bool  chk_present;
+  int   tkrID;
+  long  sntID;
+  long* sntIDs;
+  byte  sntIDs_size;
+  UCNL_NMEA_Fields_Struct fields;
+  const UCNL_NMEA_SntIDs_Table_Struct* sntTable;
+  const UCNL_NMEA_SntIDs_Entry_Struct* sntEntry;
+
+} UCNL_NMEA_State_Struct;
+
+// Sentence dispatcher: sentence IDs table + parser, result structure and callback for every ID
+typedef bool (*UCNL_NMEA_Parser_Func)(void* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+
+// Called for every successfully parsed sentence, "rdata" is the result structure registered for its ID
+typedef void (*UCNL_NMEA_Result_Callback)(UCNL_NMEA_State_Struct* uState, void* rdata, void* param);
+
+typedef struct {
+  UCNL_NMEA_Parser_Func parser;
+  void* rdata;
+  UCNL_NMEA_Result_Callback callback;
+  void* param;
+} UCNL_NMEA_Binding_Struct;
+
+typedef struct {
+  UCNL_NMEA_SntIDs_Table_Struct table;
+  UCNL_NMEA_Binding_Struct bindings[UCNL_NMEA_SNTIDS_TABLE_SIZE]; // bindings[i] belongs to table.entries[i]
+} UCNL_NMEA_Dispatcher_Struct;
+
+// Sentence writer: appends fields to a caller-owned buffer, updating the checksum on the way.
+// Appends stop at the buffer size less UCNL_NMEA_WRITER_TAIL_SIZE bytes, kept for the "*HH\r\n" tail
+#define UCNL_NMEA_WRITER_TAIL_SIZE     (5)
+#define UCNL_NMEA_WRITER_NUM_SIZE      (32)     // longest number field, zPad over 10 and dPlaces over 9 are clamped
+
+typedef struct {
+  byte* buffer;
+  byte  limit;        // appends stop here, the tail follows
+  byte  idx;
+  byte  chk;
+  bool  isOverflow;
+} UCNL_NMEA_Writer_Struct;
+
+// Compile-time sentences: UCNL_NMEA_Const_Sentence("PUWV6,1,1,1,1,1,1").str is "$PUWV6,1,1,1,1,1,1*32\r\n"
+constexpr byte UCNL_NMEA_CheckSum_Const(const char* body, byte acc = 0)
+{
+  return (*body == '\0') ? acc : UCNL_NMEA_CheckSum_Const(body + 1, acc ^ (byte)*body);
+}
+
+constexpr char UCNL_NMEA_Hex_Const(byte h)
+{
+  return (h > 9) ? (char)(h + 0x37) : (char)(h + 0x30);
+}
+
+// Character "i" of the sentence with body "body" of "n" characters and checksum "chk"
+constexpr char UCNL_NMEA_Const_Char(const char* body, int n, int i, byte chk)
+{
+  return (i == 0)     ? UCNL_NMEA_SNT_STR :
+         (i <= n)     ? body[i - 1] :
+         (i == n + 1) ? UCNL_NMEA_CHK_SEP :
+         (i == n + 2) ? UCNL_NMEA_Hex_Const(chk / 16) :
+         (i == n + 3) ? UCNL_NMEA_Hex_Const(chk % 16) :
+         (i == n + 4) ? UCNL_NMEA_SNT_END1 :
+         (i == n + 5) ? UCNL_NMEA_SNT_END : '\0';
+}
+
+#define UCNL_NMEA_WRITE_CONST(buffer, bufferSize, size, snt) (UCNL_NMEA_Write_Const((buffer), (bufferSize), (size), (snt).str, sizeof((snt).str) - 1))
+
+template <int N>
+struct UCNL_NMEA_Const_Sentence_Struct {
+  char str[N + UCNL_NMEA_WRITER_TAIL_SIZE + 2];   // '$' + body + tail + '\0'
+};
+
+template <int... I>
+struct UCNL_NMEA_Indexes {};
+
+template <int N, int... I>
+struct UCNL_NMEA_Make_Indexes : UCNL_NMEA_Make_Indexes<N - 1, N - 1, I...> {};
+
+template <int... I>
+struct UCNL_NMEA_Make_Indexes<0, I...> {
+  typedef UCNL_NMEA_Indexes<I...> type;
+};
+
+template <int N, int... I>
+constexpr UCNL_NMEA_Const_Sentence_Struct<N> UCNL_NMEA_Const_Sentence_Impl(const char* body, UCNL_NMEA_Indexes<I...>)
+{
+  return { { UCNL_NMEA_Const_Char(body, N, I, UCNL_NMEA_CheckSum_Const(body))... } };
+}
+
+template <int M>
+constexpr UCNL_NMEA_Const_Sentence_Struct<M - 1> UCNL_NMEA_Const_Sentence(const char (&body)[M])
+{
+  return UCNL_NMEA_Const_Sentence_Impl<M - 1>(body, typename UCNL_NMEA_Make_Indexes<M - 1 + UCNL_NMEA_WRITER_TAIL_SIZE + 2>::type());
+}
+
+typedef enum {
+  UCNL_NMEA_RESULT_PACKET_READY          = 0,
+  UCNL_NMEA_RESULT_BYPASS_BYTE           = 1,
+  UCNL_NMEA_RESULT_PACKET_STARTED        = 2,
+  UCNL_NMEA_RESULT_PACKET_PROCESS        = 3,
+  UCNL_NMEA_RESULT_PACKET_CHECKSUM_ERROR = 4,
+  UCNL_NMEA_RESULT_PACKET_TOO_BIG        = 5,
+  UCNL_NMEA_RESULT_PACKET_SKIPPING       = 6,
+  UCNL_NMEA_RESULT_UNKNOWN
+} UCNL_NMEA_Result_Enum;
+
+typedef enum {
+  NMEA_GGA_QTY_NO_FIX              = 0,
+  NMEA_GGA_QTY_SINGLE_POINT        = 1,
+  NMEA_GGA_QTY_PRANGE_DIFFERENTIAL = 2,
+  NMEA_GGA_QTY_RTK_FIXED           = 4,
+  NMEA_GGA_QTY_RTK_FLOATING        = 5,
+  NMEA_GGA_QTY_DEAD_RECKONING      = 6,
+  NMEA_GGA_QTY_MANUAL              = 7,
+  NMEA_GGA_QTY_SIMULATOR           = 8,
+  NMEA_GGA_QTY_WAAS_SBAS           = 9,
+  NMEA_GGA_QTY_UNKNOWN
+} NMEA_GGA_QTY_IND_Enum;
+
+typedef enum {
+  NMEA_PSMODE_AUTONOMOUS     = 'A',
+  NMEA_PSMODE_DIFFERENTIAL   = 'D',
+  NMEA_PSMODE_DEAD_RECKONING = 'E',
+  NMEA_PSMODE_MANUAL         = 'M',
+  NMEA_PSMODE_INVALID        = 'N',
+  NMEA_PSMODE_UNKNOWN  
+} NMEA_PSMODE_IND_Enum;
+
+// Standard known sentences result structures
+typedef struct {
+  bool isValid;
+  byte hour;
+  byte minute;
+  float second;
+  byte date;
+  byte month;
+  byte year;
+  double latitude_deg;
+  double longitude_deg;
+  float speed_kmh;
+  float course_deg;
+} UCNL_NMEA_RMC_RESULT_Struct;
+
+typedef struct {
+  bool isValid;
+  byte hour;
+  byte minute;
+  float second;
+  double latitude_deg;
+  double longitude_deg;
+  float hdop;
+  float gsep;
+  float dgps_rec_age;
+  byte sats_in_use;
+  byte gnss_qly_ind;
+  float orth_height;
+  byte datumID;
+} UCNL_NMEA_GGA_RESULT_Struct;
+
+typedef struct {
+  bool isValid;
+  byte hour;
+  byte minute;
+  float second;
+  double latitude_deg;
+  double longitude_deg;
+} UCNL_NMEA_GLL_RESULT_Struct;
+
+typedef struct {
+  bool isValid;
+  byte mode;
+  byte fix_type;
+  byte prns[NMEA_GSA_PRNS_NUM];
+  float pdop;
+  float hdop;
+  float vdop;
+  byte systemID;
+} UCNL_NMEA_GSA_RESULT_Struct;
+
+typedef struct {
+  bool isValid;
+  byte total_messages;
+  byte current_message;
+  byte sats_in_view;
+  
+  int PRNNumbers[NMEA_GSV_SATS_NUM];
+  int Elevations[NMEA_GSV_SATS_NUM];
+  int Azimuths[NMEA_GSV_SATS_NUM];
+  int SNRs[NMEA_GSV_SATS_NUM];
+
+  byte satDataNum;  
+  
+} UCNL_NMEA_GSV_RESULT_Struct;
+
+typedef struct {
+  bool isValid;
+  float track_true_deg;
+  bool is_magnetic;
+  float track_magnetic_deg;
+  float speed_knots;
+  float speed_kmh;
+} UCNL_NMEA_VTG_RESULT_Struct;
+
+typedef struct {
+  bool isValid;
+  float track_true_deg;
+} UCNL_NMEA_HDT_RESULT_Struct;
+
+typedef struct {
+  bool isValid;
+  float magnetic_heading_deg;
+  bool is_magnetic_variation;
+  float magnetic_variation;
+} UCNL_NMEA_HDG_RESULT_Struct;
+
+typedef struct {
+  bool isValid;
+  byte hour;
+  byte minute;
+  float second;
+  byte day; // 01..31
+  byte month;
+  int year; // 4-digit
+  int t_zone_offset_hours; // +/- 13 hours
+  byte t_zone_offset_minutes; // 0..59
+} UCNL_NMEA_ZDA_RESULT_Struct;
+
+typedef struct {
+  bool isValid;
+  float mean_water_temperature_c;
+} UCNL_NMEA_MTW_RESULT_Struct;
+
+
+#define UCNL_NMEA_RMC_SNT_ID (0x524D43)
+#define UCNL_NMEA_GGA_SNT_ID (0x474741)
+#define UCNL_NMEA_GLL_SNT_ID (0x474C4C)
+#define UCNL_NMEA_GSA_SNT_ID (0x475341)
+#define UCNL_NMEA_GSV_SNT_ID (0x475356)
+#define UCNL_NMEA_VTG_SNT_ID (0x565447)
+#define UCNL_NMEA_HDT_SNT_ID (0x484454)
+#define UCNL_NMEA_HDG_SNT_ID (0x484447)
+#define UCNL_NMEA_ZDA_SNT_ID (0x5A4441)
+#define UCNL_NMEA_MTW_SNT_ID (0x4D5457)
+
+#define UCNL_NMEA_IS_VALID_DATE(b)    (((b) >= 1) && ((b) <= 31))
+#define UCNL_NMEA_IS_VALID_MONTH(b)   (((b) >= 1) && ((b) <= 12))
+#define UCNL_NMEA_IS_VALID_YEAR(b)    (((b) >= 0) && ((b) <= 99))
+#define UCNL_NMEA_IS_VALID_HOUR(b)    (((b) >= 0) && ((b) <= 23))
+#define UCNL_NMEA_IS_VALID_MINSEC(b)  (((b) >= 0) && ((b) < 60))
+#define UCNL_NMEA_IS_VALID_LATDEG(l)  (((l) >= -90) && ((l) <= 90))
+#define UCNL_NMEA_IS_VALID_LONDEG(l)  (((l) >= -180) && ((l) <= 180))
+
+
+void UCNL_NMEA_InitStruct(UCNL_NMEA_State_Struct* uState, byte* buffer, byte buffer_size, long* sntIDs, byte sntIDs_size);
+void UCNL_NMEA_Release(UCNL_NMEA_State_Struct* uState);
+
+// Sentence IDs table, replaces the sntIDs list of a parser state when set
+void                                 UCNL_NMEA_SntIDs_Init(UCNL_NMEA_SntIDs_Table_Struct* table);
+bool                                 UCNL_NMEA_SntIDs_Add(UCNL_NMEA_SntIDs_Table_Struct* table, long sntID, UCNL_NMEA_Sentence_Callback handler, void* param);
+const UCNL_NMEA_SntIDs_Entry_Struct* UCNL_NMEA_SntIDs_Find(const UCNL_NMEA_SntIDs_Table_Struct* table, long sntID);
+void                                 UCNL_NMEA_Set_SntIDs_Table(UCNL_NMEA_State_Struct* uState, const UCNL_NMEA_SntIDs_Table_Struct* table);
+bool                                 UCNL_NMEA_Dispatch(UCNL_NMEA_State_Struct* uState);
+
+// Sentence dispatcher, use UCNL_NMEA_Set_SntIDs_Table(uState, &dispatcher->table) and call UCNL_NMEA_Dispatch for ready sentences
+void                                 UCNL_NMEA_Dispatcher_Init(UCNL_NMEA_Dispatcher_Struct* dispatcher);
+bool                                 UCNL_NMEA_Dispatcher_Add(UCNL_NMEA_Dispatcher_Struct* dispatcher, long sntID, UCNL_NMEA_Parser_Func parser,
+                                                              void* rdata, UCNL_NMEA_Result_Callback callback, void* param);
+UCNL_NMEA_Parser_Func                UCNL_NMEA_Get_Parser(long sntID);
+
+void                  UCNL_NMEA_Kernels_Init();
+UCNL_NMEA_Result_Enum UCNL_NMEA_Process_Byte(UCNL_NMEA_State_Struct* uState, byte newByte);
+size_t                UCNL_NMEA_Process_Buffer(UCNL_NMEA_State_Struct* uState, const byte* data, size_t size, UCNL_NMEA_Sentence_Callback callback, void* param);
+bool                  UCNL_NMEA_Get_NextParam(const byte* buffer, byte fromIdx, byte size, byte* stIdx, byte* ndIdx);
+bool                  UCNL_NMEA_Get_NextParam_Masked(const byte* buffer, const uint32_t* sepMask, byte fromIdx, byte size, byte* stIdx, byte* ndIdx);
+size_t                UCNL_NMEA_Find_Delimiter(const byte* data, size_t size, byte d1, byte d2, byte d3);
+byte                  UCNL_NMEA_Scan(const byte* data, byte size, uint32_t* sepMask);
+void                  UCNL_NMEA_CheckSum_Update(byte* buffer, byte size);
+
+void                  UCNL_NMEA_Writer_Init(UCNL_NMEA_Writer_Struct* writer, byte* buffer, byte size);
+void                  UCNL_NMEA_Writer_Byte(UCNL_NMEA_Writer_Struct* writer, byte c);
+void                  UCNL_NMEA_Writer_Bytes(UCNL_NMEA_Writer_Struct* writer, const byte* src, byte srcSize);
+void                  UCNL_NMEA_Writer_Str(UCNL_NMEA_Writer_Struct* writer, const char* src);
+void                  UCNL_NMEA_Writer_IntDec(UCNL_NMEA_Writer_Struct* writer, long src, byte zPad);
+void                  UCNL_NMEA_Writer_Float(UCNL_NMEA_Writer_Struct* writer, float f, byte dPlaces, byte zPad);
+void                  UCNL_NMEA_Writer_HexArray(UCNL_NMEA_Writer_Struct* writer, const byte* src, byte srcSize);
+bool                  UCNL_NMEA_Writer_Finish(UCNL_NMEA_Writer_Struct* writer, byte* size);
+bool                  UCNL_NMEA_Write_Const(byte* buffer, byte bufferSize, byte* size, const char* sentence, byte sentenceSize);
+void                  UCNL_NMEA_Fields_Build(UCNL_NMEA_Fields_Struct* fields, const byte* buffer, byte size);
+void                  UCNL_NMEA_Get_Field(const UCNL_NMEA_Fields_Struct* fields, byte n, byte* stIdx, byte* ndIdx);
+
+// Standard parsers
+bool                  UCNL_NMEA_Parse_RMC(UCNL_NMEA_RMC_RESULT_Struct* rdata, const byte* buffer, byte idx);
+bool                  UCNL_NMEA_Parse_GGA(UCNL_NMEA_GGA_RESULT_Struct* rdata, const byte* buffer, byte idx);
+bool                  UCNL_NMEA_Parse_GLL(UCNL_NMEA_GLL_RESULT_Struct* rdata, const byte* buffer, byte idx);
+bool                  UCNL_NMEA_Parse_VTG(UCNL_NMEA_VTG_RESULT_Struct* rdata, const byte* buffer, byte idx);
+bool                  UCNL_NMEA_Parse_HDT(UCNL_NMEA_HDT_RESULT_Struct* rdata, const byte* buffer, byte idx);
+bool                  UCNL_NMEA_Parse_HDG(UCNL_NMEA_HDG_RESULT_Struct* rdata, const byte* buffer, byte idx);
+bool                  UCNL_NMEA_Parse_MTW(UCNL_NMEA_MTW_RESULT_Struct* rdata, const byte* buffer, byte idx);
+bool                  UCNL_NMEA_Parse_GSA(UCNL_NMEA_GSA_RESULT_Struct* rdata, const byte* buffer, byte idx);
+bool                  UCNL_NMEA_Parse_GSV(UCNL_NMEA_GSV_RESULT_Struct* rdata, const byte* buffer, byte idx);
+bool                  UCNL_NMEA_Parse_ZDA(UCNL_NMEA_ZDA_RESULT_Struct* rdata, const byte* buffer, byte idx);
+
+// Standard parsers on a field index, e.g. the one UCNL_NMEA_Process_Byte builds in UCNL_NMEA_State_Struct.fields
+bool                  UCNL_NMEA_Parse_RMC_Fields(UCNL_NMEA_RMC_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+bool                  UCNL_NMEA_Parse_GGA_Fields(UCNL_NMEA_GGA_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+bool                  UCNL_NMEA_Parse_GLL_Fields(UCNL_NMEA_GLL_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+bool                  UCNL_NMEA_Parse_VTG_Fields(UCNL_NMEA_VTG_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+bool                  UCNL_NMEA_Parse_HDT_Fields(UCNL_NMEA_HDT_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+bool                  UCNL_NMEA_Parse_HDG_Fields(UCNL_NMEA_HDG_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+bool                  UCNL_NMEA_Parse_MTW_Fields(UCNL_NMEA_MTW_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+bool                  UCNL_NMEA_Parse_GSA_Fields(UCNL_NMEA_GSA_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+bool                  UCNL_NMEA_Parse_GSV_Fields(UCNL_NMEA_GSV_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+bool                  UCNL_NMEA_Parse_ZDA_Fields(UCNL_NMEA_ZDA_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields);
+
+#endif
@@ -1,218 +1,797 @@
-/*
-Copyright (C) 2021, Underwater communication & navigation laboratory
-All rights reserved.
-
-www.unavlab.com
-hello@unavlab.com
-
-*/
-
-#include "Arduino.h"
-#include "ucnl_str.h"
-
-void UCNL_STR_WriterInit(byte* buffer, byte* srcIdx, byte bufferSize)
-{
-  *srcIdx = 0;
-  for (int i = 0; i < bufferSize; i++)
-    buffer[i] = 0;
-}
-
-void UCNL_STR_WriteByte(byte* buffer, byte* srcIdx, byte c)
-{
-  buffer[*srcIdx] = c;
-  (*srcIdx)++;
-}
-
-void UCNL_STR_WriteIntDec(byte* buffer, byte* srcIdx, long src, byte zPad)
-{
-  long x = src;
-  int len = 0, i;
-
-  do {
-    x /= 10;
-    len++;
-  } while (x >= 1);
-
-  x = 1;
-  for (i = 1; i < len; i++) x *= 10;
-
-  if (zPad > 0) i = zPad;
-  else i = len;
-
-  do
-  {
-    if (i > len) buffer[*srcIdx] = '0';
-    else
-    {
-      buffer[*srcIdx] = (byte)((src / x) + '0');
-      src -= (src / x) * x;
-      x /= 10;
-    }
-    (*srcIdx)++;
-  } while (--i > 0);
-}
-
-void UCNL_STR_WriteFloat(byte* buffer, byte* srcIdx, float f, byte dPlaces, byte zPad)
-{
-  float ff = f;
-
-  if (ff < 0)
-  {
-    UCNL_STR_WriteByte(buffer, srcIdx, '-');
-    ff = -f;
-  }
-
-  long dec = (long)ff, mult = 1;
-  int i;
-  for (i = 0; i < dPlaces; i++) mult *= 10;
-  long frac = (long)((ff - dec) * (float)mult);
-
-  UCNL_STR_WriteIntDec(buffer, srcIdx, dec, zPad);
-  UCNL_STR_WriteByte(buffer, srcIdx, '.');
-  UCNL_STR_WriteIntDec(buffer, srcIdx, frac, dPlaces);
-}
-
-void UCNL_STR_WriteStr(byte* buffer, byte* srcIdx, byte* src)
-{
-  byte c;
-  c = *src;
-  while (c != '\0')
-  {
-    buffer[(*srcIdx)++] = c;
-    c = *++src;
-  }
-}
-
-void UCNL_STR_WriteHexByte(byte* buffer, byte* srcIdx, byte c)
-{
-  buffer[*srcIdx] = UCNL_STR_DIGIT_2HEX(c / 16);
-  (*srcIdx)++;
-  buffer[*srcIdx] = UCNL_STR_DIGIT_2HEX(c % 16);
-  (*srcIdx)++;
-}
-
-void UCNL_STR_WriteHexArray(byte* buffer, byte* srcIdx, byte* src, byte srcSize)
-{
-  int i;
-  UCNL_STR_WriteStr(buffer, srcIdx, UCNL_STR_HEX_ARRAY_PFX);
-  for (i = 0; i < srcSize; i++)
-    UCNL_STR_WriteHexByte(buffer, srcIdx, src[i]);
-}
-
-void UCNL_STR_WriteHexStr(byte* buffer, byte* srcIdx, byte* src, byte srcSize)
-{
-  int i;
-  for (i = 0; i < srcSize; i++)
-    UCNL_STR_WriteHexByte(buffer, srcIdx, src[i]);
-}
-
-
-
-
-float UCNL_STR_ParseFloat(const byte* buffer, byte stIdx, byte ndIdx)
-{
-  int i, dotIdx = ndIdx + 1;
-  float sign = 1.0f, fract = 0.0f;
-
-  if (buffer[stIdx] == '-')
-  {
-    sign = -1.0f;
-    stIdx++;
-  }
-
-  for (i = stIdx; i <= ndIdx; i++)
-  {
-    if (buffer[i] == '.')
-    {
-      dotIdx = i;
-    }
-  }
-
-  float result = 0.0f;
-  float multiplier = 1.0f;
-
-  for (i = dotIdx - 1; i >= stIdx; i--)
-  {
-    result += ((float)((buffer[i] - '0'))) * multiplier;
-    multiplier *= 10.0f;
-  }
-
-  multiplier = 0.1f;
-
-  for (i = dotIdx + 1; i <= ndIdx; i++)
-  {
-    fract += ((float)((buffer[i] - '0'))) * multiplier;
-    multiplier /= 10.0f;
-  }
-
-  result += fract;
-  return result * sign;
-}
-
-long UCNL_STR_ParseIntDec(const byte* buffer, byte stIdx, byte ndIdx)
-{
-  byte i;
-  int sign = 1;
-
-  if (buffer[stIdx] == '-')
-  {
-    sign = -1;
-    stIdx++;
-  }
-
-  long result = 0;
-  long multiplier = 1;
-
-  for (i = ndIdx; i >= stIdx; i--)
-  {
-    result += ((int)((buffer[i] - '0'))) * multiplier;
-    multiplier *= 10;
-  }
-
-  return result;
-}
-
-byte UCNL_STR_ParseHexByte(const byte* buffer, byte stIdx)
-{
-  return UCNL_STR_HEXDIGIT2B(buffer[stIdx]) * 16 + UCNL_STR_HEXDIGIT2B(buffer[stIdx + 1]);
-}
-
-int UCNL_STR_ReadHexStr(const byte* buffer, byte stIdx, byte ndIdx, byte* out_buffer, byte out_buffer_size, byte* out_size)
-{
-  int result = 0;
-  for (int i = 0; i < out_buffer_size; i++)
-    out_buffer[i] = 0;
-
-  *out_size = (ndIdx - stIdx - 1);
-  if ((*out_size < 0) || ((*out_size) % 2 != 0))
-  {
-    result = 1;
-  }
-  else
-  {
-    *out_size /= 2;
-    if ((buffer[stIdx] != '0') || (buffer[stIdx + 1] != 'x'))
-      result = 2;
-    else
-    {
-      int idx = 0;
-      while (idx < *out_size)
-      {
-        out_buffer[idx] = UCNL_STR_ParseHexByte(buffer, stIdx + idx * 2 + 2);
-        idx++;
-      }
-    }
-  }
-
-  return result;
-}
-
-void UCNL_STR_ReadString(const byte* src_buffer, byte* dst_buffer, byte* bytesRead, byte stIdx, byte ndIdx)
-{
-  *bytesRead = 0;
-  for (byte i = stIdx; i <= ndIdx; i++)
-  {
-    dst_buffer[i - stIdx] = src_buffer[i];
-    (*bytesRead)++;
-  }
-}
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+
+void UCNL_STR_WriterInit(byte* buffer, byte* srcIdx, byte bufferSize)
+{
+  *srcIdx = 0;
+  for (int i = 0; i < bufferSize; i++)
+    buffer[i] = 0;
+}
+
+void UCNL_STR_WriteByte(byte* buffer, byte* srcIdx, byte c)
+{
+  buffer[*srcIdx] = c;
+  (*srcIdx)++;
+}
+
+// Lookup tables are kept in the flash memory on AVR
+#ifdef __AVR__
+#define UCNL_STR_TABLE               PROGMEM
+#define UCNL_STR_TABLE_BYTE(t, i)    ((byte)pgm_read_byte(&(t)[(i)]))
+#else
+#define UCNL_STR_TABLE
+#define UCNL_STR_TABLE_BYTE(t, i)    ((byte)(t)[(i)])
+#endif
+
+// Digit pairs "00".."99"
+static const char UCNL_STR_DIGIT_PAIRS[201] UCNL_STR_TABLE =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+#define UCNL_STR_PAIR_CHAR(i) UCNL_STR_TABLE_BYTE(UCNL_STR_DIGIT_PAIRS, i)
+
+#define UCNL_STR_ULONG_DIGITS  (sizeof(unsigned long) * 5 / 2)   // 10 for 32-bit, 20 for 64-bit longs
+
+// Two digits of "v" < 100 before "p"
+static inline void UCNL_STR_WritePair(byte* p, byte v)
+{
+  p[-2] = UCNL_STR_PAIR_CHAR(2 * v);
+  p[-1] = UCNL_STR_PAIR_CHAR(2 * v + 1);
+}
+
+/* Decimal digits of "v" backwards from "end", returns the number of digits (at least one).
+   Values over 9999 are split into 4-digit groups by divisions by a constant, which compilers
+   turn into a multiplication where it is cheap. A group goes by pairs, v / 100 = v * 5243 >> 19
+   is exact for v < 43699
+*/
+static byte UCNL_STR_Digits(unsigned long v, byte* end)
+{
+  byte* p = end;
+  unsigned long q;
+  uint16_t g, h;
+
+  while (v >= 10000)
+  {
+    q = v / 10000;
+    g = (uint16_t)(v - q * 10000);
+    v = q;
+
+    h = (uint16_t)(((uint32_t)g * 5243) >> 19);
+    UCNL_STR_WritePair(p, (byte)(g - h * 100));
+    UCNL_STR_WritePair(p - 2, (byte)h);
+    p -= 4;
+  }
+
+  g = (uint16_t)v;
+  if (g >= 100)
+  {
+    h = (uint16_t)(((uint32_t)g * 5243) >> 19);
+    UCNL_STR_WritePair(p, (byte)(g - h * 100));
+    p -= 2;
+    g = h;
+  }
+
+  if (g >= 10)
+  {
+    UCNL_STR_WritePair(p, (byte)g);
+    p -= 2;
+  }
+  else
+    *--p = (byte)('0' + g);
+
+  return (byte)(end - p);
+}
+
+// Number of decimal digits of "v", by comparisons
+static byte UCNL_STR_Digits_Num(unsigned long v)
+{
+  unsigned long p = 10;
+  byte n = 1;
+
+  while ((n < UCNL_STR_ULONG_DIGITS) && (v >= p))
+  {
+    p *= 10;
+    n++;
+  }
+
+  return n;
+}
+
+// Unsigned value with at least "zPad" digits
+static void UCNL_STR_WriteUnsigned(byte* buffer, byte* srcIdx, unsigned long src, byte zPad)
+{
+  byte idx = *srcIdx;
+  byte n = UCNL_STR_Digits_Num(src);
+
+  while (zPad > n)
+  {
+    buffer[idx++] = '0';
+    zPad--;
+  }
+
+  idx += n;
+  UCNL_STR_Digits(src, &buffer[idx]);
+  *srcIdx = idx;
+}
+
+// "zPad" minimal number of digits, the sign is not counted
+void UCNL_STR_WriteIntDec(byte* buffer, byte* srcIdx, long src, byte zPad)
+{
+  unsigned long v = (unsigned long)src;
+
+  if (src < 0)
+  {
+    UCNL_STR_WriteByte(buffer, srcIdx, '-');
+    v = 0 - v;
+  }
+
+  UCNL_STR_WriteUnsigned(buffer, srcIdx, v, zPad);
+}
+
+/* Fixed-point number rounded to "dPlaces" decimal places (up to 9), at least one is written.
+   "zPad" minimal number of integer part digits, the sign is not counted
+*/
+void UCNL_STR_WriteFloat(byte* buffer, byte* srcIdx, float f, byte dPlaces, byte zPad)
+{
+  float ff = f;
+  unsigned long dec, frac, mult = 1;
+  byte i;
+
+  if (ff < 0)
+  {
+    UCNL_STR_WriteByte(buffer, srcIdx, '-');
+    ff = -f;
+  }
+
+  // no fraction: the rounded integer part and ".0", the difference is exact in float
+  if (dPlaces == 0)
+  {
+    dec = (unsigned long)(long)ff;
+    if (ff - (float)dec >= 0.5f)
+      dec++;
+
+    UCNL_STR_WriteUnsigned(buffer, srcIdx, dec, zPad);
+    UCNL_STR_WriteByte(buffer, srcIdx, '.');
+    UCNL_STR_WriteByte(buffer, srcIdx, '0');
+    return;
+  }
+
+  if (dPlaces > 9)
+    dPlaces = 9;
+  for (i = 0; i < dPlaces; i++)
+    mult *= 10;
+
+  // the fractional part is exact, its rounding may carry into the integer one
+  dec = (unsigned long)(long)ff;
+  frac = (unsigned long)(long)((double)(ff - (float)dec) * mult + 0.5);
+  if (frac >= mult)
+  {
+    frac -= mult;
+    dec++;
+  }
+
+  UCNL_STR_WriteUnsigned(buffer, srcIdx, dec, zPad);
+  UCNL_STR_WriteByte(buffer, srcIdx, '.');
+  UCNL_STR_WriteUnsigned(buffer, srcIdx, frac, dPlaces);
+}
+
+void UCNL_STR_WriteStr(byte* buffer, byte* srcIdx, byte* src)
+{
+  byte c;
+  c = *src;
+  while (c != '\0')
+  {
+    buffer[(*srcIdx)++] = c;
+    c = *++src;
+  }
+}
+
+// Hex codec
+// Scalar kernels use lookup tables, on x86 SSSE3 versions are chosen at runtime
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(UCNL_STR_NO_SIMD)
+#define UCNL_STR_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#define UCNL_STR_NH (0x10)    // not a hex digit flag
+
+static const char UCNL_STR_HEX_DIGITS[17] UCNL_STR_TABLE = "0123456789ABCDEF";
+
+// Hex digit values, both cases, UCNL_STR_NH for the other symbols
+static const byte UCNL_STR_HEX_VALUES[256] UCNL_STR_TABLE = {
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  0,           1,           2,           3,           4,           5,           6,           7,           8,           9,           UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, 10,          11,          12,          13,          14,          15,          UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, 10,          11,          12,          13,          14,          15,          UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+  UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH, UCNL_STR_NH,
+};
+
+typedef void (*UCNL_STR_EncodeHex_Func)(byte* dst, const byte* src, byte srcSize);
+typedef bool (*UCNL_STR_DecodeHex_Func)(byte* dst, const byte* src, byte srcSize);
+
+static void UCNL_STR_EncodeHex_Scalar(byte* dst, const byte* src, byte srcSize)
+{
+  byte i, c;
+
+  for (i = 0; i < srcSize; i++)
+  {
+    c = src[i];
+    dst[2 * i] = UCNL_STR_TABLE_BYTE(UCNL_STR_HEX_DIGITS, c >> 4);
+    dst[2 * i + 1] = UCNL_STR_TABLE_BYTE(UCNL_STR_HEX_DIGITS, c & 0x0F);
+  }
+}
+
+// Invalid symbols are collected by OR-ing their flags, the check is done once at the end
+static bool UCNL_STR_DecodeHex_Scalar(byte* dst, const byte* src, byte srcSize)
+{
+  byte i, hi, lo, flags = 0;
+
+  for (i = 0; i < srcSize / 2; i++)
+  {
+    hi = UCNL_STR_TABLE_BYTE(UCNL_STR_HEX_VALUES, src[2 * i]);
+    lo = UCNL_STR_TABLE_BYTE(UCNL_STR_HEX_VALUES, src[2 * i + 1]);
+    flags |= hi | lo;
+    dst[i] = (byte)((hi << 4) | (lo & 0x0F));
+  }
+
+  return ((flags & UCNL_STR_NH) == 0) && ((srcSize & 1) == 0);
+}
+
+#ifdef UCNL_STR_X86_SIMD
+
+// 16 bytes to 32 digits: nibbles are looked up by pshufb and interleaved
+__attribute__((target("ssse3")))
+static void UCNL_STR_EncodeHex_SSSE3(byte* dst, const byte* src, byte srcSize)
+{
+  int i = 0;
+  const __m128i digits = _mm_loadu_si128((const __m128i*)UCNL_STR_HEX_DIGITS);
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  __m128i v, hi, lo;
+
+  for (; i + 16 <= srcSize; i += 16)
+  {
+    v = _mm_loadu_si128((const __m128i*)(src + i));
+    hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+    lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, mask));
+    _mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128((__m128i*)(dst + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+  }
+
+  UCNL_STR_EncodeHex_Scalar(dst + 2 * i, src + i, (byte)(srcSize - i));
+}
+
+// Values of 16 hex digits, lanes of invalid symbols are set in "bad"
+__attribute__((target("ssse3")))
+static inline __m128i UCNL_STR_HexValues_SSSE3(__m128i c, __m128i* bad)
+{
+  __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+  __m128i l = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  __m128i is_d = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+  __m128i is_l = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+
+  *bad = _mm_or_si128(*bad, _mm_cmpeq_epi8(_mm_or_si128(is_d, is_l), _mm_setzero_si128()));
+  return _mm_or_si128(_mm_and_si128(is_d, d), _mm_and_si128(is_l, _mm_add_epi8(l, _mm_set1_epi8(10))));
+}
+
+// 32 digits to 16 bytes: pairs of values are joined by pmaddubsw (hi * 16 + lo) and packed
+__attribute__((target("ssse3")))
+static bool UCNL_STR_DecodeHex_SSSE3(byte* dst, const byte* src, byte srcSize)
+{
+  int i = 0;
+  const __m128i weights = _mm_set1_epi16(0x0110);
+  __m128i hi, lo, bad = _mm_setzero_si128();
+
+  for (; i + 32 <= srcSize; i += 32)
+  {
+    hi = _mm_maddubs_epi16(UCNL_STR_HexValues_SSSE3(_mm_loadu_si128((const __m128i*)(src + i)), &bad), weights);
+    lo = _mm_maddubs_epi16(UCNL_STR_HexValues_SSSE3(_mm_loadu_si128((const __m128i*)(src + i + 16)), &bad), weights);
+    _mm_storeu_si128((__m128i*)(dst + i / 2), _mm_packus_epi16(hi, lo));
+  }
+
+  return UCNL_STR_DecodeHex_Scalar(dst + i / 2, src + i, (byte)(srcSize - i)) && (_mm_movemask_epi8(bad) == 0);
+}
+
+#endif
+
+static void UCNL_STR_EncodeHex_Select(byte* dst, const byte* src, byte srcSize);
+static bool UCNL_STR_DecodeHex_Select(byte* dst, const byte* src, byte srcSize);
+
+static UCNL_STR_EncodeHex_Func UCNL_STR_EncodeHex_Impl = UCNL_STR_EncodeHex_Select;
+static UCNL_STR_DecodeHex_Func UCNL_STR_DecodeHex_Impl = UCNL_STR_DecodeHex_Select;
+
+/* Picks the best hex kernels for the CPU, every kernel pointer is written once with its final value
+   Otherwise this is done on the first use, call it before starting threads that use the hex codec
+*/
+void UCNL_STR_Kernels_Init()
+{
+  UCNL_STR_EncodeHex_Func encode = UCNL_STR_EncodeHex_Scalar;
+  UCNL_STR_DecodeHex_Func decode = UCNL_STR_DecodeHex_Scalar;
+
+#ifdef UCNL_STR_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("ssse3"))
+  {
+    encode = UCNL_STR_EncodeHex_SSSE3;
+    decode = UCNL_STR_DecodeHex_SSSE3;
+  }
+#endif
+
+  UCNL_STR_EncodeHex_Impl = encode;
+  UCNL_STR_DecodeHex_Impl = decode;
+}
+
+static void UCNL_STR_EncodeHex_Select(byte* dst, const byte* src, byte srcSize)
+{
+  UCNL_STR_Kernels_Init();
+  UCNL_STR_EncodeHex_Impl(dst, src, srcSize);
+}
+
+static bool UCNL_STR_DecodeHex_Select(byte* dst, const byte* src, byte srcSize)
+{
+  UCNL_STR_Kernels_Init();
+  return UCNL_STR_DecodeHex_Impl(dst, src, srcSize);
+}
+
+/* Encodes "srcSize" bytes of "src" as 2 * srcSize upper case hex digits to "dst"
+*/
+void UCNL_STR_EncodeHex(byte* dst, const byte* src, byte srcSize)
+{
+  UCNL_STR_EncodeHex_Impl(dst, src, srcSize);
+}
+
+/* Decodes "srcSize" hex digits of "src" (either case) to srcSize / 2 bytes of "dst"
+   returns false if "srcSize" is odd or there are other symbols, "dst" is undefined then
+*/
+bool UCNL_STR_DecodeHex(byte* dst, const byte* src, byte srcSize)
+{
+  return UCNL_STR_DecodeHex_Impl(dst, src, srcSize);
+}
+
+void UCNL_STR_WriteHexByte(byte* buffer, byte* srcIdx, byte c)
+{
+  buffer[*srcIdx] = UCNL_STR_TABLE_BYTE(UCNL_STR_HEX_DIGITS, c >> 4);
+  (*srcIdx)++;
+  buffer[*srcIdx] = UCNL_STR_TABLE_BYTE(UCNL_STR_HEX_DIGITS, c & 0x0F);
+  (*srcIdx)++;
+}
+
+void UCNL_STR_WriteHexArray(byte* buffer, byte* srcIdx, byte* src, byte srcSize)
+{
+  UCNL_STR_WriteStr(buffer, srcIdx, UCNL_STR_HEX_ARRAY_PFX);
+  UCNL_STR_WriteHexStr(buffer, srcIdx, src, srcSize);
+}
+
+void UCNL_STR_WriteHexStr(byte* buffer, byte* srcIdx, byte* src, byte srcSize)
+{
+  UCNL_STR_EncodeHex(&buffer[*srcIdx], src, srcSize);
+  *srcIdx += 2 * srcSize;
+}
+
+
+
+
+// Decimal number scanner: value = mantissa * 10^exp10
+#ifdef __AVR__
+typedef uint32_t UCNL_STR_Mantissa;
+#define UCNL_STR_MANTISSA_DIGITS (9)
+#else
+typedef uint64_t UCNL_STR_Mantissa;
+#define UCNL_STR_MANTISSA_DIGITS (19)
+#endif
+
+typedef struct {
+  UCNL_STR_Mantissa mantissa;
+  int exp10;
+  bool isNegative;
+  bool isExact;      // false if some non-zero digits did not fit into the mantissa
+  byte size;         // bytes taken by the number
+} UCNL_STR_Decimal_Struct;
+
+/* Takes sign, digits and a dot in one pass, stops at the first other byte
+   "stIdx", "ndIdx" first and last bytes of the field
+*/
+static void UCNL_STR_ScanDecimal(const byte* buffer, byte stIdx, byte ndIdx, UCNL_STR_Decimal_Struct* dec)
+{
+  int i = stIdx, dotIdx = -1;
+  byte c, digits = 0;
+  UCNL_STR_Mantissa mantissa = 0;
+
+  dec->exp10 = 0;
+  dec->isExact = true;
+  dec->isNegative = false;
+
+  if ((i <= ndIdx) && ((buffer[i] == '-') || (buffer[i] == '+')))
+  {
+    dec->isNegative = (buffer[i] == '-');
+    i++;
+  }
+
+  if (ndIdx - i < UCNL_STR_MANTISSA_DIGITS)
+  {
+    // short field (all the NMEA ones): every digit fits into the mantissa, no checks per digit
+    for (; i <= ndIdx; i++)
+    {
+      c = buffer[i] - '0';
+      if (c <= 9)
+        mantissa = mantissa * 10 + c;
+      else if ((buffer[i] == '.') && (dotIdx < 0))
+        dotIdx = i;
+      else
+        break;
+    }
+
+    if (dotIdx >= 0)
+      dec->exp10 = dotIdx + 1 - i;
+  }
+  else
+  {
+    for (; i <= ndIdx; i++)
+    {
+      c = buffer[i] - '0';
+      if (c <= 9)
+      {
+        if (digits < UCNL_STR_MANTISSA_DIGITS)
+        {
+          mantissa = mantissa * 10 + c;
+          if (mantissa != 0)
+            digits++;
+          if (dotIdx >= 0)
+            dec->exp10--;
+        }
+        else
+        {
+          if (c != 0)
+            dec->isExact = false;
+          if (dotIdx < 0)
+            dec->exp10++;
+        }
+      }
+      else if ((buffer[i] == '.') && (dotIdx < 0))
+        dotIdx = i;
+      else
+        break;
+    }
+  }
+
+  dec->mantissa = mantissa;
+  dec->size = (byte)(i - stIdx);
+}
+
+// Powers of ten exactly representable in float (5^10 < 2^24)
+static const float UCNL_STR_Pow10f[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+#define UCNL_STR_POW10F_MAX     (10)
+#define UCNL_STR_FLOAT_EXACT    (((uint32_t)1) << 24)
+
+#ifdef __AVR__
+
+// mantissa * 10^exp10 with 32-bit float arithmetic, correctly rounded for mantissas up to 2^24 and |exp10| <= 10
+static float UCNL_STR_Decimal2Float(UCNL_STR_Mantissa mantissa, int exp10)
+{
+  float result = (float)mantissa;
+
+  while (exp10 < -UCNL_STR_POW10F_MAX)
+  {
+    result /= UCNL_STR_Pow10f[UCNL_STR_POW10F_MAX];
+    exp10 += UCNL_STR_POW10F_MAX;
+  }
+  while (exp10 > UCNL_STR_POW10F_MAX)
+  {
+    result *= UCNL_STR_Pow10f[UCNL_STR_POW10F_MAX];
+    exp10 -= UCNL_STR_POW10F_MAX;
+  }
+
+  return (exp10 < 0) ? result / UCNL_STR_Pow10f[-exp10] : result * UCNL_STR_Pow10f[exp10];
+}
+
+#else
+
+// Powers of ten exactly representable in double (5^22 < 2^53)
+static const double UCNL_STR_Pow10d[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                          1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+#define UCNL_STR_POW10D_MAX     (22)
+#define UCNL_STR_DOUBLE_EXACT   (((uint64_t)1) << 53)
+
+/* Exact decimal to double: both the mantissa and the power of ten are exact doubles,
+   so a single multiplication or division is correctly rounded (Clinger's fast path)
+   returns false if the number is out of the fast path
+*/
+static bool UCNL_STR_Decimal2Double(const UCNL_STR_Decimal_Struct* dec, double* result)
+{
+  if (!dec->isExact || (dec->mantissa > UCNL_STR_DOUBLE_EXACT) ||
+      (dec->exp10 < -UCNL_STR_POW10D_MAX) || (dec->exp10 > UCNL_STR_POW10D_MAX))
+    return false;
+
+  *result = (dec->exp10 < 0) ? (double)dec->mantissa / UCNL_STR_Pow10d[-dec->exp10] :
+                               (double)dec->mantissa * UCNL_STR_Pow10d[dec->exp10];
+  return true;
+}
+
+// Negative powers of ten, rounded
+static const double UCNL_STR_Pow10d_Neg[] = { 1e0,   1e-1,  1e-2,  1e-3,  1e-4,  1e-5,  1e-6,  1e-7,  1e-8,  1e-9,  1e-10, 1e-11,
+                                              1e-12, 1e-13, 1e-14, 1e-15, 1e-16, 1e-17, 1e-18, 1e-19, 1e-20, 1e-21, 1e-22 };
+
+/* Rounding a double to float gives the nearest float to the number if the double is closer than
+   "tolerance" double ulps to the number and is farther than that from a halfway point between
+   two floats, i.e. its 29 extra mantissa bits are not close to 1000...0
+*/
+static bool UCNL_STR_Is_Float_Halfway(double d, uint32_t tolerance)
+{
+  uint64_t bits;
+
+  if ((d != 0.0) && ((d < 1.17549435e-38) || (d > 3.40282347e+38)))
+    return true; // out of the normal float range, leave it to the library
+
+  memcpy(&bits, &d, sizeof(bits));
+  return ((uint32_t)((bits & 0x1FFFFFFFULL) - 0x10000000ULL + tolerance) <= 2 * tolerance);
+}
+
+// Slow path for the rare numbers the fast paths can not round exactly, kept out of line:
+// its buffer would make every call set up a large stack frame
+__attribute__((noinline))
+static double UCNL_STR_ParseDecimal_Slow(const byte* buffer, byte stIdx, const UCNL_STR_Decimal_Struct* dec, bool isFloat)
+{
+  char str[256];
+
+  memcpy(str, buffer + stIdx, dec->size);
+  str[dec->size] = '\0';
+
+  // the sign is applied by the caller
+  return fabs(isFloat ? (double)strtof(str, NULL) : strtod(str, NULL));
+}
+
+#endif
+
+#ifndef __AVR__
+
+/* Fast path for the short fixed-point fields most sentences carry: [sign]digits[.digits], up to 19 bytes
+   after the sign and nothing else in the field. The digits go to a mantissa without any checks
+   "mantissa", "fDigits" the digits as an integer and the number of fractional ones
+   returns false for any other field, it goes to the general path then
+*/
+static inline bool UCNL_STR_ScanFixed(const byte* buffer, byte stIdx, byte ndIdx, uint64_t* mantissa, byte* fDigits, bool* isNegative)
+{
+  int i = stIdx, dotIdx = -1;
+  uint64_t m = 0;
+  byte c;
+
+  *isNegative = false;
+  if ((i <= ndIdx) && ((buffer[i] == '-') || (buffer[i] == '+')))
+  {
+    *isNegative = (buffer[i] == '-');
+    i++;
+  }
+
+  if ((i > ndIdx) || (ndIdx - i >= UCNL_STR_MANTISSA_DIGITS))
+    return false;
+
+  for (; i <= ndIdx; i++)
+  {
+    c = buffer[i] - '0';
+    if (c <= 9)
+      m = m * 10 + c;
+    else if ((buffer[i] == '.') && (dotIdx < 0))
+      dotIdx = i;
+    else
+      return false;
+  }
+
+  *mantissa = m;
+  *fDigits = (dotIdx < 0) ? 0 : (byte)(ndIdx - dotIdx);
+  return (m <= UCNL_STR_DOUBLE_EXACT);
+}
+
+/* A fixed-point field to float with a single correctly rounded division: a float one if the mantissa
+   fits into 24 bits, a double one otherwise, which rounds to the nearest float unless it hits
+   a halfway point exactly
+   returns false if the field is not a short fixed-point one or the double is at a halfway point
+*/
+static bool UCNL_STR_ParseFixed_Float(const byte* buffer, byte stIdx, byte ndIdx, float* result)
+{
+  uint64_t mantissa;
+  byte fDigits;
+  bool isNegative;
+  double d;
+
+  if (!UCNL_STR_ScanFixed(buffer, stIdx, ndIdx, &mantissa, &fDigits, &isNegative))
+    return false;
+
+  if ((mantissa <= UCNL_STR_FLOAT_EXACT) && (fDigits <= UCNL_STR_POW10F_MAX))
+    *result = (float)(uint32_t)mantissa / UCNL_STR_Pow10f[fDigits];
+  else
+  {
+    d = (double)(int64_t)mantissa / UCNL_STR_Pow10d[fDigits];
+    if (UCNL_STR_Is_Float_Halfway(d, 0))
+      return false;
+
+    *result = (float)d;
+  }
+
+  if (isNegative)
+    *result = -*result;
+
+  return true;
+}
+
+#endif
+
+#ifndef __AVR__
+
+/* Fields out of the fixed-point fast paths: long ones, exponents, halfway points. Kept out of line,
+   so the fast paths take no stack frame of their own
+*/
+__attribute__((noinline))
+static float UCNL_STR_ParseFloat_Decimal(const byte* buffer, byte stIdx, byte ndIdx)
+{
+  UCNL_STR_Decimal_Struct dec;
+  float result;
+  double d;
+
+  UCNL_STR_ScanDecimal(buffer, stIdx, ndIdx, &dec);
+
+  // a multiplication instead of a division, the double is within 2 ulps of the number
+  // and has 29 more bits than a float, so only numbers near a halfway point need the exact path
+  if (dec.isExact && (dec.mantissa <= UCNL_STR_DOUBLE_EXACT) && (dec.exp10 <= 0) && (dec.exp10 >= -UCNL_STR_POW10D_MAX) &&
+      !UCNL_STR_Is_Float_Halfway(d = (double)dec.mantissa * UCNL_STR_Pow10d_Neg[-dec.exp10], 4))
+    result = (float)d;
+  else if (UCNL_STR_Decimal2Double(&dec, &d) && !UCNL_STR_Is_Float_Halfway(d, 0))
+    result = (float)d;
+  else
+    result = (float)UCNL_STR_ParseDecimal_Slow(buffer, stIdx, &dec, true);
+
+  return dec.isNegative ? -result : result;
+}
+
+__attribute__((noinline))
+static double UCNL_STR_ParseDouble_Decimal(const byte* buffer, byte stIdx, byte ndIdx)
+{
+  UCNL_STR_Decimal_Struct dec;
+  double result;
+
+  UCNL_STR_ScanDecimal(buffer, stIdx, ndIdx, &dec);
+
+  if (!UCNL_STR_Decimal2Double(&dec, &result))
+    result = UCNL_STR_ParseDecimal_Slow(buffer, stIdx, &dec, false);
+
+  return dec.isNegative ? -result : result;
+}
+
+#endif
+
+/* Parses a decimal number: [sign]digits[.digits]
+   "stIdx", "ndIdx" first and last bytes of the field
+   returns the nearest float to the number in the field
+*/
+float UCNL_STR_ParseFloat(const byte* buffer, byte stIdx, byte ndIdx)
+{
+#ifdef __AVR__
+  UCNL_STR_Decimal_Struct dec;
+  float result;
+
+  UCNL_STR_ScanDecimal(buffer, stIdx, ndIdx, &dec);
+
+  // correctly rounded for mantissas up to 2^24, no 64-bit double for the rest: within an ulp or two
+  result = UCNL_STR_Decimal2Float(dec.mantissa, dec.exp10);
+
+  return dec.isNegative ? -result : result;
+#else
+  float result;
+
+  if (UCNL_STR_ParseFixed_Float(buffer, stIdx, ndIdx, &result))
+    return result;
+
+  return UCNL_STR_ParseFloat_Decimal(buffer, stIdx, ndIdx);
+#endif
+}
+
+/* Parses a decimal number: [sign]digits[.digits]
+   "stIdx", "ndIdx" first and last bytes of the field
+   returns the nearest double to the number in the field, the same as UCNL_STR_ParseFloat where double is 32-bit
+*/
+double UCNL_STR_ParseDouble(const byte* buffer, byte stIdx, byte ndIdx)
+{
+#ifdef __AVR__
+  return UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+#else
+  uint64_t mantissa;
+  byte fDigits;
+  bool isNegative;
+  double result;
+
+  // a short fixed-point field: the mantissa and the power of ten are exact, so is the division
+  if (UCNL_STR_ScanFixed(buffer, stIdx, ndIdx, &mantissa, &fDigits, &isNegative))
+  {
+    result = (double)(int64_t)mantissa / UCNL_STR_Pow10d[fDigits];
+    return isNegative ? -result : result;
+  }
+
+  return UCNL_STR_ParseDouble_Decimal(buffer, stIdx, ndIdx);
+#endif
+}
+
+long UCNL_STR_ParseIntDec(const byte* buffer, byte stIdx, byte ndIdx)
+{
+  byte i;
+  int sign = 1;
+
+  if (buffer[stIdx] == '-')
+  {
+    sign = -1;
+    stIdx++;
+  }
+
+  long result = 0;
+  long multiplier = 1;
+
+  for (i = ndIdx; i >= stIdx; i--)
+  {
+    result += ((int)((buffer[i] - '0'))) * multiplier;
+    multiplier *= 10;
+  }
+
+  return result;
+}
+
+byte UCNL_STR_ParseHexByte(const byte* buffer, byte stIdx)
+{
+  return (byte)((UCNL_STR_TABLE_BYTE(UCNL_STR_HEX_VALUES, buffer[stIdx]) << 4) |
+                (UCNL_STR_TABLE_BYTE(UCNL_STR_HEX_VALUES, buffer[stIdx + 1]) & 0x0F));
+}
+
+/* Reads a "0x" prefixed hex string from buffer[stIdx..ndIdx], the digits are validated in the same pass
+   "out_buffer" decoded bytes, "out_buffer_size" its size
+   "out_size" number of decoded bytes, 0 on errors
+   returns 0 on success, 1 if the number of digits is odd, 2 if there is no prefix,
+   3 if the data does not fit into "out_buffer", 4 if there are symbols other than hex digits
+*/
+int UCNL_STR_ReadHexStr(const byte* buffer, byte stIdx, byte ndIdx, byte* out_buffer, byte out_buffer_size, byte* out_size)
+{
+  int digits = ndIdx - stIdx - 1;
+
+  *out_size = 0;
+
+  if ((digits < 0) || (digits % 2 != 0))
+    return 1;
+
+  if ((buffer[stIdx] != '0') || (buffer[stIdx + 1] != 'x'))
+    return 2;
+
+  if (digits / 2 > out_buffer_size)
+    return 3;
+
+  if (!UCNL_STR_DecodeHex(out_buffer, &buffer[stIdx + 2], (byte)digits))
+    return 4;
+
+  *out_size = (byte)(digits / 2);
+  return 0;
+}
+
+void UCNL_STR_ReadString(const byte* src_buffer, byte* dst_buffer, byte* bytesRead, byte stIdx, byte ndIdx)
+{
+  *bytesRead = 0;
+  for (byte i = stIdx; i <= ndIdx; i++)
+  {
+    dst_buffer[i - stIdx] = src_buffer[i];
+    (*bytesRead)++;
+  }
+}
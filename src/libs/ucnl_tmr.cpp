@@ -0,0 +1,250 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#include "Arduino.h"
+#include "ucnl_tmr.h"
+
+#define UCNL_TMR_IS_BEFORE(a, b)   ((long)((a) - (b)) < 0)        // wraparound-safe comparison of clock values and ticks
+#define UCNL_TMR_MAX_DELAY_TICKS   (0x7FFFFFFFUL)                  // keeps "expires" comparable with the current tick
+
+// Links the timer into the slot of its "expires" tick at the lowest level whose span covers it
+static void UCNL_TMR_Link(UCNL_TMR_Wheel_Struct* wheel, UCNL_TMR_Timer_Struct* timer)
+{
+  unsigned long at = timer->expires;
+  unsigned long delta = at - wheel->tick;
+  UCNL_TMR_Timer_Struct** head;
+  byte level = 0;
+
+  if (UCNL_TMR_IS_BEFORE(at, wheel->tick))
+  {
+    // overdue, goes off with the next tick
+    at = wheel->tick;
+    delta = 0;
+  }
+  else if (delta > UCNL_TMR_MAX_TICKS)
+  {
+    // beyond the top level, re-filed once the slot comes up
+    at = wheel->tick + UCNL_TMR_MAX_TICKS;
+    delta = UCNL_TMR_MAX_TICKS;
+  }
+
+  while ((level < UCNL_TMR_LEVELS - 1) && (delta >= (1UL << (UCNL_TMR_SLOT_BITS * (level + 1)))))
+    level++;
+
+  head = &wheel->slots[level][(at >> (UCNL_TMR_SLOT_BITS * level)) & UCNL_TMR_SLOT_MASK];
+
+  timer->next = *head;
+  if (timer->next)
+    timer->next->pprev = &timer->next;
+  timer->pprev = head;
+  *head = timer;
+}
+
+// Moves the timers of a higher level slot down to the levels their remaining delays belong to
+static void UCNL_TMR_Cascade(UCNL_TMR_Wheel_Struct* wheel, byte level, byte idx)
+{
+  UCNL_TMR_Timer_Struct* timer = wheel->slots[level][idx];
+  UCNL_TMR_Timer_Struct* next;
+
+  wheel->slots[level][idx] = NULL;
+
+  while (timer)
+  {
+    next = timer->next;
+    UCNL_TMR_Link(wheel, timer);
+    timer = next;
+  }
+}
+
+static void UCNL_TMR_Tick(UCNL_TMR_Wheel_Struct* wheel)
+{
+  byte idx = wheel->tick & UCNL_TMR_SLOT_MASK;
+  byte level, lidx;
+  UCNL_TMR_Timer_Struct* work;
+  UCNL_TMR_Timer_Struct* timer;
+
+  // a level's slot comes up every time the level below wraps around
+  lidx = idx;
+  for (level = 1; (lidx == 0) && (level < UCNL_TMR_LEVELS); level++)
+  {
+    lidx = (wheel->tick >> (UCNL_TMR_SLOT_BITS * level)) & UCNL_TMR_SLOT_MASK;
+    UCNL_TMR_Cascade(wheel, level, lidx);
+  }
+
+  // the expired timers are taken off the wheel first, so callbacks can arm and cancel any timer
+  work = wheel->slots[0][idx];
+  wheel->slots[0][idx] = NULL;
+  if (work)
+    work->pprev = &work;
+
+  wheel->tick++;
+  wheel->ts += wheel->tick_ms;
+
+  while (work)
+  {
+    timer = work;
+    work = timer->next;
+    if (work)
+      work->pprev = &work;
+
+    // a delay longer than the wheel spans, filed at level 0 when there is no other level
+    if (UCNL_TMR_IS_BEFORE(wheel->tick - 1, timer->expires))
+    {
+      UCNL_TMR_Link(wheel, timer);
+      continue;
+    }
+
+    timer->next = NULL;
+    timer->pprev = NULL;
+    wheel->count--;
+
+    if (timer->callback)
+      timer->callback(timer, timer->param);
+  }
+}
+
+
+void UCNL_TMR_InitStruct(UCNL_TMR_Wheel_Struct* wheel, unsigned long tick_ms, UCNL_TMR_Clock_Func clock)
+{
+  byte level;
+  int i;
+
+  for (level = 0; level < UCNL_TMR_LEVELS; level++)
+    for (i = 0; i < UCNL_TMR_SLOTS; i++)
+      wheel->slots[level][i] = NULL;
+
+  wheel->tick_ms = (tick_ms > 0) ? tick_ms : 1;
+  wheel->clock = clock;
+  wheel->tick = 0;
+  wheel->ts = clock();
+  wheel->count = 0;
+}
+
+void UCNL_TMR_Init_Timer(UCNL_TMR_Timer_Struct* timer, UCNL_TMR_Callback callback, void* param)
+{
+  timer->expires = 0;
+  timer->callback = callback;
+  timer->param = param;
+  timer->next = NULL;
+  timer->pprev = NULL;
+}
+
+/* Arms the timer to go off in "delay_ms" or up to a tick later, re-arms it if it is armed already.
+   The delay is counted from the clock value, so the timers armed between polls are not shortened
+*/
+void UCNL_TMR_Arm(UCNL_TMR_Wheel_Struct* wheel, UCNL_TMR_Timer_Struct* timer, unsigned long delay_ms)
+{
+  unsigned long now = wheel->clock();
+  unsigned long span, ticks;
+
+  UCNL_TMR_Cancel(wheel, timer);
+
+  if (UCNL_TMR_IS_BEFORE(now, wheel->ts))
+    span = (delay_ms > wheel->ts - now) ? delay_ms - (wheel->ts - now) : 0;
+  else
+  {
+    span = delay_ms + (now - wheel->ts);
+    if (span < delay_ms)
+      span = 0xFFFFFFFFUL;
+  }
+
+  ticks = span / wheel->tick_ms + ((span % wheel->tick_ms) != 0);
+  if (ticks > UCNL_TMR_MAX_DELAY_TICKS)
+    ticks = UCNL_TMR_MAX_DELAY_TICKS;
+
+  timer->expires = wheel->tick + ticks;
+  UCNL_TMR_Link(wheel, timer);
+  wheel->count++;
+}
+
+bool UCNL_TMR_Cancel(UCNL_TMR_Wheel_Struct* wheel, UCNL_TMR_Timer_Struct* timer)
+{
+  if (!timer->pprev)
+    return false;
+
+  *timer->pprev = timer->next;
+  if (timer->next)
+    timer->next->pprev = timer->pprev;
+
+  timer->next = NULL;
+  timer->pprev = NULL;
+  wheel->count--;
+
+  return true;
+}
+
+bool UCNL_TMR_Is_Armed(const UCNL_TMR_Timer_Struct* timer)
+{
+  return timer->pprev != NULL;
+}
+
+void UCNL_TMR_Poll(UCNL_TMR_Wheel_Struct* wheel)
+{
+  unsigned long now = wheel->clock();
+  unsigned long n;
+
+  if (wheel->count == 0)
+  {
+    // nothing to expire, the idle ticks are skipped at once
+    if (!UCNL_TMR_IS_BEFORE(now, wheel->ts))
+    {
+      n = (now - wheel->ts) / wheel->tick_ms + 1;
+      wheel->tick += n;
+      wheel->ts += n * wheel->tick_ms;
+    }
+    return;
+  }
+
+  while (!UCNL_TMR_IS_BEFORE(now, wheel->ts))
+    UCNL_TMR_Tick(wheel);
+}
+
+
+void UCNL_TMR_Pool_Init(UCNL_TMR_Pool_Struct* pool, UCNL_TMR_Timer_Struct* timers, unsigned int size)
+{
+  unsigned int i;
+
+  pool->free = NULL;
+  for (i = size; i > 0; i--)
+  {
+    UCNL_TMR_Init_Timer(&timers[i - 1], NULL, NULL);
+    timers[i - 1].next = pool->free;
+    pool->free = &timers[i - 1];
+  }
+
+  pool->available = size;
+}
+
+// NULL if all the timers are taken
+UCNL_TMR_Timer_Struct* UCNL_TMR_Pool_Alloc(UCNL_TMR_Pool_Struct* pool, UCNL_TMR_Callback callback, void* param)
+{
+  UCNL_TMR_Timer_Struct* timer = pool->free;
+
+  if (!timer)
+    return NULL;
+
+  pool->free = timer->next;
+  pool->available--;
+  UCNL_TMR_Init_Timer(timer, callback, param);
+
+  return timer;
+}
+
+// An armed timer is not taken back, it has to be canceled first
+bool UCNL_TMR_Pool_Free(UCNL_TMR_Pool_Struct* pool, UCNL_TMR_Timer_Struct* timer)
+{
+  if (timer->pprev)
+    return false;
+
+  timer->next = pool->free;
+  pool->free = timer;
+  pool->available++;
+
+  return true;
+}
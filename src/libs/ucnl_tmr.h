@@ -0,0 +1,82 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#ifndef _UCNL_TMR_
+#define _UCNL_TMR_
+
+// Hierarchical timer wheel: arming, canceling and expiring a timer take constant time regardless of
+// how many timers are armed. Level 0 holds timers due within UCNL_TMR_SLOTS ticks, every next level
+// covers UCNL_TMR_SLOTS times longer delays with the same number of slots, its timers are moved down
+// a level once their slot comes up. Timers are owned by the caller, the wheel never allocates
+
+#ifndef UCNL_TMR_SLOT_BITS
+#ifdef __AVR__
+#define UCNL_TMR_SLOT_BITS      (4)        // 16 slots per level, 4 levels: 65535 ticks
+#else
+#define UCNL_TMR_SLOT_BITS      (6)        // 64 slots per level, 4 levels: 16777215 ticks
+#endif
+#endif
+
+#ifndef UCNL_TMR_LEVELS
+#define UCNL_TMR_LEVELS         (4)
+#endif
+
+#define UCNL_TMR_SLOTS          (1 << UCNL_TMR_SLOT_BITS)
+#define UCNL_TMR_SLOT_MASK      (UCNL_TMR_SLOTS - 1)
+#define UCNL_TMR_MAX_TICKS      ((1UL << (UCNL_TMR_SLOT_BITS * UCNL_TMR_LEVELS)) - 1)  // longer delays are re-filed at the top level
+
+struct UCNL_TMR_Timer_Struct_t;
+
+// Called once the timer expires, the timer is not armed by then and can be armed again
+typedef void (*UCNL_TMR_Callback)(struct UCNL_TMR_Timer_Struct_t* timer, void* param);
+
+// Monotonic milliseconds, e.g. millis
+typedef unsigned long (*UCNL_TMR_Clock_Func)(void);
+
+typedef struct UCNL_TMR_Timer_Struct_t {
+  unsigned long expires;                  // tick the timer is due
+  UCNL_TMR_Callback callback;
+  void* param;
+
+  // slot list links, "pprev" is NULL while the timer is not armed
+  struct UCNL_TMR_Timer_Struct_t* next;
+  struct UCNL_TMR_Timer_Struct_t** pprev;
+} UCNL_TMR_Timer_Struct;
+
+typedef struct {
+  UCNL_TMR_Timer_Struct* slots[UCNL_TMR_LEVELS][UCNL_TMR_SLOTS];
+  unsigned long tick;                     // next tick to process
+  unsigned long ts;                       // the clock value the next tick is due at
+  unsigned long tick_ms;
+  unsigned int count;                     // armed timers
+  UCNL_TMR_Clock_Func clock;
+} UCNL_TMR_Wheel_Struct;
+
+// Preallocated timers for clients that arm a varying number of them, e.g. per remote
+typedef struct {
+  UCNL_TMR_Timer_Struct* free;
+  unsigned int available;
+} UCNL_TMR_Pool_Struct;
+
+
+void UCNL_TMR_InitStruct(UCNL_TMR_Wheel_Struct* wheel, unsigned long tick_ms, UCNL_TMR_Clock_Func clock);
+void UCNL_TMR_Init_Timer(UCNL_TMR_Timer_Struct* timer, UCNL_TMR_Callback callback, void* param);
+
+void UCNL_TMR_Arm(UCNL_TMR_Wheel_Struct* wheel, UCNL_TMR_Timer_Struct* timer, unsigned long delay_ms);
+bool UCNL_TMR_Cancel(UCNL_TMR_Wheel_Struct* wheel, UCNL_TMR_Timer_Struct* timer);
+bool UCNL_TMR_Is_Armed(const UCNL_TMR_Timer_Struct* timer);
+
+// Expires the timers that are due by the clock, calls their callbacks
+void UCNL_TMR_Poll(UCNL_TMR_Wheel_Struct* wheel);
+
+void UCNL_TMR_Pool_Init(UCNL_TMR_Pool_Struct* pool, UCNL_TMR_Timer_Struct* timers, unsigned int size);
+UCNL_TMR_Timer_Struct* UCNL_TMR_Pool_Alloc(UCNL_TMR_Pool_Struct* pool, UCNL_TMR_Callback callback, void* param);
+bool UCNL_TMR_Pool_Free(UCNL_TMR_Pool_Struct* pool, UCNL_TMR_Timer_Struct* timer);
+
+#endif
@@ -1,856 +1,980 @@
-/*
-Copyright (C) 2021, Underwater communication & navigation laboratory
-All rights reserved.
-
-www.unavlab.com
-hello@unavlab.com
-
-*/
-
-
-#include "Arduino.h"
-#include "ucnl_str.h"
-#include "ucnl_nmea.h"
-#include "ucnl_uwave.h"
-
-
-// Parsers
-bool uWAVE_Parse_ACK(uWAVE_ACK_RESULT_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWV0,sndID,errCode
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->sentenceID = char(buffer[stIdx]);
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->errCode = (uWAVE_ERR_CODES_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_RC_RESPONSE(uWAVE_RC_RESPONSE_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWV3,txChID,rcCmdID,[propTime_seс],msr,[value],[azimuth]
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->txChID = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->rcCmdID = (uWAVE_RC_CODES_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 3:
-        if (ndIdx < stIdx)
-          rdata->isPropTime = false;
-        else
-        {
-          rdata->isPropTime = true;
-          rdata->propTime_sec = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-      case 4:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->MSR_dB = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 5:
-        if (ndIdx < stIdx)
-          rdata->isValue = true;
-        else
-        {
-          rdata->isValue = true;
-          rdata->value = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-      case 6:
-        if (ndIdx < stIdx)
-          rdata->isAzimuth = true;
-        else
-        {
-          rdata->isAzimuth = true;
-          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_RC_TIMEOUT(uWAVE_RC_TIMEOUT_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWV4,txChID,rcCmdID
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->txChID = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->rcCmdID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_RC_ASYNC_IN(uWAVE_RC_ASYNC_IN_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWV5,rcCmdID,msr,[azimuth]
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->rcCmdID = (uWAVE_RC_CODES_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->MSR_dB = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 3:
-        if (ndIdx < stIdx)
-          rdata->isAzimuth = false;
-        else
-        {
-          rdata->isAzimuth = true;
-          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_AMB_DTA(uWAVE_AMB_DTA_Struct* rdata, const byte* buffer, byte idx)
-{
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx > stIdx)
-        {
-          rdata->isPrs = true;
-          rdata->prs_mBar = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        else
-          rdata->isPrs = false;
-        break;
-      case 2:
-        if (ndIdx > stIdx)
-        {
-          rdata->isTemp = true;
-          rdata->temp_C = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        else
-          rdata->isTemp = false;
-        break;
-      case 3:
-        if (ndIdx > stIdx)
-        {
-          rdata->isDpt = true;
-          rdata->dpt_m = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        else
-          rdata->isDpt = false;
-        break;
-      case 4:
-        if (ndIdx > stIdx)
-        {
-          rdata->isBat = true;
-          rdata->batVoltage_V = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        else
-          rdata->isBat = false;
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_INC_DTA(uWAVE_INC_DTA_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWV9,,pitch,roll
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx > stIdx)
-        {
-          rdata->isHeading = true;
-          rdata->heading = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        else
-          rdata->isHeading = false;
-        break;
-      case 2:
-        if (ndIdx > stIdx)
-        {
-          rdata->isPitch = true;
-          rdata->pitch = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        else
-          rdata->isPitch = false;
-        break;
-      case 3:
-        if (ndIdx > stIdx)
-        {
-          rdata->isRoll = true;
-          rdata->roll = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        else
-          rdata->isRoll = false;
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_PT_SETTINGS(uWAVE_PT_SETTINGS_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWVE,isPTMode,ptAddress
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->isPtEnabled = (bool)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_PT_FAILED(uWAVE_PT_PACKET_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWVH,target_ptAddress,triesTaken,dataPacket
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->tries = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 3:
-        if ((ndIdx < stIdx) ||
-            (UCNL_STR_ReadHexStr(buffer, stIdx, ndIdx, rdata->dataPacket, uWAVE_PKT_MAX_SIZE, &(rdata->dataPacketSize)) != 0))
-          result = false;
-        break;
-    }
-
-    pIdx++;
-  } while (result && !isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_PT_DLVRD(uWAVE_PT_PACKET_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWVI,tareget_ptAddress,triesTaken,[azimuth],dataPacket
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->tries = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 3:
-        if (ndIdx > stIdx)
-        {
-          rdata->isAzimuth = true;
-          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-      case 4:
-        if ((ndIdx < stIdx) || (UCNL_STR_ReadHexStr(buffer, stIdx, ndIdx, rdata->dataPacket, uWAVE_PKT_MAX_SIZE, &(rdata->dataPacketSize)) != 0))
-          result = false;
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_PT_RCVD(uWAVE_PT_PACKET_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWVJ,sender_ptAddress,[azimuth],dataPacket
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 2:
-        if (ndIdx > stIdx)
-        {
-          rdata->isAzimuth = true;
-          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-      case 3:
-        if ((ndIdx < stIdx) || (UCNL_STR_ReadHexStr(buffer, stIdx, ndIdx, rdata->dataPacket, uWAVE_PKT_MAX_SIZE, &(rdata->dataPacketSize)) != 0))
-          result = false;
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_PT_TMO(uWAVE_PT_ITG_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWVL,target_ptAddress,pt_itg_dataID
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->pt_itg_dataID = (uWAVE_DataID_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_PT_ITG_RESP(uWAVE_PT_ITG_RESP_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWVM,target_ptAddress,pt_itg_dataID,[dataValue],pTime,[azimuth]
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->target_ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->pt_itg_dataID = (uWAVE_DataID_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 3:
-        if (ndIdx >= stIdx)
-        {
-          rdata->isValue = true;
-          rdata->dataValue = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-
-      case 4:
-        if (ndIdx >= stIdx)
-        {
-          rdata->isPTime = true;
-          rdata->pTime = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-
-      case 5:
-        if (ndIdx >= stIdx)
-        {
-          rdata->isAzimuth = true;
-          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        }
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_AQPNG_SETTINGS(uWAVE_AQPNG_SETTINGS_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWVO,[isSaveInFlash],AQPN_ModeID,[periodMs],[rcCmdID],[rcTxID],[rcRxID],[isPT],[pt_targetAddr]
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  rdata->isSaveInFlash = false;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 2:
-        if (ndIdx > stIdx)
-          rdata->aqpng_Mode = (uWAVE_AQPNG_Mode_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        else
-          result = false;
-        break;
-
-      case 3:
-        if (ndIdx > stIdx)
-        {
-          rdata->isPeriod = true;
-          rdata->periodMs = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        }
-        break;
-
-      case 4:
-        if (ndIdx > stIdx)
-        {
-          rdata->isDataID = true;
-          rdata->dataID = (uWAVE_DataID_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        }
-        break;
-
-      case 5:
-        if (ndIdx > stIdx)
-          rdata->rcTxID = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 6:
-        if (ndIdx > stIdx)
-          rdata->rcRxID = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 7:
-        if (ndIdx > stIdx)
-          rdata->isPT = (bool)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-
-      case 8:
-        if (ndIdx > stIdx)
-        {
-          rdata->pt_targetAddr = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        }
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-bool uWAVE_Parse_DINFO(uWAVE_DINFO_Struct* rdata, const byte* buffer, byte idx)
-{
-  // $PUWV!,serialNumber,sys_moniker,sys_version,core_moniker [release],core_version,acBaudrate,rxChID,txChID,totalCh,salinityPSU,isPTS,isCmdMode
-  byte stIdx = 0, ndIdx = 0, pIdx = 0;
-  bool result = true, isNotLastParam;
-
-  do
-  {
-    isNotLastParam = UCNL_NMEA_Get_NextParam(buffer, ndIdx + 1, idx, &stIdx, &ndIdx);
-    switch (pIdx)
-    {
-      case 1:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          UCNL_STR_ReadString(buffer, rdata->serialNumber, &(rdata->serialNumber_size), stIdx, ndIdx);
-        break;
-      case 2:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          UCNL_STR_ReadString(buffer, rdata->core_moniker, &(rdata->sys_moniker_size), stIdx, ndIdx);
-        break;
-      case 3:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->core_version = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 4:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          UCNL_STR_ReadString(buffer, rdata->sys_moniker, &(rdata->sys_moniker_size), stIdx, ndIdx);
-        break;
-      case 5:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->sys_version = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 6:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->acBaudrate = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 7:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->txChID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 8:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->rxChID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 9:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->totalChannels = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 10:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->styPSU = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
-        break;
-      case 11:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->isPTSPresent = (bool)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      case 12:
-        if (ndIdx < stIdx)
-          result = false;
-        else
-          rdata->isCmdMode = (bool)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
-        break;
-      default:
-        break;
-    }
-
-    pIdx++;
-  } while (result && isNotLastParam);
-
-  return result;
-}
-
-
-// Sentence builders
-void uWAVE_Build_SETTINGS_WRITE(uWAVE_SETTINGS_WRITE_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWV1,\0");
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->rxChID, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->txChID, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteFloat(  buffer, idx, sdata->styPSU, 0, 1);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isCmdMode, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isACKOnTXFinished, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteFloat(  buffer, idx, sdata->gravityAcc, 4, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_CHK_SEP);
-  UCNL_STR_WriteHexByte(buffer, idx, 0);
-  UCNL_STR_WriteStr(    buffer, idx, (byte*)"\r\n");
-
-  UCNL_NMEA_CheckSum_Update(buffer, *idx);
-}
-
-void uWAVE_Build_RC_REQUEST(uWAVE_RC_REQUEST_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWV2,\0");
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->txChID, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->rxChID, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->rcCmdID, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_CHK_SEP);
-  UCNL_STR_WriteHexByte(buffer, idx, 0);
-  UCNL_STR_WriteStr(    buffer, idx, (byte*)"\r\n");
-
-  UCNL_NMEA_CheckSum_Update(buffer, *idx);
-}
-
-void uWAVE_Build_AMB_DTA_CFG(uWAVE_AMB_DTA_CFG_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWV6,\0");
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isSaveInFlash, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->periodMs, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isPrs, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isTemp, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isDpt, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isBatV, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_CHK_SEP);
-  UCNL_STR_WriteHexByte(buffer, idx, 0);
-  UCNL_STR_WriteStr(    buffer, idx, (byte*)"\r\n");
-
-  UCNL_NMEA_CheckSum_Update(buffer, *idx);
-}
-
-void uWAVE_Build_INC_DTA_CFG(uWAVE_INC_DTA_CFG_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWV8,\0");
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isSaveInFlash, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->periodMs, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_CHK_SEP);
-  UCNL_STR_WriteHexByte(buffer, idx, 0);
-  UCNL_STR_WriteStr(    buffer, idx, (byte*)"\r\n");
-
-  UCNL_NMEA_CheckSum_Update(buffer, *idx);
-}
-
-void uWAVE_Build_PT_SETTINGS_READ(byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWVD,0*5C\r\n\0");
-}
-
-void uWAVE_Build_PT_SETTINGS_WRITE(uWAVE_PT_SETTINGS_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWVF,\0");
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isSaveInFlash, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isPtEnabled, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->ptAddress, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_CHK_SEP);
-  UCNL_STR_WriteHexByte(buffer, idx, 0);
-  UCNL_STR_WriteStr(    buffer, idx, (byte*)"\r\n");
-
-  UCNL_NMEA_CheckSum_Update(buffer, *idx);
-}
-
-void uWAVE_Build_PT_SEND(uWAVE_PT_PACKET_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWVG,\0");
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->ptAddress, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->tries, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteHexArray( buffer, idx, sdata->dataPacket, sdata->dataPacketSize);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_CHK_SEP);
-  UCNL_STR_WriteHexByte(buffer, idx, 0);
-  UCNL_STR_WriteStr(    buffer, idx, (byte*)"\r\n");
-
-  UCNL_NMEA_CheckSum_Update(buffer, *idx);
-}
-
-void uWAVE_Build_PT_ABORT_SEND(byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWVG,0,0,*6F\r\n\0");
-}
-
-void uWAVE_Build_PT_ITG(uWAVE_PT_ITG_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWVK,\0");
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->ptAddress, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->pt_itg_dataID, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_CHK_SEP);
-
-  UCNL_STR_WriteHexByte(buffer, idx, 0);
-  UCNL_STR_WriteStr(    buffer, idx, (byte*)"\r\n");
-
-  UCNL_NMEA_CheckSum_Update(buffer, *idx);
-}
-
-void uWAVE_Build_AQPNG_SETTINGS_READ(byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWVN,0*56\r\n\0");
-}
-
-void uWAVE_Build_AQPNG_SETTINGS(uWAVE_AQPNG_SETTINGS_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWVO,\0");
-
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isSaveInFlash, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->aqpng_Mode, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-
-  if (sdata->isPeriod)
-    UCNL_STR_WriteIntDec( buffer, idx, sdata->periodMs, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-
-  if (sdata->isDataID)
-    UCNL_STR_WriteIntDec( buffer, idx, sdata->dataID, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->rcTxID, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->rcRxID, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->isPT, 0);
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_PAR_SEP);
-
-  UCNL_STR_WriteIntDec( buffer, idx, sdata->pt_targetAddr, 0);
-
-  UCNL_STR_WriteByte(   buffer, idx, UCNL_NMEA_CHK_SEP);
-  UCNL_STR_WriteHexByte(buffer, idx, 0);
-  UCNL_STR_WriteStr(    buffer, idx, (byte*)"\r\n");
-
-  UCNL_NMEA_CheckSum_Update(buffer, *idx);
-}
-
-void uWAVE_Build_DINFO_GET(byte* buffer, byte bufferSize, byte* idx)
-{
-  UCNL_STR_WriterInit(  buffer, idx, bufferSize);
-  UCNL_STR_WriteStr(    buffer, idx, "$PUWV?,0*27\r\n\0");
-}
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+#include "ucnl_nmea.h"
+#include "ucnl_uwave.h"
+
+
+// Parsers
+bool uWAVE_Parse_ACK_Fields(uWAVE_ACK_RESULT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWV0,sndID,errCode
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->sentenceID = char(buffer[stIdx]);
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->errCode = (uWAVE_ERR_CODES_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_ACK(uWAVE_ACK_RESULT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_ACK_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_RC_RESPONSE_Fields(uWAVE_RC_RESPONSE_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWV3,txChID,rcCmdID,[propTime_seс],msr,[value],[azimuth]
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->txChID = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->rcCmdID = (uWAVE_RC_CODES_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 3:
+        if (ndIdx < stIdx)
+          rdata->isPropTime = false;
+        else
+        {
+          rdata->isPropTime = true;
+          rdata->propTime_sec = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+      case 4:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->MSR_dB = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 5:
+        if (ndIdx < stIdx)
+          rdata->isValue = false;
+        else
+        {
+          rdata->isValue = true;
+          rdata->value = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+      case 6:
+        if (ndIdx < stIdx)
+          rdata->isAzimuth = false;
+        else
+        {
+          rdata->isAzimuth = true;
+          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_RC_RESPONSE(uWAVE_RC_RESPONSE_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_RC_RESPONSE_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_RC_TIMEOUT_Fields(uWAVE_RC_TIMEOUT_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWV4,txChID,rcCmdID
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->txChID = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->rcCmdID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_RC_TIMEOUT(uWAVE_RC_TIMEOUT_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_RC_TIMEOUT_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_RC_ASYNC_IN_Fields(uWAVE_RC_ASYNC_IN_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWV5,rcCmdID,msr,[azimuth]
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->rcCmdID = (uWAVE_RC_CODES_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->MSR_dB = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 3:
+        if (ndIdx < stIdx)
+          rdata->isAzimuth = false;
+        else
+        {
+          rdata->isAzimuth = true;
+          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_RC_ASYNC_IN(uWAVE_RC_ASYNC_IN_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_RC_ASYNC_IN_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_AMB_DTA_Fields(uWAVE_AMB_DTA_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx > stIdx)
+        {
+          rdata->isPrs = true;
+          rdata->prs_mBar = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        else
+          rdata->isPrs = false;
+        break;
+      case 2:
+        if (ndIdx > stIdx)
+        {
+          rdata->isTemp = true;
+          rdata->temp_C = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        else
+          rdata->isTemp = false;
+        break;
+      case 3:
+        if (ndIdx > stIdx)
+        {
+          rdata->isDpt = true;
+          rdata->dpt_m = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        else
+          rdata->isDpt = false;
+        break;
+      case 4:
+        if (ndIdx > stIdx)
+        {
+          rdata->isBat = true;
+          rdata->batVoltage_V = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        else
+          rdata->isBat = false;
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_AMB_DTA(uWAVE_AMB_DTA_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_AMB_DTA_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_INC_DTA_Fields(uWAVE_INC_DTA_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWV9,,pitch,roll
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx > stIdx)
+        {
+          rdata->isHeading = true;
+          rdata->heading = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        else
+          rdata->isHeading = false;
+        break;
+      case 2:
+        if (ndIdx > stIdx)
+        {
+          rdata->isPitch = true;
+          rdata->pitch = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        else
+          rdata->isPitch = false;
+        break;
+      case 3:
+        if (ndIdx > stIdx)
+        {
+          rdata->isRoll = true;
+          rdata->roll = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        else
+          rdata->isRoll = false;
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_INC_DTA(uWAVE_INC_DTA_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_INC_DTA_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_PT_SETTINGS_Fields(uWAVE_PT_SETTINGS_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWVE,isPTMode,ptAddress
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->isPtEnabled = (bool)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_PT_SETTINGS(uWAVE_PT_SETTINGS_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_PT_SETTINGS_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_PT_FAILED_Fields(uWAVE_PT_PACKET_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWVH,target_ptAddress,triesTaken,dataPacket
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->tries = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 3:
+        if ((ndIdx < stIdx) ||
+            (UCNL_STR_ReadHexStr(buffer, stIdx, ndIdx, rdata->dataPacket, uWAVE_PKT_MAX_SIZE, &(rdata->dataPacketSize)) != 0))
+          result = false;
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_PT_FAILED(uWAVE_PT_PACKET_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_PT_FAILED_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_PT_DLVRD_Fields(uWAVE_PT_PACKET_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWVI,tareget_ptAddress,triesTaken,[azimuth],dataPacket
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->tries = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 3:
+        if (ndIdx > stIdx)
+        {
+          rdata->isAzimuth = true;
+          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+      case 4:
+        if ((ndIdx < stIdx) || (UCNL_STR_ReadHexStr(buffer, stIdx, ndIdx, rdata->dataPacket, uWAVE_PKT_MAX_SIZE, &(rdata->dataPacketSize)) != 0))
+          result = false;
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_PT_DLVRD(uWAVE_PT_PACKET_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_PT_DLVRD_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_PT_RCVD_Fields(uWAVE_PT_PACKET_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWVJ,sender_ptAddress,[azimuth],dataPacket
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 2:
+        if (ndIdx > stIdx)
+        {
+          rdata->isAzimuth = true;
+          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+      case 3:
+        if ((ndIdx < stIdx) || (UCNL_STR_ReadHexStr(buffer, stIdx, ndIdx, rdata->dataPacket, uWAVE_PKT_MAX_SIZE, &(rdata->dataPacketSize)) != 0))
+          result = false;
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_PT_RCVD(uWAVE_PT_PACKET_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_PT_RCVD_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_PT_TMO_Fields(uWAVE_PT_ITG_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWVL,target_ptAddress,pt_itg_dataID
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->pt_itg_dataID = (uWAVE_DataID_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_PT_TMO(uWAVE_PT_ITG_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_PT_TMO_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_PT_ITG_RESP_Fields(uWAVE_PT_ITG_RESP_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWVM,target_ptAddress,pt_itg_dataID,[dataValue],pTime,[azimuth]
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->target_ptAddress = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->pt_itg_dataID = (uWAVE_DataID_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 3:
+        if (ndIdx >= stIdx)
+        {
+          rdata->isValue = true;
+          rdata->dataValue = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+
+      case 4:
+        if (ndIdx >= stIdx)
+        {
+          rdata->isPTime = true;
+          rdata->pTime = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+
+      case 5:
+        if (ndIdx >= stIdx)
+        {
+          rdata->isAzimuth = true;
+          rdata->azimuth = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        }
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_PT_ITG_RESP(uWAVE_PT_ITG_RESP_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_PT_ITG_RESP_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_AQPNG_SETTINGS_Fields(uWAVE_AQPNG_SETTINGS_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWVO,[isSaveInFlash],AQPN_ModeID,[periodMs],[rcCmdID],[rcTxID],[rcRxID],[isPT],[pt_targetAddr]
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  rdata->isSaveInFlash = false;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 2:
+        if (ndIdx > stIdx)
+          rdata->aqpng_Mode = (uWAVE_AQPNG_Mode_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        else
+          result = false;
+        break;
+
+      case 3:
+        if (ndIdx > stIdx)
+        {
+          rdata->isPeriod = true;
+          rdata->periodMs = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        }
+        break;
+
+      case 4:
+        if (ndIdx > stIdx)
+        {
+          rdata->isDataID = true;
+          rdata->dataID = (uWAVE_DataID_Enum)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        }
+        break;
+
+      case 5:
+        if (ndIdx > stIdx)
+          rdata->rcTxID = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 6:
+        if (ndIdx > stIdx)
+          rdata->rcRxID = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 7:
+        if (ndIdx > stIdx)
+          rdata->isPT = (bool)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+
+      case 8:
+        if (ndIdx > stIdx)
+        {
+          rdata->pt_targetAddr = (byte)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        }
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_AQPNG_SETTINGS(uWAVE_AQPNG_SETTINGS_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_AQPNG_SETTINGS_Fields(rdata, buffer, &fields);
+}
+
+bool uWAVE_Parse_DINFO_Fields(uWAVE_DINFO_Struct* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields)
+{
+  // $PUWV!,serialNumber,sys_moniker,sys_version,core_moniker [release],core_version,acBaudrate,rxChID,txChID,totalCh,salinityPSU,isPTS,isCmdMode
+  byte stIdx = 0, ndIdx = 0, pIdx = 0;
+  bool result = true;
+
+  for (pIdx = 1; (pIdx < fields->num) && result; pIdx++)
+  {
+    UCNL_NMEA_Get_Field(fields, pIdx, &stIdx, &ndIdx);
+    switch (pIdx)
+    {
+      case 1:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          UCNL_STR_ReadString(buffer, rdata->serialNumber, &(rdata->serialNumber_size), stIdx, ndIdx);
+        break;
+      case 2:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          UCNL_STR_ReadString(buffer, rdata->core_moniker, &(rdata->sys_moniker_size), stIdx, ndIdx);
+        break;
+      case 3:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->core_version = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 4:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          UCNL_STR_ReadString(buffer, rdata->sys_moniker, &(rdata->sys_moniker_size), stIdx, ndIdx);
+        break;
+      case 5:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->sys_version = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 6:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->acBaudrate = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 7:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->txChID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 8:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->rxChID = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 9:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->totalChannels = UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 10:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->styPSU = UCNL_STR_ParseFloat(buffer, stIdx, ndIdx);
+        break;
+      case 11:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->isPTSPresent = (bool)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      case 12:
+        if (ndIdx < stIdx)
+          result = false;
+        else
+          rdata->isCmdMode = (bool)UCNL_STR_ParseIntDec(buffer, stIdx, ndIdx);
+        break;
+      default:
+        break;
+    }
+  }
+
+  return result;
+}
+
+bool uWAVE_Parse_DINFO(uWAVE_DINFO_Struct* rdata, const byte* buffer, byte idx)
+{
+  UCNL_NMEA_Fields_Struct fields;
+
+  UCNL_NMEA_Fields_Build(&fields, buffer, idx);
+  return uWAVE_Parse_DINFO_Fields(rdata, buffer, &fields);
+}
+
+
+// Sentence dispatcher
+#define uWAVE_PARSER(name, type) \
+static bool uWAVE_Parser_##name(void* rdata, const byte* buffer, const UCNL_NMEA_Fields_Struct* fields) \
+{ \
+  return uWAVE_Parse_##name##_Fields((type*)rdata, buffer, fields); \
+}
+
+uWAVE_PARSER(ACK,            uWAVE_ACK_RESULT_Struct)
+uWAVE_PARSER(RC_RESPONSE,    uWAVE_RC_RESPONSE_Struct)
+uWAVE_PARSER(RC_TIMEOUT,     uWAVE_RC_TIMEOUT_Struct)
+uWAVE_PARSER(RC_ASYNC_IN,    uWAVE_RC_ASYNC_IN_Struct)
+uWAVE_PARSER(AMB_DTA,        uWAVE_AMB_DTA_Struct)
+uWAVE_PARSER(INC_DTA,        uWAVE_INC_DTA_Struct)
+uWAVE_PARSER(PT_SETTINGS,    uWAVE_PT_SETTINGS_Struct)
+uWAVE_PARSER(PT_FAILED,      uWAVE_PT_PACKET_Struct)
+uWAVE_PARSER(PT_DLVRD,       uWAVE_PT_PACKET_Struct)
+uWAVE_PARSER(PT_RCVD,        uWAVE_PT_PACKET_Struct)
+uWAVE_PARSER(PT_TMO,         uWAVE_PT_ITG_Struct)
+uWAVE_PARSER(PT_ITG_RESP,    uWAVE_PT_ITG_RESP_Struct)
+uWAVE_PARSER(AQPNG_SETTINGS, uWAVE_AQPNG_SETTINGS_Struct)
+uWAVE_PARSER(DINFO,          uWAVE_DINFO_Struct)
+
+/* Gets the parser of a uWave or a standard sentence, "rdata" of the parser is the result structure
+   of the corresponding uWAVE_Parse_xxx/UCNL_NMEA_Parse_xxx function
+   returns NULL for unknown sentence IDs
+*/
+UCNL_NMEA_Parser_Func uWAVE_Get_Parser(long sntID)
+{
+  switch (sntID)
+  {
+    case uWAVE_NMEA_UWV0_SNT_ID:     return uWAVE_Parser_ACK;
+    case uWAVE_NMEA_UWV3_SNT_ID:     return uWAVE_Parser_RC_RESPONSE;
+    case uWAVE_NMEA_UWV4_SNT_ID:     return uWAVE_Parser_RC_TIMEOUT;
+    case uWAVE_NMEA_UWV5_SNT_ID:     return uWAVE_Parser_RC_ASYNC_IN;
+    case uWAVE_NMEA_UWV7_SNT_ID:     return uWAVE_Parser_AMB_DTA;
+    case uWAVE_NMEA_UWV9_SNT_ID:     return uWAVE_Parser_INC_DTA;
+    case uWAVE_NMEA_UWVE_SNT_ID:     return uWAVE_Parser_PT_SETTINGS;
+    case uWAVE_NMEA_UWVH_SNT_ID:     return uWAVE_Parser_PT_FAILED;
+    case uWAVE_NMEA_UWVI_SNT_ID:     return uWAVE_Parser_PT_DLVRD;
+    case uWAVE_NMEA_UWVJ_SNT_ID:     return uWAVE_Parser_PT_RCVD;
+    case uWAVE_NMEA_UWVL_SNT_ID:     return uWAVE_Parser_PT_TMO;
+    case uWAVE_NMEA_UWVM_SNT_ID:     return uWAVE_Parser_PT_ITG_RESP;
+    case uWAVE_NMEA_UWVO_SNT_ID:     return uWAVE_Parser_AQPNG_SETTINGS;
+    case uWAVE_NMEA_UWV_EXCL_SNT_ID: return uWAVE_Parser_DINFO;
+    default:                         return UCNL_NMEA_Get_Parser(sntID);
+  }
+}
+
+// Registers a uWave or a standard sentence with its own parser, see UCNL_NMEA_Dispatcher_Add
+bool uWAVE_Dispatcher_Add(UCNL_NMEA_Dispatcher_Struct* dispatcher, long sntID, void* rdata, UCNL_NMEA_Result_Callback callback, void* param)
+{
+  return UCNL_NMEA_Dispatcher_Add(dispatcher, sntID, uWAVE_Get_Parser(sntID), rdata, callback, param);
+}
+
+// Sentence builders
+
+// Sentences without parameters, checksums are computed at compile time
+static constexpr auto uWAVE_PT_SETTINGS_READ_SNT = UCNL_NMEA_Const_Sentence("PUWVD,0");
+static constexpr auto uWAVE_PT_ABORT_SEND_SNT = UCNL_NMEA_Const_Sentence("PUWVG,0,0,");
+static constexpr auto uWAVE_AQPNG_SETTINGS_READ_SNT = UCNL_NMEA_Const_Sentence("PUWVN,0");
+static constexpr auto uWAVE_DINFO_GET_SNT = UCNL_NMEA_Const_Sentence("PUWV?,0");
+
+void uWAVE_Build_SETTINGS_WRITE(uWAVE_SETTINGS_WRITE_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_Writer_Struct writer;
+
+  UCNL_NMEA_Writer_Init(   &writer, buffer, bufferSize);
+  UCNL_NMEA_Writer_Str(    &writer, "PUWV1,");
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->rxChID, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->txChID, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_Float(  &writer, sdata->styPSU, 0, 1);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isCmdMode, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isACKOnTXFinished, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_Float(  &writer, sdata->gravityAcc, 4, 0);
+  UCNL_NMEA_Writer_Finish( &writer, idx);
+}
+
+void uWAVE_Build_RC_REQUEST(uWAVE_RC_REQUEST_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_Writer_Struct writer;
+
+  UCNL_NMEA_Writer_Init(   &writer, buffer, bufferSize);
+  UCNL_NMEA_Writer_Str(    &writer, "PUWV2,");
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->txChID, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->rxChID, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->rcCmdID, 0);
+  UCNL_NMEA_Writer_Finish( &writer, idx);
+}
+
+void uWAVE_Build_AMB_DTA_CFG(uWAVE_AMB_DTA_CFG_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_Writer_Struct writer;
+
+  UCNL_NMEA_Writer_Init(   &writer, buffer, bufferSize);
+  UCNL_NMEA_Writer_Str(    &writer, "PUWV6,");
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isSaveInFlash, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->periodMs, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isPrs, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isTemp, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isDpt, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isBatV, 0);
+  UCNL_NMEA_Writer_Finish( &writer, idx);
+}
+
+void uWAVE_Build_INC_DTA_CFG(uWAVE_INC_DTA_CFG_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_Writer_Struct writer;
+
+  UCNL_NMEA_Writer_Init(   &writer, buffer, bufferSize);
+  UCNL_NMEA_Writer_Str(    &writer, "PUWV8,");
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isSaveInFlash, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->periodMs, 0);
+  UCNL_NMEA_Writer_Finish( &writer, idx);
+}
+
+void uWAVE_Build_PT_SETTINGS_READ(byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_WRITE_CONST(buffer, bufferSize, idx, uWAVE_PT_SETTINGS_READ_SNT);
+}
+
+void uWAVE_Build_PT_SETTINGS_WRITE(uWAVE_PT_SETTINGS_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_Writer_Struct writer;
+
+  UCNL_NMEA_Writer_Init(   &writer, buffer, bufferSize);
+  UCNL_NMEA_Writer_Str(    &writer, "PUWVF,");
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isSaveInFlash, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isPtEnabled, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->ptAddress, 0);
+  UCNL_NMEA_Writer_Finish( &writer, idx);
+}
+
+void uWAVE_Build_PT_SEND(uWAVE_PT_PACKET_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_Writer_Struct writer;
+
+  UCNL_NMEA_Writer_Init(   &writer, buffer, bufferSize);
+  UCNL_NMEA_Writer_Str(    &writer, "PUWVG,");
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->ptAddress, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->tries, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_HexArray(&writer, sdata->dataPacket, sdata->dataPacketSize);
+  UCNL_NMEA_Writer_Finish( &writer, idx);
+}
+
+void uWAVE_Build_PT_ABORT_SEND(byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_WRITE_CONST(buffer, bufferSize, idx, uWAVE_PT_ABORT_SEND_SNT);
+}
+
+void uWAVE_Build_PT_ITG(uWAVE_PT_ITG_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_Writer_Struct writer;
+
+  UCNL_NMEA_Writer_Init(   &writer, buffer, bufferSize);
+  UCNL_NMEA_Writer_Str(    &writer, "PUWVK,");
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->ptAddress, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->pt_itg_dataID, 0);
+  UCNL_NMEA_Writer_Finish( &writer, idx);
+}
+
+void uWAVE_Build_AQPNG_SETTINGS_READ(byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_WRITE_CONST(buffer, bufferSize, idx, uWAVE_AQPNG_SETTINGS_READ_SNT);
+}
+
+void uWAVE_Build_AQPNG_SETTINGS(uWAVE_AQPNG_SETTINGS_Struct* sdata, byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_Writer_Struct writer;
+
+  UCNL_NMEA_Writer_Init(   &writer, buffer, bufferSize);
+  UCNL_NMEA_Writer_Str(    &writer, "PUWVO,");
+
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isSaveInFlash, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->aqpng_Mode, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+
+  if (sdata->isPeriod)
+    UCNL_NMEA_Writer_IntDec( &writer, sdata->periodMs, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+
+  if (sdata->isDataID)
+    UCNL_NMEA_Writer_IntDec( &writer, sdata->dataID, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->rcTxID, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->rcRxID, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->isPT, 0);
+  UCNL_NMEA_Writer_Byte(   &writer, UCNL_NMEA_PAR_SEP);
+
+  UCNL_NMEA_Writer_IntDec( &writer, sdata->pt_targetAddr, 0);
+
+  UCNL_NMEA_Writer_Finish( &writer, idx);
+}
+
+void uWAVE_Build_DINFO_GET(byte* buffer, byte bufferSize, byte* idx)
+{
+  UCNL_NMEA_WRITE_CONST(buffer, bufferSize, idx, uWAVE_DINFO_GET_SNT);
+}
@@ -0,0 +1,481 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+#include "ucnl_nmea.h"
+#include "ucnl_uwave.h"
+#include "ucnl_wphx.h"
+#include "ucnl_uwtxn.h"
+
+// Sentences the engine takes from the dispatcher
+static const long uWAVE_TXN_SNT_IDS[] = {
+  uWAVE_NMEA_UWV0_SNT_ID,
+  uWAVE_NMEA_UWV3_SNT_ID,
+  uWAVE_NMEA_UWV4_SNT_ID,
+  uWAVE_NMEA_UWVE_SNT_ID,
+  uWAVE_NMEA_UWVH_SNT_ID,
+  uWAVE_NMEA_UWVI_SNT_ID,
+  uWAVE_NMEA_UWVL_SNT_ID,
+  uWAVE_NMEA_UWVM_SNT_ID,
+  uWAVE_NMEA_UWVO_SNT_ID,
+  uWAVE_NMEA_UWV_EXCL_SNT_ID
+};
+
+// How a command completes
+typedef struct {
+  long okSntID;        // result sentence, 0 - the command is complete on its ACK
+  long failSntID;      // the remote did not answer, 0 - the result comes from the local modem
+  bool isFailParsed;   // the fail sentence has the result structure of the result sentence
+} uWAVE_TXN_Info_Struct;
+
+static bool uWAVE_TXN_Get_Info(const uWAVE_TXN_Request_Struct* req, uWAVE_TXN_Info_Struct* info)
+{
+  info->okSntID = 0;
+  info->failSntID = 0;
+  info->isFailParsed = false;
+
+  switch (req->cmdID)
+  {
+    case IC_H2D_SETTINGS_WRITE:
+    case IC_H2D_AMB_DTA_CFG:
+    case IC_H2D_INC_DTA_CFG:
+    case IC_H2H_PT_SETTINGS_WRITE:
+    case IC_HDH_AQPNG_SETTINGS:
+      break;
+    case IC_H2D_RC_REQUEST:
+      info->okSntID = uWAVE_NMEA_UWV3_SNT_ID;
+      info->failSntID = uWAVE_NMEA_UWV4_SNT_ID;
+      break;
+    case IC_H2D_PT_SEND:
+      // broadcast packets are not answered
+      if (req->sdata.pt_packet.ptAddress != uWAVE_PKT_BCAST_ADDR)
+      {
+        info->okSntID = uWAVE_NMEA_UWVI_SNT_ID;
+        info->failSntID = uWAVE_NMEA_UWVH_SNT_ID;
+        info->isFailParsed = true;
+      }
+      break;
+    case IC_H2D_PT_ITG:
+      info->okSntID = uWAVE_NMEA_UWVM_SNT_ID;
+      info->failSntID = uWAVE_NMEA_UWVL_SNT_ID;
+      break;
+    case IC_H2D_PT_SETTINGS_READ:
+      info->okSntID = uWAVE_NMEA_UWVE_SNT_ID;
+      break;
+    case IC_H2D_AQPNG_SETTINGS_READ:
+      info->okSntID = uWAVE_NMEA_UWVO_SNT_ID;
+      break;
+    case IC_H2D_DINFO_GET:
+      info->okSntID = uWAVE_NMEA_UWV_EXCL_SNT_ID;
+      break;
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+static void uWAVE_TXN_Build(uWAVE_TXN_Request_Struct* req, byte* buffer, byte bufferSize, byte* idx)
+{
+  *idx = 0;
+
+  switch (req->cmdID)
+  {
+    case IC_H2D_SETTINGS_WRITE:      uWAVE_Build_SETTINGS_WRITE(&req->sdata.settings, buffer, bufferSize, idx); break;
+    case IC_H2D_RC_REQUEST:          uWAVE_Build_RC_REQUEST(&req->sdata.rc_request, buffer, bufferSize, idx); break;
+    case IC_H2D_AMB_DTA_CFG:         uWAVE_Build_AMB_DTA_CFG(&req->sdata.amb_dta_cfg, buffer, bufferSize, idx); break;
+    case IC_H2D_INC_DTA_CFG:         uWAVE_Build_INC_DTA_CFG(&req->sdata.inc_dta_cfg, buffer, bufferSize, idx); break;
+    case IC_H2D_PT_SETTINGS_READ:    uWAVE_Build_PT_SETTINGS_READ(buffer, bufferSize, idx); break;
+    case IC_H2H_PT_SETTINGS_WRITE:   uWAVE_Build_PT_SETTINGS_WRITE(&req->sdata.pt_settings, buffer, bufferSize, idx); break;
+    case IC_H2D_PT_SEND:             uWAVE_Build_PT_SEND(&req->sdata.pt_packet, buffer, bufferSize, idx); break;
+    case IC_H2D_PT_ITG:              uWAVE_Build_PT_ITG(&req->sdata.pt_itg, buffer, bufferSize, idx); break;
+    case IC_H2D_AQPNG_SETTINGS_READ: uWAVE_Build_AQPNG_SETTINGS_READ(buffer, bufferSize, idx); break;
+    case IC_HDH_AQPNG_SETTINGS:      uWAVE_Build_AQPNG_SETTINGS(&req->sdata.aqpng_settings, buffer, bufferSize, idx); break;
+    case IC_H2D_DINFO_GET:           uWAVE_Build_DINFO_GET(buffer, bufferSize, idx); break;
+    default: break;
+  }
+}
+
+static void uWAVE_TXN_Set_State(uWAVE_TXN_Engine_Struct* engine, uWAVE_TXN_State_Enum state, unsigned long timeout_ms)
+{
+  engine->state = state;
+  engine->ts = engine->clock();
+  engine->timeout_ms = timeout_ms;
+}
+
+// Removes the request in flight from the queue and reports it, the next one is started by the caller
+static void uWAVE_TXN_Complete(uWAVE_TXN_Engine_Struct* engine, uWAVE_TXN_Status_Enum status, long sntID)
+{
+  uWAVE_TXN_Request_Struct* req = engine->head;
+
+  engine->head = req->next;
+  if (engine->head == NULL)
+    engine->tail = NULL;
+  engine->state = uWAVE_TXN_STATE_IDLE;
+
+  req->next = NULL;
+  req->resultSntID = sntID;
+  req->status = status;
+
+  if (req->callback != NULL)
+    req->callback(req, req->param);
+}
+
+static void uWAVE_TXN_Send(uWAVE_TXN_Engine_Struct* engine)
+{
+  uWAVE_TXN_Request_Struct* req = engine->head;
+  byte idx;
+
+  uWAVE_TXN_Build(req, engine->buffer, engine->buffer_size, &idx);
+
+  if (idx == 0)
+  {
+    req->errCode = LOC_ERR_TX_BUFFER_OVERRUN;
+    uWAVE_TXN_Complete(engine, uWAVE_TXN_STATUS_ERROR, 0);
+  }
+  else
+  {
+    engine->write(engine->buffer, idx, engine->write_param);
+    uWAVE_TXN_Set_State(engine, uWAVE_TXN_STATE_WAIT_ACK, uWAVE_TXN_ACK_TIMEOUT_MS);
+  }
+}
+
+// Sends queued requests until one is in flight, requests that can not be built are completed on the way
+static void uWAVE_TXN_Start_Next(uWAVE_TXN_Engine_Struct* engine)
+{
+  while ((engine->state == uWAVE_TXN_STATE_IDLE) && (engine->head != NULL))
+    uWAVE_TXN_Send(engine);
+}
+
+static void uWAVE_TXN_OnACK(uWAVE_TXN_Engine_Struct* engine, uWAVE_TXN_Request_Struct* req, const uWAVE_TXN_Info_Struct* info)
+{
+  uWAVE_ERR_CODES_Enum errCode = engine->ack.errCode;
+  unsigned long roundTrip_ms;
+
+  if ((errCode == LOC_ERR_NO_ERROR) || (errCode == LOC_ERR_TX_FINISHED))
+  {
+    if (info->failSntID != 0)
+      uWAVE_TXN_Set_State(engine, uWAVE_TXN_STATE_WAIT_RESULT, uWAVE_TXN_RoundTrip_ms(engine, req));
+    else if (info->okSntID != 0)
+      uWAVE_TXN_Set_State(engine, uWAVE_TXN_STATE_WAIT_ACK, uWAVE_TXN_ACK_TIMEOUT_MS);   // the requested data follows
+    else
+    {
+      // a broadcast packet keeps the transmitter busy until it is sent
+      roundTrip_ms = uWAVE_TXN_RoundTrip_ms(engine, req);
+      if (roundTrip_ms == 0)
+        uWAVE_TXN_Complete(engine, uWAVE_TXN_STATUS_OK, uWAVE_NMEA_UWV0_SNT_ID);
+      else
+        uWAVE_TXN_Set_State(engine, uWAVE_TXN_STATE_WAIT_RESULT, roundTrip_ms);
+    }
+  }
+  else if (((errCode == LOC_ERR_TRANSMITTER_BUSY) || (errCode == LOC_ERR_RECEIVER_BUSY)) &&
+           (req->retries < uWAVE_TXN_BUSY_RETRIES))
+  {
+    req->retries++;
+    uWAVE_TXN_Set_State(engine, uWAVE_TXN_STATE_WAIT_RETRY, uWAVE_TXN_BUSY_RETRY_MS);
+  }
+  else
+  {
+    req->errCode = errCode;
+    uWAVE_TXN_Complete(engine, uWAVE_TXN_STATUS_ERROR, uWAVE_NMEA_UWV0_SNT_ID);
+  }
+}
+
+static bool uWAVE_TXN_Field_Is(const UCNL_NMEA_State_Struct* uState, byte n, long value)
+{
+  byte stIdx, ndIdx;
+
+  if (n >= uState->fields.num)
+    return false;
+
+  UCNL_NMEA_Get_Field(&uState->fields, n, &stIdx, &ndIdx);
+  return (ndIdx >= stIdx) && (UCNL_STR_ParseIntDec(uState->buffer, stIdx, ndIdx) == value);
+}
+
+// Checks that a result sentence belongs to the request: same remote, same command or data ID
+static bool uWAVE_TXN_Is_Result_Of(const uWAVE_TXN_Request_Struct* req, const UCNL_NMEA_State_Struct* uState)
+{
+  switch (req->cmdID)
+  {
+    case IC_H2D_RC_REQUEST:
+      // $PUWV3/4,txChID,rcCmdID,...
+      return uWAVE_TXN_Field_Is(uState, 2, req->sdata.rc_request.rcCmdID);
+    case IC_H2D_PT_SEND:
+      // $PUWVH/I,target_ptAddress,triesTaken,...
+      return uWAVE_TXN_Field_Is(uState, 1, req->sdata.pt_packet.ptAddress);
+    case IC_H2D_PT_ITG:
+      // $PUWVL/M,target_ptAddress,pt_itg_dataID,...
+      return uWAVE_TXN_Field_Is(uState, 1, req->sdata.pt_itg.ptAddress) &&
+             uWAVE_TXN_Field_Is(uState, 2, req->sdata.pt_itg.pt_itg_dataID);
+    default:
+      return true;
+  }
+}
+
+static void uWAVE_TXN_OnSentence(UCNL_NMEA_State_Struct* uState, void* param)
+{
+  uWAVE_TXN_Engine_Struct* engine = (uWAVE_TXN_Engine_Struct*)param;
+  uWAVE_TXN_Request_Struct* req = engine->head;
+  uWAVE_TXN_Info_Struct info;
+  long sntID = uState->sntID;
+
+  if ((req != NULL) &&
+      ((engine->state == uWAVE_TXN_STATE_WAIT_ACK) || (engine->state == uWAVE_TXN_STATE_WAIT_RESULT)))
+  {
+    uWAVE_TXN_Get_Info(req, &info);
+
+    if (sntID == uWAVE_NMEA_UWV0_SNT_ID)
+    {
+      if (uWAVE_Parse_ACK_Fields(&engine->ack, uState->buffer, &uState->fields) &&
+          (engine->ack.sentenceID == req->cmdID))
+      {
+        // ACKs that follow the first one, e.g. on the transmission end, are dropped
+        if (engine->state == uWAVE_TXN_STATE_WAIT_ACK)
+        {
+          uWAVE_TXN_OnACK(engine, req, &info);
+          uWAVE_TXN_Start_Next(engine);
+        }
+        return;
+      }
+    }
+    else if (((sntID == info.okSntID) || (sntID == info.failSntID)) && uWAVE_TXN_Is_Result_Of(req, uState))
+    {
+      if ((req->rdata != NULL) && ((sntID == info.okSntID) || info.isFailParsed))
+      {
+        uWAVE_Get_Parser(sntID)(req->rdata, uState->buffer, &uState->fields);
+
+        if ((sntID == uWAVE_NMEA_UWV_EXCL_SNT_ID) && (((uWAVE_DINFO_Struct*)req->rdata)->acBaudrate > 0))
+          engine->acBaudrate = ((uWAVE_DINFO_Struct*)req->rdata)->acBaudrate;
+      }
+
+      uWAVE_TXN_Complete(engine, (sntID == info.okSntID) ? uWAVE_TXN_STATUS_OK : uWAVE_TXN_STATUS_REM_TIMEOUT, sntID);
+      uWAVE_TXN_Start_Next(engine);
+      return;
+    }
+  }
+
+  if (engine->unsolicited != NULL)
+    engine->unsolicited(uState, engine->unsolicited_param);
+}
+
+/* Initializes a transaction engine
+   "buffer" output buffer for the sentences, owned by the caller
+   "buffer_size" its size, bytes
+   "write" writes a sentence to the modem's port
+   "write_param" user parameter passed to "write", e.g. a Stream*
+   "clock" monotonic milliseconds, e.g. millis
+*/
+void uWAVE_TXN_InitStruct(uWAVE_TXN_Engine_Struct* engine, byte* buffer, byte buffer_size,
+                          uWAVE_TXN_Write_Func write, void* write_param, uWAVE_TXN_Clock_Func clock)
+{
+  engine->head = NULL;
+  engine->tail = NULL;
+  engine->state = uWAVE_TXN_STATE_IDLE;
+  engine->ts = 0;
+  engine->timeout_ms = 0;
+
+  engine->buffer = buffer;
+  engine->buffer_size = buffer_size;
+  engine->write = write;
+  engine->write_param = write_param;
+  engine->clock = clock;
+
+  engine->unsolicited = NULL;
+  engine->unsolicited_param = NULL;
+
+  engine->sound_speed_mps = UCNL_WPHX_FWTR_SOUND_SPEED_MPS;
+  engine->max_range_m = uWAVE_TXN_MAX_RANGE_M;
+  engine->acBaudrate = uWAVE_TXN_AC_BAUDRATE_BPS;
+}
+
+/* Registers the engine's sentences: $PUWV0, 3, 4, E, H, I, L, M, O and ! in a dispatcher
+   These IDs must not be registered in the dispatcher by other means, the sentences that
+   are not results of the request in flight are passed to "unsolicited" instead
+   "unsolicited" may be NULL, "param" user parameter passed to it
+   returns false if the sentence IDs table of the dispatcher is full
+*/
+bool uWAVE_TXN_Dispatcher_Add(uWAVE_TXN_Engine_Struct* engine, UCNL_NMEA_Dispatcher_Struct* dispatcher,
+                              UCNL_NMEA_Sentence_Callback unsolicited, void* param)
+{
+  byte i;
+
+  engine->unsolicited = unsolicited;
+  engine->unsolicited_param = param;
+
+  for (i = 0; i < sizeof(uWAVE_TXN_SNT_IDS) / sizeof(uWAVE_TXN_SNT_IDS[0]); i++)
+  {
+    if (!UCNL_NMEA_SntIDs_Add(&dispatcher->table, uWAVE_TXN_SNT_IDS[i], uWAVE_TXN_OnSentence, engine))
+      return false;
+  }
+
+  return true;
+}
+
+/* Prepares a request, the command parameters go to the sdata member of the command afterwards
+   "cmdID" IC_H2D_xxx command
+   "rdata" result structure of the command's result sentence: uWAVE_RC_RESPONSE_Struct for IC_H2D_RC_REQUEST,
+   uWAVE_PT_PACKET_Struct for IC_H2D_PT_SEND, uWAVE_PT_ITG_RESP_Struct for IC_H2D_PT_ITG, uWAVE_DINFO_Struct
+   for IC_H2D_DINFO_GET etc. with the buffers its parser fills, or NULL if the result values are not needed
+   "callback" is called when the request is complete, may be NULL
+   "param" user parameter passed to the callback
+*/
+void uWAVE_TXN_Init_Request(uWAVE_TXN_Request_Struct* req, char cmdID, void* rdata, uWAVE_TXN_Callback callback, void* param)
+{
+  memset(req, 0, sizeof(uWAVE_TXN_Request_Struct));
+  req->cmdID = cmdID;
+  req->rdata = rdata;
+  req->callback = callback;
+  req->param = param;
+  req->status = uWAVE_TXN_STATUS_NONE;
+}
+
+/* Queues a request, it is sent at once if the engine is idle
+   returns false if the request is already pending or the command is not supported
+*/
+bool uWAVE_TXN_Submit(uWAVE_TXN_Engine_Struct* engine, uWAVE_TXN_Request_Struct* req)
+{
+  uWAVE_TXN_Info_Struct info;
+
+  if ((req->status == uWAVE_TXN_STATUS_PENDING) || !uWAVE_TXN_Get_Info(req, &info))
+    return false;
+
+  req->status = uWAVE_TXN_STATUS_PENDING;
+  req->errCode = LOC_ERR_NO_ERROR;
+  req->resultSntID = 0;
+  req->retries = 0;
+  req->next = NULL;
+
+  if (engine->tail == NULL)
+    engine->head = req;
+  else
+    engine->tail->next = req;
+  engine->tail = req;
+
+  uWAVE_TXN_Start_Next(engine);
+  return true;
+}
+
+/* Removes a queued request, the callback is called with uWAVE_TXN_STATUS_CANCELED
+   returns false if the request is in flight or is not queued
+*/
+bool uWAVE_TXN_Cancel(uWAVE_TXN_Engine_Struct* engine, uWAVE_TXN_Request_Struct* req)
+{
+  uWAVE_TXN_Request_Struct* prev = NULL;
+  uWAVE_TXN_Request_Struct* r = engine->head;
+
+  if ((req == engine->head) && (engine->state != uWAVE_TXN_STATE_IDLE))
+    return false;
+
+  while ((r != NULL) && (r != req))
+  {
+    prev = r;
+    r = r->next;
+  }
+
+  if (r == NULL)
+    return false;
+
+  if (prev == NULL)
+    engine->head = req->next;
+  else
+    prev->next = req->next;
+
+  if (engine->tail == req)
+    engine->tail = prev;
+
+  req->next = NULL;
+  req->status = uWAVE_TXN_STATUS_CANCELED;
+
+  if (req->callback != NULL)
+    req->callback(req, req->param);
+
+  return true;
+}
+
+// Handles timeouts and busy retries, call it from the main loop
+void uWAVE_TXN_Poll(uWAVE_TXN_Engine_Struct* engine)
+{
+  uWAVE_TXN_Info_Struct info;
+
+  if ((engine->state != uWAVE_TXN_STATE_IDLE) && (engine->clock() - engine->ts >= engine->timeout_ms))
+  {
+    switch (engine->state)
+    {
+      case uWAVE_TXN_STATE_WAIT_ACK:
+        uWAVE_TXN_Complete(engine, uWAVE_TXN_STATUS_LOC_TIMEOUT, 0);
+        break;
+      case uWAVE_TXN_STATE_WAIT_RESULT:
+        uWAVE_TXN_Get_Info(engine->head, &info);
+        uWAVE_TXN_Complete(engine, (info.okSntID == 0) ? uWAVE_TXN_STATUS_OK : uWAVE_TXN_STATUS_NO_RESULT, 0);
+        break;
+      case uWAVE_TXN_STATE_WAIT_RETRY:
+        uWAVE_TXN_Send(engine);
+        break;
+      default:
+        break;
+    }
+  }
+
+  uWAVE_TXN_Start_Next(engine);
+}
+
+// returns true if there are no requests queued or in flight
+bool uWAVE_TXN_Is_Idle(const uWAVE_TXN_Engine_Struct* engine)
+{
+  return (engine->head == NULL);
+}
+
+// Time on air of an acoustic message of "bits" bits
+unsigned long uWAVE_TXN_Airtime_ms(const uWAVE_TXN_Engine_Struct* engine, int bits)
+{
+  return uWAVE_TXN_AC_MSG_OVERHEAD_MS + (unsigned long)(bits * 1000.0f / engine->acBaudrate);
+}
+
+/* Expected time from the ACK of a request to its result: the request and the response times on air,
+   the propagation there and back over the request's range (or the max range) and a guard interval,
+   for packets - for every try. The modem reports a silent remote itself once its own remote timeout
+   is over, so a try is never expected to take less than uWAVE_TXN_REM_TIMEOUT_MS: a shorter wait would
+   complete the request before that report and send the next command to a modem that is still busy.
+   0 for the commands that do not use the acoustic channel
+*/
+unsigned long uWAVE_TXN_RoundTrip_ms(const uWAVE_TXN_Engine_Struct* engine, const uWAVE_TXN_Request_Struct* req)
+{
+  float range_m = (req->range_m > 0) ? req->range_m : engine->max_range_m;
+  unsigned long prop_ms = (unsigned long)(2000.0f * range_m / engine->sound_speed_mps);
+  unsigned long try_ms;
+  byte tries = 1;
+
+  switch (req->cmdID)
+  {
+    case IC_H2D_RC_REQUEST:
+      try_ms = uWAVE_TXN_Airtime_ms(engine, uWAVE_TXN_AC_CODE_BITS) + prop_ms +
+               uWAVE_TXN_Airtime_ms(engine, uWAVE_TXN_AC_CODE_BITS + uWAVE_TXN_AC_VALUE_BITS);
+      break;
+    case IC_H2D_PT_ITG:
+      try_ms = uWAVE_TXN_Airtime_ms(engine, uWAVE_TXN_AC_PT_HEADER_BITS + uWAVE_TXN_AC_CODE_BITS) + prop_ms +
+               uWAVE_TXN_Airtime_ms(engine, uWAVE_TXN_AC_PT_HEADER_BITS + uWAVE_TXN_AC_CODE_BITS + uWAVE_TXN_AC_VALUE_BITS);
+      break;
+    case IC_H2D_PT_SEND:
+      try_ms = uWAVE_TXN_Airtime_ms(engine, uWAVE_TXN_AC_PT_HEADER_BITS + req->sdata.pt_packet.dataPacketSize * 8);
+      if (req->sdata.pt_packet.ptAddress == uWAVE_PKT_BCAST_ADDR)
+        return try_ms;
+
+      tries = (req->sdata.pt_packet.tries > 0) ? req->sdata.pt_packet.tries : 1;
+      try_ms += prop_ms + uWAVE_TXN_Airtime_ms(engine, uWAVE_TXN_AC_PT_HEADER_BITS);
+      break;
+    default:
+      return 0;
+  }
+
+  if (try_ms < uWAVE_TXN_REM_TIMEOUT_MS)
+    try_ms = uWAVE_TXN_REM_TIMEOUT_MS;
+
+  return tries * try_ms + uWAVE_TXN_GUARD_MS;
+}
@@ -0,0 +1,152 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#ifndef _UCNL_UWTXN_
+#define _UCNL_UWTXN_
+
+#include "ucnl_nmea.h"
+#include "ucnl_uwave.h"
+
+// uWave transaction engine: a queue of commands for one modem, which handles one command at a time.
+// The next command is sent as soon as the previous one is complete: on its ACK for local commands,
+// on the remote's result ($PUWV3/4, $PUWVH/I, $PUWVL/M) for the ones that go over the acoustic channel
+
+#ifndef uWAVE_TXN_ACK_TIMEOUT_MS
+#define uWAVE_TXN_ACK_TIMEOUT_MS      (1000)     // local modem answer, ACK or the requested data
+#endif
+
+#ifndef uWAVE_TXN_GUARD_MS
+#define uWAVE_TXN_GUARD_MS            (500)      // added to the expected acoustic round trip
+#endif
+
+#ifndef uWAVE_TXN_BUSY_RETRIES
+#define uWAVE_TXN_BUSY_RETRIES        (3)        // resends of a command the modem rejected as busy
+#endif
+
+#ifndef uWAVE_TXN_BUSY_RETRY_MS
+#define uWAVE_TXN_BUSY_RETRY_MS       (250)
+#endif
+
+#ifndef uWAVE_TXN_REM_TIMEOUT_MS
+#define uWAVE_TXN_REM_TIMEOUT_MS      (4000)     // the modem's own wait for a remote, it reports $PUWV4, $PUWVL or $PUWVH after it
+#endif
+
+// Acoustic channel defaults, the engine fields can be updated at runtime
+#ifndef uWAVE_TXN_MAX_RANGE_M
+#define uWAVE_TXN_MAX_RANGE_M         (1000.0f)  // longest expected range to a remote
+#endif
+#define uWAVE_TXN_AC_BAUDRATE_BPS     (78.0f)    // replaced by acBaudrate when a DINFO request completes
+#define uWAVE_TXN_AC_MSG_OVERHEAD_MS  (400)      // preamble, decoding and turnaround of an acoustic message
+
+// Approximate acoustic message sizes, bits
+#define uWAVE_TXN_AC_CODE_BITS        (8)        // RC command or response code
+#define uWAVE_TXN_AC_VALUE_BITS       (16)       // a value in a RC or PT_ITG response
+#define uWAVE_TXN_AC_PT_HEADER_BITS   (24)       // packet mode address and service fields
+
+typedef enum {
+  uWAVE_TXN_STATUS_NONE           = 0,   // not submitted
+  uWAVE_TXN_STATUS_PENDING        = 1,   // queued or in flight
+  uWAVE_TXN_STATUS_OK             = 2,   // complete, "rdata" holds the result if there is one
+  uWAVE_TXN_STATUS_ERROR          = 3,   // the modem rejected the command, see errCode
+  uWAVE_TXN_STATUS_REM_TIMEOUT    = 4,   // the remote did not answer: $PUWV4, $PUWVL or $PUWVH
+  uWAVE_TXN_STATUS_LOC_TIMEOUT    = 5,   // no answer from the local modem
+  uWAVE_TXN_STATUS_NO_RESULT      = 6,   // no result within the expected acoustic round trip
+  uWAVE_TXN_STATUS_CANCELED       = 7,
+  uWAVE_TXN_STATUS_UNKNOWN
+} uWAVE_TXN_Status_Enum;
+
+#define uWAVE_TXN_IS_DONE(req)        ((req)->status > uWAVE_TXN_STATUS_PENDING)
+
+typedef enum {
+  uWAVE_TXN_STATE_IDLE            = 0,
+  uWAVE_TXN_STATE_WAIT_ACK        = 1,
+  uWAVE_TXN_STATE_WAIT_RESULT     = 2,
+  uWAVE_TXN_STATE_WAIT_RETRY      = 3
+} uWAVE_TXN_State_Enum;
+
+struct uWAVE_TXN_Request_Struct_t;
+
+// Called once a request is complete, req->status tells how
+typedef void (*uWAVE_TXN_Callback)(struct uWAVE_TXN_Request_Struct_t* req, void* param);
+
+// Writes a sentence to the modem's port
+typedef void (*uWAVE_TXN_Write_Func)(const byte* data, byte size, void* param);
+
+// Monotonic milliseconds, e.g. millis
+typedef unsigned long (*uWAVE_TXN_Clock_Func)(void);
+
+/* A request is owned by the caller and stays untouched by the caller until it is complete,
+   so it serves as a future as well: uWAVE_TXN_IS_DONE(req) can be polled instead of using a callback
+*/
+typedef struct uWAVE_TXN_Request_Struct_t {
+  char cmdID;                             // IC_H2D_xxx command
+  union {
+    uWAVE_SETTINGS_WRITE_Struct settings;
+    uWAVE_RC_REQUEST_Struct rc_request;
+    uWAVE_AMB_DTA_CFG_Struct amb_dta_cfg;
+    uWAVE_INC_DTA_CFG_Struct inc_dta_cfg;
+    uWAVE_PT_SETTINGS_Struct pt_settings;
+    uWAVE_PT_PACKET_Struct pt_packet;
+    uWAVE_PT_ITG_Struct pt_itg;
+    uWAVE_AQPNG_SETTINGS_Struct aqpng_settings;
+  } sdata;                                // command parameters, the member of the command
+  void* rdata;                            // result structure of the command's result sentence or NULL
+  float range_m;                          // expected range to the remote, 0 - the engine's max_range_m
+  uWAVE_TXN_Callback callback;
+  void* param;
+
+  // set by the engine
+  volatile uWAVE_TXN_Status_Enum status;
+  uWAVE_ERR_CODES_Enum errCode;           // ACK error code for uWAVE_TXN_STATUS_ERROR
+  long resultSntID;                       // the sentence that completed the request, 0 if none
+  byte retries;
+  struct uWAVE_TXN_Request_Struct_t* next;
+} uWAVE_TXN_Request_Struct;
+
+typedef struct {
+  uWAVE_TXN_Request_Struct* head;         // in flight unless the engine is idle
+  uWAVE_TXN_Request_Struct* tail;
+  uWAVE_TXN_State_Enum state;
+  unsigned long ts;                       // the current state started
+  unsigned long timeout_ms;               // the current state lasts
+
+  byte* buffer;
+  byte buffer_size;
+  uWAVE_TXN_Write_Func write;
+  void* write_param;
+  uWAVE_TXN_Clock_Func clock;
+
+  // sentences of the engine's IDs that are not a result of the request in flight
+  UCNL_NMEA_Sentence_Callback unsolicited;
+  void* unsolicited_param;
+
+  uWAVE_ACK_RESULT_Struct ack;
+
+  // acoustic channel
+  float sound_speed_mps;
+  float max_range_m;
+  float acBaudrate;
+} uWAVE_TXN_Engine_Struct;
+
+
+void          uWAVE_TXN_InitStruct(uWAVE_TXN_Engine_Struct* engine, byte* buffer, byte buffer_size,
+                                   uWAVE_TXN_Write_Func write, void* write_param, uWAVE_TXN_Clock_Func clock);
+bool          uWAVE_TXN_Dispatcher_Add(uWAVE_TXN_Engine_Struct* engine, UCNL_NMEA_Dispatcher_Struct* dispatcher,
+                                       UCNL_NMEA_Sentence_Callback unsolicited, void* param);
+
+void          uWAVE_TXN_Init_Request(uWAVE_TXN_Request_Struct* req, char cmdID, void* rdata, uWAVE_TXN_Callback callback, void* param);
+bool          uWAVE_TXN_Submit(uWAVE_TXN_Engine_Struct* engine, uWAVE_TXN_Request_Struct* req);
+bool          uWAVE_TXN_Cancel(uWAVE_TXN_Engine_Struct* engine, uWAVE_TXN_Request_Struct* req);
+void          uWAVE_TXN_Poll(uWAVE_TXN_Engine_Struct* engine);
+bool          uWAVE_TXN_Is_Idle(const uWAVE_TXN_Engine_Struct* engine);
+
+unsigned long uWAVE_TXN_Airtime_ms(const uWAVE_TXN_Engine_Struct* engine, int bits);
+unsigned long uWAVE_TXN_RoundTrip_ms(const uWAVE_TXN_Engine_Struct* engine, const uWAVE_TXN_Request_Struct* req);
+
+#endif
@@ -1,201 +1,516 @@
-/*
-Copyright (C) 2021, Underwater communication & navigation laboratory
-All rights reserved.
-
-www.unavlab.com
-hello@unavlab.com
-
-*/
-
-#include "Arduino.h"
-#include "ucnl_vlbl.h"
-
-void UCNL_VLBL_Points_Ring_Reset(VLBL_Points_Ring_Struct* vlblRing)
-{
-  vlblRing->idx = 0;
-  vlblRing->cnt = 0;
-}
-
-void UCNL_VLBL_ResetStructs(VLBL_Points_Ring_Struct* vlblRing, VLBL_Ring_Struct* lrRing)
-{
-  vlblRing->idx = 0;
-  vlblRing->cnt = 0;
-
-  lrRing->cnt = 0;
-  lrRing->idx = 0;
-  lrRing->drms_best = 10E+6;
-}
-
-void UCNL_VLBL_AddPoint(VLBL_Points_Ring_Struct* vlblRing, float x, float y, float d)
-{
-  vlblRing->xs[vlblRing->idx] = x;
-  vlblRing->ys[vlblRing->idx] = y;
-  vlblRing->ds[vlblRing->idx] = d;
-
-  vlblRing->idx = (vlblRing->idx + 1) % VLBL_POINTS_RING_SIZE;
-  if (vlblRing->cnt < VLBL_POINTS_RING_SIZE)
-    vlblRing->cnt++;
-}
-
-void UCNL_VLBL_Heap_UpdateCentroids(VLBL_Ring_Struct* lrRing)
-{
-  if (lrRing->cnt <= 0) return;
-  
-  lrRing->clx = 0;
-  lrRing->cly = 0;
-  lrRing->crx = 0;
-  lrRing->cry = 0;
-  
-  for (int n = 0; n < lrRing->cnt; n++)
-  {
-    lrRing->clx += lrRing->lxs[n];
-    lrRing->cly += lrRing->lys[n];
-    lrRing->crx += lrRing->rxs[n];
-    lrRing->cry += lrRing->rys[n];
-  }
-
-  lrRing->clx /= lrRing->cnt;
-  lrRing->cly /= lrRing->cnt;
-  lrRing->crx /= lrRing->cnt;
-  lrRing->cry /= lrRing->cnt;
-}
-
-void UCNL_VLBL_Heap_UpdateDRMSs(VLBL_Ring_Struct* lrRing)
-{
-  if (lrRing->cnt <= 0) return;
-
-  float delta;
-  float l_sigma_x = 0;
-  float l_sigma_y = 0;
-  float r_sigma_x = 0;
-  float r_sigma_y = 0;
-  
-  for (int n = 0; n < lrRing->cnt; n++)
-  {
-    delta = lrRing->lxs[n] - lrRing->clx;
-    l_sigma_x += delta * delta;
-
-    delta = lrRing->lys[n] - lrRing->cly;
-    l_sigma_y += delta * delta;
-
-    delta = lrRing->rxs[n] - lrRing->crx;
-    r_sigma_x += delta * delta;
-
-    delta = lrRing->rys[n] - lrRing->cry;
-    r_sigma_y += delta * delta;
-  }
-
-  l_sigma_x /= lrRing->cnt;
-  l_sigma_y /= lrRing->cnt;
-  r_sigma_x /= lrRing->cnt;
-  r_sigma_y /= lrRing->cnt;
-
-  lrRing->l_drms = sqrt(l_sigma_x * l_sigma_x + l_sigma_y * l_sigma_y);
-  lrRing->r_drms = sqrt(r_sigma_x * r_sigma_x + r_sigma_y * r_sigma_y);
-}
-
-void UCNL_VLBL_Heap_ProcessPoints(VLBL_Ring_Struct* lrRing, float x1, float y1, float x2, float y2)
-{
-  if (lrRing->cnt == 0)
-  {
-    lrRing->lxs[0] = x1;
-    lrRing->lys[0] = y1;
-    lrRing->rxs[0] = x2;
-    lrRing->rys[0] = y2;
-    lrRing->idx = 1;
-    lrRing->cnt = 1;
-    lrRing->clx = x1;
-    lrRing->cly = y1;
-    lrRing->crx = x2;
-    lrRing->cry = y2;
-    lrRing->l_drms = -1;
-    lrRing->r_drms = -1;
-
-    lrRing->x = 0;
-    lrRing->y = 0;
-    lrRing->drms = 1E+6;
-    
-    lrRing->x_best = 0;
-    lrRing->y_best = 0;
-    lrRing->drms_best = 1E+6;
-  }
-  else
-  {
-    // find which point to which heap fits better
-    float dst;
-    float dst_min = UCNL_NAV_Dist2D(x1, y1, lrRing->clx, lrRing->cly);
-    byte dst_min_idx = 0;
-    
-    dst = UCNL_NAV_Dist2D(x1, y1, lrRing->crx, lrRing->cry);
-    if (dst < dst_min) { dst_min = dst; dst_min_idx = 1; }
-
-    dst = UCNL_NAV_Dist2D(x2, y2, lrRing->clx, lrRing->cly);
-    if (dst < dst_min) { dst_min = dst; dst_min_idx = 2; }
-    
-    dst = UCNL_NAV_Dist2D(x2, y2, lrRing->crx, lrRing->cry);
-    if (dst < dst_min) { dst_min = dst; dst_min_idx = 3; }
-
-    if ((dst_min_idx == 0) || (dst_min_idx == 3))
-    {
-      lrRing->lxs[lrRing->idx] = x1;
-      lrRing->lys[lrRing->idx] = y1;
-      lrRing->rxs[lrRing->idx] = x2;
-      lrRing->rys[lrRing->idx] = y2;
-    }
-    else
-    {
-      lrRing->lxs[lrRing->idx] = x2;
-      lrRing->lys[lrRing->idx] = y2;
-      lrRing->rxs[lrRing->idx] = x1;
-      lrRing->rys[lrRing->idx] = y1;
-    }
-
-    lrRing->idx = (lrRing->idx + 1) % VLBL_HEAPS_RING_SIZE;
-    if (lrRing->cnt < VLBL_HEAPS_RING_SIZE) lrRing->cnt++;
-
-    // recalculate centroids of both heaps
-    UCNL_VLBL_Heap_UpdateCentroids(lrRing);
-
-    // recalculate DRMS values of both heaps
-    UCNL_VLBL_Heap_UpdateDRMSs(lrRing);
-    
-    if (lrRing->l_drms < lrRing->r_drms)
-    {
-      lrRing->x = lrRing->clx;
-      lrRing->y = lrRing->cly;
-      lrRing->drms = lrRing->l_drms;
-    }
-    else
-    {
-      lrRing->x = lrRing->crx;
-      lrRing->y = lrRing->cry;
-      lrRing->drms = lrRing->r_drms;
-    }
-
-    if (lrRing->drms < lrRing->drms_best)
-    {
-      lrRing->drms_best = lrRing->drms;
-      lrRing->x_best = lrRing->x;
-      lrRing->y_best = lrRing->y;      
-    }
-  }
-}
-
-void UCNL_VLBL_Clusterize(VLBL_Points_Ring_Struct* vlblRing, VLBL_Ring_Struct* lrRing, float x, float y, float d)
-{
-  float ix1, iy1, ix2, iy2;
-
-  for (int n = 0; n < vlblRing->cnt; n++)
-  {
-    if (UCNL_NAV_CirclesIntersection(vlblRing->xs[n], vlblRing->ys[n], vlblRing->ds[n],
-                                     x, y, d,
-                                     &ix1, &iy1, &ix2, &iy2))
-      {
-        // ok, there are two points of intersection
-        // put it to the heaps
-        UCNL_VLBL_Heap_ProcessPoints(lrRing, ix1, iy1, ix2, iy2);
-      }
-  }
-    
-  UCNL_VLBL_AddPoint(vlblRing, x, y, d);
-}
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#include "Arduino.h"
+#include "ucnl_vlbl.h"
+
+void UCNL_VLBL_Points_Ring_Reset(VLBL_Points_Ring_Struct* vlblRing)
+{
+  UCNL_VLBL_Points_Ring_Reset_T<VLBL_POINTS_RING_SIZE>(vlblRing);
+}
+
+void UCNL_VLBL_ResetStructs(VLBL_Points_Ring_Struct* vlblRing, VLBL_Ring_Struct* lrRing)
+{
+  UCNL_VLBL_ResetStructs_T<VLBL_POINTS_RING_SIZE, VLBL_HEAPS_RING_SIZE>(vlblRing, lrRing);
+}
+
+void UCNL_VLBL_AddPoint(VLBL_Points_Ring_Struct* vlblRing, float x, float y, float d)
+{
+  UCNL_VLBL_AddPoint_T<VLBL_POINTS_RING_SIZE>(vlblRing, x, y, d);
+}
+
+void UCNL_VLBL_Heap_UpdateCentroids(VLBL_Ring_Struct* lrRing)
+{
+  UCNL_VLBL_Heap_UpdateCentroids_T<VLBL_HEAPS_RING_SIZE>(lrRing);
+}
+
+void UCNL_VLBL_Heap_UpdateDRMSs(VLBL_Ring_Struct* lrRing)
+{
+  UCNL_VLBL_Heap_UpdateDRMSs_T<VLBL_HEAPS_RING_SIZE>(lrRing);
+}
+
+void UCNL_VLBL_Heap_ProcessPoints(VLBL_Ring_Struct* lrRing, float x1, float y1, float x2, float y2)
+{
+  UCNL_VLBL_Heap_ProcessPoints_T<VLBL_HEAPS_RING_SIZE>(lrRing, x1, y1, x2, y2);
+}
+
+void UCNL_VLBL_Clusterize(VLBL_Points_Ring_Struct* vlblRing, VLBL_Ring_Struct* lrRing, float x, float y, float d)
+{
+  UCNL_VLBL_Clusterize_T<VLBL_POINTS_RING_SIZE, VLBL_HEAPS_RING_SIZE>(vlblRing, lrRing, x, y, d);
+}
+
+
+
+// Least-squares solver. The remote is at (x, y) in the local frame, the range to it
+// from the i-th point is sqrt((x - xi)^2 + (y - yi)^2 + dzi^2), dzi is the depth difference
+
+/* Sum of squared range residuals at (x, y), if "a11" is not NULL also the normal
+   equations: J'J = [a11 a12; a12 a22], J'e = [b1; b2]
+*/
+static float UCNL_VLBL_LSQ_Normals(const VLBL_LSQ_Struct* lsq, float x, float y,
+                                   float* a11, float* a12, float* a22, float* b1, float* b2)
+{
+  float dx, dy, rho, e, jx, jy;
+  float rss = 0;
+
+  if (a11 != NULL)
+  {
+    *a11 = 0;
+    *a12 = 0;
+    *a22 = 0;
+    *b1 = 0;
+    *b2 = 0;
+  }
+
+  for (int n = 0; n < lsq->cnt; n++)
+  {
+    dx = x - lsq->xs[n];
+    dy = y - lsq->ys[n];
+    rho = sqrt(dx * dx + dy * dy + lsq->dzs[n] * lsq->dzs[n]);
+    e = lsq->rs[n] - rho;
+    rss += e * e;
+
+    if ((a11 != NULL) && (rho > VLBL_LSQ_STEP_EPS_M))
+    {
+      jx = dx / rho;
+      jy = dy / rho;
+      *a11 += jx * jx;
+      *a12 += jx * jy;
+      *a22 += jy * jy;
+      *b1 += jx * e;
+      *b2 += jy * e;
+    }
+  }
+
+  return rss;
+}
+
+/* The first fix: the new range circle is intersected with every stored one
+   and the intersection with the least residuals is taken as the starting point
+*/
+static bool UCNL_VLBL_LSQ_Seed(VLBL_LSQ_Struct* lsq, byte newIdx)
+{
+  float ix[2], iy[2], r1, r2, rss;
+  float rss_min = -1;
+
+  r1 = lsq->rs[newIdx] * lsq->rs[newIdx] - lsq->dzs[newIdx] * lsq->dzs[newIdx];
+  r1 = r1 > 0 ? sqrt(r1) : 0;
+
+  for (int n = 0; n < lsq->cnt; n++)
+  {
+    if (n == newIdx) continue;
+
+    r2 = lsq->rs[n] * lsq->rs[n] - lsq->dzs[n] * lsq->dzs[n];
+    r2 = r2 > 0 ? sqrt(r2) : 0;
+
+    if (UCNL_NAV_CirclesIntersection(lsq->xs[n], lsq->ys[n], r2,
+                                     lsq->xs[newIdx], lsq->ys[newIdx], r1,
+                                     &ix[0], &iy[0], &ix[1], &iy[1]))
+    {
+      for (int k = 0; k < 2; k++)
+      {
+        rss = UCNL_VLBL_LSQ_Normals(lsq, ix[k], iy[k], NULL, NULL, NULL, NULL, NULL);
+        if ((rss_min < 0) || (rss < rss_min))
+        {
+          rss_min = rss;
+          lsq->x = ix[k];
+          lsq->y = iy[k];
+        }
+      }
+    }
+  }
+
+  return (rss_min >= 0);
+}
+
+/* "range_sigma_m" a priori range error, the covariance is not reported less than it
+   gives even if the ranges fit better
+*/
+void UCNL_VLBL_LSQ_Reset(VLBL_LSQ_Struct* lsq, float range_sigma_m)
+{
+  lsq->cnt = 0;
+  lsq->idx = 0;
+  lsq->x = 0;
+  lsq->y = 0;
+  lsq->cxx = 0;
+  lsq->cxy = 0;
+  lsq->cyy = 0;
+  lsq->drms = 1E+6;
+  lsq->rms = 0;
+  lsq->lambda = 1E-3;
+  lsq->range_var = range_sigma_m * range_sigma_m;
+  lsq->iterations = 0;
+  lsq->is_valid = false;
+}
+
+/* Adds a range and updates the fix, returns true if the fix is valid
+   "x", "y" measurement point in the local frame
+   "range_m" slant range (propagation time times sound speed)
+   "d_dpt_m" depth difference between the modems
+
+   Up to VLBL_LSQ_MAX_ITERATIONS damped Gauss-Newton steps are made from the previous
+   fix, the covariance is sigma^2 * inv(J'J), sigma^2 from the residuals
+*/
+bool UCNL_VLBL_LSQ_AddRange(VLBL_LSQ_Struct* lsq, float x, float y, float range_m, float d_dpt_m)
+{
+  float a11, a12, a22, b1, b2, rss, rss_new, det, dx, dy, s2;
+  byte newIdx = lsq->idx;
+
+  lsq->xs[newIdx] = x;
+  lsq->ys[newIdx] = y;
+  lsq->rs[newIdx] = range_m;
+  lsq->dzs[newIdx] = d_dpt_m;
+
+  lsq->idx = (lsq->idx + 1) % VLBL_LSQ_RING_SIZE;
+  if (lsq->cnt < VLBL_LSQ_RING_SIZE)
+    lsq->cnt++;
+
+  lsq->iterations = 0;
+
+  if (!lsq->is_valid)
+  {
+    if (!UCNL_VLBL_LSQ_Seed(lsq, newIdx))
+      return false;
+    lsq->lambda = 1E-3;
+  }
+
+  rss = UCNL_VLBL_LSQ_Normals(lsq, lsq->x, lsq->y, &a11, &a12, &a22, &b1, &b2);
+
+  while (lsq->iterations < VLBL_LSQ_MAX_ITERATIONS)
+  {
+    lsq->iterations++;
+
+    // Marquardt's scaling of the diagonal
+    det = a11 * (1 + lsq->lambda) * a22 * (1 + lsq->lambda) - a12 * a12;
+    if (det <= 0)
+      break;
+
+    dx = (b1 * a22 * (1 + lsq->lambda) - b2 * a12) / det;
+    dy = (b2 * a11 * (1 + lsq->lambda) - b1 * a12) / det;
+
+    rss_new = UCNL_VLBL_LSQ_Normals(lsq, lsq->x + dx, lsq->y + dy, NULL, NULL, NULL, NULL, NULL);
+    if (rss_new <= rss)
+    {
+      lsq->x += dx;
+      lsq->y += dy;
+      if (lsq->lambda > 1E-6)
+        lsq->lambda *= 0.1f;
+      rss = UCNL_VLBL_LSQ_Normals(lsq, lsq->x, lsq->y, &a11, &a12, &a22, &b1, &b2);
+
+      if (sqrt(dx * dx + dy * dy) < VLBL_LSQ_STEP_EPS_M)
+        break;
+    }
+    else if (lsq->lambda < 1E+6)
+      lsq->lambda *= 10.0f;
+  }
+
+  lsq->rms = sqrt(rss / lsq->cnt);
+
+  // two ranges give two mirrored solutions, points on a line do not tell the side
+  det = a11 * a22 - a12 * a12;
+  lsq->is_valid = (lsq->cnt >= 3) && (det > 1E-4f * (a11 + a22) * (a11 + a22));
+
+  if (lsq->is_valid)
+  {
+    s2 = rss / (lsq->cnt - 2);
+    if (s2 < lsq->range_var)
+      s2 = lsq->range_var;
+
+    lsq->cxx = s2 * a22 / det;
+    lsq->cxy = -s2 * a12 / det;
+    lsq->cyy = s2 * a11 / det;
+    lsq->drms = sqrt(lsq->cxx + lsq->cyy);
+  }
+
+  return lsq->is_valid;
+}
+
+
+
+// Kalman filter. Azimuths are clockwise from the y axis: atan2(x - xi, y - yi),
+// where (xi, yi) is the measurement point
+
+/* "accel_sigma_mps2" remote's manoeuvring (white noise acceleration)
+   "speed_sigma_mps" remote's speed when the filter starts
+   "range_sigma_m" slant range error
+   "azimuth_sigma_rad" azimuth error
+*/
+void UCNL_VLBL_KF_Init(VLBL_KF_Struct* kf, float accel_sigma_mps2, float speed_sigma_mps, float range_sigma_m, float azimuth_sigma_rad)
+{
+  kf->accel_var = accel_sigma_mps2 * accel_sigma_mps2;
+  kf->speed_var = speed_sigma_mps * speed_sigma_mps;
+  kf->range_var = range_sigma_m * range_sigma_m;
+  kf->azimuth_var = azimuth_sigma_rad * azimuth_sigma_rad;
+  kf->drms = 1E+6;
+  kf->rejects = 0;
+  kf->is_initialized = false;
+}
+
+// Starts the filter at a known position, e.g. a VLBL_LSQ_Struct fix, the remote is assumed still
+void UCNL_VLBL_KF_Start(VLBL_KF_Struct* kf, float x, float y, float pos_sigma_m)
+{
+  memset(kf->P, 0, sizeof(kf->P));
+
+  kf->x = x;
+  kf->y = y;
+  kf->vx = 0;
+  kf->vy = 0;
+  kf->P[0][0] = pos_sigma_m * pos_sigma_m;
+  kf->P[1][1] = pos_sigma_m * pos_sigma_m;
+  kf->P[2][2] = kf->speed_var;
+  kf->P[3][3] = kf->speed_var;
+  kf->drms = sqrt(kf->P[0][0] + kf->P[1][1]);
+  kf->rejects = 0;
+  kf->is_initialized = true;
+}
+
+void UCNL_VLBL_KF_Predict(VLBL_KF_Struct* kf, float dt_s)
+{
+  if (!kf->is_initialized || (dt_s <= 0)) return;
+
+  float q11 = kf->accel_var * dt_s * dt_s * dt_s / 3;
+  float q12 = kf->accel_var * dt_s * dt_s / 2;
+  float q22 = kf->accel_var * dt_s;
+  int i;
+
+  kf->x += kf->vx * dt_s;
+  kf->y += kf->vy * dt_s;
+
+  // P = F * P * F' + Q, F adds dt times the rates to the positions
+  for (i = 0; i < 4; i++)
+  {
+    kf->P[i][0] += dt_s * kf->P[i][2];
+    kf->P[i][1] += dt_s * kf->P[i][3];
+  }
+  for (i = 0; i < 4; i++)
+  {
+    kf->P[0][i] += dt_s * kf->P[2][i];
+    kf->P[1][i] += dt_s * kf->P[3][i];
+  }
+
+  kf->P[0][0] += q11;
+  kf->P[1][1] += q11;
+  kf->P[0][2] += q12;
+  kf->P[2][0] += q12;
+  kf->P[1][3] += q12;
+  kf->P[3][1] += q12;
+  kf->P[2][2] += q22;
+  kf->P[3][3] += q22;
+
+  kf->drms = sqrt(kf->P[0][0] + kf->P[1][1]);
+}
+
+/* Scalar measurement update, the measurement depends on the position only: "hx", "hy" its
+   derivatives, "innovation" measured minus predicted. Returns false if the measurement is rejected
+*/
+static bool UCNL_VLBL_KF_Update(VLBL_KF_Struct* kf, float hx, float hy, float innovation, float r_var)
+{
+  float ph[4], k[4], s;
+  int i, j;
+
+  for (i = 0; i < 4; i++)
+    ph[i] = kf->P[i][0] * hx + kf->P[i][1] * hy;
+
+  s = hx * ph[0] + hy * ph[1] + r_var;
+
+  if (innovation * innovation > VLBL_KF_GATE * s)
+  {
+    if (++kf->rejects >= VLBL_KF_MAX_REJECTS)
+      kf->is_initialized = false;
+    return false;
+  }
+
+  kf->rejects = 0;
+
+  for (i = 0; i < 4; i++)
+    k[i] = ph[i] / s;
+
+  kf->x += k[0] * innovation;
+  kf->y += k[1] * innovation;
+  kf->vx += k[2] * innovation;
+  kf->vy += k[3] * innovation;
+
+  // P = P - K * (H * P), kept symmetric
+  for (i = 0; i < 4; i++)
+    for (j = i; j < 4; j++)
+    {
+      kf->P[i][j] -= k[i] * ph[j];
+      kf->P[j][i] = kf->P[i][j];
+    }
+
+  kf->drms = sqrt(kf->P[0][0] + kf->P[1][1]);
+
+  return true;
+}
+
+/* "x", "y" measurement point, "range_m" slant range, "d_dpt_m" depth difference.
+   Returns false if the filter is not started or the range is rejected
+*/
+bool UCNL_VLBL_KF_Update_Range(VLBL_KF_Struct* kf, float x, float y, float range_m, float d_dpt_m)
+{
+  if (!kf->is_initialized) return false;
+
+  float dx = kf->x - x;
+  float dy = kf->y - y;
+  float rho = sqrt(dx * dx + dy * dy + d_dpt_m * d_dpt_m);
+
+  if (rho < VLBL_LSQ_STEP_EPS_M) return false;
+
+  return UCNL_VLBL_KF_Update(kf, dx / rho, dy / rho, range_m - rho, kf->range_var);
+}
+
+bool UCNL_VLBL_KF_Update_Azimuth(VLBL_KF_Struct* kf, float x, float y, float azimuth_rad)
+{
+  if (!kf->is_initialized) return false;
+
+  float dx = kf->x - x;
+  float dy = kf->y - y;
+  float r2 = dx * dx + dy * dy;
+
+  // the azimuth tells nothing right above the remote
+  if (r2 < VLBL_LSQ_STEP_EPS_M) return false;
+
+  return UCNL_VLBL_KF_Update(kf, dy / r2, -dx / r2, UCNL_NAV_WrapPI(azimuth_rad - atan2(dx, dy)), kf->azimuth_var);
+}
+
+/* Predicts by "dt_s" and takes a range and, if "isAzimuth", an azimuth from the point (x, y).
+   A range with an azimuth starts the filter if it is not started yet.
+   Returns true if the measurements are taken
+*/
+bool UCNL_VLBL_KF_Process(VLBL_KF_Struct* kf, float dt_s, float x, float y, float range_m, float d_dpt_m,
+                          bool isAzimuth, float azimuth_rad)
+{
+  bool result;
+
+  if (!kf->is_initialized)
+  {
+    if (!isAzimuth) return false;
+
+    float h = range_m * range_m - d_dpt_m * d_dpt_m;
+    h = (h > 0) ? sqrt(h) : 0;
+
+    UCNL_VLBL_KF_Start(kf, x + h * sin(azimuth_rad), y + h * cos(azimuth_rad),
+                       sqrt(kf->range_var + h * h * kf->azimuth_var));
+    return true;
+  }
+
+  UCNL_VLBL_KF_Predict(kf, dt_s);
+  result = UCNL_VLBL_KF_Update_Range(kf, x, y, range_m, d_dpt_m);
+
+  if (isAzimuth && kf->is_initialized)
+    result = UCNL_VLBL_KF_Update_Azimuth(kf, x, y, azimuth_rad) && result;
+
+  return result;
+}
+
+
+
+// Multi-target tracker
+
+/* "targets" caller-owned array of "targets_size" entries, no more remotes can be tracked at once
+   "range_sigma_m" a priori range error for every target's solver
+*/
+bool UCNL_VLBL_Tracker_Init(VLBL_Tracker_Struct* tracker, VLBL_Target_Struct* targets, byte targets_size, float range_sigma_m)
+{
+  if ((targets == NULL) || (targets_size == 0))
+    return false;
+
+  tracker->targets = targets;
+  tracker->targets_size = targets_size;
+  tracker->range_sigma_m = range_sigma_m;
+  UCNL_VLBL_Tracker_Reset(tracker);
+
+  return true;
+}
+
+// Forgets all the targets
+void UCNL_VLBL_Tracker_Reset(VLBL_Tracker_Struct* tracker)
+{
+  tracker->num = 0;
+  memset(tracker->slots, VLBL_TRACKER_NO_SLOT, sizeof(tracker->slots));
+}
+
+// Returns the target with the address, NULL if it is not tracked
+VLBL_Target_Struct* UCNL_VLBL_Tracker_Get_Target(VLBL_Tracker_Struct* tracker, byte ptAddress)
+{
+  byte slot = tracker->slots[ptAddress];
+  return (slot == VLBL_TRACKER_NO_SLOT) ? NULL : &tracker->targets[slot];
+}
+
+// Starts tracking the address, returns its target (the existing one if it is tracked already), NULL if all the targets are in use
+VLBL_Target_Struct* UCNL_VLBL_Tracker_Add_Target(VLBL_Tracker_Struct* tracker, byte ptAddress)
+{
+  VLBL_Target_Struct* target = UCNL_VLBL_Tracker_Get_Target(tracker, ptAddress);
+
+  if ((target == NULL) && (ptAddress != VLBL_TRACKER_BCAST_ADDR) && (tracker->num < tracker->targets_size))
+  {
+    target = &tracker->targets[tracker->num];
+    target->ptAddress = ptAddress;
+    UCNL_VLBL_LSQ_Reset(&target->lsq, tracker->range_sigma_m);
+
+    tracker->slots[ptAddress] = tracker->num;
+    tracker->num++;
+  }
+
+  return target;
+}
+
+// The last target takes the place of the removed one, so the targets stay contiguous
+void UCNL_VLBL_Tracker_Remove_Target(VLBL_Tracker_Struct* tracker, byte ptAddress)
+{
+  byte slot = tracker->slots[ptAddress];
+
+  if (slot != VLBL_TRACKER_NO_SLOT)
+  {
+    tracker->num--;
+    if (slot != tracker->num)
+    {
+      tracker->targets[slot] = tracker->targets[tracker->num];
+      tracker->slots[tracker->targets[slot].ptAddress] = slot;
+    }
+
+    tracker->slots[ptAddress] = VLBL_TRACKER_NO_SLOT;
+  }
+}
+
+/* Routes a range to the target with the address, the target is added if it is not tracked yet.
+   Returns true if the target has a valid fix, false if it has not or there is no room for it
+   "x", "y", "range_m", "d_dpt_m" as in UCNL_VLBL_LSQ_AddRange
+*/
+bool UCNL_VLBL_Tracker_AddRange(VLBL_Tracker_Struct* tracker, byte ptAddress, float x, float y, float range_m, float d_dpt_m)
+{
+  VLBL_Target_Struct* target = UCNL_VLBL_Tracker_Add_Target(tracker, ptAddress);
+
+  if (target == NULL)
+    return false;
+
+  return UCNL_VLBL_LSQ_AddRange(&target->lsq, x, y, range_m, d_dpt_m);
+}
+
+// Copies up to "fixes_size" valid fixes of all the targets, returns the number of the fixes copied
+byte UCNL_VLBL_Tracker_Get_Fixes(const VLBL_Tracker_Struct* tracker, VLBL_Fix_Struct* fixes, byte fixes_size)
+{
+  byte n, num = 0;
+  const VLBL_Target_Struct* target;
+
+  for (n = 0; (n < tracker->num) && (num < fixes_size); n++)
+  {
+    target = &tracker->targets[n];
+    if (target->lsq.is_valid)
+    {
+      fixes[num].ptAddress = target->ptAddress;
+      fixes[num].x = target->lsq.x;
+      fixes[num].y = target->lsq.y;
+      fixes[num].drms = target->lsq.drms;
+      num++;
+    }
+  }
+
+  return num;
+}
@@ -1,57 +1,407 @@
-/*
-Copyright (C) 2021, Underwater communication & navigation laboratory
-All rights reserved.
-
-www.unavlab.com
-hello@unavlab.com
-
-*/
-
-#ifndef _UCNL_VLBL_
-#define _UCNL_VLBL_
-
-#include "ucnl_nav.h"
-
-#define VLBL_POINTS_RING_SIZE (3)
-#define VLBL_HEAPS_RING_SIZE  (4)
-
-typedef struct
-{
-  float xs[VLBL_POINTS_RING_SIZE];
-  float ys[VLBL_POINTS_RING_SIZE];
-  float ds[VLBL_POINTS_RING_SIZE];
-  byte cnt;
-  byte idx;  
-} VLBL_Points_Ring_Struct;
-
-typedef struct
-{
-  float lxs[VLBL_HEAPS_RING_SIZE];
-  float lys[VLBL_HEAPS_RING_SIZE];
-  float rxs[VLBL_HEAPS_RING_SIZE];
-  float rys[VLBL_HEAPS_RING_SIZE];
-  byte cnt;
-  byte idx;
-  float clx;
-  float cly;
-  float crx;
-  float cry;
-  float l_drms;
-  float r_drms;
-  float x;
-  float y;
-  float drms;
-  float x_best;
-  float y_best;
-  float drms_best;
-} VLBL_Ring_Struct;
-
-void UCNL_VLBL_ResetStructs(VLBL_Points_Ring_Struct* vlblRing, VLBL_Ring_Struct* lrRing);
-void UCNL_VLBL_Points_Ring_Reset(VLBL_Points_Ring_Struct* vlblRing);
-void UCNL_VLBL_AddPoint(VLBL_Points_Ring_Struct* vlblRing, float x, float y, float d);
-void UCNL_VLBL_Heap_UpdateCentroids(VLBL_Ring_Struct* lrRing);
-void UCNL_VLBL_Heap_UpdateDRMSs(VLBL_Ring_Struct* lrRing);
-void UCNL_VLBL_Heap_ProcessPoints(VLBL_Ring_Struct* lrRing, float x1, float y1, float x2, float y2);
-void UCNL_VLBL_Clusterize(VLBL_Points_Ring_Struct* vlblRing, VLBL_Ring_Struct* lrRing, float x, float y, float d);
-
-#endif
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#ifndef _UCNL_VLBL_
+#define _UCNL_VLBL_
+
+#include "ucnl_nav.h"
+
+#define VLBL_POINTS_RING_SIZE (3)
+#define VLBL_HEAPS_RING_SIZE  (4)
+
+#ifndef VLBL_LSQ_RING_SIZE
+#ifdef __AVR__
+#define VLBL_LSQ_RING_SIZE    (8)        // ranges used by the least-squares solver
+#else
+#define VLBL_LSQ_RING_SIZE    (32)
+#endif
+#endif
+
+#define VLBL_LSQ_MAX_ITERATIONS (5)      // per range, so the update cost is fixed
+#define VLBL_LSQ_STEP_EPS_M     (0.001f)
+
+#define VLBL_KF_GATE            (16.0f)  // squared innovation over its variance, measurements beyond 4 sigma are rejected
+#define VLBL_KF_MAX_REJECTS     (4)      // the filter starts over after so many rejections in a row
+
+#define VLBL_TRACKER_ADDR_NUM   (256)    // packet mode addresses
+#define VLBL_TRACKER_BCAST_ADDR (255)    // uWAVE_PKT_BCAST_ADDR, is not tracked
+#define VLBL_TRACKER_NO_SLOT    (0xFF)
+
+// Ring indexes fit a byte on small rings, AVR builds stay as tiny as they were
+template <bool isSmall> struct VLBL_Index_Sel_T { typedef byte Type; };
+template <> struct VLBL_Index_Sel_T<false> { typedef unsigned int Type; };
+
+template <unsigned int N>
+struct VLBL_Points_Ring_T
+{
+  float xs[N];
+  float ys[N];
+  float ds[N];
+  typename VLBL_Index_Sel_T<(N < 256)>::Type cnt;
+  typename VLBL_Index_Sel_T<(N < 256)>::Type idx;
+};
+
+template <unsigned int N>
+struct VLBL_Ring_T
+{
+  float lxs[N];
+  float lys[N];
+  float rxs[N];
+  float rys[N];
+  typename VLBL_Index_Sel_T<(N < 256)>::Type cnt;
+  typename VLBL_Index_Sel_T<(N < 256)>::Type idx;
+  float clx;
+  float cly;
+  float crx;
+  float cry;
+  float l_drms;
+  float r_drms;
+  float x;
+  float y;
+  float drms;
+  float x_best;
+  float y_best;
+  float drms_best;
+  float olx, oly, orx, ory;       // origins of the running sums, near the centroids
+  float slx, sly, srx, sry;       // sums of the heaps' points relative to the origins
+  float qlx, qly, qrx, qry;       // sums of their squares
+};
+
+typedef VLBL_Points_Ring_T<VLBL_POINTS_RING_SIZE> VLBL_Points_Ring_Struct;
+typedef VLBL_Ring_T<VLBL_HEAPS_RING_SIZE> VLBL_Ring_Struct;
+
+// Range-only least-squares (Levenberg-Marquardt) solver over the last VLBL_LSQ_RING_SIZE ranges
+typedef struct
+{
+  float xs[VLBL_LSQ_RING_SIZE];
+  float ys[VLBL_LSQ_RING_SIZE];
+  float rs[VLBL_LSQ_RING_SIZE];   // slant ranges
+  float dzs[VLBL_LSQ_RING_SIZE];  // depth differences
+  byte cnt;
+  byte idx;
+  float x;
+  float y;
+  float cxx;                      // covariance of x and y, m^2
+  float cxy;
+  float cyy;
+  float drms;                     // sqrt(cxx + cyy)
+  float rms;                      // RMS of range residuals
+  float lambda;
+  float range_var;
+  byte iterations;
+  bool is_valid;
+} VLBL_LSQ_Struct;
+
+/* Constant velocity extended Kalman filter for moving remotes,
+   state is x, y and their rates, measurements are slant ranges and azimuths
+*/
+typedef struct
+{
+  float x;
+  float y;
+  float vx;
+  float vy;
+  float P[4][4];                  // covariance of x, y, vx, vy
+  float drms;                     // sqrt(P[0][0] + P[1][1])
+  float accel_var;
+  float speed_var;
+  float range_var;
+  float azimuth_var;
+  byte rejects;
+  bool is_initialized;
+} VLBL_KF_Struct;
+
+// A remote tracked by its packet mode address
+typedef struct
+{
+  byte ptAddress;
+  VLBL_LSQ_Struct lsq;
+} VLBL_Target_Struct;
+
+typedef struct
+{
+  byte ptAddress;
+  float x;
+  float y;
+  float drms;
+} VLBL_Fix_Struct;
+
+/* Many remotes at once: targets are kept in a caller-owned array,
+   a range is routed to its target by a direct address table
+*/
+typedef struct
+{
+  VLBL_Target_Struct* targets;
+  byte targets_size;
+  byte num;
+  float range_sigma_m;
+  byte slots[VLBL_TRACKER_ADDR_NUM];   // address -> index in "targets" or VLBL_TRACKER_NO_SLOT
+} VLBL_Tracker_Struct;
+
+void UCNL_VLBL_ResetStructs(VLBL_Points_Ring_Struct* vlblRing, VLBL_Ring_Struct* lrRing);
+void UCNL_VLBL_Points_Ring_Reset(VLBL_Points_Ring_Struct* vlblRing);
+void UCNL_VLBL_AddPoint(VLBL_Points_Ring_Struct* vlblRing, float x, float y, float d);
+void UCNL_VLBL_Heap_UpdateCentroids(VLBL_Ring_Struct* lrRing);
+void UCNL_VLBL_Heap_UpdateDRMSs(VLBL_Ring_Struct* lrRing);
+void UCNL_VLBL_Heap_ProcessPoints(VLBL_Ring_Struct* lrRing, float x1, float y1, float x2, float y2);
+void UCNL_VLBL_Clusterize(VLBL_Points_Ring_Struct* vlblRing, VLBL_Ring_Struct* lrRing, float x, float y, float d);
+
+void UCNL_VLBL_LSQ_Reset(VLBL_LSQ_Struct* lsq, float range_sigma_m);
+bool UCNL_VLBL_LSQ_AddRange(VLBL_LSQ_Struct* lsq, float x, float y, float range_m, float d_dpt_m);
+
+void UCNL_VLBL_KF_Init(VLBL_KF_Struct* kf, float accel_sigma_mps2, float speed_sigma_mps, float range_sigma_m, float azimuth_sigma_rad);
+void UCNL_VLBL_KF_Start(VLBL_KF_Struct* kf, float x, float y, float pos_sigma_m);
+void UCNL_VLBL_KF_Predict(VLBL_KF_Struct* kf, float dt_s);
+bool UCNL_VLBL_KF_Update_Range(VLBL_KF_Struct* kf, float x, float y, float range_m, float d_dpt_m);
+bool UCNL_VLBL_KF_Update_Azimuth(VLBL_KF_Struct* kf, float x, float y, float azimuth_rad);
+bool UCNL_VLBL_KF_Process(VLBL_KF_Struct* kf, float dt_s, float x, float y, float range_m, float d_dpt_m,
+                          bool isAzimuth, float azimuth_rad);
+
+bool UCNL_VLBL_Tracker_Init(VLBL_Tracker_Struct* tracker, VLBL_Target_Struct* targets, byte targets_size, float range_sigma_m);
+void UCNL_VLBL_Tracker_Reset(VLBL_Tracker_Struct* tracker);
+VLBL_Target_Struct* UCNL_VLBL_Tracker_Get_Target(VLBL_Tracker_Struct* tracker, byte ptAddress);
+VLBL_Target_Struct* UCNL_VLBL_Tracker_Add_Target(VLBL_Tracker_Struct* tracker, byte ptAddress);
+void UCNL_VLBL_Tracker_Remove_Target(VLBL_Tracker_Struct* tracker, byte ptAddress);
+bool UCNL_VLBL_Tracker_AddRange(VLBL_Tracker_Struct* tracker, byte ptAddress, float x, float y, float range_m, float d_dpt_m);
+byte UCNL_VLBL_Tracker_Get_Fixes(const VLBL_Tracker_Struct* tracker, VLBL_Fix_Struct* fixes, byte fixes_size);
+
+
+// The C API above is the VLBL_POINTS_RING_SIZE/VLBL_HEAPS_RING_SIZE instantiation of the templates below.
+// Centroids and DRMSs are taken from running sums, an update costs the same for any capacity
+
+template <unsigned int N>
+void UCNL_VLBL_Points_Ring_Reset_T(VLBL_Points_Ring_T<N>* vlblRing)
+{
+  vlblRing->idx = 0;
+  vlblRing->cnt = 0;
+}
+
+template <unsigned int P, unsigned int H>
+void UCNL_VLBL_ResetStructs_T(VLBL_Points_Ring_T<P>* vlblRing, VLBL_Ring_T<H>* lrRing)
+{
+  vlblRing->idx = 0;
+  vlblRing->cnt = 0;
+
+  lrRing->cnt = 0;
+  lrRing->idx = 0;
+  lrRing->drms_best = 10E+6;
+}
+
+template <unsigned int N>
+void UCNL_VLBL_AddPoint_T(VLBL_Points_Ring_T<N>* vlblRing, float x, float y, float d)
+{
+  vlblRing->xs[vlblRing->idx] = x;
+  vlblRing->ys[vlblRing->idx] = y;
+  vlblRing->ds[vlblRing->idx] = d;
+
+  vlblRing->idx = (vlblRing->idx + 1) % N;
+  if (vlblRing->cnt < N)
+    vlblRing->cnt++;
+}
+
+// Adds (sign = 1) or removes (sign = -1) the points of the "n"-th slot to/from the running sums
+template <unsigned int N>
+void UCNL_VLBL_Heap_Sum_T(VLBL_Ring_T<N>* lrRing, unsigned int n, float sign)
+{
+  float delta;
+
+  delta = lrRing->lxs[n] - lrRing->olx;
+  lrRing->slx += sign * delta;
+  lrRing->qlx += sign * delta * delta;
+
+  delta = lrRing->lys[n] - lrRing->oly;
+  lrRing->sly += sign * delta;
+  lrRing->qly += sign * delta * delta;
+
+  delta = lrRing->rxs[n] - lrRing->orx;
+  lrRing->srx += sign * delta;
+  lrRing->qrx += sign * delta * delta;
+
+  delta = lrRing->rys[n] - lrRing->ory;
+  lrRing->sry += sign * delta;
+  lrRing->qry += sign * delta * delta;
+}
+
+// Sums the whole ring again around the current centroids: once per ring turn, so rounding errors
+// of the running sums do not accumulate and the cost is still O(1) per update on average
+template <unsigned int N>
+void UCNL_VLBL_Heap_Resum_T(VLBL_Ring_T<N>* lrRing)
+{
+  lrRing->olx = lrRing->clx;
+  lrRing->oly = lrRing->cly;
+  lrRing->orx = lrRing->crx;
+  lrRing->ory = lrRing->cry;
+
+  lrRing->slx = 0;
+  lrRing->sly = 0;
+  lrRing->srx = 0;
+  lrRing->sry = 0;
+  lrRing->qlx = 0;
+  lrRing->qly = 0;
+  lrRing->qrx = 0;
+  lrRing->qry = 0;
+
+  for (unsigned int n = 0; n < lrRing->cnt; n++)
+    UCNL_VLBL_Heap_Sum_T<N>(lrRing, n, 1.0f);
+}
+
+template <unsigned int N>
+void UCNL_VLBL_Heap_UpdateCentroids_T(VLBL_Ring_T<N>* lrRing)
+{
+  if (lrRing->cnt <= 0) return;
+
+  lrRing->clx = lrRing->olx + lrRing->slx / lrRing->cnt;
+  lrRing->cly = lrRing->oly + lrRing->sly / lrRing->cnt;
+  lrRing->crx = lrRing->orx + lrRing->srx / lrRing->cnt;
+  lrRing->cry = lrRing->ory + lrRing->sry / lrRing->cnt;
+}
+
+// Variance is the mean of squares minus the squared mean, both relative to the origin
+static inline float UCNL_VLBL_Variance(float sum, float sum_sq, float cnt)
+{
+  float mean = sum / cnt;
+  float var = sum_sq / cnt - mean * mean;
+
+  return (var > 0) ? var : 0;
+}
+
+template <unsigned int N>
+void UCNL_VLBL_Heap_UpdateDRMSs_T(VLBL_Ring_T<N>* lrRing)
+{
+  if (lrRing->cnt <= 0) return;
+
+  float l_sigma_x = UCNL_VLBL_Variance(lrRing->slx, lrRing->qlx, lrRing->cnt);
+  float l_sigma_y = UCNL_VLBL_Variance(lrRing->sly, lrRing->qly, lrRing->cnt);
+  float r_sigma_x = UCNL_VLBL_Variance(lrRing->srx, lrRing->qrx, lrRing->cnt);
+  float r_sigma_y = UCNL_VLBL_Variance(lrRing->sry, lrRing->qry, lrRing->cnt);
+
+  lrRing->l_drms = sqrt(l_sigma_x * l_sigma_x + l_sigma_y * l_sigma_y);
+  lrRing->r_drms = sqrt(r_sigma_x * r_sigma_x + r_sigma_y * r_sigma_y);
+}
+
+template <unsigned int N>
+void UCNL_VLBL_Heap_ProcessPoints_T(VLBL_Ring_T<N>* lrRing, float x1, float y1, float x2, float y2)
+{
+  if (lrRing->cnt == 0)
+  {
+    lrRing->lxs[0] = x1;
+    lrRing->lys[0] = y1;
+    lrRing->rxs[0] = x2;
+    lrRing->rys[0] = y2;
+    lrRing->idx = 1 % N;
+    lrRing->cnt = 1;
+    lrRing->clx = x1;
+    lrRing->cly = y1;
+    lrRing->crx = x2;
+    lrRing->cry = y2;
+    lrRing->l_drms = -1;
+    lrRing->r_drms = -1;
+
+    lrRing->x = 0;
+    lrRing->y = 0;
+    lrRing->drms = 1E+6;
+
+    lrRing->x_best = 0;
+    lrRing->y_best = 0;
+    lrRing->drms_best = 1E+6;
+
+    UCNL_VLBL_Heap_Resum_T<N>(lrRing);
+  }
+  else
+  {
+    // find which point to which heap fits better
+    float dst;
+    float dst_min = UCNL_NAV_Dist2D(x1, y1, lrRing->clx, lrRing->cly);
+    byte dst_min_idx = 0;
+
+    dst = UCNL_NAV_Dist2D(x1, y1, lrRing->crx, lrRing->cry);
+    if (dst < dst_min) { dst_min = dst; dst_min_idx = 1; }
+
+    dst = UCNL_NAV_Dist2D(x2, y2, lrRing->clx, lrRing->cly);
+    if (dst < dst_min) { dst_min = dst; dst_min_idx = 2; }
+
+    dst = UCNL_NAV_Dist2D(x2, y2, lrRing->crx, lrRing->cry);
+    if (dst < dst_min) { dst_min = dst; dst_min_idx = 3; }
+
+    // the oldest points leave the sums when the ring is full
+    if (lrRing->cnt == N)
+      UCNL_VLBL_Heap_Sum_T<N>(lrRing, lrRing->idx, -1.0f);
+
+    if ((dst_min_idx == 0) || (dst_min_idx == 3))
+    {
+      lrRing->lxs[lrRing->idx] = x1;
+      lrRing->lys[lrRing->idx] = y1;
+      lrRing->rxs[lrRing->idx] = x2;
+      lrRing->rys[lrRing->idx] = y2;
+    }
+    else
+    {
+      lrRing->lxs[lrRing->idx] = x2;
+      lrRing->lys[lrRing->idx] = y2;
+      lrRing->rxs[lrRing->idx] = x1;
+      lrRing->rys[lrRing->idx] = y1;
+    }
+
+    UCNL_VLBL_Heap_Sum_T<N>(lrRing, lrRing->idx, 1.0f);
+
+    lrRing->idx = (lrRing->idx + 1) % N;
+    if (lrRing->cnt < N) lrRing->cnt++;
+
+    // recalculate centroids of both heaps
+    UCNL_VLBL_Heap_UpdateCentroids_T<N>(lrRing);
+
+    if (lrRing->idx == 0)
+      UCNL_VLBL_Heap_Resum_T<N>(lrRing);
+
+    // recalculate DRMS values of both heaps
+    UCNL_VLBL_Heap_UpdateDRMSs_T<N>(lrRing);
+
+    if (lrRing->l_drms < lrRing->r_drms)
+    {
+      lrRing->x = lrRing->clx;
+      lrRing->y = lrRing->cly;
+      lrRing->drms = lrRing->l_drms;
+    }
+    else
+    {
+      lrRing->x = lrRing->crx;
+      lrRing->y = lrRing->cry;
+      lrRing->drms = lrRing->r_drms;
+    }
+
+    if (lrRing->drms < lrRing->drms_best)
+    {
+      lrRing->drms_best = lrRing->drms;
+      lrRing->x_best = lrRing->x;
+      lrRing->y_best = lrRing->y;
+    }
+  }
+}
+
+template <unsigned int P, unsigned int H>
+void UCNL_VLBL_Clusterize_T(VLBL_Points_Ring_T<P>* vlblRing, VLBL_Ring_T<H>* lrRing, float x, float y, float d)
+{
+  float ix1, iy1, ix2, iy2;
+
+  for (unsigned int n = 0; n < vlblRing->cnt; n++)
+  {
+    if (UCNL_NAV_CirclesIntersection(vlblRing->xs[n], vlblRing->ys[n], vlblRing->ds[n],
+                                     x, y, d,
+                                     &ix1, &iy1, &ix2, &iy2))
+      {
+        // ok, there are two points of intersection
+        // put it to the heaps
+        UCNL_VLBL_Heap_ProcessPoints_T<H>(lrRing, ix1, iy1, ix2, iy2);
+      }
+  }
+
+  UCNL_VLBL_AddPoint_T<P>(vlblRing, x, y, d);
+}
+
+#endif
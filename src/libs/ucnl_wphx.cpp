@@ -1,102 +1,565 @@
-/*
-Copyright (C) 2021, Underwater communication & navigation laboratory
-All rights reserved.
-
-www.unavlab.com
-hello@unavlab.com
-
-*/
-
-#include "Arduino.h"
-#include "ucnl_wphx.h"
-
-/// calculates in situ density of water
-/// millero et al 1980, deep-sea res.,27a,255-264
-/// jpots ninth report 1978,tenth report 1980
-float UCNL_WPHX_water_density_calc(float t, float p, float s)
-{
-  p = p / 1000.0;
-  float sr = sqrt(s);
-  float sig = (((4.8314E-4 * s) +
-                ((-1.6546E-6 * t + 1.0227E-4) * t - 5.72466E-3) * sr +
-                (((5.3875E-9 * t - 8.2467E-7) * t + 7.6438E-5) * t - 4.0899E-3) * t + 0.824493) * s) +
-              ((((6.536332E-9 * t - 1.120083E-6) * t + 1.001685E-4) * t - 9.095290E-3) * t + 6.793952E-2) * t - 0.157406;
-
-  float b = ((9.1697E-10 * t + 2.0816E-8) * t - 9.9348E-7) * s + (5.2787E-8 * t - 6.12293E-6) * t + 8.50935E-5;
-
-  float k0 = (((((-5.3009E-4 * t + 1.6483E-2) * t + 7.944E-2) * sr) +
-               ((-6.1670E-5 * t + 1.09987E-2) * t - 0.603459) * t + 54.6746) * s) +
-             (((-5.155288E-5 * t + 1.360477E-2) * t - 2.327105) * t + 148.4206) * t + 19652.21;
-
-  float a = (1.91075E-4 * sr + (-1.6078E-6 * t - 1.0981E-5) * t + 2.2838E-3) * s +
-            ((-5.77905E-7 * t + 1.16092E-4) * t + 1.43713E-3) * t + 3.239908;
-
-  float k = (b * p + a) * p + k0;
-
-  return 1000.0f + (k * sig + 1000.0 * p) / (k - p);
-}
-
-/// The UNESCO equation: Chen and Millero (1977)
-float UCNL_WPHX_speed_of_sound_UNESCO_calc(float t, float p, float s)
-{
-  p = p / 1000.0;
-  float sr = sqrt(s);
-
-  float d = 1.727E-3 - 7.9836E-6 * p;
-
-  float b_1 = 7.3637E-5 + 1.7945E-7 * t;
-  float b_0 = -1.922E-2 - 4.42E-5 * t;
-  float b = b_0 + b_1 * p;
-
-  float a_3 = (-3.389E-13 * t + 6.649E-12)  * t + 1.100E-10;
-  float a_2 = ((7.988E-12 * t - 1.6002E-10) * t + 9.1041E-9) * t - 3.9064E-7;
-  float a_1 = (((-2.0122E-10 * t + 1.0507E-8)  * t - 6.4885E-8) * t - 1.2580E-5) * t + 9.4742E-5;
-  float a_0 = (((-3.21E-8 * t + 2.006E-6) * t + 7.164E-5) * t - 1.262E-2) * t + 1.389;
-  float a = ((a_3 * p + a_2) * p + a_1) * p + a_0;
-
-  float c_3 = (-2.3643E-12 * t + 3.8504E-10) * t - 9.7729E-9;
-  float c_2 = (((1.0405E-12 * t - 2.5335E-10) * t + 2.5974E-8) * t - 1.7107E-6)  * t + 3.1260E-5;
-  float c_1 = (((-6.1185E-10 * t + 1.3621E-7)  * t - 8.1788E-6) * t + 6.8982E-4)  * t + 0.153563;
-  float c_0 = ((((3.1464E-9  * t - 1.47800E-6) * t + 3.3420E-4) * t - 5.80852E-2) * t + 5.03711) * t + 1402.388;
-  float c  = ((c_3 * p + c_2) * p + c_1) * p + c_0;
-
-  return c + (a + b * sr + d * s) * s;
-}
-
-/// Calculates gravity at sea level vs latitude
-/// WGS84 ellipsoid gravity formula
-float UCNL_WPHX_gravity_constant_wgs84_calc(float phi)
-{
-  float phi_sq = sin(phi);
-  phi_sq *= phi_sq;
-  return (9.7803253359 * ((1.0 + 0.00193185265241 * phi_sq) / sqrt(1.0 - 0.00669437999013 * phi_sq)));
-}
-
-/// calculates distance from the water surface where pressure is p0 to the point, where pressure is p
-float UCNL_WPHX_depth_by_pressure_calc(float p, float p0, float rho, float g)
-{
-  return 100.0 * (p - p0) / (rho * g);
-}
-
-// Calculates pressure of a water column with given height (distance between
-// the water surface and the given point) assuming constant water density
-// h - depth, m
-// p0 - atmospheric pressure, mBar
-// rho - water density, kg/m^3
-// g - gravity acceleration, m/s^2
-float UCNL_WPHX_pressure_by_depth_calc(float h, float p0, float rho, float g)
-{
-  return h * rho * g / 100.0 + p0;
-}
-
-// Calculated the freezing temperature of seawater (in °C) with specified pressure and salinity.
-// According to:
-// Algorithms for computation of fundamental properties of seawater.
-// Unesco technical papers in marine science vol. 44, 1983, pp. 30
-// https://darchive.mblwhoilibrary.org/bitstream/handle/1912/2470/059832eb.pdf
-// p - pressure, mBar
-// s - PSU
-float UCNL_WPHX_water_fpoint_calc(float p, float s)
-{
-  return (-0.0575 + 1.710523E-3 * sqrt(s) - 2.154996E-4 * s) * s - 7.53E-6 * p;
-}
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#include "Arduino.h"
+#include "ucnl_wphx.h"
+
+// The equations are written once for float (batch functions) and double (scalar ones, float on AVR)
+// "p" is in Bar, "sr" is sqrt(s)
+
+/// calculates in situ density of water
+/// millero et al 1980, deep-sea res.,27a,255-264
+/// jpots ninth report 1978,tenth report 1980
+template <typename T>
+static inline T UCNL_WPHX_water_density_T(T t, T p, T s, T sr)
+{
+  T sig = ((((T)4.8314E-4 * s) +
+            (((T)-1.6546E-6 * t + (T)1.0227E-4) * t - (T)5.72466E-3) * sr +
+            ((((T)5.3875E-9 * t - (T)8.2467E-7) * t + (T)7.6438E-5) * t - (T)4.0899E-3) * t + (T)0.824493) * s) +
+          (((((T)6.536332E-9 * t - (T)1.120083E-6) * t + (T)1.001685E-4) * t - (T)9.095290E-3) * t + (T)6.793952E-2) * t - (T)0.157406;
+
+  T b = (((T)9.1697E-10 * t + (T)2.0816E-8) * t - (T)9.9348E-7) * s + ((T)5.2787E-8 * t - (T)6.12293E-6) * t + (T)8.50935E-5;
+
+  T k0 = ((((((T)-5.3009E-4 * t + (T)1.6483E-2) * t + (T)7.944E-2) * sr) +
+           (((T)-6.1670E-5 * t + (T)1.09987E-2) * t - (T)0.603459) * t + (T)54.6746) * s) +
+         ((((T)-5.155288E-5 * t + (T)1.360477E-2) * t - (T)2.327105) * t + (T)148.4206) * t + (T)19652.21;
+
+  T a = ((T)1.91075E-4 * sr + ((T)-1.6078E-6 * t - (T)1.0981E-5) * t + (T)2.2838E-3) * s +
+        (((T)-5.77905E-7 * t + (T)1.16092E-4) * t + (T)1.43713E-3) * t + (T)3.239908;
+
+  T k = (b * p + a) * p + k0;
+
+  return (T)1000.0 + (k * sig + (T)1000.0 * p) / (k - p);
+}
+
+/// The UNESCO equation: Chen and Millero (1977)
+template <typename T>
+static inline T UCNL_WPHX_speed_of_sound_UNESCO_T(T t, T p, T s, T sr)
+{
+  T d = (T)1.727E-3 - (T)7.9836E-6 * p;
+
+  T b_1 = (T)7.3637E-5 + (T)1.7945E-7 * t;
+  T b_0 = (T)-1.922E-2 - (T)4.42E-5 * t;
+  T b = b_0 + b_1 * p;
+
+  T a_3 = ((T)-3.389E-13 * t + (T)6.649E-12)  * t + (T)1.100E-10;
+  T a_2 = (((T)7.988E-12 * t - (T)1.6002E-10) * t + (T)9.1041E-9) * t - (T)3.9064E-7;
+  T a_1 = ((((T)-2.0122E-10 * t + (T)1.0507E-8)  * t - (T)6.4885E-8) * t - (T)1.2580E-5) * t + (T)9.4742E-5;
+  T a_0 = ((((T)-3.21E-8 * t + (T)2.006E-6) * t + (T)7.164E-5) * t - (T)1.262E-2) * t + (T)1.389;
+  T a = ((a_3 * p + a_2) * p + a_1) * p + a_0;
+
+  T c_3 = ((T)-2.3643E-12 * t + (T)3.8504E-10) * t - (T)9.7729E-9;
+  T c_2 = ((((T)1.0405E-12 * t - (T)2.5335E-10) * t + (T)2.5974E-8) * t - (T)1.7107E-6)  * t + (T)3.1260E-5;
+  T c_1 = ((((T)-6.1185E-10 * t + (T)1.3621E-7)  * t - (T)8.1788E-6) * t + (T)6.8982E-4)  * t + (T)0.153563;
+  T c_0 = (((((T)3.1464E-9  * t - (T)1.47800E-6) * t + (T)3.3420E-4) * t - (T)5.80852E-2) * t + (T)5.03711) * t + (T)1402.388;
+  T c  = ((c_3 * p + c_2) * p + c_1) * p + c_0;
+
+  return c + (a + b * sr + d * s) * s;
+}
+
+// "p" is in mBar here
+template <typename T>
+static inline T UCNL_WPHX_water_fpoint_T(T p, T s, T sr)
+{
+  return ((T)-0.0575 + (T)1.710523E-3 * sr - (T)2.154996E-4 * s) * s - (T)7.53E-6 * p;
+}
+
+/// calculates in situ density of water
+/// millero et al 1980, deep-sea res.,27a,255-264
+/// jpots ninth report 1978,tenth report 1980
+float UCNL_WPHX_water_density_calc(float t, float p, float s)
+{
+  return UCNL_WPHX_water_density_T<double>(t, p / 1000.0, s, sqrt((double)s));
+}
+
+/// The UNESCO equation: Chen and Millero (1977)
+float UCNL_WPHX_speed_of_sound_UNESCO_calc(float t, float p, float s)
+{
+  return UCNL_WPHX_speed_of_sound_UNESCO_T<double>(t, p / 1000.0, s, sqrt((double)s));
+}
+
+/// Calculates gravity at sea level vs latitude
+/// WGS84 ellipsoid gravity formula
+float UCNL_WPHX_gravity_constant_wgs84_calc(float phi)
+{
+  float phi_sq = sin(phi);
+  phi_sq *= phi_sq;
+  return (9.7803253359 * ((1.0 + 0.00193185265241 * phi_sq) / sqrt(1.0 - 0.00669437999013 * phi_sq)));
+}
+
+/// calculates distance from the water surface where pressure is p0 to the point, where pressure is p
+float UCNL_WPHX_depth_by_pressure_calc(float p, float p0, float rho, float g)
+{
+  return 100.0 * (p - p0) / (rho * g);
+}
+
+// Calculates pressure of a water column with given height (distance between
+// the water surface and the given point) assuming constant water density
+// h - depth, m
+// p0 - atmospheric pressure, mBar
+// rho - water density, kg/m^3
+// g - gravity acceleration, m/s^2
+float UCNL_WPHX_pressure_by_depth_calc(float h, float p0, float rho, float g)
+{
+  return h * rho * g / 100.0 + p0;
+}
+
+// Calculated the freezing temperature of seawater (in °C) with specified pressure and salinity.
+// According to:
+// Algorithms for computation of fundamental properties of seawater.
+// Unesco technical papers in marine science vol. 44, 1983, pp. 30
+// https://darchive.mblwhoilibrary.org/bitstream/handle/1912/2470/059832eb.pdf
+// p - pressure, mBar
+// s - PSU
+float UCNL_WPHX_water_fpoint_calc(float p, float s)
+{
+  return UCNL_WPHX_water_fpoint_T<double>(p, s, sqrt((double)s));
+}
+
+
+
+// Batch functions for CTD casts: arrays of "n" samples, the outputs must not overlap the inputs.
+// A chunk of samples takes the square roots of the salinities first, into the output array, and
+// then the equations in a loop without calls and branches, which the compiler vectorizes
+// (-O3 or -O2 -ftree-vectorize, plus -march for wider vectors). With OpenMP (-fopenmp) long
+// casts are shared between threads by chunks
+
+#define UCNL_WPHX_BATCH_CHUNK        (256)
+#define UCNL_WPHX_BATCH_PARALLEL_MIN (65536)   // fewer samples are not worth starting the threads
+
+static inline int UCNL_WPHX_Batch_End(int i, int n)
+{
+  return (n - i > UCNL_WPHX_BATCH_CHUNK) ? i + UCNL_WPHX_BATCH_CHUNK : n;
+}
+
+static inline void UCNL_WPHX_Batch_Sqrt(const float* s, float* sr, int st, int nd)
+{
+  int j;
+  for (j = st; j < nd; j++)
+    sr[j] = sqrt(s[j]);
+}
+
+// "t" - °C, "p" - mBar, "s" - PSU, "rho" - kg/m^3
+void UCNL_WPHX_water_density_batch(const float* t, const float* p, const float* s, float* rho, int n)
+{
+  int i;
+
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= UCNL_WPHX_BATCH_PARALLEL_MIN)
+#endif
+  for (i = 0; i < n; i += UCNL_WPHX_BATCH_CHUNK)
+  {
+    int j, nd = UCNL_WPHX_Batch_End(i, n);
+
+    UCNL_WPHX_Batch_Sqrt(s, rho, i, nd);
+    for (j = i; j < nd; j++)
+      rho[j] = UCNL_WPHX_water_density_T<float>(t[j], p[j] * 1E-3f, s[j], rho[j]);
+  }
+}
+
+// "c" - m/s
+void UCNL_WPHX_speed_of_sound_UNESCO_batch(const float* t, const float* p, const float* s, float* c, int n)
+{
+  int i;
+
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= UCNL_WPHX_BATCH_PARALLEL_MIN)
+#endif
+  for (i = 0; i < n; i += UCNL_WPHX_BATCH_CHUNK)
+  {
+    int j, nd = UCNL_WPHX_Batch_End(i, n);
+
+    UCNL_WPHX_Batch_Sqrt(s, c, i, nd);
+    for (j = i; j < nd; j++)
+      c[j] = UCNL_WPHX_speed_of_sound_UNESCO_T<float>(t[j], p[j] * 1E-3f, s[j], c[j]);
+  }
+}
+
+// Both the density and the sound speed in one pass, sharing the square roots
+void UCNL_WPHX_density_and_sound_speed_batch(const float* t, const float* p, const float* s, float* rho, float* c, int n)
+{
+  int i;
+
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= UCNL_WPHX_BATCH_PARALLEL_MIN)
+#endif
+  for (i = 0; i < n; i += UCNL_WPHX_BATCH_CHUNK)
+  {
+    int j, nd = UCNL_WPHX_Batch_End(i, n);
+
+    UCNL_WPHX_Batch_Sqrt(s, c, i, nd);
+    for (j = i; j < nd; j++)
+    {
+      float pb = p[j] * 1E-3f;
+      rho[j] = UCNL_WPHX_water_density_T<float>(t[j], pb, s[j], c[j]);
+      c[j] = UCNL_WPHX_speed_of_sound_UNESCO_T<float>(t[j], pb, s[j], c[j]);
+    }
+  }
+}
+
+// "fp" - °C
+void UCNL_WPHX_water_fpoint_batch(const float* p, const float* s, float* fp, int n)
+{
+  int i;
+
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= UCNL_WPHX_BATCH_PARALLEL_MIN)
+#endif
+  for (i = 0; i < n; i += UCNL_WPHX_BATCH_CHUNK)
+  {
+    int j, nd = UCNL_WPHX_Batch_End(i, n);
+
+    UCNL_WPHX_Batch_Sqrt(s, fp, i, nd);
+    for (j = i; j < nd; j++)
+      fp[j] = UCNL_WPHX_water_fpoint_T<float>(p[j], s[j], fp[j]);
+  }
+}
+
+// Depths by pressures "p" and densities "rho" (e.g. from UCNL_WPHX_water_density_batch), "h" - m
+void UCNL_WPHX_depth_by_pressure_batch(const float* p, float p0, const float* rho, float g, float* h, int n)
+{
+  int i;
+
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= UCNL_WPHX_BATCH_PARALLEL_MIN)
+#endif
+  for (i = 0; i < n; i++)
+    h[i] = 100.0f * (p[i] - p0) / (rho[i] * g);
+}
+
+
+
+// Lookup tables
+// Linear interpolation error is within step^2 / 8 of the second derivative along each axis:
+// with 2 °C, 100 Bar and 5 PSU steps it is below 0.08 m/s for the sound speed and 0.03 kg/m^3
+// for the density, src/tools/bench/ucnl_wphx_bench.cpp measures it for other grids.
+// A lookup takes 10 multiplications, 5 with a fixed salinity, instead of about 40 and a square root
+// of the exact functions
+
+/* Tabulates "func" over the grid, returns false if "values_size" is less than t_num * p_num * s_num
+   "t_min".."t_max" temperature range, °C, "t_num" nodes
+   "p_min".."p_max" pressure range, mBar, "p_num" nodes
+   "s_min".."s_max" salinity range, PSU, "s_num" nodes
+   The ranges are extrapolated linearly outside
+*/
+bool UCNL_WPHX_LUT_Init(UCNL_WPHX_LUT_Struct* lut, float* values, int values_size, UCNL_WPHX_TPS_Func func,
+                        float t_min, float t_max, int t_num,
+                        float p_min, float p_max, int p_num,
+                        float s_min, float s_max, int s_num)
+{
+  int it, ip, is, n = 0;
+  float t_k, p_k, s_k;
+
+  if ((values == NULL) || (func == NULL) ||
+      (t_num <= 0) || (p_num <= 0) || (s_num <= 0) ||
+      (values_size < t_num * p_num * s_num))
+    return false;
+
+  t_k = (t_num > 1) ? (t_max - t_min) / (t_num - 1) : 0;
+  p_k = (p_num > 1) ? (p_max - p_min) / (p_num - 1) : 0;
+  s_k = (s_num > 1) ? (s_max - s_min) / (s_num - 1) : 0;
+
+  lut->values = values;
+  lut->t_min = t_min;
+  lut->p_min = p_min;
+  lut->s_min = s_min;
+  lut->t_ik = (t_k != 0) ? 1.0f / t_k : 0;
+  lut->p_ik = (p_k != 0) ? 1.0f / p_k : 0;
+  lut->s_ik = (s_k != 0) ? 1.0f / s_k : 0;
+  lut->t_num = t_num;
+  lut->p_num = p_num;
+  lut->s_num = s_num;
+  lut->dt = (t_num > 1) ? 1 : 0;
+  lut->dp = (p_num > 1) ? t_num : 0;
+  lut->ds = (s_num > 1) ? t_num * p_num : 0;
+
+  for (is = 0; is < s_num; is++)
+    for (ip = 0; ip < p_num; ip++)
+      for (it = 0; it < t_num; it++)
+        values[n++] = func(t_min + it * t_k, p_min + ip * p_k, s_min + is * s_k);
+
+  return true;
+}
+
+// Cell of the value along an axis and the position in it, the outer cells are extended,
+// an axis of one node takes no arithmetic
+static inline int UCNL_WPHX_LUT_Cell(float v, float v_min, float v_ik, int num, float* f)
+{
+  float x;
+  int i;
+
+  if (num < 2)
+  {
+    *f = 0;
+    return 0;
+  }
+
+  x = (v - v_min) * v_ik;
+  i = (x > 0) ? (int)x : 0;
+  if (i > num - 2)
+    i = num - 2;
+
+  *f = x - i;
+  return i;
+}
+
+// Bilinear interpolation over t and p in a (t, p) plane of the table
+static inline float UCNL_WPHX_LUT_Plane(const UCNL_WPHX_LUT_Struct* lut, const float* v, float ft, float fp)
+{
+  float v0 = v[0] + (v[lut->dt] - v[0]) * ft;
+  float v1 = v[lut->dp] + (v[lut->dp + lut->dt] - v[lut->dp]) * ft;
+
+  return v0 + (v1 - v0) * fp;
+}
+
+// A fixed salinity (an s axis of one node) takes one plane: 3 interpolations instead of 7
+float UCNL_WPHX_LUT_Get(const UCNL_WPHX_LUT_Struct* lut, float t, float p, float s)
+{
+  float ft, fp, fs, v0, v1;
+  int it = UCNL_WPHX_LUT_Cell(t, lut->t_min, lut->t_ik, lut->t_num, &ft);
+  int ip = UCNL_WPHX_LUT_Cell(p, lut->p_min, lut->p_ik, lut->p_num, &fp);
+  int is = UCNL_WPHX_LUT_Cell(s, lut->s_min, lut->s_ik, lut->s_num, &fs);
+  const float* v = &lut->values[is * lut->ds + ip * lut->dp + it];
+
+  v0 = UCNL_WPHX_LUT_Plane(lut, v, ft, fp);
+  if (lut->ds == 0)
+    return v0;
+
+  v1 = UCNL_WPHX_LUT_Plane(lut, v + lut->ds, ft, fp);
+  return v0 + (v1 - v0) * fs;
+}
+
+
+
+// Sound speed profile
+// Slowness (1 / speed) is linear between the samples, the profile is extended by the speeds
+// of the shallowest and the deepest samples. Vertical travel times are integrated once when
+// a sample is added, so a mean speed between two depths takes two binary searches and three
+// divisions, depths within one segment take one division
+
+// "depths", "speeds", "times" caller-owned arrays of "size" elements
+bool UCNL_WPHX_SSP_Init(UCNL_WPHX_SSP_Struct* ssp, float* depths, float* speeds, float* times, int size, float min_step_m)
+{
+  if ((depths == NULL) || (speeds == NULL) || (times == NULL) || (size <= 0))
+    return false;
+
+  ssp->depths = depths;
+  ssp->speeds = speeds;
+  ssp->times = times;
+  ssp->size = size;
+  ssp->min_step_m = min_step_m;
+  ssp->num = 0;
+
+  return true;
+}
+
+void UCNL_WPHX_SSP_Reset(UCNL_WPHX_SSP_Struct* ssp)
+{
+  ssp->num = 0;
+}
+
+// Index of the last sample not deeper than "depth_m", -1 if all the samples are deeper.
+// The search takes log2(num) steps whatever the depth, with no branches to mispredict
+static int UCNL_WPHX_SSP_Find(const UCNL_WPHX_SSP_Struct* ssp, float depth_m)
+{
+  const float* base = ssp->depths;
+  int half, n = ssp->num;
+
+  if (n <= 0)
+    return -1;
+
+  while (n > 1)
+  {
+    half = n / 2;
+    base = (base[half] <= depth_m) ? base + half : base;
+    n -= half;
+  }
+
+  return (int)(base - ssp->depths) - ((*base <= depth_m) ? 0 : 1);
+}
+
+// UCNL_WPHX_SSP_Find for two depths at once, the two searches overlap
+static void UCNL_WPHX_SSP_Find_Pair(const UCNL_WPHX_SSP_Struct* ssp, float depth1_m, float depth2_m, int* i1, int* i2)
+{
+  const float* base1 = ssp->depths;
+  const float* base2 = ssp->depths;
+  int half, n = ssp->num;
+
+  while (n > 1)
+  {
+    half = n / 2;
+    base1 = (base1[half] <= depth1_m) ? base1 + half : base1;
+    base2 = (base2[half] <= depth2_m) ? base2 + half : base2;
+    n -= half;
+  }
+
+  *i1 = (int)(base1 - ssp->depths) - ((*base1 <= depth1_m) ? 0 : 1);
+  *i2 = (int)(base2 - ssp->depths) - ((*base2 <= depth2_m) ? 0 : 1);
+}
+
+// Index of a sample closer than min_step_m to the depth, -1 if there is none,
+// "i" gets the index of the last sample not deeper than the depth
+static int UCNL_WPHX_SSP_Find_Near(const UCNL_WPHX_SSP_Struct* ssp, float depth_m, int* i)
+{
+  *i = UCNL_WPHX_SSP_Find(ssp, depth_m);
+
+  if ((*i >= 0) && (depth_m - ssp->depths[*i] <= ssp->min_step_m))
+    return *i;
+
+  if ((*i + 1 < ssp->num) && (ssp->depths[*i + 1] - depth_m <= ssp->min_step_m))
+    return *i + 1;
+
+  return -1;
+}
+
+// Stores a sample at the index "near" it replaces, or inserts it after the sample "i"
+static bool UCNL_WPHX_SSP_Store(UCNL_WPHX_SSP_Struct* ssp, int near, int i, float depth_m, float speed_mps)
+{
+  int n;
+
+  if (near >= 0)
+    i = near;
+  else
+  {
+    if (ssp->num >= ssp->size)
+      return false;
+
+    i++;
+    for (n = ssp->num; n > i; n--)
+    {
+      ssp->depths[n] = ssp->depths[n - 1];
+      ssp->speeds[n] = ssp->speeds[n - 1];
+    }
+    ssp->num++;
+  }
+
+  ssp->depths[i] = depth_m;
+  ssp->speeds[i] = speed_mps;
+
+  // travel times change below the sample only
+  if (i == 0)
+  {
+    ssp->times[0] = 0;
+    i++;
+  }
+
+  for (n = i; n < ssp->num; n++)
+    ssp->times[n] = ssp->times[n - 1] +
+                    (ssp->depths[n] - ssp->depths[n - 1]) * (1.0f / ssp->speeds[n - 1] + 1.0f / ssp->speeds[n]) / 2;
+
+  return true;
+}
+
+/* Adds a sound speed sample, a sample closer than "min_step_m" to an existing one replaces it.
+   Samples streamed during a descent are appended at O(1), others are inserted at O(N).
+   Returns false if the profile is full
+*/
+bool UCNL_WPHX_SSP_Add_Speed(UCNL_WPHX_SSP_Struct* ssp, float depth_m, float speed_mps)
+{
+  int i, near = UCNL_WPHX_SSP_Find_Near(ssp, depth_m, &i);
+
+  return UCNL_WPHX_SSP_Store(ssp, near, i, depth_m, speed_mps);
+}
+
+// True if the profile has no sample closer than "min_step_m" to the depth
+bool UCNL_WPHX_SSP_Is_New_Depth(const UCNL_WPHX_SSP_Struct* ssp, float depth_m)
+{
+  int i;
+
+  return (UCNL_WPHX_SSP_Find_Near(ssp, depth_m, &i) < 0);
+}
+
+/* Adds a sample of temperature "t" (°C) and salinity "s" (PSU) at a depth,
+   e.g. uWAVE_AMB_DTA_Struct readings. The pressure is taken for the density
+   of the water at the surface and the standard gravity. A sample closer than
+   "min_step_m" to an existing one is dropped before the equations are evaluated,
+   so it costs a search only; use UCNL_WPHX_SSP_Add_Speed to replace a sample
+   or UCNL_WPHX_SSP_Reset to start the profile over. Returns false if the profile is full
+*/
+bool UCNL_WPHX_SSP_Add_Sample(UCNL_WPHX_SSP_Struct* ssp, float depth_m, float t, float s)
+{
+  int i;
+
+  if (UCNL_WPHX_SSP_Find_Near(ssp, depth_m, &i) >= 0)
+    return true;
+
+  float rho = UCNL_WPHX_water_density_calc(t, UCNL_WPHX_ATM_PRESSURE_MBAR, s);
+  float p = UCNL_WPHX_pressure_by_depth_calc(depth_m, UCNL_WPHX_ATM_PRESSURE_MBAR, rho, UCNL_WPHX_GRAVITY_ACC_MPS2);
+
+  return UCNL_WPHX_SSP_Store(ssp, -1, i, depth_m, UCNL_WPHX_speed_of_sound_UNESCO_calc(t, p, s));
+}
+
+// Sound speed at the depth, "i" is the index UCNL_WPHX_SSP_Find gives for it. Between the samples
+// 1 / (1/v0 + (1/v1 - 1/v0) * (d - z0) / (z1 - z0)) is taken over a common denominator
+static float UCNL_WPHX_SSP_Speed_At(const UCNL_WPHX_SSP_Struct* ssp, int i, float depth_m)
+{
+  if ((i < 0) || (i == ssp->num - 1))
+    return ssp->speeds[(i < 0) ? 0 : i];
+
+  float z0 = ssp->depths[i], z1 = ssp->depths[i + 1];
+  float v0 = ssp->speeds[i], v1 = ssp->speeds[i + 1];
+
+  return v0 * v1 * (z1 - z0) / ((z1 - depth_m) * v1 + (depth_m - z0) * v0);
+}
+
+// Travel time at the depth, "i" is the index UCNL_WPHX_SSP_Find gives for it.
+// Between the samples (d - z0) * (1/v0 + slowness(d)) / 2 is taken over a common denominator
+static float UCNL_WPHX_SSP_Time_At(const UCNL_WPHX_SSP_Struct* ssp, int i, float depth_m)
+{
+  if (i < 0)
+    return (depth_m - ssp->depths[0]) / ssp->speeds[0];
+
+  if (i == ssp->num - 1)
+    return ssp->times[i] + (depth_m - ssp->depths[i]) / ssp->speeds[i];
+
+  float z0 = ssp->depths[i], z1 = ssp->depths[i + 1];
+  float v0 = ssp->speeds[i], v1 = ssp->speeds[i + 1];
+  float h = z1 - z0;
+
+  return ssp->times[i] + (depth_m - z0) * ((h + z1 - depth_m) * v1 + (depth_m - z0) * v0) / (2 * v0 * v1 * h);
+}
+
+// Vertical travel time from the shallowest sample to the depth, negative above it
+float UCNL_WPHX_SSP_Time(const UCNL_WPHX_SSP_Struct* ssp, float depth_m)
+{
+  if (ssp->num <= 0)
+    return depth_m / UCNL_WPHX_FWTR_SOUND_SPEED_MPS;
+
+  return UCNL_WPHX_SSP_Time_At(ssp, UCNL_WPHX_SSP_Find(ssp, depth_m), depth_m);
+}
+
+// Sound speed at the depth, UCNL_WPHX_FWTR_SOUND_SPEED_MPS if the profile is empty
+float UCNL_WPHX_SSP_Speed(const UCNL_WPHX_SSP_Struct* ssp, float depth_m)
+{
+  if (ssp->num <= 0)
+    return UCNL_WPHX_FWTR_SOUND_SPEED_MPS;
+
+  return UCNL_WPHX_SSP_Speed_At(ssp, UCNL_WPHX_SSP_Find(ssp, depth_m), depth_m);
+}
+
+// Harmonic mean sound speed between two depths: the effective speed for a range between modems at the depths
+float UCNL_WPHX_SSP_Mean_Speed(const UCNL_WPHX_SSP_Struct* ssp, float depth1_m, float depth2_m)
+{
+  if (ssp->num <= 0)
+    return UCNL_WPHX_FWTR_SOUND_SPEED_MPS;
+
+  int i1, i2;
+
+  UCNL_WPHX_SSP_Find_Pair(ssp, depth1_m, depth2_m, &i1, &i2);
+
+  // within one segment the slowness is linear, the mean speed is the one in the middle
+  if (i1 == i2)
+    return UCNL_WPHX_SSP_Speed_At(ssp, i1, (depth1_m + depth2_m) / 2);
+
+  // close depths across a sample, the travel times would cancel out
+  if (fabs(depth2_m - depth1_m) <= ssp->min_step_m)
+    return UCNL_WPHX_SSP_Speed(ssp, (depth1_m + depth2_m) / 2);
+
+  return (depth2_m - depth1_m) / (UCNL_WPHX_SSP_Time_At(ssp, i2, depth2_m) - UCNL_WPHX_SSP_Time_At(ssp, i1, depth1_m));
+}
@@ -1,51 +1,102 @@
-/*
-Copyright (C) 2021, Underwater communication & navigation laboratory
-All rights reserved.
-
-www.unavlab.com
-hello@unavlab.com
-
-*/
-
-#ifndef _UCNL_WPHX_
-#define _UCNL_WPHX_
-
-#define UCNL_WPHX_FWTR_DENSITY_KGM3        (998.02)       // Fresh water density at 20°C
-#define UCNL_WPHX_FWTR_SOUND_SPEED_MPS     (1500.0)       //
-#define UCNL_WPHX_FWTR_SALINITY_PSU        (0.0)          //
-#define UCNL_WPHX_GRAVITY_ACC_MPS2         (9.80665)      // ISO 80000-3:2006
-#define UCNL_WPHX_ATM_PRESSURE_MBAR        (1013.25)      // Average at sea level
-
-/// calculates in situ density of water
-/// millero et al 1980, deep-sea res.,27a,255-264
-/// jpots ninth report 1978,tenth report 1980
-float UCNL_WPHX_water_density_calc(float t, float p, float s);
-
-/// The UNESCO equation: Chen and Millero (1977)
-float UCNL_WPHX_speed_of_sound_UNESCO_calc(float t, float p, float s);
-
-/// Calculates gravity at sea level vs latitude
-/// WGS84 ellipsoid gravity formula
-float UCNL_WPHX_gravity_constant_wgs84_calc(float phi);
-
-/// calculates distance from the water surface where pressure is p0 to the point, where pressure is p
-float UCNL_WPHX_depth_by_pressure_calc(float p, float p0, float rho, float g);
-
-// Calculates pressure of a water column with given height (distance between
-// the water surface and the given point) assuming constant water density
-// h - depth, m
-// p0 - atmospheric pressure, mBar
-// rho - water density, kg/m^3
-// g - gravity acceleration, m/s^2
-float UCNL_WPHX_pressure_by_depth_calc(float h, float p0, float rho, float g);
-
-// Calculated the freezing temperature of seawater (in °C) with specified pressure and salinity.
-// According to:
-// Algorithms for computation of fundamental properties of seawater.
-// Unesco technical papers in marine science vol. 44, 1983, pp. 30
-// https://darchive.mblwhoilibrary.org/bitstream/handle/1912/2470/059832eb.pdf
-// p - pressure, mBar
-// s - PSU
-float UCNL_WPHX_water_fpoint_calc(float p, float s);
-
-#endif
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+#ifndef _UCNL_WPHX_
+#define _UCNL_WPHX_
+
+#define UCNL_WPHX_FWTR_DENSITY_KGM3        (998.02)       // Fresh water density at 20°C
+#define UCNL_WPHX_FWTR_SOUND_SPEED_MPS     (1500.0)       //
+#define UCNL_WPHX_FWTR_SALINITY_PSU        (0.0)          //
+#define UCNL_WPHX_GRAVITY_ACC_MPS2         (9.80665)      // ISO 80000-3:2006
+#define UCNL_WPHX_ATM_PRESSURE_MBAR        (1013.25)      // Average at sea level
+
+/// calculates in situ density of water
+/// millero et al 1980, deep-sea res.,27a,255-264
+/// jpots ninth report 1978,tenth report 1980
+float UCNL_WPHX_water_density_calc(float t, float p, float s);
+
+/// The UNESCO equation: Chen and Millero (1977)
+float UCNL_WPHX_speed_of_sound_UNESCO_calc(float t, float p, float s);
+
+/// Calculates gravity at sea level vs latitude
+/// WGS84 ellipsoid gravity formula
+float UCNL_WPHX_gravity_constant_wgs84_calc(float phi);
+
+/// calculates distance from the water surface where pressure is p0 to the point, where pressure is p
+float UCNL_WPHX_depth_by_pressure_calc(float p, float p0, float rho, float g);
+
+// Calculates pressure of a water column with given height (distance between
+// the water surface and the given point) assuming constant water density
+// h - depth, m
+// p0 - atmospheric pressure, mBar
+// rho - water density, kg/m^3
+// g - gravity acceleration, m/s^2
+float UCNL_WPHX_pressure_by_depth_calc(float h, float p0, float rho, float g);
+
+// Calculated the freezing temperature of seawater (in °C) with specified pressure and salinity.
+// According to:
+// Algorithms for computation of fundamental properties of seawater.
+// Unesco technical papers in marine science vol. 44, 1983, pp. 30
+// https://darchive.mblwhoilibrary.org/bitstream/handle/1912/2470/059832eb.pdf
+// p - pressure, mBar
+// s - PSU
+float UCNL_WPHX_water_fpoint_calc(float p, float s);
+
+// Batch versions for CTD casts: arrays of "n" samples, outputs must not overlap inputs.
+// Vectorized by the compiler, multithreaded with OpenMP. Agree with the functions above to float precision
+void UCNL_WPHX_water_density_batch(const float* t, const float* p, const float* s, float* rho, int n);
+void UCNL_WPHX_speed_of_sound_UNESCO_batch(const float* t, const float* p, const float* s, float* c, int n);
+void UCNL_WPHX_density_and_sound_speed_batch(const float* t, const float* p, const float* s, float* rho, float* c, int n);
+void UCNL_WPHX_water_fpoint_batch(const float* p, const float* s, float* fp, int n);
+void UCNL_WPHX_depth_by_pressure_batch(const float* p, float p0, const float* rho, float g, float* h, int n);
+
+// Fast mode: a function of (t, p, s) tabulated over a grid and interpolated trilinearly.
+// The table is built at startup in a caller-owned array, an axis of one node takes its value at "min"
+typedef float (*UCNL_WPHX_TPS_Func)(float t, float p, float s);
+
+typedef struct
+{
+  float* values;      // [s][p][t]
+  float t_min, t_ik;  // minimal value and inverse step of each axis
+  float p_min, p_ik;
+  float s_min, s_ik;
+  int t_num;
+  int p_num;
+  int s_num;
+  int dt, dp, ds;     // offsets of the next node along each axis, 0 for an axis of one node
+} UCNL_WPHX_LUT_Struct;
+
+bool  UCNL_WPHX_LUT_Init(UCNL_WPHX_LUT_Struct* lut, float* values, int values_size, UCNL_WPHX_TPS_Func func,
+                         float t_min, float t_max, int t_num,
+                         float p_min, float p_max, int p_num,
+                         float s_min, float s_max, int s_num);
+float UCNL_WPHX_LUT_Get(const UCNL_WPHX_LUT_Struct* lut, float t, float p, float s);
+
+// Sound speed profile: sound speeds at depths, sorted by depth, and vertical travel times
+// from the shallowest depth, kept in caller-owned arrays of "size" elements
+typedef struct
+{
+  float* depths;      // m
+  float* speeds;      // m/s
+  float* times;       // s
+  int size;
+  int num;
+  float min_step_m;   // closer samples replace each other
+} UCNL_WPHX_SSP_Struct;
+
+bool  UCNL_WPHX_SSP_Init(UCNL_WPHX_SSP_Struct* ssp, float* depths, float* speeds, float* times, int size, float min_step_m);
+void  UCNL_WPHX_SSP_Reset(UCNL_WPHX_SSP_Struct* ssp);
+bool  UCNL_WPHX_SSP_Add_Speed(UCNL_WPHX_SSP_Struct* ssp, float depth_m, float speed_mps);
+bool  UCNL_WPHX_SSP_Is_New_Depth(const UCNL_WPHX_SSP_Struct* ssp, float depth_m);
+bool  UCNL_WPHX_SSP_Add_Sample(UCNL_WPHX_SSP_Struct* ssp, float depth_m, float t, float s);
+float UCNL_WPHX_SSP_Time(const UCNL_WPHX_SSP_Struct* ssp, float depth_m);
+float UCNL_WPHX_SSP_Speed(const UCNL_WPHX_SSP_Struct* ssp, float depth_m);
+float UCNL_WPHX_SSP_Mean_Speed(const UCNL_WPHX_SSP_Struct* ssp, float depth1_m, float depth2_m);
+
+#endif
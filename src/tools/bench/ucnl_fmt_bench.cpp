@@ -0,0 +1,247 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_STR_WriteIntDec/WriteFloat benchmark: the digit pairs formatter vs the former division loops
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -I../common -I../../libs ucnl_fmt_bench.cpp ../../libs/ucnl_str.cpp -o ucnl_fmt_bench
+//
+// Usage:
+//   ucnl_fmt_bench [values_number]
+//
+// Values look like the fields of the uWave builders: channel IDs, addresses, periods in ms, gravity
+// acceleration with 4 decimal places, coordinates with 6 etc. The number of results that differ from
+// printf is reported for both versions, the former WriteFloat truncates instead of rounding.
+// ucnl_str_fmt_avr/ucnl_str_fmt_avr.ino counts CPU cycles of both versions on an 8-bit AVR board.
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+
+#define BENCH_RUNS (5)
+
+// UCNL_STR_WriteIntDec and UCNL_STR_WriteFloat before the digit pairs rework, kept for the comparison
+static void Bench_WriteIntDec_Legacy(byte* buffer, byte* srcIdx, long src, byte zPad)
+{
+  long x = src;
+  int len = 0, i;
+
+  do {
+    x /= 10;
+    len++;
+  } while (x >= 1);
+
+  x = 1;
+  for (i = 1; i < len; i++) x *= 10;
+
+  if (zPad > 0) i = zPad;
+  else i = len;
+
+  do
+  {
+    if (i > len) buffer[*srcIdx] = '0';
+    else
+    {
+      buffer[*srcIdx] = (byte)((src / x) + '0');
+      src -= (src / x) * x;
+      x /= 10;
+    }
+    (*srcIdx)++;
+  } while (--i > 0);
+}
+
+static void Bench_WriteFloat_Legacy(byte* buffer, byte* srcIdx, float f, byte dPlaces, byte zPad)
+{
+  float ff = f;
+
+  if (ff < 0)
+  {
+    UCNL_STR_WriteByte(buffer, srcIdx, '-');
+    ff = -f;
+  }
+
+  long dec = (long)ff, mult = 1;
+  int i;
+  for (i = 0; i < dPlaces; i++) mult *= 10;
+  long frac = (long)((ff - dec) * (float)mult);
+
+  Bench_WriteIntDec_Legacy(buffer, srcIdx, dec, zPad);
+  UCNL_STR_WriteByte(buffer, srcIdx, '.');
+  Bench_WriteIntDec_Legacy(buffer, srcIdx, frac, dPlaces);
+}
+
+typedef struct
+{
+  long i;
+  float f;
+  byte places;
+  byte zPad;
+} Bench_Value_Struct;
+
+typedef struct
+{
+  const char* name;
+  bool isFloat;
+  double v_min;
+  double v_max;
+  byte places;
+  byte zPad;
+} Bench_Kind_Struct;
+
+static const Bench_Kind_Struct kinds[] = {
+  { "channel ID, 0..20",      false, 0,      20,         0, 0 },
+  { "address, 0..254",        false, 0,      254,        0, 0 },
+  { "period, ms",             false, 0,      100000,     0, 0 },
+  { "large, 0..2^31",         false, 0,      2147483647, 0, 0 },
+  { "time hhmmss, zero pad",  false, 0,      235959,     0, 6 },
+  { "salinity, 0 places",     true,  0,      40,         0, 1 },
+  { "gravity, 4 places",      true,  9.78,   9.83,       4, 0 },
+  { "temperature, 1 place",   true,  -2,     35,         1, 0 },
+  { "coordinate, 6 places",   true,  -180,   180,        6, 0 },
+};
+
+static double Bench_Rand(double v_min, double v_max)
+{
+  return v_min + (v_max - v_min) * (rand() / (double)RAND_MAX);
+}
+
+// Best time of a few runs, seconds per value
+template <typename F>
+static double Bench_Run(F write, const std::vector<Bench_Value_Struct>& values, int rounds, long* sink)
+{
+  std::chrono::steady_clock::time_point ts;
+  double t, best = 0;
+  byte buffer[64], idx;
+  long sum = 0;
+  size_t i;
+  int r, k;
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+
+    for (r = 0; r < rounds; r++)
+      for (i = 0; i < values.size(); i++)
+      {
+        idx = 0;
+        write(buffer, &idx, values[i]);
+        sum += idx + buffer[idx - 1];
+      }
+
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    if ((k == 0) || (t < best))
+      best = t;
+  }
+
+  *sink += sum;
+  return best / ((double)values.size() * rounds);
+}
+
+// Results that differ from printf, exact ties are skipped as printf rounds them to even
+template <typename F>
+static size_t Bench_Check(F write, const std::vector<Bench_Value_Struct>& values, bool isFloat)
+{
+  byte buffer[64], idx;
+  char ref[64];
+  double scaled;
+  size_t i, errors = 0;
+  int places;
+
+  for (i = 0; i < values.size(); i++)
+  {
+    idx = 0;
+    write(buffer, &idx, values[i]);
+    buffer[idx] = '\0';
+
+    if (isFloat)
+    {
+      places = (values[i].places > 0) ? values[i].places : 1;
+      scaled = fabs((double)values[i].f) * pow(10.0, values[i].places);
+      if (scaled - floor(scaled) == 0.5)
+        continue;
+      snprintf(ref, sizeof(ref), "%0*.*f", values[i].zPad + places + 1 + (values[i].f < 0), places,
+               (values[i].places > 0) ? (double)values[i].f : round((double)values[i].f));
+    }
+    else
+      snprintf(ref, sizeof(ref), "%0*ld", values[i].zPad, values[i].i);
+
+    if (strcmp((char*)buffer, ref) != 0)
+      errors++;
+  }
+
+  return errors;
+}
+
+static void Write_IntDec_Legacy(byte* buffer, byte* idx, const Bench_Value_Struct& v)
+{
+  Bench_WriteIntDec_Legacy(buffer, idx, v.i, v.zPad);
+}
+
+static void Write_IntDec(byte* buffer, byte* idx, const Bench_Value_Struct& v)
+{
+  UCNL_STR_WriteIntDec(buffer, idx, v.i, v.zPad);
+}
+
+static void Write_Float_Legacy(byte* buffer, byte* idx, const Bench_Value_Struct& v)
+{
+  Bench_WriteFloat_Legacy(buffer, idx, v.f, v.places, v.zPad);
+}
+
+static void Write_Float(byte* buffer, byte* idx, const Bench_Value_Struct& v)
+{
+  UCNL_STR_WriteFloat(buffer, idx, v.f, v.places, v.zPad);
+}
+
+int main(int argc, char** argv)
+{
+  size_t num = (argc > 1) ? (size_t)atol(argv[1]) : 10000;
+  int rounds = (int)(2000000 / (num ? num : 1)) + 1;
+  std::vector<Bench_Value_Struct> values(num);
+  double t_legacy, t_new;
+  long sink = 0;
+  size_t i, k;
+
+  srand(1);
+  printf("%zu values x %d rounds, ns/value (results differing from printf)\n", num, rounds);
+
+  for (k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++)
+  {
+    for (i = 0; i < num; i++)
+    {
+      values[i].f = (float)Bench_Rand(kinds[k].v_min, kinds[k].v_max);
+      values[i].i = (long)Bench_Rand(kinds[k].v_min, kinds[k].v_max);
+      values[i].places = kinds[k].places;
+      values[i].zPad = kinds[k].zPad;
+    }
+
+    if (kinds[k].isFloat)
+    {
+      t_legacy = Bench_Run(Write_Float_Legacy, values, rounds, &sink);
+      t_new = Bench_Run(Write_Float, values, rounds, &sink);
+      printf("%-24s legacy %7.2f (%6zu)  new %7.2f (%6zu)  x%5.1f\n", kinds[k].name,
+             t_legacy * 1e9, Bench_Check(Write_Float_Legacy, values, true),
+             t_new * 1e9, Bench_Check(Write_Float, values, true), t_legacy / t_new);
+    }
+    else
+    {
+      t_legacy = Bench_Run(Write_IntDec_Legacy, values, rounds, &sink);
+      t_new = Bench_Run(Write_IntDec, values, rounds, &sink);
+      printf("%-24s legacy %7.2f (%6zu)  new %7.2f (%6zu)  x%5.1f\n", kinds[k].name,
+             t_legacy * 1e9, Bench_Check(Write_IntDec_Legacy, values, false),
+             t_new * 1e9, Bench_Check(Write_IntDec, values, false), t_legacy / t_new);
+    }
+  }
+
+  printf("(%ld)\n", sink);
+
+  return 0;
+}
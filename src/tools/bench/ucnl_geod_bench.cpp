@@ -0,0 +1,254 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_NAV ellipsoidal (Vincenty) vs spherical (haversine) geodesy: accuracy and ns per call
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -I../common -I../../libs ucnl_geod_bench.cpp ../../libs/ucnl_nav.cpp -o ucnl_geod_bench
+//
+// Usage:
+//   ucnl_geod_bench [lines_number]
+//
+// Vincenty's solutions are checked against the example from Vincenty's paper (Flinders Peak - Buninyong,
+// given on GRS80, which differs from WGS84 by less than 0.1 mm on this line) and by inverse-direct round trips.
+// The haversine ranges are compared to the Vincenty ones for lines of different lengths.
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_nav.h"
+
+#define BENCH_RUNS (5)
+
+typedef struct {
+  double sp_lat_rad;
+  double sp_lon_rad;
+  double ep_lat_rad;
+  double ep_lon_rad;
+  double dst_m;
+  double fwd_az_rad;
+} Bench_Line_Struct;
+
+static double Bench_Rand(double min, double max)
+{
+  return min + (max - min) * ((double)rand() / RAND_MAX);
+}
+
+static double Bench_DMS(int deg, int min, double sec)
+{
+  double val = abs(deg) + min / 60.0 + sec / 3600.0;
+  return UCNL_NAV_DEG2RAD((deg < 0) ? -val : val);
+}
+
+static void Bench_Print_DMS(const char* name, double rad)
+{
+  double deg = fabs(UCNL_NAV_RAD2DEG(rad));
+  int d = (int)deg;
+  int m = (int)((deg - d) * 60);
+
+  printf("%s%s%d %02d' %08.5f\"", name, (rad < 0) ? "-" : "", d, m, (deg - d - m / 60.0) * 3600);
+}
+
+// Lines up to "max_dst_m" long with random start points and azimuths, end points by VincentyDirect_D
+static void Bench_Make_Lines(std::vector<Bench_Line_Struct>* lines, size_t num, double max_dst_m)
+{
+  Bench_Line_Struct l;
+  size_t i;
+
+  lines->clear();
+  for (i = 0; i < num; i++)
+  {
+    l.sp_lat_rad = UCNL_NAV_DEG2RAD(Bench_Rand(-80, 80));
+    l.sp_lon_rad = UCNL_NAV_DEG2RAD(Bench_Rand(-180, 180));
+    l.dst_m = Bench_Rand(max_dst_m / 100, max_dst_m);
+    l.fwd_az_rad = Bench_Rand(0, PI2);
+    UCNL_NAV_VincentyDirect_D(l.sp_lat_rad, l.sp_lon_rad, l.dst_m, l.fwd_az_rad, UCNL_NAV_VINCENTY_MAX_ITERATIONS,
+                              &l.ep_lat_rad, &l.ep_lon_rad, NULL);
+    lines->push_back(l);
+  }
+}
+
+static void Bench_Reference(void)
+{
+  double sp_lat = Bench_DMS(-37, 57, 3.72030), sp_lon = Bench_DMS(144, 25, 29.52440);
+  double ep_lat = Bench_DMS(-37, 39, 10.15610), ep_lon = Bench_DMS(143, 55, 35.38390);
+  double dst, fwd_az, fin_az, lat, lon;
+
+  printf("Flinders Peak - Buninyong, reference: 54972.271 m, 306 52' 05.37\", reverse 127 10' 25.07\"\n");
+
+  UCNL_NAV_VincentyInverse_D(sp_lat, sp_lon, ep_lat, ep_lon, UCNL_NAV_VINCENTY_MAX_ITERATIONS, false, &dst, &fwd_az, &fin_az);
+  printf("  VincentyInverse_D: %.3f m, ", dst);
+  Bench_Print_DMS("", fwd_az);
+  Bench_Print_DMS(", reverse ", UCNL_NAV_Wrap2PI_D(fin_az + _PI));
+  printf("\n");
+
+  UCNL_NAV_VincentyDirect_D(sp_lat, sp_lon, 54972.271, Bench_DMS(306, 52, 5.37), UCNL_NAV_VINCENTY_MAX_ITERATIONS, &lat, &lon, &fin_az);
+  printf("  VincentyDirect_D:  ");
+  Bench_Print_DMS("", lat);
+  Bench_Print_DMS(", ", lon);
+  printf(", reference -37 39' 10.15610\", 143 55' 35.38390\"\n");
+  printf("  HaversineInverse_D: %.3f m\n\n", UCNL_NAV_HaversineInverse_D(sp_lat, sp_lon, ep_lat, ep_lon));
+}
+
+static void Bench_Accuracy(const std::vector<Bench_Line_Struct>& lines, double max_dst_m)
+{
+  double err, err_rt = 0, err_f = 0, err_rtf = 0, rel, rel_max = 0, rel_sum = 0;
+  double dst, fwd_az, lat, lon;
+  float dst_f, fwd_az_f;
+  size_t i;
+
+  for (i = 0; i < lines.size(); i++)
+  {
+    const Bench_Line_Struct& l = lines[i];
+
+    // inverse, then direct back to the end point
+    UCNL_NAV_VincentyInverse_D(l.sp_lat_rad, l.sp_lon_rad, l.ep_lat_rad, l.ep_lon_rad, UCNL_NAV_VINCENTY_MAX_ITERATIONS, true,
+                               &dst, &fwd_az, NULL);
+    UCNL_NAV_VincentyDirect_D(l.sp_lat_rad, l.sp_lon_rad, dst, fwd_az, UCNL_NAV_VINCENTY_MAX_ITERATIONS, &lat, &lon, NULL);
+    err = UCNL_NAV_HaversineInverse_D(lat, lon, l.ep_lat_rad, l.ep_lon_rad);
+    err_rt = fmax(err_rt, fmax(err, fabs(dst - l.dst_m)));
+
+    // real time iterations limit
+    UCNL_NAV_VincentyInverse_D(l.sp_lat_rad, l.sp_lon_rad, l.ep_lat_rad, l.ep_lon_rad, UCNL_NAV_VINCENTY_RT_ITERATIONS, false,
+                               &dst, NULL, NULL);
+    err_rtf = fmax(err_rtf, fabs(dst - l.dst_m));
+
+    // float API
+    UCNL_NAV_VincentyInverse((float)l.sp_lat_rad, (float)l.sp_lon_rad, (float)l.ep_lat_rad, (float)l.ep_lon_rad,
+                             UCNL_NAV_VINCENTY_MAX_ITERATIONS, false, &dst_f, &fwd_az_f, NULL);
+    err_f = fmax(err_f, fabs(dst_f - l.dst_m));
+
+    rel = fabs(UCNL_NAV_HaversineInverse_D(l.sp_lat_rad, l.sp_lon_rad, l.ep_lat_rad, l.ep_lon_rad) - l.dst_m) / l.dst_m;
+    rel_max = fmax(rel_max, rel);
+    rel_sum += rel;
+  }
+
+  printf("lines up to %.0f km:\n", max_dst_m / 1000);
+  printf("  Vincenty double, inverse-direct round trip: max %.3e m\n", err_rt);
+  printf("  Vincenty double, %d iterations limit:        max %.3e m\n", UCNL_NAV_VINCENTY_RT_ITERATIONS, err_rtf);
+  printf("  Vincenty float:                             max %.3e m\n", err_f);
+  printf("  haversine vs Vincenty range:                max %.3f %%, mean %.3f %%\n",
+         rel_max * 100, rel_sum * 100 / lines.size());
+}
+
+// Best time of a few runs, ns per call
+template <typename F>
+static double Bench_Time(F func, const std::vector<Bench_Line_Struct>& lines, double* sink)
+{
+  std::chrono::steady_clock::time_point ts;
+  double t, best = 0, sum = 0;
+  size_t i;
+  int k;
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+    for (i = 0; i < lines.size(); i++)
+      sum += func(lines[i]);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    if ((k == 0) || (t < best))
+      best = t;
+  }
+
+  *sink += sum;
+  return best * 1e9 / lines.size();
+}
+
+static double Bench_Haversine(const Bench_Line_Struct& l)
+{
+  return UCNL_NAV_HaversineInverse_D(l.sp_lat_rad, l.sp_lon_rad, l.ep_lat_rad, l.ep_lon_rad);
+}
+
+static double Bench_Vincenty_RT(const Bench_Line_Struct& l)
+{
+  double dst;
+  UCNL_NAV_VincentyInverse_D(l.sp_lat_rad, l.sp_lon_rad, l.ep_lat_rad, l.ep_lon_rad, UCNL_NAV_VINCENTY_RT_ITERATIONS, false, &dst, NULL, NULL);
+  return dst;
+}
+
+static double Bench_Vincenty(const Bench_Line_Struct& l)
+{
+  double dst;
+  UCNL_NAV_VincentyInverse_D(l.sp_lat_rad, l.sp_lon_rad, l.ep_lat_rad, l.ep_lon_rad, UCNL_NAV_VINCENTY_MAX_ITERATIONS, false, &dst, NULL, NULL);
+  return dst;
+}
+
+static double Bench_Vincenty_Fast(const Bench_Line_Struct& l)
+{
+  double dst;
+  UCNL_NAV_VincentyInverse_D(l.sp_lat_rad, l.sp_lon_rad, l.ep_lat_rad, l.ep_lon_rad, UCNL_NAV_VINCENTY_MAX_ITERATIONS, true, &dst, NULL, NULL);
+  return dst;
+}
+
+static double Bench_Vincenty_Direct(const Bench_Line_Struct& l)
+{
+  double lat, lon;
+  UCNL_NAV_VincentyDirect_D(l.sp_lat_rad, l.sp_lon_rad, l.dst_m, l.fwd_az_rad, UCNL_NAV_VINCENTY_MAX_ITERATIONS, &lat, &lon, NULL);
+  return lat + lon;
+}
+
+static double Bench_Haversine_Direct(const Bench_Line_Struct& l)
+{
+  double lat, lon;
+  UCNL_NAV_HaversineDirect_D(l.sp_lat_rad, l.sp_lon_rad, l.dst_m, l.fwd_az_rad, &lat, &lon);
+  return lat + lon;
+}
+
+// Lines with the end point within 1 degree of the antipode of the start point
+static void Bench_Antipodal(size_t num)
+{
+  size_t i, plain = 0, fast = 0;
+  double sp_lat, ep_lat, ep_lon, dst;
+
+  for (i = 0; i < num; i++)
+  {
+    sp_lat = UCNL_NAV_DEG2RAD(Bench_Rand(-80, 80));
+    ep_lat = -sp_lat + UCNL_NAV_DEG2RAD(Bench_Rand(-1, 1));
+    ep_lon = UCNL_NAV_DEG2RAD(Bench_Rand(178, 179.5));
+
+    if (UCNL_NAV_VincentyInverse_D(sp_lat, 0, ep_lat, ep_lon, UCNL_NAV_VINCENTY_MAX_ITERATIONS, false, &dst, NULL, NULL))
+      plain++;
+    if (UCNL_NAV_VincentyInverse_D(sp_lat, 0, ep_lat, ep_lon, UCNL_NAV_VINCENTY_MAX_ITERATIONS, true, &dst, NULL, NULL))
+      fast++;
+  }
+
+  printf("\nnearly antipodal lines, converged in %d iterations: plain %zu of %zu, accelerated %zu of %zu\n",
+         UCNL_NAV_VINCENTY_MAX_ITERATIONS, plain, num, fast, num);
+}
+
+int main(int argc, char** argv)
+{
+  size_t num = (argc > 1) ? (size_t)atol(argv[1]) : 100000;
+  static const double max_dst_m[] = { 10000, 1000000, 19000000 };
+  std::vector<Bench_Line_Struct> lines;
+  double sink = 0;
+  size_t k;
+
+  srand(1);
+  Bench_Reference();
+
+  for (k = 0; k < sizeof(max_dst_m) / sizeof(max_dst_m[0]); k++)
+  {
+    Bench_Make_Lines(&lines, num, max_dst_m[k]);
+    Bench_Accuracy(lines, max_dst_m[k]);
+    printf("  HaversineInverse_D:            %7.1f ns/call\n", Bench_Time(Bench_Haversine, lines, &sink));
+    printf("  VincentyInverse_D, RT limit:   %7.1f ns/call\n", Bench_Time(Bench_Vincenty_RT, lines, &sink));
+    printf("  VincentyInverse_D:             %7.1f ns/call\n", Bench_Time(Bench_Vincenty, lines, &sink));
+    printf("  VincentyInverse_D accelerated: %7.1f ns/call\n", Bench_Time(Bench_Vincenty_Fast, lines, &sink));
+    printf("  HaversineDirect_D:             %7.1f ns/call\n", Bench_Time(Bench_Haversine_Direct, lines, &sink));
+    printf("  VincentyDirect_D:              %7.1f ns/call\n", Bench_Time(Bench_Vincenty_Direct, lines, &sink));
+  }
+
+  Bench_Antipodal(num / 10);
+  printf("(%g)\n", sink);
+
+  return 0;
+}
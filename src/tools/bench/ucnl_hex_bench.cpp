@@ -0,0 +1,194 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_STR hex codec benchmark: the table driven and SSSE3 encoder/decoder vs the former per digit loops
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -I../common -I../../libs ucnl_hex_bench.cpp ../../libs/ucnl_str.cpp -o ucnl_hex_bench
+//   add -DUCNL_STR_NO_SIMD to measure the table driven scalar kernels alone
+//
+// Usage:
+//   ucnl_hex_bench [packets_number]
+//
+// Packets are random, their sizes are the ones of uWave data packets up to uWAVE_PKT_MAX_SIZE and the
+// longest field a byte index can address. Every decoded packet is compared with the original one, and
+// then a single symbol of each packet is replaced by a non hex one: the number of corrupted packets
+// that were reported as errors is printed for both decoders.
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+
+#define BENCH_RUNS (5)
+#define BENCH_MAX_SIZE (126)
+
+// UCNL_STR_WriteHexStr and UCNL_STR_ReadHexStr before the hex codec rework, kept for the comparison
+static void Bench_WriteHexStr_Legacy(byte* buffer, byte* srcIdx, const byte* src, byte srcSize)
+{
+  int i;
+  for (i = 0; i < srcSize; i++)
+  {
+    buffer[*srcIdx] = UCNL_STR_DIGIT_2HEX(src[i] / 16);
+    (*srcIdx)++;
+    buffer[*srcIdx] = UCNL_STR_DIGIT_2HEX(src[i] % 16);
+    (*srcIdx)++;
+  }
+}
+
+static int Bench_ReadHexStr_Legacy(const byte* buffer, byte stIdx, byte ndIdx, byte* out_buffer, byte out_buffer_size, byte* out_size)
+{
+  int result = 0;
+  for (int i = 0; i < out_buffer_size; i++)
+    out_buffer[i] = 0;
+
+  *out_size = (ndIdx - stIdx - 1);
+  if ((*out_size) % 2 != 0)
+  {
+    result = 1;
+  }
+  else
+  {
+    *out_size /= 2;
+    if ((buffer[stIdx] != '0') || (buffer[stIdx + 1] != 'x'))
+      result = 2;
+    else
+    {
+      int idx = 0;
+      while (idx < *out_size)
+      {
+        out_buffer[idx] = UCNL_STR_HEXDIGIT2B(buffer[stIdx + idx * 2 + 2]) * 16 + UCNL_STR_HEXDIGIT2B(buffer[stIdx + idx * 2 + 3]);
+        idx++;
+      }
+    }
+  }
+
+  return result;
+}
+
+static void Write_Legacy(byte* buffer, byte* idx, const byte* src, byte srcSize)
+{
+  UCNL_STR_WriteStr(buffer, idx, UCNL_STR_HEX_ARRAY_PFX);
+  Bench_WriteHexStr_Legacy(buffer, idx, src, srcSize);
+}
+
+static void Write_New(byte* buffer, byte* idx, const byte* src, byte srcSize)
+{
+  UCNL_STR_WriteHexArray(buffer, idx, (byte*)src, srcSize);
+}
+
+// Best time of a few runs, seconds per packet
+template <typename F>
+static double Bench_Run(F func, size_t num, int rounds)
+{
+  std::chrono::steady_clock::time_point ts;
+  double t, best = 0;
+  int r, k;
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+    for (r = 0; r < rounds; r++)
+      func();
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    if ((k == 0) || (t < best))
+      best = t;
+  }
+
+  return best / ((double)num * rounds);
+}
+
+int main(int argc, char** argv)
+{
+  static const byte sizes[] = { 1, 8, 32, 64, BENCH_MAX_SIZE };
+  size_t num = (argc > 1) ? (size_t)atol(argv[1]) : 1000;
+  std::vector<byte> packets, texts, decoded;
+  double t_enc_legacy, t_enc_new, t_dec_legacy, t_dec_new;
+  size_t i, j, mismatches, detected_legacy, detected_new;
+  byte size, idx, out_size, c;
+  int rounds, m;
+  long sink = 0;
+
+  srand(1);
+  printf("%zu packets, ns/packet: encode legacy, new; decode legacy, new (corrupted packets detected)\n", num);
+
+  for (m = 0; m < (int)(sizeof(sizes) / sizeof(sizes[0])); m++)
+  {
+    size = sizes[m];
+    rounds = (int)(4000000 / (num * size)) + 1;
+
+    packets.resize(num * size);
+    texts.resize(num * 256);
+    decoded.resize(num * BENCH_MAX_SIZE);
+
+    for (i = 0; i < packets.size(); i++)
+      packets[i] = (byte)rand();
+
+    t_enc_legacy = Bench_Run([&]() {
+      for (i = 0; i < num; i++)
+      {
+        idx = 0;
+        Write_Legacy(&texts[i * 256], &idx, &packets[i * size], size);
+        sink += idx;
+      }
+    }, num, rounds);
+
+    t_enc_new = Bench_Run([&]() {
+      for (i = 0; i < num; i++)
+      {
+        idx = 0;
+        Write_New(&texts[i * 256], &idx, &packets[i * size], size);
+        sink += idx;
+      }
+    }, num, rounds);
+
+    t_dec_legacy = Bench_Run([&]() {
+      for (i = 0; i < num; i++)
+        sink += Bench_ReadHexStr_Legacy(&texts[i * 256], 0, (byte)(2 * size + 1), &decoded[i * BENCH_MAX_SIZE], BENCH_MAX_SIZE, &out_size) + out_size;
+    }, num, rounds);
+
+    t_dec_new = Bench_Run([&]() {
+      for (i = 0; i < num; i++)
+        sink += UCNL_STR_ReadHexStr(&texts[i * 256], 0, (byte)(2 * size + 1), &decoded[i * BENCH_MAX_SIZE], BENCH_MAX_SIZE, &out_size) + out_size;
+    }, num, rounds);
+
+    mismatches = 0;
+    for (i = 0; i < num; i++)
+      for (j = 0; j < size; j++)
+        if (decoded[i * BENCH_MAX_SIZE + j] != packets[i * size + j])
+          mismatches++;
+
+    detected_legacy = 0;
+    detected_new = 0;
+    for (i = 0; i < num; i++)
+    {
+      do {
+        c = (byte)rand();
+      } while (((c >= '0') && (c <= '9')) || ((c >= 'A') && (c <= 'F')) || ((c >= 'a') && (c <= 'f')));
+
+      texts[i * 256 + 2 + rand() % (2 * size)] = c;
+
+      if (Bench_ReadHexStr_Legacy(&texts[i * 256], 0, (byte)(2 * size + 1), &decoded[0], BENCH_MAX_SIZE, &out_size) != 0)
+        detected_legacy++;
+      if (UCNL_STR_ReadHexStr(&texts[i * 256], 0, (byte)(2 * size + 1), &decoded[0], BENCH_MAX_SIZE, &out_size) != 0)
+        detected_new++;
+    }
+
+    printf("%3d bytes: %8.2f %8.2f x%5.1f  %8.2f %8.2f x%5.1f  (%zu, %zu)%s\n", size,
+           t_enc_legacy * 1e9, t_enc_new * 1e9, t_enc_legacy / t_enc_new,
+           t_dec_legacy * 1e9, t_dec_new * 1e9, t_dec_legacy / t_dec_new,
+           detected_legacy, detected_new, (mismatches != 0) ? " DECODING ERRORS" : "");
+  }
+
+  printf("(%ld)\n", sink);
+
+  return 0;
+}
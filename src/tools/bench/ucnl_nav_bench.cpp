@@ -0,0 +1,443 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_NAV geodesy benchmark: accuracy and throughput of the float API vs the double (_D) one
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -I../common -I../../libs ucnl_nav_bench.cpp ../../libs/ucnl_nav.cpp -o ucnl_nav_bench
+//   add -mavx2 -mfma (or -march=native) to get the AVX2 batch kernels
+//
+// Usage:
+//   ucnl_nav_bench [pairs_number]
+//
+// Point pairs are spread all over the globe, the second point is 10 m .. 10 km away from the first one,
+// like a base station and a remote. The batch part takes one base and the end points of all the pairs
+// moved next to it, like a fleet of beacons around a base station. Reference values of the float/double
+// checks are the same spherical formulas evaluated in long double with the exact (double) coordinates:
+// these errors are the numerical ones only, they say nothing of the sphere vs the WGS84 ellipsoid, the
+// float errors include rounding of the coordinates to float. The model error is given separately against
+// Vincenty's solutions on the ellipsoid (VincentyInverse_D), checked first on Vincenty's Flinders Peak -
+// Buninyong example. Errors are reported in meters.
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_nav.h"
+
+#define BENCH_RUNS (5)
+
+typedef long double ldouble;
+
+typedef struct {
+  double sp_lat_rad;
+  double sp_lon_rad;
+  double ep_lat_rad;
+  double ep_lon_rad;
+  double dst_m;      // reference distance
+  double fwd_az_rad; // reference initial bearing
+} Bench_Pair_Struct;
+
+typedef struct {
+  double max;
+  double sum2;
+  size_t n;
+} Bench_Error_Struct;
+
+static double Bench_Rand(double min, double max)
+{
+  return min + (max - min) * ((double)rand() / RAND_MAX);
+}
+
+static ldouble Bench_Ref_Inverse(ldouble sp_lat, ldouble sp_lon, ldouble ep_lat, ldouble ep_lon)
+{
+  ldouble sdLat = sinl((ep_lat - sp_lat) / 2);
+  ldouble sdLon = sinl((ep_lon - sp_lon) / 2);
+  ldouble a = sdLat * sdLat + cosl(sp_lat) * cosl(ep_lat) * sdLon * sdLon;
+  return (ldouble)WGS84_MJ_SEMIAXIS_M * 2 * atan2l(sqrtl(a), sqrtl(1 - a));
+}
+
+static ldouble Bench_Ref_InitialBearing(ldouble sp_lat, ldouble sp_lon, ldouble ep_lat, ldouble ep_lon)
+{
+  ldouble y = sinl(ep_lon - sp_lon) * cosl(ep_lat);
+  ldouble x = cosl(sp_lat) * sinl(ep_lat) - sinl(sp_lat) * cosl(ep_lat) * cosl(ep_lon - sp_lon);
+  ldouble az = atan2l(y, x);
+  return (az < 0) ? az + 2 * 3.14159265358979323846264338327950288L : az;
+}
+
+static void Bench_Ref_Direct(ldouble sp_lat, ldouble sp_lon, ldouble dst, ldouble az, ldouble* ep_lat, ldouble* ep_lon)
+{
+  ldouble delta = dst / (ldouble)WGS84_MJ_SEMIAXIS_M;
+  *ep_lat = asinl(sinl(sp_lat) * cosl(delta) + cosl(sp_lat) * sinl(delta) * cosl(az));
+  *ep_lon = sp_lon + atan2l(sinl(az) * sinl(delta) * cosl(sp_lat), cosl(delta) - sinl(sp_lat) * sinl(*ep_lat));
+}
+
+static void Bench_Make_Pairs(std::vector<Bench_Pair_Struct>* pairs, size_t num)
+{
+  Bench_Pair_Struct p;
+  ldouble lat, lon;
+  size_t i;
+
+  for (i = 0; i < num; i++)
+  {
+    p.sp_lat_rad = UCNL_NAV_DEG2RAD(Bench_Rand(-80, 80));
+    p.sp_lon_rad = UCNL_NAV_DEG2RAD(Bench_Rand(-179, 179));
+    Bench_Ref_Direct(p.sp_lat_rad, p.sp_lon_rad, Bench_Rand(10, 10000), Bench_Rand(0, PI2), &lat, &lon);
+    p.ep_lat_rad = (double)lat;
+    p.ep_lon_rad = (double)lon;
+    p.dst_m = (double)Bench_Ref_Inverse(p.sp_lat_rad, p.sp_lon_rad, p.ep_lat_rad, p.ep_lon_rad);
+    p.fwd_az_rad = (double)Bench_Ref_InitialBearing(p.sp_lat_rad, p.sp_lon_rad, p.ep_lat_rad, p.ep_lon_rad);
+    pairs->push_back(p);
+  }
+}
+
+static void Bench_Error_Add(Bench_Error_Struct* e, double err)
+{
+  err = fabs(err);
+  if (err > e->max)
+    e->max = err;
+  e->sum2 += err * err;
+  e->n++;
+}
+
+static void Bench_Error_Print(const char* name, const Bench_Error_Struct* e)
+{
+  printf("  %-24s max %10.3e m, rms %10.3e m\n", name, e->max, sqrt(e->sum2 / (e->n ? e->n : 1)));
+}
+
+template <typename T, typename IF, typename DF, typename BF, typename OF>
+static void Bench_Check(const char* title, IF inverse, DF direct, BF bearing, OF offset, const std::vector<Bench_Pair_Struct>& pairs)
+{
+  Bench_Error_Struct e_inv = { 0, 0, 0 }, e_dir = { 0, 0, 0 }, e_brg = { 0, 0, 0 }, e_ofs = { 0, 0, 0 };
+  T lat, lon, dlat, dlon;
+  ldouble m_per_rad_lat, m_per_rad_lon;
+  double d_az;
+  size_t i;
+
+  for (i = 0; i < pairs.size(); i++)
+  {
+    const Bench_Pair_Struct& p = pairs[i];
+
+    Bench_Error_Add(&e_inv, inverse((T)p.sp_lat_rad, (T)p.sp_lon_rad, (T)p.ep_lat_rad, (T)p.ep_lon_rad) - p.dst_m);
+
+    direct((T)p.sp_lat_rad, (T)p.sp_lon_rad, (T)p.dst_m, (T)p.fwd_az_rad, &lat, &lon);
+    Bench_Error_Add(&e_dir, (double)Bench_Ref_Inverse(lat, lon, p.ep_lat_rad, p.ep_lon_rad));
+
+    // bearing error as the cross-track displacement of the end point,
+    // UCNL_NAV_HaversineInitialBearing returns the forward azimuth plus PI
+    d_az = bearing((T)p.sp_lat_rad, (T)p.sp_lon_rad, (T)p.ep_lat_rad, (T)p.ep_lon_rad) - p.fwd_az_rad - _PI;
+    d_az = remainder(d_az, PI2);
+    Bench_Error_Add(&e_brg, d_az * p.dst_m);
+
+    // local metric offsets: the reference is the same empirical meters per degree model, in long double
+    m_per_rad_lat = (111132.92L - 559.82L * cosl(2.0L * p.sp_lat_rad) + 1.175L * cosl(4.0L * p.sp_lat_rad)) * D180_DBY_PI;
+    m_per_rad_lon = (111412.84L * cosl(p.sp_lat_rad) - 93.5L * cosl(3.0L * p.sp_lat_rad)) * D180_DBY_PI;
+    dlat = (T)((p.sp_lat_rad - p.ep_lat_rad) * m_per_rad_lat);
+    dlon = (T)((p.sp_lon_rad - p.ep_lon_rad) * m_per_rad_lon);
+    offset((T)p.sp_lat_rad, (T)p.sp_lon_rad, dlat, dlon, &lat, &lon);
+    Bench_Error_Add(&e_ofs, (double)Bench_Ref_Inverse(lat, lon, p.ep_lat_rad, p.ep_lon_rad));
+  }
+
+  printf("%s\n", title);
+  Bench_Error_Print("HaversineInverse", &e_inv);
+  Bench_Error_Print("HaversineDirect", &e_dir);
+  Bench_Error_Print("HaversineInitialBearing", &e_brg);
+  Bench_Error_Print("PointOffset_WGS84", &e_ofs);
+}
+
+// The sphere vs the WGS84 ellipsoid: haversine ranges and bearings against VincentyInverse_D
+static void Bench_Ellipsoid(const std::vector<Bench_Pair_Struct>& pairs)
+{
+  Bench_Error_Struct e_inv = { 0, 0, 0 }, e_brg = { 0, 0, 0 }, e_rel = { 0, 0, 0 };
+  double sp_lat = UCNL_NAV_DEG2RAD(-(37 + 57 / 60.0 + 3.72030 / 3600.0));
+  double sp_lon = UCNL_NAV_DEG2RAD(144 + 25 / 60.0 + 29.52440 / 3600.0);
+  double ep_lat = UCNL_NAV_DEG2RAD(-(37 + 39 / 60.0 + 10.15610 / 3600.0));
+  double ep_lon = UCNL_NAV_DEG2RAD(143 + 55 / 60.0 + 35.38390 / 3600.0);
+  double dst, fwd_az, d;
+  size_t i;
+
+  printf("\nsphere vs WGS84 ellipsoid\n");
+  UCNL_NAV_VincentyInverse_D(sp_lat, sp_lon, ep_lat, ep_lon, UCNL_NAV_VINCENTY_MAX_ITERATIONS, false, &dst, &fwd_az, NULL);
+  printf("  Flinders Peak - Buninyong: VincentyInverse_D %.3f m (reference 54972.271 m), HaversineInverse_D %.3f m\n",
+         dst, UCNL_NAV_HaversineInverse_D(sp_lat, sp_lon, ep_lat, ep_lon));
+
+  for (i = 0; i < pairs.size(); i++)
+  {
+    const Bench_Pair_Struct& p = pairs[i];
+
+    if (!UCNL_NAV_VincentyInverse_D(p.sp_lat_rad, p.sp_lon_rad, p.ep_lat_rad, p.ep_lon_rad,
+                                    UCNL_NAV_VINCENTY_MAX_ITERATIONS, false, &dst, &fwd_az, NULL))
+      continue;
+
+    d = UCNL_NAV_HaversineInverse_D(p.sp_lat_rad, p.sp_lon_rad, p.ep_lat_rad, p.ep_lon_rad) - dst;
+    Bench_Error_Add(&e_inv, d);
+    Bench_Error_Add(&e_rel, d / dst * 1000);
+    Bench_Error_Add(&e_brg, remainder(UCNL_NAV_HaversineInitialBearing_D(p.sp_lat_rad, p.sp_lon_rad, p.ep_lat_rad, p.ep_lon_rad) -
+                                      fwd_az - _PI, PI2) * dst);
+  }
+
+  printf("  model errors of the double API, %zu of %zu pairs converged:\n", e_inv.n, pairs.size());
+  Bench_Error_Print("HaversineInverse", &e_inv);
+  Bench_Error_Print("  per km of the range", &e_rel);
+  Bench_Error_Print("HaversineInitialBearing", &e_brg);
+}
+
+// Best time of a few runs, seconds per call
+template <typename T, typename F>
+static double Bench_Run_Inverse(F inverse, const std::vector<Bench_Pair_Struct>& pairs, int rounds, double* sink)
+{
+  std::chrono::steady_clock::time_point ts;
+  std::vector<T> c(pairs.size() * 4);
+  double t, best = 0;
+  size_t i;
+  int r, k;
+  T sum = 0;
+
+  for (i = 0; i < pairs.size(); i++)
+  {
+    c[i * 4 + 0] = (T)pairs[i].sp_lat_rad;
+    c[i * 4 + 1] = (T)pairs[i].sp_lon_rad;
+    c[i * 4 + 2] = (T)pairs[i].ep_lat_rad;
+    c[i * 4 + 3] = (T)pairs[i].ep_lon_rad;
+  }
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+
+    for (r = 0; r < rounds; r++)
+      for (i = 0; i < pairs.size(); i++)
+        sum += inverse(c[i * 4 + 0], c[i * 4 + 1], c[i * 4 + 2], c[i * 4 + 3]);
+
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    if ((k == 0) || (t < best))
+      best = t;
+  }
+
+  *sink += sum;
+  return best / ((double)pairs.size() * rounds);
+}
+
+template <typename T, typename F>
+static double Bench_Run_Direct(F direct, const std::vector<Bench_Pair_Struct>& pairs, int rounds, double* sink)
+{
+  std::chrono::steady_clock::time_point ts;
+  std::vector<T> c(pairs.size() * 4);
+  double t, best = 0;
+  size_t i;
+  int r, k;
+  T lat, lon, sum = 0;
+
+  for (i = 0; i < pairs.size(); i++)
+  {
+    c[i * 4 + 0] = (T)pairs[i].sp_lat_rad;
+    c[i * 4 + 1] = (T)pairs[i].sp_lon_rad;
+    c[i * 4 + 2] = (T)pairs[i].dst_m;
+    c[i * 4 + 3] = (T)pairs[i].fwd_az_rad;
+  }
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+
+    for (r = 0; r < rounds; r++)
+      for (i = 0; i < pairs.size(); i++)
+      {
+        direct(c[i * 4 + 0], c[i * 4 + 1], c[i * 4 + 2], c[i * 4 + 3], &lat, &lon);
+        sum += lat + lon;
+      }
+
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    if ((k == 0) || (t < best))
+      best = t;
+  }
+
+  *sink += sum;
+  return best / ((double)pairs.size() * rounds);
+}
+
+// Batch kernels vs one pair at a time for one base and a fleet of end points around it
+static void Bench_Batch(const std::vector<Bench_Pair_Struct>& pairs, int rounds, double* sink)
+{
+  Bench_Error_Struct e_inv = { 0, 0, 0 }, e_brg = { 0, 0, 0 };
+  std::chrono::steady_clock::time_point ts;
+  size_t i, n = pairs.size();
+  std::vector<float> lat(n), lon(n), dst(n), az(n);
+  std::vector<double> ref_dst(n), ref_az(n);
+  double sp_lat = pairs[0].sp_lat_rad, sp_lon = pairs[0].sp_lon_rad;
+  double t, t_single = 0, t_batch = 0;
+  float sum = 0;
+  int r, k;
+
+  for (i = 0; i < n; i++)
+  {
+    // keep the offsets of the pairs, but from the one base
+    lat[i] = (float)(sp_lat + pairs[i].ep_lat_rad - pairs[i].sp_lat_rad);
+    lon[i] = (float)(sp_lon + pairs[i].ep_lon_rad - pairs[i].sp_lon_rad);
+    ref_dst[i] = (double)Bench_Ref_Inverse((float)sp_lat, (float)sp_lon, lat[i], lon[i]);
+    ref_az[i] = (double)Bench_Ref_InitialBearing((float)sp_lat, (float)sp_lon, lat[i], lon[i]);
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    Bench_Error_Add(&e_inv, UCNL_NAV_HaversineInverse((float)sp_lat, (float)sp_lon, lat[i], lon[i]) - ref_dst[i]);
+    Bench_Error_Add(&e_brg, remainder(UCNL_NAV_HaversineInitialBearing((float)sp_lat, (float)sp_lon, lat[i], lon[i]) -
+                                      ref_az[i] - _PI, PI2) * ref_dst[i]);
+  }
+
+  printf("\nfleet, the same float coordinates as the reference:\n");
+  Bench_Error_Print("HaversineInverse", &e_inv);
+  Bench_Error_Print("HaversineInitialBearing", &e_brg);
+
+  memset(&e_inv, 0, sizeof(e_inv));
+  memset(&e_brg, 0, sizeof(e_brg));
+  UCNL_NAV_Haversine_Batch((float)sp_lat, (float)sp_lon, &lat[0], &lon[0], &dst[0], &az[0], (int)n);
+  for (i = 0; i < n; i++)
+  {
+    Bench_Error_Add(&e_inv, dst[i] - ref_dst[i]);
+    Bench_Error_Add(&e_brg, remainder(az[i] - ref_az[i] - _PI, PI2) * ref_dst[i]);
+  }
+
+  Bench_Error_Print("Haversine_Batch range", &e_inv);
+  Bench_Error_Print("Haversine_Batch bearing", &e_brg);
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+    for (r = 0; r < rounds; r++)
+      for (i = 0; i < n; i++)
+      {
+        dst[i] = UCNL_NAV_HaversineInverse((float)sp_lat, (float)sp_lon, lat[i], lon[i]);
+        az[i] = UCNL_NAV_HaversineInitialBearing((float)sp_lat, (float)sp_lon, lat[i], lon[i]);
+      }
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    if ((k == 0) || (t < t_single))
+      t_single = t;
+    sum += dst[k] + az[k];
+
+    ts = std::chrono::steady_clock::now();
+    for (r = 0; r < rounds; r++)
+      UCNL_NAV_Haversine_Batch((float)sp_lat, (float)sp_lon, &lat[0], &lon[0], &dst[0], &az[0], (int)n);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    if ((k == 0) || (t < t_batch))
+      t_batch = t;
+    sum += dst[k] + az[k];
+  }
+
+  *sink += sum;
+  printf("range + bearing, one pair a time: %8.2f ns/point\n", t_single * 1e9 / ((double)n * rounds));
+  printf("range + bearing, Haversine_Batch: %8.2f ns/point\n", t_batch * 1e9 / ((double)n * rounds));
+}
+
+// Local frame vs GetDeltasByGeopoints/PointOffset for one origin and a fleet of points around it, double
+static void Bench_LocalFrame(const std::vector<Bench_Pair_Struct>& pairs, int rounds, double* sink)
+{
+  UCNL_NAV_LocalFrame_D_Struct frame;
+  std::chrono::steady_clock::time_point ts;
+  size_t i, n = pairs.size();
+  std::vector<double> lat(n), lon(n), dlat(n), dlon(n), lat2(n), lon2(n);
+  double sp_lat = pairs[0].sp_lat_rad, sp_lon = pairs[0].sp_lon_rad;
+  double y, x, e_fwd = 0, e_inv = 0, e_ofs = 0, sum = 0;
+  double t, t_deltas = 0, t_fwd = 0, t_ofs = 0, t_inv = 0;
+  int r, k;
+
+  UCNL_NAV_LocalFrame_Init_D(&frame, sp_lat, sp_lon);
+
+  for (i = 0; i < n; i++)
+  {
+    lat[i] = sp_lat + pairs[i].ep_lat_rad - pairs[i].sp_lat_rad;
+    lon[i] = sp_lon + pairs[i].ep_lon_rad - pairs[i].sp_lon_rad;
+
+    UCNL_NAV_GetDeltasByGeopoints_WGS84_D(sp_lat, sp_lon, lat[i], lon[i], &y, &x);
+    UCNL_NAV_LocalFrame_Forward_D(&frame, lat[i], lon[i], &dlat[i], &dlon[i]);
+    e_fwd = fmax(e_fwd, sqrt((y - dlat[i]) * (y - dlat[i]) + (x - dlon[i]) * (x - dlon[i])));
+
+    UCNL_NAV_LocalFrame_Inverse_D(&frame, dlat[i], dlon[i], &lat2[i], &lon2[i]);
+    e_inv = fmax(e_inv, (double)Bench_Ref_Inverse(lat[i], lon[i], lat2[i], lon2[i]));
+
+    UCNL_NAV_PointOffset_WGS84_D(sp_lat, sp_lon, y, x, &lat2[i], &lon2[i]);
+    e_ofs = fmax(e_ofs, (double)Bench_Ref_Inverse(lat[i], lon[i], lat2[i], lon2[i]));
+  }
+
+  printf("\nlocal frame (LocalFrame_), double:\n");
+  printf("  Forward_D vs GetDeltasByGeopoints_WGS84_D:              max %10.3e m\n", e_fwd);
+  printf("  Forward_D, Inverse_D round trip:                        max %10.3e m\n", e_inv);
+  printf("  GetDeltasByGeopoints_WGS84_D, PointOffset_WGS84_D trip: max %10.3e m\n", e_ofs);
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+    for (r = 0; r < rounds; r++)
+      for (i = 0; i < n; i++)
+        UCNL_NAV_GetDeltasByGeopoints_WGS84_D(sp_lat, sp_lon, lat[i], lon[i], &dlat[i], &dlon[i]);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    t_deltas = ((k == 0) || (t < t_deltas)) ? t : t_deltas;
+    sum += dlat[k] + dlon[k];
+
+    ts = std::chrono::steady_clock::now();
+    for (r = 0; r < rounds; r++)
+      UCNL_NAV_LocalFrame_Forward_Batch_D(&frame, &lat[0], &lon[0], &dlat[0], &dlon[0], (int)n);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    t_fwd = ((k == 0) || (t < t_fwd)) ? t : t_fwd;
+    sum += dlat[k] + dlon[k];
+
+    ts = std::chrono::steady_clock::now();
+    for (r = 0; r < rounds; r++)
+      for (i = 0; i < n; i++)
+        UCNL_NAV_PointOffset_WGS84_D(sp_lat, sp_lon, dlat[i], dlon[i], &lat2[i], &lon2[i]);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    t_ofs = ((k == 0) || (t < t_ofs)) ? t : t_ofs;
+    sum += lat2[k] + lon2[k];
+
+    ts = std::chrono::steady_clock::now();
+    for (r = 0; r < rounds; r++)
+      UCNL_NAV_LocalFrame_Inverse_Batch_D(&frame, &dlat[0], &dlon[0], &lat2[0], &lon2[0], (int)n);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    t_inv = ((k == 0) || (t < t_inv)) ? t : t_inv;
+    sum += lat2[k] + lon2[k];
+  }
+
+  *sink += sum;
+  printf("GetDeltasByGeopoints_WGS84_D:  %8.2f ns/point\n", t_deltas * 1e9 / ((double)n * rounds));
+  printf("LocalFrame_Forward_Batch_D:    %8.2f ns/point\n", t_fwd * 1e9 / ((double)n * rounds));
+  printf("PointOffset_WGS84_D:           %8.2f ns/point\n", t_ofs * 1e9 / ((double)n * rounds));
+  printf("LocalFrame_Inverse_Batch_D:    %8.2f ns/point\n", t_inv * 1e9 / ((double)n * rounds));
+}
+
+int main(int argc, char** argv)
+{
+  size_t num = (argc > 1) ? (size_t)atol(argv[1]) : 10000;
+  int rounds = (int)(2000000 / (num ? num : 1)) + 1;
+  std::vector<Bench_Pair_Struct> pairs;
+  double sink = 0;
+
+  srand(1);
+  Bench_Make_Pairs(&pairs, num);
+
+  printf("%zu point pairs, 10 m .. 10 km apart\n\n", pairs.size());
+
+  Bench_Check<float>("float API:", UCNL_NAV_HaversineInverse, UCNL_NAV_HaversineDirect,
+                     UCNL_NAV_HaversineInitialBearing, UCNL_NAV_PointOffset_WGS84, pairs);
+  Bench_Check<double>("double API:", UCNL_NAV_HaversineInverse_D, UCNL_NAV_HaversineDirect_D,
+                      UCNL_NAV_HaversineInitialBearing_D, UCNL_NAV_PointOffset_WGS84_D, pairs);
+  Bench_Ellipsoid(pairs);
+
+  printf("\n%zu pairs x %d rounds\n", pairs.size(), rounds);
+  printf("HaversineInverse:    %8.2f ns/call\n", Bench_Run_Inverse<float>(UCNL_NAV_HaversineInverse, pairs, rounds, &sink) * 1e9);
+  printf("HaversineInverse_D:  %8.2f ns/call\n", Bench_Run_Inverse<double>(UCNL_NAV_HaversineInverse_D, pairs, rounds, &sink) * 1e9);
+  printf("HaversineDirect:     %8.2f ns/call\n", Bench_Run_Direct<float>(UCNL_NAV_HaversineDirect, pairs, rounds, &sink) * 1e9);
+  printf("HaversineDirect_D:   %8.2f ns/call\n", Bench_Run_Direct<double>(UCNL_NAV_HaversineDirect_D, pairs, rounds, &sink) * 1e9);
+
+  Bench_Batch(pairs, rounds, &sink);
+  Bench_LocalFrame(pairs, rounds, &sink);
+  printf("(%g)\n", sink);
+
+  return 0;
+}
@@ -0,0 +1,330 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_NMEA ingestion benchmark: UCNL_NMEA_Process_Buffer vs feeding the same data to the former
+// UCNL_NMEA_Process_Byte and to the current one byte by byte
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -fpermissive -I../common -I../../libs ucnl_nmea_bench.cpp
+//       ../../libs/ucnl_str.cpp ../../libs/ucnl_nmea.cpp -o ucnl_nmea_bench
+//
+// Usage:
+//   ucnl_nmea_bench [capture.log]
+//
+// Without a capture an 8 MB log of GNSS and uWave sentences is generated: a few percent of them have
+// wrong checksums, no checksums or are cut short, some are preceded by garbage. The former Process_Byte
+// looks sentence IDs up in a list, as UCNL_NMEA_InitStruct sets them, the current paths look them up in
+// a sentence IDs table (UCNL_NMEA_Set_SntIDs_Table), Process_Buffer is also timed with the list.
+// The data is fed by random chunks of up to 4 KB, the number of complete sentences of every path
+// is printed along with the time.
+
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+#include "ucnl_nmea.h"
+
+#define BENCH_RUNS        (15)
+#define BENCH_LOG_SIZE    (8 * 1024 * 1024)
+#define BENCH_CHUNK_SIZE  (4096)
+#define BENCH_BUFFER_SIZE (255)
+
+static long bench_ids[] = {
+  UCNL_NMEA_RMC_SNT_ID, UCNL_NMEA_GGA_SNT_ID, UCNL_NMEA_GLL_SNT_ID, UCNL_NMEA_VTG_SNT_ID,
+  UCNL_NMEA_HDT_SNT_ID, UCNL_NMEA_ZDA_SNT_ID, UCNL_NMEA_MTW_SNT_ID,
+  0x55575630, 0x55575633, 0x55575634, 0x55575637, 0x55575648, 0x5557564A, 0x5557564D };
+
+// UCNL_NMEA_Process_Byte before the bulk ingestion rework, kept for the comparison: it clears the whole
+// buffer on every start symbol. The only change is the isPSentence reset, without it the former version
+// takes every sentence after a proprietary one for a proprietary one and the sentence counts differ.
+// Not inlined, as it was not when it lived in the library
+static __attribute__((noinline)) UCNL_NMEA_Result_Enum Bench_Process_Byte_Legacy(UCNL_NMEA_State_Struct* uState, byte newByte)
+{
+  UCNL_NMEA_Result_Enum result = UCNL_NMEA_RESULT_BYPASS_BYTE;
+
+  if (!uState->isReady)
+  {
+    if (newByte == UCNL_NMEA_SNT_STR)
+    {
+      uState->isStarted = true;
+      result = UCNL_NMEA_RESULT_PACKET_STARTED;
+
+      for (int i = 0; i < uState->buffer_size; i++)
+        uState->buffer[i] = 0;
+
+      uState->chk_act     = 0;
+      uState->chk_dcl     = 0;
+      uState->chk_dcl_idx = 0;
+      uState->idx         = 0;
+
+      uState->isPSentence = false;
+      uState->tkrID       = 0;
+      uState->sntID       = 0;
+
+      uState->buffer[uState->idx] = newByte;
+      uState->idx++;
+    }
+    else
+    {
+      if (uState->isStarted)
+      {
+        result = UCNL_NMEA_RESULT_PACKET_PROCESS;
+        uState->buffer[uState->idx] = newByte;
+
+        if (newByte == UCNL_NMEA_SNT_END)
+        {
+          uState->isStarted = false;
+          uState->isReady = true;
+          result = UCNL_NMEA_RESULT_PACKET_READY;
+        }
+        else if (newByte == UCNL_NMEA_CHK_SEP)
+        {
+          uState->chk_dcl_idx = 1;
+          uState->chk_present = true;
+        }
+        else
+        {
+          if (uState->idx >= uState->buffer_size)
+          {
+            uState->isStarted = false;
+            result = UCNL_NMEA_RESULT_PACKET_TOO_BIG;
+          }
+          else
+          {
+            if (uState->chk_dcl_idx == 0)
+            {
+              uState->chk_act ^= newByte;
+              if      (uState->idx == 1)
+                if (newByte == UCNL_NMEA_PSENTENCE_SYMBOL)
+                  uState->isPSentence = true;
+                else
+                  uState->tkrID = ((int)newByte) << 8;
+              else if (uState->idx == 2)
+                if (uState->isPSentence)
+                  uState->sntID = ((long)newByte) << 24;
+                else
+                  uState->tkrID |= newByte;
+              else if (uState->idx == 3)
+                if (uState->isPSentence)
+                  uState->sntID |= (((long)newByte) << 16);
+                else
+                  uState->sntID = (((long)newByte) << 16);
+              else if (uState->idx == 4)
+                uState->sntID |= (((long)newByte) << 8);
+              else if (uState->idx == 5)
+              {
+                uState->sntID |= newByte;
+
+                byte i = 0;
+                while ((i < uState->sntIDs_size) && (uState->sntID != uState->sntIDs[i]))
+                  i++;
+
+                if (i >= uState->sntIDs_size)
+                {
+                  uState->isStarted = false;
+                  result = UCNL_NMEA_RESULT_PACKET_SKIPPING;
+                }
+              }
+            }
+            else if (uState->chk_dcl_idx == 1)
+            {
+              uState->chk_dcl = 16 * UCNL_STR_HEXDIGIT2B(newByte);
+              uState->chk_dcl_idx++;
+            }
+            else if (uState->chk_dcl_idx == 2)
+            {
+              uState->chk_dcl += UCNL_STR_HEXDIGIT2B(newByte);
+              if (uState->chk_act != uState->chk_dcl)
+              {
+                uState->isStarted = false;
+                result = UCNL_NMEA_RESULT_PACKET_CHECKSUM_ERROR;
+              }
+              uState->chk_dcl_idx++;
+            }
+          }
+        }
+        uState->idx++;
+      }
+    }
+  }
+  return result;
+}
+
+static double Bench_Rand(double v_min, double v_max)
+{
+  return v_min + (v_max - v_min) * (rand() / (double)RAND_MAX);
+}
+
+static std::string Bench_Sentence()
+{
+  static const char* ids[] = { "GPRMC", "GNGGA", "GPGLL", "GPVTG", "HEHDT", "GPZDA", "YXMTW", "GPGSV",
+                               "PUWV0", "PUWV3", "PUWV4", "PUWV7", "PUWVH", "PUWVJ", "PUWVM" };
+  char body[160], field[32];
+  int k = rand() % (int)(sizeof(ids) / sizeof(ids[0]));
+  int i, n = 2 + rand() % 12;
+  std::string s;
+  byte chk = 0;
+
+  snprintf(body, sizeof(body), "%s", ids[k]);
+  for (i = 0; i < n; i++)
+  {
+    switch (rand() % 4)
+    {
+      case 0:  snprintf(field, sizeof(field), ",%.*f", 1 + rand() % 6, Bench_Rand(-180, 5000)); break;
+      case 1:  snprintf(field, sizeof(field), ",%d", rand() % 1000); break;
+      case 2:  snprintf(field, sizeof(field), ",%c", "ANSEWTMK"[rand() % 8]); break;
+      default: snprintf(field, sizeof(field), ","); break;
+    }
+    strncat(body, field, sizeof(body) - strlen(body) - 1);
+  }
+
+  for (i = 0; body[i] != '\0'; i++)
+    chk ^= (byte)body[i];
+
+  s = std::string("$") + body;
+  k = rand() % 100;
+  if (k < 5)
+    snprintf(field, sizeof(field), "*%02X\r\n", (chk + 1) & 0xFF);
+  else if (k < 10)
+    snprintf(field, sizeof(field), "\r\n");
+  else
+    snprintf(field, sizeof(field), "*%02X\r\n", chk);
+  s += field;
+
+  if (k >= 98)
+    s.resize(1 + rand() % s.size());
+
+  if (rand() % 100 < 3)
+    for (i = 1 + rand() % 30; i > 0; i--)
+      s.insert(s.begin(), (char)(' ' + rand() % 90));
+
+  return s;
+}
+
+static size_t bench_sentences;
+
+static void Bench_OnSentence(UCNL_NMEA_State_Struct* uState, void* param)
+{
+  bench_sentences++;
+}
+
+// Time of a single run, seconds
+template <typename F>
+static double Bench_Time(F func)
+{
+  std::chrono::steady_clock::time_point ts = std::chrono::steady_clock::now();
+
+  func();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+}
+
+static void Bench_Best(double* best, double t, int k)
+{
+  if ((k == 0) || (t < *best))
+    *best = t;
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<byte> data;
+  std::vector<size_t> chunks;
+  std::string s;
+  byte buffer[BENCH_BUFFER_SIZE];
+  UCNL_NMEA_State_Struct uState;
+  UCNL_NMEA_SntIDs_Table_Struct table;
+  size_t i, n, legacy_num, byte_num, list_num, buffer_num;
+  double t_legacy = 0, t_byte = 0, t_list = 0, t_buffer = 0;
+  FILE* fp;
+  int c, k;
+
+  srand(1);
+
+  if (argc > 1)
+  {
+    fp = fopen(argv[1], "rb");
+    if (fp == NULL)
+    {
+      printf("can not open %s\n", argv[1]);
+      return 1;
+    }
+    while ((c = fgetc(fp)) != EOF)
+      data.push_back((byte)c);
+    fclose(fp);
+  }
+  else
+  {
+    while (data.size() < BENCH_LOG_SIZE)
+    {
+      s = Bench_Sentence();
+      data.insert(data.end(), s.begin(), s.end());
+    }
+  }
+
+  for (i = 0; i < data.size(); i += n)
+  {
+    n = 1 + rand() % BENCH_CHUNK_SIZE;
+    chunks.push_back(n);
+  }
+
+  UCNL_NMEA_InitStruct(&uState, buffer, BENCH_BUFFER_SIZE, bench_ids, sizeof(bench_ids) / sizeof(bench_ids[0]));
+
+  UCNL_NMEA_SntIDs_Init(&table);
+  for (i = 0; i < sizeof(bench_ids) / sizeof(bench_ids[0]); i++)
+    UCNL_NMEA_SntIDs_Add(&table, bench_ids[i], NULL, NULL);
+
+  auto buffer_run = [&]() {
+    bench_sentences = 0;
+    for (i = 0, n = 0; i < data.size(); i += chunks[n++])
+      UCNL_NMEA_Process_Buffer(&uState, &data[i], (chunks[n] < data.size() - i) ? chunks[n] : data.size() - i, Bench_OnSentence, NULL);
+    return bench_sentences;
+  };
+
+  // the paths take turns, the best run of each is taken, so a slow spell of the host hits them all
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    UCNL_NMEA_Set_SntIDs_Table(&uState, NULL);
+
+    Bench_Best(&t_legacy, Bench_Time([&]() {
+      legacy_num = 0;
+      for (i = 0; i < data.size(); i++)
+        if (Bench_Process_Byte_Legacy(&uState, data[i]) == UCNL_NMEA_RESULT_PACKET_READY)
+        {
+          legacy_num++;
+          UCNL_NMEA_Release(&uState);
+        }
+    }), k);
+
+    Bench_Best(&t_list, Bench_Time([&]() { list_num = buffer_run(); }), k);
+
+    UCNL_NMEA_Set_SntIDs_Table(&uState, &table);
+
+    Bench_Best(&t_byte, Bench_Time([&]() {
+      byte_num = 0;
+      for (i = 0; i < data.size(); i++)
+        if (UCNL_NMEA_Process_Byte(&uState, data[i]) == UCNL_NMEA_RESULT_PACKET_READY)
+        {
+          byte_num++;
+          UCNL_NMEA_Release(&uState);
+        }
+    }), k);
+
+    Bench_Best(&t_buffer, Bench_Time([&]() { buffer_num = buffer_run(); }), k);
+  }
+
+  printf("%zu bytes, ms (complete sentences)\n", data.size());
+  printf("former Process_Byte    %8.2f (%zu)\n", t_legacy * 1e3, legacy_num);
+  printf("Process_Byte           %8.2f (%zu)  x%5.2f\n", t_byte * 1e3, byte_num, t_legacy / t_byte);
+  printf("Process_Buffer, list   %8.2f (%zu)  x%5.2f\n", t_list * 1e3, list_num, t_legacy / t_list);
+  printf("Process_Buffer         %8.2f (%zu)  x%5.2f\n", t_buffer * 1e3, buffer_num, t_legacy / t_buffer);
+
+  return ((legacy_num == byte_num) && (byte_num == list_num) && (list_num == buffer_num)) ? 0 : 1;
+}
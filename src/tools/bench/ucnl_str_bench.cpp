@@ -0,0 +1,256 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_STR_ParseFloat benchmark: the one-pass integer mantissa parser vs the former float accumulating one
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -I../common -I../../libs ucnl_str_bench.cpp ../../libs/ucnl_str.cpp -o ucnl_str_bench
+//
+// Usage:
+//   ucnl_str_bench [fields_number]
+//
+// Fields look like the ones in NMEA and uWave sentences: coordinates in ddmm.mmmm, propagation times,
+// temperatures, pressures etc. Both parsers are also checked against strtof/strtod, the number of
+// results that are not the nearest float (double) to the field is reported.
+// The time of a parser that only reads the field is the loop and call overhead, it is subtracted for
+// the net times. Then every field shape is timed on its own.
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+
+#define BENCH_RUNS (9)
+
+typedef struct {
+  size_t base;       // the field is at buffer[st..nd], buffer = &text[base]
+  byte st;
+  byte nd;
+} Bench_Field_Struct;
+
+// UCNL_STR_ParseFloat before the integer mantissa rework, kept for the comparison
+static float Bench_ParseFloat_Legacy(const byte* buffer, byte stIdx, byte ndIdx)
+{
+  int i, dotIdx = ndIdx + 1;
+  float sign = 1.0f, fract = 0.0f;
+
+  if (buffer[stIdx] == '-')
+  {
+    sign = -1.0f;
+    stIdx++;
+  }
+
+  for (i = stIdx; i <= ndIdx; i++)
+  {
+    if (buffer[i] == '.')
+    {
+      dotIdx = i;
+    }
+  }
+
+  float result = 0.0f;
+  float multiplier = 1.0f;
+
+  for (i = dotIdx - 1; i >= stIdx; i--)
+  {
+    result += ((float)((buffer[i] - '0'))) * multiplier;
+    multiplier *= 10.0f;
+  }
+
+  multiplier = 0.1f;
+
+  for (i = dotIdx + 1; i <= ndIdx; i++)
+  {
+    fract += ((float)((buffer[i] - '0'))) * multiplier;
+    multiplier /= 10.0f;
+  }
+
+  result += fract;
+  return result * sign;
+}
+
+// Reads the field and nothing else: the loop and call overhead
+static float Bench_ParseFloat_Empty(const byte* buffer, byte stIdx, byte ndIdx)
+{
+  return (float)buffer[stIdx] + (float)buffer[ndIdx];
+}
+
+// Random field with "intDigits" integer and "fractDigits" fractional digits
+static int Bench_Make_Field(char* str, int intDigits, int fractDigits, bool isNegative)
+{
+  int i, n = 0;
+
+  if (isNegative)
+    str[n++] = '-';
+
+  for (i = 0; i < intDigits; i++)
+    str[n++] = (char)('0' + ((i == 0) && (intDigits > 1) ? 1 + rand() % 9 : rand() % 10));
+
+  if (fractDigits > 0)
+  {
+    str[n++] = '.';
+    for (i = 0; i < fractDigits; i++)
+      str[n++] = (char)('0' + rand() % 10);
+  }
+
+  return n;
+}
+
+// Field shapes: integer digits, fractional digits, may be negative
+static const int Bench_Shapes[][3] = {
+  { 6, 3, 0 },   // RMC: UTC time hhmmss.sss
+  { 4, 4, 0 },   //      latitude ddmm.mmmm
+  { 5, 7, 0 },   //      longitude dddmm.mmmmmmm
+  { 1, 3, 0 },   //      speed
+  { 3, 1, 0 },   //      course
+  { 1, 5, 0 },   // RC_RESPONSE: propagation time
+  { 2, 1, 0 },   //              MSR
+  { 3, 1, 0 },   //              azimuth
+  { 4, 2, 0 },   // AMB_DTA: pressure
+  { 2, 1, 1 },   //          temperature, may be negative
+  { 2, 2, 0 },   //          depth
+  { 2, 1, 0 },   //          supply voltage
+};
+#define BENCH_SHAPES_NUM ((int)(sizeof(Bench_Shapes) / sizeof(Bench_Shapes[0])))
+
+/* Fields are stored as sentence bodies: field,field,...
+   Like in a real stream, sentences of a few kinds follow each other, so the field shapes repeat
+   and only the digits are random
+   "shape" is an index in Bench_Shapes or -1 for all of them in turn
+*/
+static void Bench_Make_Fields(std::vector<byte>* text, std::vector<Bench_Field_Struct>* fields, size_t num, int shape)
+{
+  char str[32];
+  size_t i;
+  int n, k;
+  Bench_Field_Struct field;
+
+  for (i = 0; i < num; i++)
+  {
+    if (text->size() > 200)
+    {
+      // fields are addressed by byte indexes, start a new "sentence"
+      text->resize((text->size() + 255) & ~(size_t)255);
+    }
+
+    k = (shape < 0) ? (int)(i % BENCH_SHAPES_NUM) : shape;
+    n = Bench_Make_Field(str, Bench_Shapes[k][0], Bench_Shapes[k][1], (Bench_Shapes[k][2] != 0) && ((rand() % 8) == 0));
+
+    field.base = text->size() & ~(size_t)255;
+    field.st = (byte)(text->size() - field.base);
+    field.nd = (byte)(field.st + n - 1);
+    fields->push_back(field);
+
+    text->insert(text->end(), str, str + n);
+    text->push_back(',');
+  }
+}
+
+// Time of a run, seconds per field
+template <typename T, typename F>
+static double Bench_Run(F parse, const std::vector<byte>& text, const std::vector<Bench_Field_Struct>& fields, int rounds, T* sink)
+{
+  std::chrono::steady_clock::time_point ts = std::chrono::steady_clock::now();
+  size_t i;
+  int r;
+  T sum = 0;
+
+  for (r = 0; r < rounds; r++)
+    for (i = 0; i < fields.size(); i++)
+      sum += parse(&text[fields[i].base], fields[i].st, fields[i].nd);
+
+  *sink += sum;
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count() / ((double)fields.size() * rounds);
+}
+
+template <typename T, typename F, typename R>
+static size_t Bench_Check(F parse, R reference, const std::vector<byte>& text, const std::vector<Bench_Field_Struct>& fields)
+{
+  char str[32];
+  size_t i, errors = 0;
+
+  for (i = 0; i < fields.size(); i++)
+  {
+    memcpy(str, &text[fields[i].base + fields[i].st], fields[i].nd - fields[i].st + 1);
+    str[fields[i].nd - fields[i].st + 1] = '\0';
+
+    if (parse(&text[fields[i].base], fields[i].st, fields[i].nd) != (T)reference(str, NULL))
+      errors++;
+  }
+
+  return errors;
+}
+
+// Best times of the empty, the legacy and the new parsers, seconds per field: they take turns,
+// so a slow spell of the host hits them all
+static void Bench_Times(const std::vector<byte>& text, const std::vector<Bench_Field_Struct>& fields, int rounds,
+                        double* times, float* fsink, double* dsink)
+{
+  double t[4];
+  int i, k;
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    t[0] = Bench_Run<float>(Bench_ParseFloat_Empty, text, fields, rounds, fsink);
+    t[1] = Bench_Run<float>(Bench_ParseFloat_Legacy, text, fields, rounds, fsink);
+    t[2] = Bench_Run<float>(UCNL_STR_ParseFloat, text, fields, rounds, fsink);
+    t[3] = Bench_Run<double>(UCNL_STR_ParseDouble, text, fields, rounds, dsink);
+
+    for (i = 0; i < 4; i++)
+      times[i] = ((k == 0) || (t[i] < times[i])) ? t[i] : times[i];
+  }
+}
+
+int main(int argc, char** argv)
+{
+  size_t num = (argc > 1) ? (size_t)atol(argv[1]) : 10000;
+  int rounds = (int)(10000000 / (num ? num : 1)) + 1;
+  std::vector<byte> text;
+  std::vector<Bench_Field_Struct> fields;
+  float fsink = 0;
+  double dsink = 0;
+  double t[4];
+  int k;
+
+  srand(1);
+  text.reserve(num * 16);
+  Bench_Make_Fields(&text, &fields, num, -1);
+  text.resize(text.size() + 256);
+
+  Bench_Times(text, fields, rounds, t, &fsink, &dsink);
+
+  printf("%zu fields x %d rounds, ns/field, net of the %.2f ns loop and call overhead in brackets\n",
+         fields.size(), rounds, t[0] * 1e9);
+  printf("legacy ParseFloat: %8.2f (%5.2f), %zu not nearest float\n", t[1] * 1e9, (t[1] - t[0]) * 1e9,
+         Bench_Check<float>(Bench_ParseFloat_Legacy, strtof, text, fields));
+  printf("ParseFloat:        %8.2f (%5.2f), %zu not nearest float\n", t[2] * 1e9, (t[2] - t[0]) * 1e9,
+         Bench_Check<float>(UCNL_STR_ParseFloat, strtof, text, fields));
+  printf("ParseDouble:       %8.2f (%5.2f), %zu not nearest double\n", t[3] * 1e9, (t[3] - t[0]) * 1e9,
+         Bench_Check<double>(UCNL_STR_ParseDouble, strtod, text, fields));
+
+  // every shape on its own, the same number of fields, fewer rounds
+  printf("\nshape      legacy  ParseFloat  ParseDouble, net ns/field\n");
+  for (k = 0; k < BENCH_SHAPES_NUM; k++)
+  {
+    text.clear();
+    fields.clear();
+    Bench_Make_Fields(&text, &fields, num, k);
+    text.resize(text.size() + 256);
+
+    Bench_Times(text, fields, rounds / 4 + 1, t, &fsink, &dsink);
+    printf("%s%d.%-2d  %9.2f %11.2f %12.2f\n", Bench_Shapes[k][2] ? "-" : " ", Bench_Shapes[k][0], Bench_Shapes[k][1],
+           (t[1] - t[0]) * 1e9, (t[2] - t[0]) * 1e9, (t[3] - t[0]) * 1e9);
+  }
+
+  printf("(%g %g)\n", fsink, dsink);
+
+  return 0;
+}
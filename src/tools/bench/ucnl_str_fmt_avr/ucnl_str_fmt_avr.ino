@@ -0,0 +1,160 @@
+/*
+  Copyright (C) 2021, Underwater communication & navigation laboratory
+  All rights reserved.
+
+  www.unavlab.com
+  hello@unavlab.com
+
+*/
+/* UCNL_STR_WriteIntDec/WriteFloat CPU cycles on an 8-bit AVR board (Uno, Nano, Mega)
+
+   The sketch:
+
+   Counts CPU cycles of the digit pairs formatter and the former division loops for
+   values like the fields of the uWave builders, Timer1 runs at the CPU clock.
+   Results are printed to Serial at 115200 baud. The host side benchmark is
+   src/tools/bench/ucnl_fmt_bench.cpp
+*/
+
+#include "ucnl_str.h"
+
+#define SERIAL_BAUDRATE (115200)
+
+// UCNL_STR_WriteIntDec and UCNL_STR_WriteFloat before the digit pairs rework, kept for the comparison
+void WriteIntDec_Legacy(byte* buffer, byte* srcIdx, long src, byte zPad)
+{
+  long x = src;
+  int len = 0, i;
+
+  do {
+    x /= 10;
+    len++;
+  } while (x >= 1);
+
+  x = 1;
+  for (i = 1; i < len; i++) x *= 10;
+
+  if (zPad > 0) i = zPad;
+  else i = len;
+
+  do
+  {
+    if (i > len) buffer[*srcIdx] = '0';
+    else
+    {
+      buffer[*srcIdx] = (byte)((src / x) + '0');
+      src -= (src / x) * x;
+      x /= 10;
+    }
+    (*srcIdx)++;
+  } while (--i > 0);
+}
+
+void WriteFloat_Legacy(byte* buffer, byte* srcIdx, float f, byte dPlaces, byte zPad)
+{
+  float ff = f;
+
+  if (ff < 0)
+  {
+    UCNL_STR_WriteByte(buffer, srcIdx, '-');
+    ff = -f;
+  }
+
+  long dec = (long)ff, mult = 1;
+  int i;
+  for (i = 0; i < dPlaces; i++) mult *= 10;
+  long frac = (long)((ff - dec) * (float)mult);
+
+  WriteIntDec_Legacy(buffer, srcIdx, dec, zPad);
+  UCNL_STR_WriteByte(buffer, srcIdx, '.');
+  WriteIntDec_Legacy(buffer, srcIdx, frac, dPlaces);
+}
+
+typedef struct
+{
+  const char* name;
+  bool isFloat;
+  long i;
+  float f;
+  byte places;
+  byte zPad;
+} Value_Struct;
+
+const Value_Struct values[] = {
+  { "channel ID 7",        false, 7,          0,          0, 0 },
+  { "address 254",         false, 254,        0,          0, 0 },
+  { "period 60000 ms",     false, 60000,      0,          0, 0 },
+  { "2147483647",          false, 2147483647, 0,          0, 0 },
+  { "time 093015, pad 6",  false, 93015,      0,          0, 6 },
+  { "salinity 35, .0",     true,  0,          35.0f,      0, 1 },
+  { "gravity 9.8066, .4",  true,  0,          9.80665f,   4, 0 },
+  { "temperature -1.5, .1",true,  0,          -1.5f,      1, 0 },
+  { "latitude 48.5, .6",   true,  0,          48.512345f, 6, 0 },
+};
+
+byte buffer[32];
+byte idx;
+volatile byte sink;
+
+// Cycles taken by "func", Timer1 counts CPU cycles, one overflow is accounted
+template <typename F>
+unsigned long Cycles(F func)
+{
+  unsigned int t;
+  bool isOverflow;
+
+  noInterrupts();
+  TCNT1 = 0;
+  TIFR1 = _BV(TOV1);
+  func();
+  t = TCNT1;
+  isOverflow = (TIFR1 & _BV(TOV1)) != 0;
+  interrupts();
+
+  sink = buffer[0];
+  return t + (isOverflow ? 65536UL : 0);
+}
+
+void setup()
+{
+  unsigned long overhead, c_legacy, c_new;
+  byte i;
+
+  Serial.begin(SERIAL_BAUDRATE);
+
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);   // no prescaler
+
+  overhead = Cycles([]() { idx = 0; });
+
+  Serial.println(F("CPU cycles: legacy, new"));
+
+  for (i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+  {
+    const Value_Struct* v = &values[i];
+
+    if (v->isFloat)
+    {
+      c_legacy = Cycles([v]() { idx = 0; WriteFloat_Legacy(buffer, &idx, v->f, v->places, v->zPad); });
+      c_new = Cycles([v]() { idx = 0; UCNL_STR_WriteFloat(buffer, &idx, v->f, v->places, v->zPad); });
+    }
+    else
+    {
+      c_legacy = Cycles([v]() { idx = 0; WriteIntDec_Legacy(buffer, &idx, v->i, v->zPad); });
+      c_new = Cycles([v]() { idx = 0; UCNL_STR_WriteIntDec(buffer, &idx, v->i, v->zPad); });
+    }
+
+    buffer[idx] = '\0';
+    Serial.print(v->name);
+    Serial.print(F(": "));
+    Serial.print(c_legacy - overhead);
+    Serial.print(F(", "));
+    Serial.print(c_new - overhead);
+    Serial.print(F(" -> "));
+    Serial.println((char*)buffer);
+  }
+}
+
+void loop()
+{
+}
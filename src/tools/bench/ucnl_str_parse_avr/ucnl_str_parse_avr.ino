@@ -0,0 +1,136 @@
+/*
+  Copyright (C) 2021, Underwater communication & navigation laboratory
+  All rights reserved.
+
+  www.unavlab.com
+  hello@unavlab.com
+
+*/
+/* UCNL_STR_ParseFloat CPU cycles on an 8-bit AVR board (Uno, Nano, Mega)
+
+   The sketch:
+
+   Counts CPU cycles of the integer mantissa parser and the former float accumulating
+   one for fields like the ones of NMEA and uWave sentences, Timer1 runs at the CPU clock.
+   Results are printed to Serial at 115200 baud. The host side benchmark is
+   src/tools/bench/ucnl_str_bench.cpp
+*/
+
+#include "ucnl_str.h"
+
+#define SERIAL_BAUDRATE (115200)
+
+// UCNL_STR_ParseFloat before the integer mantissa rework, kept for the comparison
+float ParseFloat_Legacy(const byte* buffer, byte stIdx, byte ndIdx)
+{
+  int i, dotIdx = ndIdx + 1;
+  float sign = 1.0f, fract = 0.0f;
+
+  if (buffer[stIdx] == '-')
+  {
+    sign = -1.0f;
+    stIdx++;
+  }
+
+  for (i = stIdx; i <= ndIdx; i++)
+  {
+    if (buffer[i] == '.')
+    {
+      dotIdx = i;
+    }
+  }
+
+  float result = 0.0f;
+  float multiplier = 1.0f;
+
+  for (i = dotIdx - 1; i >= stIdx; i--)
+  {
+    result += ((float)((buffer[i] - '0'))) * multiplier;
+    multiplier *= 10.0f;
+  }
+
+  multiplier = 0.1f;
+
+  for (i = dotIdx + 1; i <= ndIdx; i++)
+  {
+    fract += ((float)((buffer[i] - '0'))) * multiplier;
+    multiplier /= 10.0f;
+  }
+
+  result += fract;
+  return result * sign;
+}
+
+const char* const fields[] = {
+  "230540.00",        // RMC: UTC time
+  "5312.1329616",     //      latitude
+  "15942.6950884",    //      longitude
+  "4.9",              //      speed
+  "217.1",            //      course
+  "0.12345",          // RC_RESPONSE: propagation time
+  "12.3",             //              MSR
+  "1013.25",          // AMB_DTA: pressure
+  "-3.6",             //          temperature
+  "12.1",             //          supply voltage
+};
+
+volatile float sink;
+
+// Cycles taken by "func", Timer1 counts CPU cycles, one overflow is accounted
+template <typename F>
+unsigned long Cycles(F func)
+{
+  unsigned int t;
+  bool isOverflow;
+
+  noInterrupts();
+  TCNT1 = 0;
+  TIFR1 = _BV(TOV1);
+  func();
+  t = TCNT1;
+  isOverflow = (TIFR1 & _BV(TOV1)) != 0;
+  interrupts();
+
+  return t + (isOverflow ? 65536UL : 0);
+}
+
+void setup()
+{
+  unsigned long overhead, c_legacy, c_new;
+  float f_legacy, f_new;
+  byte i, nd;
+
+  Serial.begin(SERIAL_BAUDRATE);
+
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);   // no prescaler
+
+  overhead = Cycles([]() { sink = 0.0f; });
+
+  Serial.println(F("CPU cycles: legacy, new; results: legacy, new"));
+
+  for (i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+  {
+    const byte* field = (const byte*)fields[i];
+    nd = (byte)(strlen(fields[i]) - 1);
+
+    c_legacy = Cycles([field, nd]() { sink = ParseFloat_Legacy(field, 0, nd); });
+    f_legacy = sink;
+    c_new = Cycles([field, nd]() { sink = UCNL_STR_ParseFloat(field, 0, nd); });
+    f_new = sink;
+
+    Serial.print(fields[i]);
+    Serial.print(F(": "));
+    Serial.print(c_legacy - overhead);
+    Serial.print(F(", "));
+    Serial.print(c_new - overhead);
+    Serial.print(F("; "));
+    Serial.print(f_legacy, 7);
+    Serial.print(F(", "));
+    Serial.println(f_new, 7);
+  }
+}
+
+void loop()
+{
+}
@@ -0,0 +1,173 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_TMR timer wheel benchmark: the wheel vs comparing every timeout's timestamp on each loop pass
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -I../common -I../../libs ucnl_tmr_bench.cpp ../../libs/ucnl_tmr.cpp -o ucnl_tmr_bench
+//
+// Usage:
+//   ucnl_tmr_bench [simulated_seconds]
+//
+// Every timer stands for a remote or a command in flight: it is re-armed with a random timeout of
+// 50 ms..20 s as soon as it expires, a tenth of the timers is canceled and re-armed before they expire.
+// The clock is simulated and steps 1 ms per loop pass, it starts right before the wraparound. Timers
+// that went off early or more than a tick late are counted for the wheel.
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_tmr.h"
+
+#define BENCH_TICK_MS      (10)
+#define BENCH_MIN_DELAY_MS (50)
+#define BENCH_MAX_DELAY_MS (20000)
+
+static unsigned long bench_clock;
+
+static unsigned long Bench_Clock()
+{
+  return bench_clock;
+}
+
+static unsigned long Bench_Delay()
+{
+  return BENCH_MIN_DELAY_MS + (unsigned long)rand() % (BENCH_MAX_DELAY_MS - BENCH_MIN_DELAY_MS);
+}
+
+typedef struct
+{
+  UCNL_TMR_Wheel_Struct* wheel;
+  unsigned long due;
+  size_t fired;
+  size_t early;
+  size_t late;
+} Bench_Wheel_Ctx_Struct;
+
+static Bench_Wheel_Ctx_Struct* ctxs;
+
+static void Bench_OnExpired(UCNL_TMR_Timer_Struct* timer, void* param)
+{
+  Bench_Wheel_Ctx_Struct* ctx = (Bench_Wheel_Ctx_Struct*)param;
+  unsigned long delay = Bench_Delay();
+
+  if ((long)(bench_clock - ctx->due) < 0)
+    ctxs->early++;
+  else if (bench_clock - ctx->due > BENCH_TICK_MS)
+    ctxs->late++;
+  ctxs->fired++;
+
+  ctx->due = bench_clock + delay;
+  UCNL_TMR_Arm(ctx->wheel, timer, delay);
+}
+
+int main(int argc, char** argv)
+{
+  static const size_t nums[] = { 10, 100, 1000, 10000 };
+  unsigned long duration_ms = (argc > 1) ? (unsigned long)atol(argv[1]) * 1000 : 60000;
+  std::chrono::steady_clock::time_point ts;
+  double t_scan, t_wheel;
+  size_t num, i, m, fired_scan;
+  unsigned long start, delay;
+  long sink = 0;
+
+  printf("%lu s simulated, 1 ms loop passes, ns/pass (expired timers; early, late)\n", duration_ms / 1000);
+
+  for (m = 0; m < sizeof(nums) / sizeof(nums[0]); m++)
+  {
+    num = nums[m];
+    start = (unsigned long)0 - duration_ms / 2;
+
+    // every timeout kept as a timestamp and a duration, all of them compared on each pass
+    std::vector<unsigned long> req_ts(num), tmo_ms(num);
+
+    srand(1);
+    bench_clock = start;
+    for (i = 0; i < num; i++)
+    {
+      req_ts[i] = bench_clock;
+      tmo_ms[i] = Bench_Delay();
+    }
+
+    fired_scan = 0;
+    ts = std::chrono::steady_clock::now();
+    for (; bench_clock - start < duration_ms; bench_clock++)
+    {
+      for (i = 0; i < num; i++)
+        if (bench_clock - req_ts[i] >= tmo_ms[i])
+        {
+          req_ts[i] = bench_clock;
+          tmo_ms[i] = Bench_Delay();
+          fired_scan++;
+        }
+
+      if ((bench_clock & 0xFF) == 0)
+      {
+        i = (size_t)rand() % num;
+        req_ts[i] = bench_clock;
+        tmo_ms[i] = Bench_Delay();
+      }
+    }
+    t_scan = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count() / duration_ms;
+    sink += (long)fired_scan;
+
+    // the same load on the wheel
+    UCNL_TMR_Wheel_Struct wheel;
+    std::vector<UCNL_TMR_Timer_Struct> timers(num);
+    std::vector<Bench_Wheel_Ctx_Struct> wctx(num);
+    UCNL_TMR_Pool_Struct pool;
+    UCNL_TMR_Timer_Struct* timer;
+
+    srand(1);
+    bench_clock = start;
+    UCNL_TMR_InitStruct(&wheel, BENCH_TICK_MS, Bench_Clock);
+    UCNL_TMR_Pool_Init(&pool, &timers[0], (unsigned int)num);
+    ctxs = &wctx[0];
+    ctxs->fired = ctxs->early = ctxs->late = 0;
+
+    for (i = 0; i < num; i++)
+    {
+      timer = UCNL_TMR_Pool_Alloc(&pool, Bench_OnExpired, &wctx[i]);
+      wctx[i].wheel = &wheel;
+      delay = Bench_Delay();
+      wctx[i].due = bench_clock + delay;
+      UCNL_TMR_Arm(&wheel, timer, delay);
+    }
+
+    ts = std::chrono::steady_clock::now();
+    for (; bench_clock - start < duration_ms; bench_clock++)
+    {
+      UCNL_TMR_Poll(&wheel);
+
+      if ((bench_clock & 0xFF) == 0)
+      {
+        i = (size_t)rand() % num;
+        delay = Bench_Delay();
+        wctx[i].due = bench_clock + delay;
+        UCNL_TMR_Arm(&wheel, &timers[i], delay);
+      }
+    }
+    t_wheel = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count() / duration_ms;
+
+    for (i = 0; i < num; i++)
+      UCNL_TMR_Cancel(&wheel, &timers[i]);
+    for (i = 0; i < num; i++)
+      UCNL_TMR_Pool_Free(&pool, &timers[i]);
+
+    printf("%6zu timers: scan %9.1f (%7zu)  wheel %9.1f (%7zu; %zu, %zu)  x%6.1f%s\n", num,
+           t_scan * 1e9, fired_scan, t_wheel * 1e9, ctxs->fired, ctxs->early, ctxs->late, t_scan / t_wheel,
+           ((wheel.count != 0) || (pool.available != num)) ? " TIMERS LEAKED" : "");
+  }
+
+  printf("(%ld)\n", sink);
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_VLBL constant velocity Kalman filter vs the still remote least-squares solver on a simulated AUV
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -fpermissive -I../common -I../../libs ucnl_vlbl_kf_bench.cpp
+//       ../../libs/ucnl_nav.cpp ../../libs/ucnl_vlbl.cpp -o ucnl_vlbl_kf_bench
+//
+// Usage:
+//   ucnl_vlbl_kf_bench [runs_number]
+//
+// The AUV starts at a random point within 200 m of the base, 30 m deep, and moves at 1 m/s on a slowly
+// wandering course. The base circles: 15 m legs, turning by 0.3 rad each, and pings the AUV every 5 s,
+// 200 pings a run. Slant ranges get 1 m, azimuths 3 deg of gaussian noise. Compared are the filter fed
+// with ranges and azimuths, the filter fed with ranges only, started from the solver's fix after
+// 10 pings, and the solver itself. Errors are averaged from the 50th ping on. UCNL_VLBL_KF_Process
+// is timed call by call, the clock reads are included.
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+
+#include "Arduino.h"
+#include "ucnl_vlbl.h"
+
+#define BENCH_PINGS        (200)
+#define BENCH_SKIP_PINGS   (50)
+#define BENCH_LSQ_PINGS    (10)
+#define BENCH_DT_S         (5.0f)
+#define BENCH_SPEED_MPS    (1.0f)
+#define BENCH_DEPTH_M      (30.0f)
+#define BENCH_LEG_M        (15.0f)
+#define BENCH_TURN_RAD     (0.3f)
+#define BENCH_COURSE_SIGMA (0.02f)
+#define BENCH_RANGE_SIGMA  (1.0f)
+#define BENCH_AZ_SIGMA     (3.0f * 0.01745f)
+
+#define BENCH_ACCEL_SIGMA  (0.05f)
+#define BENCH_VEL_SIGMA    (2.0f)
+
+// Approximately normal, zero mean and unit variance
+static float Bench_Gauss()
+{
+  float s = 0;
+  int i;
+
+  for (i = 0; i < 12; i++)
+    s += rand() / (float)RAND_MAX;
+
+  return s - 6;
+}
+
+int main(int argc, char** argv)
+{
+  int runs = (argc > 1) ? atoi(argv[1]) : 500;
+  double kf_err = 0, kf_vel_err = 0, kfr_err = 0, lsq_err = 0, t_process = 0;
+  long kf_num = 0, kfr_num = 0, lsq_num = 0, process_num = 0;
+  VLBL_KF_Struct kf, kfr;
+  VLBL_LSQ_Struct lsq;
+  std::chrono::steady_clock::time_point ts;
+  float tx, ty, th, bx, by, hd, r, az;
+  bool is_lsq_valid;
+  int n, k;
+
+  srand(7);
+
+  for (n = 0; n < runs; n++)
+  {
+    UCNL_VLBL_KF_Init(&kf, BENCH_ACCEL_SIGMA, BENCH_VEL_SIGMA, BENCH_RANGE_SIGMA, BENCH_AZ_SIGMA);
+    kfr = kf;
+    UCNL_VLBL_LSQ_Reset(&lsq, BENCH_RANGE_SIGMA);
+
+    tx = rand() % 400 - 200;
+    ty = rand() % 400 - 200;
+    th = (rand() % 360) * 0.01745f;
+    bx = 0;
+    by = 0;
+    hd = 0;
+
+    for (k = 0; k < BENCH_PINGS; k++)
+    {
+      th += BENCH_COURSE_SIGMA * Bench_Gauss();
+      tx += BENCH_SPEED_MPS * sinf(th) * BENCH_DT_S;
+      ty += BENCH_SPEED_MPS * cosf(th) * BENCH_DT_S;
+
+      hd += BENCH_TURN_RAD;
+      bx += BENCH_LEG_M * cosf(hd);
+      by += BENCH_LEG_M * sinf(hd);
+
+      r = sqrtf((tx - bx) * (tx - bx) + (ty - by) * (ty - by) + BENCH_DEPTH_M * BENCH_DEPTH_M) + Bench_Gauss() * BENCH_RANGE_SIGMA;
+      az = atan2f(tx - bx, ty - by) + BENCH_AZ_SIGMA * Bench_Gauss();
+
+      ts = std::chrono::steady_clock::now();
+      UCNL_VLBL_KF_Process(&kf, BENCH_DT_S, bx, by, r, BENCH_DEPTH_M, true, az);
+      t_process += std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+      process_num++;
+
+      is_lsq_valid = UCNL_VLBL_LSQ_AddRange(&lsq, bx, by, r, BENCH_DEPTH_M);
+      if (!kfr.is_initialized)
+      {
+        if (is_lsq_valid && (k > BENCH_LSQ_PINGS))
+          UCNL_VLBL_KF_Start(&kfr, lsq.x, lsq.y, lsq.drms);
+      }
+      else
+        UCNL_VLBL_KF_Process(&kfr, BENCH_DT_S, bx, by, r, BENCH_DEPTH_M, false, 0);
+
+      if (k >= BENCH_SKIP_PINGS)
+      {
+        kf_err += hypot(kf.x - tx, kf.y - ty);
+        kf_vel_err += hypot(kf.vx - BENCH_SPEED_MPS * sinf(th), kf.vy - BENCH_SPEED_MPS * cosf(th));
+        kf_num++;
+
+        if (kfr.is_initialized)
+        {
+          kfr_err += hypot(kfr.x - tx, kfr.y - ty);
+          kfr_num++;
+        }
+
+        if (is_lsq_valid)
+        {
+          lsq_err += hypot(lsq.x - tx, lsq.y - ty);
+          lsq_num++;
+        }
+      }
+    }
+  }
+
+  printf("%d runs, AUV at %.1f m/s, a ping every %.0f s, %.1f m range and %.0f deg azimuth noise\n",
+         runs, BENCH_SPEED_MPS, BENCH_DT_S, BENCH_RANGE_SIGMA, BENCH_AZ_SIGMA / 0.01745f);
+  printf("mean errors from ping %d on\n", BENCH_SKIP_PINGS);
+  printf("EKF, ranges and azimuths  %7.2f m  %5.3f m/s\n", kf_num ? kf_err / kf_num : 0.0, kf_num ? kf_vel_err / kf_num : 0.0);
+  printf("EKF, ranges only          %7.2f m  (%ld estimates)\n", kfr_num ? kfr_err / kfr_num : 0.0, kfr_num);
+  printf("LSQ, still remote         %7.2f m  (%ld estimates)\n", lsq_num ? lsq_err / lsq_num : 0.0, lsq_num);
+  printf("UCNL_VLBL_KF_Process      %7.0f ns\n", t_process / process_num * 1e9);
+
+  return 0;
+}
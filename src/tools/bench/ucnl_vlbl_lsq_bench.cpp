@@ -0,0 +1,124 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_VLBL least-squares solver vs the circle intersection clusterizer on simulated remotes
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -fpermissive -I../common -I../../libs ucnl_vlbl_lsq_bench.cpp
+//       ../../libs/ucnl_nav.cpp ../../libs/ucnl_vlbl.cpp -o ucnl_vlbl_lsq_bench
+//
+// Usage:
+//   ucnl_vlbl_lsq_bench [remotes_number]
+//
+// Every remote sits still at a random point within 500 m of the start and 20..70 m deep. The base
+// sails a curved track: 60 m legs, turning by 0.5 rad each, and pings the remote after every leg,
+// 30 pings in all. Slant ranges get 1 m and depth differences 0.1 m of gaussian noise. The LSQ solver
+// takes slant ranges, the clusterizer takes their horizontal projections, as the VLBL sketch does.
+// Printed are the shares of fixes within 5 m after each of the first pings, the mean error after
+// the last ping, the share of the errors within sqrt(3) times the reported DRMS and the mean
+// number of LSQ iterations per range.
+
+#include <stdio.h>
+#include <math.h>
+
+#include "Arduino.h"
+#include "ucnl_vlbl.h"
+
+#define BENCH_PINGS        (30)
+#define BENCH_PRINT_PINGS  (10)
+#define BENCH_LEG_M        (60.0f)
+#define BENCH_TURN_RAD     (0.5f)
+#define BENCH_RANGE_SIGMA  (1.0f)
+#define BENCH_DEPTH_SIGMA  (0.1f)
+#define BENCH_FIX_RADIUS_M (5.0)
+
+// Approximately normal, zero mean and unit variance
+static float Bench_Gauss()
+{
+  float s = 0;
+  int i;
+
+  for (i = 0; i < 12; i++)
+    s += rand() / (float)RAND_MAX;
+
+  return s - 6;
+}
+
+int main(int argc, char** argv)
+{
+  int remotes = (argc > 1) ? atoi(argv[1]) : 2000;
+  int lsq_fixes[BENCH_PINGS] = { 0 }, heap_fixes[BENCH_PINGS] = { 0 };
+  double lsq_err = 0, heap_err = 0, e;
+  long iterations = 0, updates = 0, lsq_valid = 0, drms_ok = 0;
+  VLBL_LSQ_Struct lsq;
+  VLBL_Points_Ring_Struct pointsRing;
+  VLBL_Ring_Struct heapsRing;
+  float tx, ty, tz, bx, by, hd, r, dz, rp;
+  int n, k;
+
+  srand(2);
+
+  for (n = 0; n < remotes; n++)
+  {
+    tx = (rand() % 2000 - 1000) * 0.5f;
+    ty = (rand() % 2000 - 1000) * 0.5f;
+    tz = 20 + rand() % 50;
+
+    UCNL_VLBL_LSQ_Reset(&lsq, BENCH_RANGE_SIGMA);
+    UCNL_VLBL_ResetStructs(&pointsRing, &heapsRing);
+
+    bx = 0;
+    by = 0;
+    hd = (rand() % 360) * 0.01745f;
+
+    for (k = 0; k < BENCH_PINGS; k++)
+    {
+      r = sqrtf((tx - bx) * (tx - bx) + (ty - by) * (ty - by) + tz * tz) + Bench_Gauss() * BENCH_RANGE_SIGMA;
+      dz = tz + Bench_Gauss() * BENCH_DEPTH_SIGMA;
+
+      UCNL_VLBL_LSQ_AddRange(&lsq, bx, by, r, dz);
+      rp = (r > dz) ? sqrtf(r * r - dz * dz) : r;
+      UCNL_VLBL_Clusterize(&pointsRing, &heapsRing, bx, by, rp);
+
+      iterations += lsq.iterations;
+      updates++;
+
+      if (lsq.is_valid && (hypot(lsq.x - tx, lsq.y - ty) < BENCH_FIX_RADIUS_M))
+        lsq_fixes[k]++;
+      if ((heapsRing.cnt >= 2) && (hypot(heapsRing.x_best - tx, heapsRing.y_best - ty) < BENCH_FIX_RADIUS_M))
+        heap_fixes[k]++;
+
+      hd += BENCH_TURN_RAD;
+      bx += BENCH_LEG_M * cosf(hd);
+      by += BENCH_LEG_M * sinf(hd);
+    }
+
+    if (lsq.is_valid)
+    {
+      e = hypot(lsq.x - tx, lsq.y - ty);
+      lsq_err += e;
+      lsq_valid++;
+      if (e * e < 3 * lsq.drms * lsq.drms)
+        drms_ok++;
+    }
+    heap_err += hypot(heapsRing.x_best - tx, heapsRing.y_best - ty);
+  }
+
+  printf("%d remotes, %d pings, %.1f m range noise\n", remotes, BENCH_PINGS, BENCH_RANGE_SIGMA);
+  printf("fixes within %.0f m\nping   LSQ  clusterizer\n", BENCH_FIX_RADIUS_M);
+  for (k = 0; k < BENCH_PRINT_PINGS; k++)
+    printf("%4d  %3.0f%%  %10.0f%%\n", k + 1, 100.0 * lsq_fixes[k] / remotes, 100.0 * heap_fixes[k] / remotes);
+
+  printf("mean error after %d pings: LSQ %.2f m, clusterizer %.2f m\n", BENCH_PINGS,
+         lsq_valid ? lsq_err / lsq_valid : 0.0, heap_err / remotes);
+  printf("LSQ errors within sqrt(3) DRMS: %.0f%%, iterations per range: %.2f\n",
+         lsq_valid ? 100.0 * drms_ok / lsq_valid : 0.0, (double)iterations / updates);
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_VLBL multi-target tracker on simulated remotes: fix accuracy, removal and refill, cost per range
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -fpermissive -I../common -I../../libs ucnl_vlbl_tracker_bench.cpp
+//       ../../libs/ucnl_nav.cpp ../../libs/ucnl_vlbl.cpp -o ucnl_vlbl_tracker_bench
+//
+// Usage:
+//   ucnl_vlbl_tracker_bench [remotes_number]
+//
+// The remotes (30 by default) sit still at random points within 500 m of the start, 20 m deep, and
+// are tracked on a 40-entry arena. The base sails a curved track: 60 m legs, turning by 0.5 rad each,
+// and polls every remote after every leg, 20 polls in all. Slant ranges get 1 m of gaussian noise.
+// A few targets are removed then: the fixes of the rest must stay with their addresses, and the arena
+// is filled up again. The time of UCNL_VLBL_Tracker_AddRange is taken for a growing number of targets.
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_vlbl.h"
+
+#define BENCH_RUNS         (5)
+#define BENCH_ARENA_SIZE   (40)
+#define BENCH_POLLS        (20)
+#define BENCH_LEG_M        (60.0f)
+#define BENCH_TURN_RAD     (0.5f)
+#define BENCH_DEPTH_M      (20.0f)
+#define BENCH_RANGE_SIGMA  (1.0f)
+
+static float remote_xs[VLBL_TRACKER_ADDR_NUM];
+static float remote_ys[VLBL_TRACKER_ADDR_NUM];
+
+// Approximately normal, zero mean and unit variance
+static float Bench_Gauss()
+{
+  float s = 0;
+  int i;
+
+  for (i = 0; i < 12; i++)
+    s += rand() / (float)RAND_MAX;
+
+  return s - 6;
+}
+
+static float Bench_Range(byte ptAddress, float x, float y)
+{
+  float dx = remote_xs[ptAddress] - x;
+  float dy = remote_ys[ptAddress] - y;
+
+  return sqrtf(dx * dx + dy * dy + BENCH_DEPTH_M * BENCH_DEPTH_M) + Bench_Gauss() * BENCH_RANGE_SIGMA;
+}
+
+// Polls remotes 1.."remotes" after every leg of the track
+static void Bench_Polls(VLBL_Tracker_Struct* tracker, int remotes, int polls)
+{
+  float bx = 0, by = 0, hd = 0;
+  int k, a;
+
+  for (k = 0; k < polls; k++)
+  {
+    for (a = 1; a <= remotes; a++)
+      UCNL_VLBL_Tracker_AddRange(tracker, (byte)a, bx, by, Bench_Range((byte)a, bx, by), BENCH_DEPTH_M);
+
+    hd += BENCH_TURN_RAD;
+    bx += BENCH_LEG_M * cosf(hd);
+    by += BENCH_LEG_M * sinf(hd);
+  }
+}
+
+// Mean error of the valid fixes, "num" gets their number
+static double Bench_Fixes_Error(const VLBL_Tracker_Struct* tracker, byte* num)
+{
+  VLBL_Fix_Struct fixes[VLBL_TRACKER_ADDR_NUM];
+  double err = 0;
+  byte i;
+
+  *num = UCNL_VLBL_Tracker_Get_Fixes(tracker, fixes, VLBL_TRACKER_ADDR_NUM - 1);
+  for (i = 0; i < *num; i++)
+    err += hypot(fixes[i].x - remote_xs[fixes[i].ptAddress], fixes[i].y - remote_ys[fixes[i].ptAddress]);
+
+  return (*num > 0) ? err / *num : 0.0;
+}
+
+int main(int argc, char** argv)
+{
+  static const int nums[] = { 10, 50, 250 };
+  static VLBL_Target_Struct arena[VLBL_TRACKER_ADDR_NUM];
+  int remotes = (argc > 1) ? atoi(argv[1]) : 30;
+  VLBL_Tracker_Struct tracker;
+  std::chrono::steady_clock::time_point ts;
+  double err, t, best;
+  byte fixes_num;
+  int a, k, m, added;
+
+  if ((remotes < 4) || (remotes >= BENCH_ARENA_SIZE))
+  {
+    printf("remotes_number must be 4..%d\n", BENCH_ARENA_SIZE - 1);
+    return 1;
+  }
+
+  srand(1);
+
+  for (a = 0; a < VLBL_TRACKER_ADDR_NUM; a++)
+  {
+    remote_xs[a] = rand() % 1000 - 500;
+    remote_ys[a] = rand() % 1000 - 500;
+  }
+
+  // Accuracy
+  UCNL_VLBL_Tracker_Init(&tracker, arena, BENCH_ARENA_SIZE, BENCH_RANGE_SIGMA);
+  Bench_Polls(&tracker, remotes, BENCH_POLLS);
+
+  err = Bench_Fixes_Error(&tracker, &fixes_num);
+  printf("%d remotes, %d polls, %.1f m range noise: %d targets, %d fixes, mean error %.2f m\n",
+         remotes, BENCH_POLLS, BENCH_RANGE_SIGMA, tracker.num, fixes_num, err);
+  printf("broadcast address tracked: %s\n",
+         (UCNL_VLBL_Tracker_Add_Target(&tracker, VLBL_TRACKER_BCAST_ADDR) != NULL) ? "yes, WRONG" : "no");
+
+  // Removal: the last targets take the removed ones' places, the fixes stay with their addresses
+  UCNL_VLBL_Tracker_Remove_Target(&tracker, 3);
+  UCNL_VLBL_Tracker_Remove_Target(&tracker, (byte)remotes);
+  UCNL_VLBL_Tracker_Remove_Target(&tracker, 99);
+
+  err = Bench_Fixes_Error(&tracker, &fixes_num);
+  printf("3, %d and untracked 99 removed: %d targets, %d fixes, mean error %.2f m, 3 %s, 5 %s\n",
+         remotes, tracker.num, fixes_num, err,
+         (UCNL_VLBL_Tracker_Get_Target(&tracker, 3) == NULL) ? "gone" : "still there, WRONG",
+         ((UCNL_VLBL_Tracker_Get_Target(&tracker, 5) != NULL) &&
+          (UCNL_VLBL_Tracker_Get_Target(&tracker, 5)->ptAddress == 5)) ? "kept" : "lost, WRONG");
+
+  // Refill: new addresses take the free entries until the arena is full
+  added = 0;
+  for (a = 100; a < 100 + BENCH_ARENA_SIZE; a++)
+    if (UCNL_VLBL_Tracker_Add_Target(&tracker, (byte)a) != NULL)
+      added++;
+  printf("refill: %d of %d new targets added, %d targets\n", added, BENCH_ARENA_SIZE, tracker.num);
+
+  // Cost per range for a growing number of targets, every remote is polled from the same 20 points
+  printf("targets  ns per range\n");
+  for (m = 0; m < (int)(sizeof(nums) / sizeof(nums[0])); m++)
+  {
+    best = 0;
+    for (k = 0; k < BENCH_RUNS; k++)
+    {
+      UCNL_VLBL_Tracker_Init(&tracker, arena, (byte)nums[m], BENCH_RANGE_SIGMA);
+      srand(1);
+      ts = std::chrono::steady_clock::now();
+      Bench_Polls(&tracker, nums[m], BENCH_POLLS);
+      t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count() / (nums[m] * BENCH_POLLS);
+      if ((k == 0) || (t < best))
+        best = t;
+    }
+    printf("%7d  %12.0f\n", nums[m], best * 1e9);
+  }
+
+  return 0;
+}
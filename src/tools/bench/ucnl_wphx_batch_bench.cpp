@@ -0,0 +1,154 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_WPHX batch functions benchmark: CTD cast processing by the batch functions vs a loop over the scalar ones
+//
+// Build (Linux):
+//   g++ -O3 -std=gnu++11 -I../common -I../../libs ucnl_wphx_batch_bench.cpp ../../libs/ucnl_wphx.cpp -o ucnl_wphx_batch_bench
+//   add -march=native for wider vectors, -fopenmp for the multithreaded batch functions
+//
+// Usage:
+//   ucnl_wphx_batch_bench [samples_number]
+//
+// The cast is a synthetic 0..6000 m profile with a thermocline and some noise. The max deviation of
+// the batch results from the scalar ones is reported for each function.
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_wphx.h"
+
+#define BENCH_RUNS (5)
+
+typedef struct
+{
+  std::vector<float> t;     // °C
+  std::vector<float> p;     // mBar
+  std::vector<float> s;     // PSU
+} Bench_Cast_Struct;
+
+static float Bench_Rand(float v_min, float v_max)
+{
+  return v_min + (v_max - v_min) * (float)(rand() / (double)RAND_MAX);
+}
+
+static void Bench_Make_Cast(Bench_Cast_Struct* cast, size_t num)
+{
+  float depth;
+  size_t i;
+
+  cast->t.resize(num);
+  cast->p.resize(num);
+  cast->s.resize(num);
+
+  for (i = 0; i < num; i++)
+  {
+    depth = 6000.0f * i / num;
+    cast->t[i] = 2.0f + 18.0f * expf(-depth / 300.0f) + Bench_Rand(-0.05f, 0.05f);
+    cast->s[i] = 34.7f + 0.5f * expf(-depth / 500.0f) + Bench_Rand(-0.02f, 0.02f);
+    cast->p[i] = UCNL_WPHX_pressure_by_depth_calc(depth, UCNL_WPHX_ATM_PRESSURE_MBAR, 1030.0f, UCNL_WPHX_GRAVITY_ACC_MPS2);
+  }
+}
+
+// Best time of a few runs, seconds per sample
+template <typename F>
+static double Bench_Run(F func, size_t num)
+{
+  std::chrono::steady_clock::time_point ts;
+  double t, best = 0;
+  int k;
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+    func();
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    if ((k == 0) || (t < best))
+      best = t;
+  }
+
+  return best / (double)num;
+}
+
+static double Bench_Error(const std::vector<float>& a, const std::vector<float>& b)
+{
+  double err, max_err = 0;
+  size_t i;
+
+  for (i = 0; i < a.size(); i++)
+  {
+    err = fabs((double)a[i] - (double)b[i]);
+    if ((err > max_err) || (err != err))
+      max_err = err;
+  }
+
+  return max_err;
+}
+
+static void Bench_Print(const char* name, double t_scalar, double t_batch, double err)
+{
+  printf("%-22s scalar %7.2f ns  batch %7.2f ns  x%5.1f  max deviation %8.2e\n",
+         name, t_scalar * 1e9, t_batch * 1e9, t_scalar / t_batch, err);
+}
+
+int main(int argc, char** argv)
+{
+  size_t num = (argc > 1) ? (size_t)atol(argv[1]) : 1000000;
+  int n = (int)num;
+  Bench_Cast_Struct cast;
+  std::vector<float> rho_s(num), rho_b(num), c_s(num), c_b(num), fp_s(num), fp_b(num), h_s(num), h_b(num);
+  const float* t;
+  const float* p;
+  const float* s;
+  double t_scalar, t_batch;
+
+  srand(1);
+  Bench_Make_Cast(&cast, num);
+  t = &cast.t[0];
+  p = &cast.p[0];
+  s = &cast.s[0];
+
+  printf("%zu samples, per sample:\n", num);
+
+  t_scalar = Bench_Run([&]() { for (int i = 0; i < n; i++) rho_s[i] = UCNL_WPHX_water_density_calc(t[i], p[i], s[i]); }, num);
+  t_batch = Bench_Run([&]() { UCNL_WPHX_water_density_batch(t, p, s, &rho_b[0], n); }, num);
+  Bench_Print("density", t_scalar, t_batch, Bench_Error(rho_s, rho_b));
+
+  t_scalar = Bench_Run([&]() { for (int i = 0; i < n; i++) c_s[i] = UCNL_WPHX_speed_of_sound_UNESCO_calc(t[i], p[i], s[i]); }, num);
+  t_batch = Bench_Run([&]() { UCNL_WPHX_speed_of_sound_UNESCO_batch(t, p, s, &c_b[0], n); }, num);
+  Bench_Print("sound speed", t_scalar, t_batch, Bench_Error(c_s, c_b));
+
+  t_scalar = Bench_Run([&]() {
+    for (int i = 0; i < n; i++)
+    {
+      rho_s[i] = UCNL_WPHX_water_density_calc(t[i], p[i], s[i]);
+      c_s[i] = UCNL_WPHX_speed_of_sound_UNESCO_calc(t[i], p[i], s[i]);
+    }
+  }, num);
+  t_batch = Bench_Run([&]() { UCNL_WPHX_density_and_sound_speed_batch(t, p, s, &rho_b[0], &c_b[0], n); }, num);
+  Bench_Print("density & sound speed", t_scalar, t_batch, Bench_Error(c_s, c_b) + Bench_Error(rho_s, rho_b));
+
+  t_scalar = Bench_Run([&]() { for (int i = 0; i < n; i++) fp_s[i] = UCNL_WPHX_water_fpoint_calc(p[i], s[i]); }, num);
+  t_batch = Bench_Run([&]() { UCNL_WPHX_water_fpoint_batch(p, s, &fp_b[0], n); }, num);
+  Bench_Print("freezing point", t_scalar, t_batch, Bench_Error(fp_s, fp_b));
+
+  t_scalar = Bench_Run([&]() {
+    for (int i = 0; i < n; i++)
+      h_s[i] = UCNL_WPHX_depth_by_pressure_calc(p[i], UCNL_WPHX_ATM_PRESSURE_MBAR, rho_s[i], UCNL_WPHX_GRAVITY_ACC_MPS2);
+  }, num);
+  t_batch = Bench_Run([&]() {
+    UCNL_WPHX_depth_by_pressure_batch(p, UCNL_WPHX_ATM_PRESSURE_MBAR, &rho_s[0], UCNL_WPHX_GRAVITY_ACC_MPS2, &h_b[0], n);
+  }, num);
+  Bench_Print("depth by pressure", t_scalar, t_batch, Bench_Error(h_s, h_b));
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_WPHX lookup tables benchmark: speed and accuracy of UCNL_WPHX_LUT_Get vs the exact functions
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -I../common -I../../libs ucnl_wphx_bench.cpp ../../libs/ucnl_wphx.cpp -o ucnl_wphx_bench
+//
+// Usage:
+//   ucnl_wphx_bench [points_number]
+//
+// Sound speed and density are tabulated over a few grids, the max error is taken
+// over random points inside the grid ranges (0..30 °C, 0..2000 m, 0..40 PSU).
+// CPU cycles on an 8-bit AVR board are counted by ucnl_wphx_lut_avr/ucnl_wphx_lut_avr.ino
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_wphx.h"
+
+#define BENCH_RUNS (9)
+
+typedef struct
+{
+  const char* name;
+  float t_step;
+  float p_step;       // mBar
+  float s_step;       // 0 for a fixed salinity
+} Bench_Grid_Struct;
+
+static const Bench_Grid_Struct grids[] = {
+  { "2 C, 100 Bar, 5 PSU",   2.0f, 100000.0f, 5.0f },
+  { "1 C, 50 Bar, 2.5 PSU",  1.0f, 50000.0f,  2.5f },
+  { "2 C, 100 Bar, 35 PSU",  2.0f, 100000.0f, 0.0f },
+  { "5 C, 200 Bar, 35 PSU",  5.0f, 200000.0f, 0.0f },
+};
+
+#define T_MIN (0.0f)
+#define T_MAX (30.0f)
+#define P_MIN (UCNL_WPHX_ATM_PRESSURE_MBAR)
+#define P_MAX (UCNL_WPHX_ATM_PRESSURE_MBAR + 200000.0f)   // about 2000 m
+#define S_MIN (0.0f)
+#define S_MAX (40.0f)
+#define S_FIXED (35.0f)
+
+typedef struct
+{
+  float t;
+  float p;
+  float s;
+} Bench_Point_Struct;
+
+// Time of a run, seconds per point
+template <typename F>
+static double Bench_Run(F func, const std::vector<Bench_Point_Struct>& points, float* sink)
+{
+  std::chrono::steady_clock::time_point ts = std::chrono::steady_clock::now();
+  float sum = 0;
+  size_t i;
+
+  for (i = 0; i < points.size(); i++)
+    sum += func(points[i].t, points[i].p, points[i].s);
+
+  *sink += sum;
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count() / (double)points.size();
+}
+
+static float Bench_Rand(float v_min, float v_max)
+{
+  return v_min + (v_max - v_min) * (float)(rand() / (double)RAND_MAX);
+}
+
+static int Bench_Nodes(float v_min, float v_max, float step)
+{
+  return (step > 0) ? (int)ceil((v_max - v_min) / step - 1E-3) + 1 : 1;
+}
+
+static void Bench_Grid(const Bench_Grid_Struct* grid, const char* func_name, UCNL_WPHX_TPS_Func func, size_t num, float* sink)
+{
+  UCNL_WPHX_LUT_Struct lut;
+  std::vector<float> values;
+  std::vector<Bench_Point_Struct> points(num);
+  int t_num = Bench_Nodes(T_MIN, T_MAX, grid->t_step);
+  int p_num = Bench_Nodes(P_MIN, P_MAX, grid->p_step);
+  int s_num = Bench_Nodes(S_MIN, S_MAX, grid->s_step);
+  float s_min = (s_num > 1) ? S_MIN : S_FIXED;
+  double err, max_err = 0, t_run, t_exact = 0, t_lut = 0;
+  size_t i;
+  int k;
+
+  values.resize(t_num * p_num * s_num);
+  UCNL_WPHX_LUT_Init(&lut, &values[0], (int)values.size(), func,
+                     T_MIN, T_MIN + grid->t_step * (t_num - 1), t_num,
+                     P_MIN, P_MIN + grid->p_step * (p_num - 1), p_num,
+                     s_min, s_min + grid->s_step * (s_num - 1), s_num);
+
+  for (i = 0; i < num; i++)
+  {
+    points[i].t = Bench_Rand(T_MIN, T_MAX);
+    points[i].p = Bench_Rand(P_MIN, P_MAX);
+    points[i].s = (s_num > 1) ? Bench_Rand(S_MIN, S_MAX) : S_FIXED;
+
+    err = fabs((double)UCNL_WPHX_LUT_Get(&lut, points[i].t, points[i].p, points[i].s) -
+               (double)func(points[i].t, points[i].p, points[i].s));
+    if (err > max_err)
+      max_err = err;
+  }
+
+  // the functions take turns, the best run of each is taken, so a slow spell of the host hits them both
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    t_run = Bench_Run(func, points, sink);
+    t_exact = ((k == 0) || (t_run < t_exact)) ? t_run : t_exact;
+    t_run = Bench_Run([&lut](float t, float p, float s) { return UCNL_WPHX_LUT_Get(&lut, t, p, s); }, points, sink);
+    t_lut = ((k == 0) || (t_run < t_lut)) ? t_run : t_lut;
+  }
+
+  printf("%-14s %-22s %5d nodes %6d bytes  max error %9.2e  exact %6.2f ns  LUT %6.2f ns\n",
+         func_name, grid->name, t_num * p_num * s_num, (int)(values.size() * sizeof(float)), max_err, t_exact * 1e9, t_lut * 1e9);
+}
+
+int main(int argc, char** argv)
+{
+  size_t num = (argc > 1) ? (size_t)atol(argv[1]) : 1000000;
+  float sink = 0;
+  size_t k;
+
+  srand(1);
+
+  for (k = 0; k < sizeof(grids) / sizeof(grids[0]); k++)
+  {
+    Bench_Grid(&grids[k], "sound speed", UCNL_WPHX_speed_of_sound_UNESCO_calc, num, &sink);
+    Bench_Grid(&grids[k], "density", UCNL_WPHX_water_density_calc, num, &sink);
+  }
+
+  printf("(%g)\n", sink);
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+  Copyright (C) 2021, Underwater communication & navigation laboratory
+  All rights reserved.
+
+  www.unavlab.com
+  hello@unavlab.com
+
+*/
+/* UCNL_WPHX_LUT_Get CPU cycles on an 8-bit AVR board (Uno, Nano, Mega)
+
+   The sketch:
+
+   Counts CPU cycles of the exact sound speed and density functions and of the lookup tables
+   at a few points of the water column, Timer1 runs at the CPU clock. The tables fit into the RAM
+   of an Uno: a fixed salinity one (2 °C, 100 Bar steps, 192 bytes each) and a three axes one
+   (5 °C, 200 Bar, 10 PSU steps, 280 bytes each). Results are printed to Serial at 115200 baud.
+   The host side benchmark is src/tools/bench/ucnl_wphx_bench.cpp
+*/
+
+#include "ucnl_wphx.h"
+
+#define SERIAL_BAUDRATE (115200)
+
+#define T_MIN  (0.0f)
+#define T_MAX  (30.0f)
+#define P_MIN  (UCNL_WPHX_ATM_PRESSURE_MBAR)
+#define P_MAX  (UCNL_WPHX_ATM_PRESSURE_MBAR + 200000.0f)   // about 2000 m
+#define S_MIN  (0.0f)
+#define S_MAX  (40.0f)
+#define S_FIXED (35.0f)
+
+#define TP_T_NUM  (16)    // 2 °C
+#define TP_P_NUM  (3)     // 100 Bar
+#define TPS_T_NUM (7)     // 5 °C
+#define TPS_P_NUM (2)     // 200 Bar
+#define TPS_S_NUM (5)     // 10 PSU
+
+typedef struct
+{
+  const char* name;
+  float t;
+  float p;
+  float s;
+} Point_Struct;
+
+const Point_Struct points[] = {
+  { "surface, 20 C, 35 PSU",   20.0f, P_MIN,                35.0f },
+  { "100 m, 12.5 C, 35 PSU",   12.5f, P_MIN + 10000.0f,     35.0f },
+  { "1500 m, 3.7 C, 35 PSU",   3.7f,  P_MIN + 150000.0f,    35.0f },
+  { "60 m, 8 C, 0.5 PSU",      8.0f,  P_MIN + 6000.0f,      0.5f },
+};
+
+float speed_tp[TP_T_NUM * TP_P_NUM];
+float density_tp[TP_T_NUM * TP_P_NUM];
+float speed_tps[TPS_T_NUM * TPS_P_NUM * TPS_S_NUM];
+float density_tps[TPS_T_NUM * TPS_P_NUM * TPS_S_NUM];
+
+UCNL_WPHX_LUT_Struct speed_tp_lut, density_tp_lut, speed_tps_lut, density_tps_lut;
+
+volatile float sink;
+
+// Cycles taken by "func", Timer1 counts CPU cycles, one overflow is accounted
+template <typename F>
+unsigned long Cycles(F func)
+{
+  unsigned int t;
+  bool isOverflow;
+
+  noInterrupts();
+  TCNT1 = 0;
+  TIFR1 = _BV(TOV1);
+  func();
+  t = TCNT1;
+  isOverflow = (TIFR1 & _BV(TOV1)) != 0;
+  interrupts();
+
+  return t + (isOverflow ? 65536UL : 0);
+}
+
+void Init_Tables(float* tp, float* tps, UCNL_WPHX_LUT_Struct* tp_lut, UCNL_WPHX_LUT_Struct* tps_lut, UCNL_WPHX_TPS_Func func)
+{
+  UCNL_WPHX_LUT_Init(tp_lut, tp, TP_T_NUM * TP_P_NUM, func,
+                     T_MIN, T_MAX, TP_T_NUM, P_MIN, P_MAX, TP_P_NUM, S_FIXED, S_FIXED, 1);
+  UCNL_WPHX_LUT_Init(tps_lut, tps, TPS_T_NUM * TPS_P_NUM * TPS_S_NUM, func,
+                     T_MIN, T_MAX, TPS_T_NUM, P_MIN, P_MAX, TPS_P_NUM, S_MIN, S_MAX, TPS_S_NUM);
+}
+
+void Measure(const char* func_name, UCNL_WPHX_TPS_Func func, const UCNL_WPHX_LUT_Struct* tp_lut,
+             const UCNL_WPHX_LUT_Struct* tps_lut, unsigned long overhead)
+{
+  unsigned long c_exact, c_tp, c_tps;
+  float exact, tp, tps;
+  byte i;
+
+  Serial.print(func_name);
+  Serial.println(F(" CPU cycles: exact, fixed salinity LUT, three axes LUT -> values"));
+
+  for (i = 0; i < sizeof(points) / sizeof(points[0]); i++)
+  {
+    const Point_Struct* pt = &points[i];
+
+    c_exact = Cycles([&]() { exact = func(pt->t, pt->p, pt->s); });
+    c_tp = Cycles([&]() { tp = UCNL_WPHX_LUT_Get(tp_lut, pt->t, pt->p, pt->s); });
+    c_tps = Cycles([&]() { tps = UCNL_WPHX_LUT_Get(tps_lut, pt->t, pt->p, pt->s); });
+    sink = exact + tp + tps;
+
+    // the fixed salinity table is for 35 PSU only
+    Serial.print(pt->name);
+    Serial.print(F(": "));
+    Serial.print(c_exact - overhead);
+    Serial.print(F(", "));
+    Serial.print(c_tp - overhead);
+    Serial.print(F(", "));
+    Serial.print(c_tps - overhead);
+    Serial.print(F(" -> "));
+    Serial.print(exact, 3);
+    Serial.print(F(", "));
+    Serial.print(tp, 3);
+    Serial.print(F(", "));
+    Serial.println(tps, 3);
+  }
+}
+
+void setup()
+{
+  unsigned long overhead;
+
+  Serial.begin(SERIAL_BAUDRATE);
+
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);   // no prescaler
+
+  Init_Tables(speed_tp, speed_tps, &speed_tp_lut, &speed_tps_lut, UCNL_WPHX_speed_of_sound_UNESCO_calc);
+  Init_Tables(density_tp, density_tps, &density_tp_lut, &density_tps_lut, UCNL_WPHX_water_density_calc);
+
+  overhead = Cycles([]() { sink = 0; });
+
+  Measure("sound speed", UCNL_WPHX_speed_of_sound_UNESCO_calc, &speed_tp_lut, &speed_tps_lut, overhead);
+  Measure("density", UCNL_WPHX_water_density_calc, &density_tp_lut, &density_tps_lut, overhead);
+}
+
+void loop()
+{
+}
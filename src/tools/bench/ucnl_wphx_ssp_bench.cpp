@@ -0,0 +1,201 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_WPHX sound speed profile: accuracy of UCNL_WPHX_SSP_Mean_Speed and of the former mean temperature
+// estimate against a fine numerical integration, and the time of a lookup
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -I../common -I../../libs ucnl_wphx_ssp_bench.cpp ../../libs/ucnl_wphx.cpp -o ucnl_wphx_ssp_bench
+//
+// Usage:
+//   ucnl_wphx_ssp_bench [pairs_number]
+//
+// The water column is a 500 m thermocline: 20 °C at the surface, 4 °C at the depth, 35 PSU. The profile
+// is built from 1 m samples of a descent and again from the same samples fed in a scrambled order, the
+// two must agree. The reference travel times are integrated in double with 1 cm steps of the UNESCO
+// speed at the pressure of the depth. Mean speeds between random depth pairs are compared to the
+// reference ones for a few span ranges. The former estimate is the speed at the mean of the two
+// temperatures and at the surface pressure, as the VLBL sketch took it. Ranging errors are given for
+// a 1000 m range. The lookup is timed against the former estimate on the last span range's pairs,
+// the temperatures are taken beforehand as a sensor would give them. The profile is fed again with
+// the depths of the pairs, as the VLBL sketch feeds it on every range: all of them are sampled already,
+// the time is compared to the density, pressure and UNESCO equations UCNL_WPHX_SSP_Add_Sample skips.
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_wphx.h"
+
+#define BENCH_RUNS          (5)
+#define BENCH_DEPTH_M       (500)
+#define BENCH_SSP_SIZE      (512)
+#define BENCH_SSP_STEP_M    (0.5f)
+#define BENCH_SALINITY_PSU  (35.0f)
+#define BENCH_REF_STEPS_M   (100)        // reference integration steps per meter
+#define BENCH_RANGE_M       (1000.0)
+
+typedef struct
+{
+  const char* name;
+  float min_span_m;
+  float max_span_m;
+} Bench_Span_Struct;
+
+static const Bench_Span_Struct spans[] = {
+  { "1..10 m",     1.0f,   10.0f },
+  { "10..100 m",   10.0f,  100.0f },
+  { "100..500 m",  100.0f, 500.0f },
+};
+
+static float Bench_Temperature(float depth_m)
+{
+  return 4.0f + 16.0f * expf(-depth_m / 50.0f);
+}
+
+static float Bench_Speed(float depth_m)
+{
+  float t = Bench_Temperature(depth_m);
+  float rho = UCNL_WPHX_water_density_calc(t, UCNL_WPHX_ATM_PRESSURE_MBAR, BENCH_SALINITY_PSU);
+  float p = UCNL_WPHX_pressure_by_depth_calc(depth_m, UCNL_WPHX_ATM_PRESSURE_MBAR, rho, UCNL_WPHX_GRAVITY_ACC_MPS2);
+
+  return UCNL_WPHX_speed_of_sound_UNESCO_calc(t, p, BENCH_SALINITY_PSU);
+}
+
+// Depths on the reference grid
+static float Bench_Rand_Depth(float min_m, float max_m)
+{
+  return floorf((min_m + (max_m - min_m) * (float)(rand() / (double)RAND_MAX)) * BENCH_REF_STEPS_M) / BENCH_REF_STEPS_M;
+}
+
+int main(int argc, char** argv)
+{
+  size_t num = (argc > 1) ? (size_t)atol(argv[1]) : 100000;
+  float depths[BENCH_SSP_SIZE], speeds[BENCH_SSP_SIZE], times[BENCH_SSP_SIZE];
+  float s_depths[BENCH_SSP_SIZE], s_speeds[BENCH_SSP_SIZE], s_times[BENCH_SSP_SIZE];
+  UCNL_WPHX_SSP_Struct ssp, s_ssp;
+  std::vector<double> ref_times(BENCH_DEPTH_M * BENCH_REF_STEPS_M + 1);
+  std::vector<float> z1s(num), z2s(num), t1s(num), t2s(num);
+  std::chrono::steady_clock::time_point ts;
+  double err, max_err, max_former_err, ref, diff, t, t_ssp, t_unesco, t_add, t_eqs;
+  float z1, z2, sink = 0;
+  size_t i, m;
+  int z, k;
+
+  srand(1);
+
+  // the profile from a descent and from the same samples in a scrambled order
+  UCNL_WPHX_SSP_Init(&ssp, depths, speeds, times, BENCH_SSP_SIZE, BENCH_SSP_STEP_M);
+  for (z = 0; z <= BENCH_DEPTH_M; z++)
+    UCNL_WPHX_SSP_Add_Sample(&ssp, (float)z, Bench_Temperature((float)z), BENCH_SALINITY_PSU);
+
+  UCNL_WPHX_SSP_Init(&s_ssp, s_depths, s_speeds, s_times, BENCH_SSP_SIZE, BENCH_SSP_STEP_M);
+  for (k = 0; k < 3; k++)
+    for (z = BENCH_DEPTH_M - k; z >= 0; z -= 3)
+      UCNL_WPHX_SSP_Add_Sample(&s_ssp, (float)z, Bench_Temperature((float)z), BENCH_SALINITY_PSU);
+
+  diff = 0;
+  for (z1 = 0; z1 < BENCH_DEPTH_M; z1 += 7.3f)
+  {
+    err = fabs((double)UCNL_WPHX_SSP_Time(&ssp, z1) - (double)UCNL_WPHX_SSP_Time(&s_ssp, z1));
+    if (err > diff)
+      diff = err;
+  }
+
+  printf("%d and %d samples, travel times of the descent and the scrambled profiles differ by %.3g s at most\n",
+         ssp.num, s_ssp.num, diff);
+
+  // reference travel times, midpoint rule
+  ref_times[0] = 0;
+  for (i = 1; i < ref_times.size(); i++)
+    ref_times[i] = ref_times[i - 1] + (1.0 / BENCH_REF_STEPS_M) / Bench_Speed(((double)i - 0.5) / BENCH_REF_STEPS_M);
+
+  printf("span          max error, m/s: profile  former   ranging error at %.0f m, m: profile  former\n", BENCH_RANGE_M);
+
+  for (m = 0; m < sizeof(spans) / sizeof(spans[0]); m++)
+  {
+    max_err = 0;
+    max_former_err = 0;
+
+    for (i = 0; i < num; i++)
+    {
+      do
+      {
+        z1 = Bench_Rand_Depth(0, BENCH_DEPTH_M);
+        z2 = Bench_Rand_Depth(0, BENCH_DEPTH_M);
+      } while ((fabsf(z2 - z1) < spans[m].min_span_m) || (fabsf(z2 - z1) > spans[m].max_span_m));
+      z1s[i] = z1;
+      z2s[i] = z2;
+      t1s[i] = Bench_Temperature(z1);
+      t2s[i] = Bench_Temperature(z2);
+
+      ref = (z2 - z1) / (ref_times[lroundf(z2 * BENCH_REF_STEPS_M)] - ref_times[lroundf(z1 * BENCH_REF_STEPS_M)]);
+
+      err = fabs(UCNL_WPHX_SSP_Mean_Speed(&ssp, z1, z2) - ref);
+      if (err > max_err)
+        max_err = err;
+
+      err = fabs(UCNL_WPHX_speed_of_sound_UNESCO_calc((t1s[i] + t2s[i]) / 2, UCNL_WPHX_ATM_PRESSURE_MBAR, BENCH_SALINITY_PSU) - ref);
+      if (err > max_former_err)
+        max_former_err = err;
+    }
+
+    printf("%-12s %22.4f %7.2f %40.3f %7.2f\n", spans[m].name, max_err, max_former_err,
+           BENCH_RANGE_M * max_err / 1500.0, BENCH_RANGE_M * max_former_err / 1500.0);
+  }
+
+  // lookup time vs evaluating UNESCO at the mean temperature, best of a few runs
+  t_ssp = 0;
+  t_unesco = 0;
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+    for (i = 0; i < num; i++)
+      sink += UCNL_WPHX_SSP_Mean_Speed(&ssp, z1s[i], z2s[i]);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count() / num;
+    if ((k == 0) || (t < t_ssp))
+      t_ssp = t;
+
+    ts = std::chrono::steady_clock::now();
+    for (i = 0; i < num; i++)
+      sink += UCNL_WPHX_speed_of_sound_UNESCO_calc((t1s[i] + t2s[i]) / 2, UCNL_WPHX_ATM_PRESSURE_MBAR, BENCH_SALINITY_PSU);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count() / num;
+    if ((k == 0) || (t < t_unesco))
+      t_unesco = t;
+  }
+
+  printf("UCNL_WPHX_SSP_Mean_Speed %6.1f ns, former estimate %6.1f ns\n", t_ssp * 1e9, t_unesco * 1e9);
+
+  // a sampled depth again vs the equations for it
+  t_add = 0;
+  t_eqs = 0;
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    ts = std::chrono::steady_clock::now();
+    for (i = 0; i < num; i++)
+      UCNL_WPHX_SSP_Add_Sample(&ssp, z1s[i], t1s[i], BENCH_SALINITY_PSU);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count() / num;
+    if ((k == 0) || (t < t_add))
+      t_add = t;
+
+    ts = std::chrono::steady_clock::now();
+    for (i = 0; i < num; i++)
+      sink += Bench_Speed(z1s[i]);
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count() / num;
+    if ((k == 0) || (t < t_eqs))
+      t_eqs = t;
+  }
+
+  printf("UCNL_WPHX_SSP_Add_Sample at a sampled depth %6.1f ns (%d samples), the equations %6.1f ns\n(%g)\n",
+         t_add * 1e9, ssp.num, t_eqs * 1e9, sink);
+
+  return 0;
+}
@@ -0,0 +1,158 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_NAV_Wrap benchmark: the constant-time wrapping vs the former subtracting loop, across input magnitudes
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -I../common -I../../libs ucnl_wrap_bench.cpp ../../libs/ucnl_nav.cpp -o ucnl_wrap_bench
+//   add -ftree-vectorize (or use -O3) for the vectorized batch functions, -march=native for wider vectors
+//
+// Usage:
+//   ucnl_wrap_bench [values_number]
+//
+// Angles are random in -mag..mag radians, the former loop takes about mag / 2PI iterations, so it is run
+// on fewer values at large magnitudes. The deviation from the fmod reference is reported for each function.
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_nav.h"
+
+#define BENCH_RUNS (5)
+
+// UCNL_NAV_Wrap before the constant-time rework, kept for the comparison
+static float Bench_Wrap_Legacy(float val, float lim)
+{
+  float result = val;
+
+  while (result > lim)
+    result -= lim;
+
+  while (result < -lim)
+    result += lim;
+
+  return result;
+}
+
+// Best time of a few runs, seconds per value. "func" wraps the whole vector in place
+template <typename F>
+static double Bench_Run(F func, const std::vector<float>& src, std::vector<float>* dst)
+{
+  std::chrono::steady_clock::time_point ts;
+  double t, best = 0;
+  int k;
+
+  for (k = 0; k < BENCH_RUNS; k++)
+  {
+    *dst = src;
+    ts = std::chrono::steady_clock::now();
+    func(&(*dst)[0], (int)dst->size());
+    t = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+    if ((k == 0) || (t < best))
+      best = t;
+  }
+
+  return best / (double)src.size();
+}
+
+// Max deviation from fmod, both wrapped to -PI..PI to compare the signed and unsigned ranges
+static double Bench_Error(const std::vector<float>& src, const std::vector<float>& dst)
+{
+  double ref, err, max_err = 0;
+  size_t i;
+
+  for (i = 0; i < src.size(); i++)
+  {
+    ref = fmod((double)src[i], (double)PI2);
+    err = fabs(remainder((double)dst[i] - ref, (double)PI2));
+    if ((err > max_err) || (err != err))
+      max_err = err;
+  }
+
+  return max_err;
+}
+
+static void Legacy_Func(float* vals, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    vals[i] = Bench_Wrap_Legacy(vals[i], PI2);
+}
+
+static void Scalar_Func(float* vals, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    vals[i] = UCNL_NAV_Wrap2PI(vals[i]);
+}
+
+static void Signed_Func(float* vals, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    vals[i] = UCNL_NAV_WrapPI(vals[i]);
+}
+
+static void Batch_Func(float* vals, int n)
+{
+  UCNL_NAV_Wrap_Batch(vals, n, PI2);
+}
+
+static void Batch_PI_Func(float* vals, int n)
+{
+  UCNL_NAV_WrapPI_Batch(vals, n);
+}
+
+int main(int argc, char** argv)
+{
+  static const double mags[] = { 1, 10, 1e3, 1e6 };
+  size_t num = (argc > 1) ? (size_t)atol(argv[1]) : 100000;
+  std::vector<float> src, legacy_src, dst;
+  double t, mag;
+  size_t i, legacy_num;
+  int m;
+
+  srand(1);
+  printf("%zu values, ns/value (max error, rad)\n", num);
+  printf("%10s %18s %18s %18s %18s %18s\n", "magnitude", "legacy loop", "Wrap2PI", "WrapPI", "Wrap_Batch", "WrapPI_Batch");
+
+  for (m = 0; m < (int)(sizeof(mags) / sizeof(mags[0])); m++)
+  {
+    mag = mags[m];
+    src.resize(num);
+    for (i = 0; i < num; i++)
+      src[i] = (float)((rand() / (double)RAND_MAX * 2 - 1) * mag);
+
+    // about mag / 2PI iterations per value, keep the legacy run short
+    legacy_num = (mag > 100) ? (size_t)(num * 100 / mag) + 1 : num;
+    legacy_src.assign(src.begin(), src.begin() + (legacy_num < num ? legacy_num : num));
+
+    printf("%10g", mag);
+
+    t = Bench_Run(Legacy_Func, legacy_src, &dst);
+    printf(" %8.2f (%7.1e)", t * 1e9, Bench_Error(legacy_src, dst));
+
+    t = Bench_Run(Scalar_Func, src, &dst);
+    printf(" %8.2f (%7.1e)", t * 1e9, Bench_Error(src, dst));
+
+    t = Bench_Run(Signed_Func, src, &dst);
+    printf(" %8.2f (%7.1e)", t * 1e9, Bench_Error(src, dst));
+
+    t = Bench_Run(Batch_Func, src, &dst);
+    printf(" %8.2f (%7.1e)", t * 1e9, Bench_Error(src, dst));
+
+    t = Bench_Run(Batch_PI_Func, src, &dst);
+    printf(" %8.2f (%7.1e)\n", t * 1e9, Bench_Error(src, dst));
+  }
+
+  return 0;
+}
@@ -0,0 +1,29 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// Minimal Arduino.h replacement to build the libraries on a host (Linux gateways, offline tools)
+
+#ifndef _UCNL_HOST_ARDUINO_
+#define _UCNL_HOST_ARDUINO_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+
+#ifndef PI
+#define PI       3.1415926535897932384626433832795
+#endif
+#define HALF_PI  1.5707963267948966192313216916398
+#define TWO_PI   6.283185307179586476925286766559
+
+#endif
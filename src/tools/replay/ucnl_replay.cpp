@@ -0,0 +1,512 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// Offline replay of raw serial captures (standard NMEA and uWave sentences) on all CPU cores
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -fpermissive -pthread -I../common -I../../libs ucnl_replay.cpp
+//       ../../libs/ucnl_str.cpp ../../libs/ucnl_nmea.cpp ../../libs/ucnl_uwave.cpp -o ucnl_replay
+//
+// Usage:
+//   ucnl_replay [-j threads] [-c chunk_kbytes] capture.log > parsed.csv
+//
+// The capture is mapped into memory and split into chunks right before a '$'. A start symbol resets
+// the parser, so every chunk can be parsed by its own parser state and the result does not depend
+// on where the chunks are cut. Chunks are taken by the worker threads one by one and their output
+// is written in the capture order, so the output is exactly the same for any number of threads.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+#include "ucnl_nmea.h"
+#include "ucnl_uwave.h"
+
+#define REPLAY_CHUNK_SIZE_DEFAULT (4096 * 1024)
+#define REPLAY_WINDOW_PER_THREAD  (4)        // chunks in flight per worker thread
+
+typedef struct {
+  UCNL_NMEA_RMC_RESULT_Struct rmc;
+  UCNL_NMEA_GGA_RESULT_Struct gga;
+  UCNL_NMEA_GLL_RESULT_Struct gll;
+  UCNL_NMEA_VTG_RESULT_Struct vtg;
+  UCNL_NMEA_HDT_RESULT_Struct hdt;
+  UCNL_NMEA_HDG_RESULT_Struct hdg;
+  UCNL_NMEA_ZDA_RESULT_Struct zda;
+  UCNL_NMEA_MTW_RESULT_Struct mtw;
+  uWAVE_ACK_RESULT_Struct ack;
+  uWAVE_RC_RESPONSE_Struct rc_response;
+  uWAVE_RC_TIMEOUT_Struct rc_timeout;
+  uWAVE_RC_ASYNC_IN_Struct rc_async_in;
+  uWAVE_AMB_DTA_Struct amb_dta;
+  uWAVE_INC_DTA_Struct inc_dta;
+  uWAVE_PT_PACKET_Struct pt_packet;
+  uWAVE_PT_ITG_Struct pt_itg;
+  uWAVE_PT_ITG_RESP_Struct pt_itg_resp;
+} Replay_Results_Struct;
+
+typedef void (*Replay_Format_Func)(std::string* out, const Replay_Results_Struct* r);
+
+// Known sentence: ID, name in the output, result structure and its formatter
+typedef struct {
+  long sntID;
+  const char* name;
+  size_t offset;
+  size_t size;
+  Replay_Format_Func format;
+} Replay_Sentence_Struct;
+
+struct Replay_Worker_Struct_t;
+
+typedef struct {
+  struct Replay_Worker_Struct_t* worker;
+  const Replay_Sentence_Struct* sentence;
+  UCNL_NMEA_Parser_Func parser;
+} Replay_Binding_Struct;
+
+// Everything a worker thread needs to parse a chunk, nothing is shared between the workers
+typedef struct Replay_Worker_Struct_t {
+  UCNL_NMEA_State_Struct uState;
+  byte buffer[255];
+  UCNL_NMEA_SntIDs_Table_Struct table;
+  Replay_Binding_Struct bindings[UCNL_NMEA_SNTIDS_TABLE_SIZE];
+  Replay_Results_Struct results;
+  byte pt_data[uWAVE_PKT_MAX_SIZE];
+  std::string* out;
+  unsigned long sentences;
+} Replay_Worker_Struct;
+
+typedef struct {
+  size_t start;
+  size_t end;
+} Replay_Chunk_Struct;
+
+// Ordered output window: chunk i goes to slot i % window_size
+typedef struct {
+  std::vector<std::string> slots;
+  std::vector<bool> isReady;
+  size_t written;
+  std::mutex lock;
+  std::condition_variable changed;
+} Replay_Output_Struct;
+
+
+
+static void Replay_Printf(std::string* out, const char* fmt, ...)
+{
+  char line[512];
+  va_list args;
+  int n;
+
+  va_start(args, fmt);
+  n = vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+
+  if (n > 0)
+    out->append(line, (n < (int)sizeof(line)) ? (size_t)n : sizeof(line) - 1);
+}
+
+// Formatters, every line starts with the sentence name
+static void Replay_Format_RMC(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "RMC,%d,%02u:%02u:%06.3f,%02u.%02u.%02u,%.7f,%.7f,%.2f,%.1f\n",
+                r->rmc.isValid, r->rmc.hour, r->rmc.minute, r->rmc.second,
+                r->rmc.date, r->rmc.month, r->rmc.year,
+                r->rmc.latitude_deg, r->rmc.longitude_deg, r->rmc.speed_kmh, r->rmc.course_deg);
+}
+
+static void Replay_Format_GGA(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "GGA,%d,%02u:%02u:%06.3f,%.7f,%.7f,%u,%u,%.1f,%.2f,%.2f\n",
+                r->gga.isValid, r->gga.hour, r->gga.minute, r->gga.second,
+                r->gga.latitude_deg, r->gga.longitude_deg, r->gga.gnss_qly_ind, r->gga.sats_in_use,
+                r->gga.hdop, r->gga.orth_height, r->gga.gsep);
+}
+
+static void Replay_Format_GLL(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "GLL,%d,%02u:%02u:%06.3f,%.7f,%.7f\n",
+                r->gll.isValid, r->gll.hour, r->gll.minute, r->gll.second,
+                r->gll.latitude_deg, r->gll.longitude_deg);
+}
+
+static void Replay_Format_VTG(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "VTG,%d,%.1f,%.1f,%.2f,%.2f\n",
+                r->vtg.isValid, r->vtg.track_true_deg, r->vtg.track_magnetic_deg,
+                r->vtg.speed_knots, r->vtg.speed_kmh);
+}
+
+static void Replay_Format_HDT(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "HDT,%d,%.1f\n", r->hdt.isValid, r->hdt.track_true_deg);
+}
+
+static void Replay_Format_HDG(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "HDG,%d,%.1f,%.1f\n",
+                r->hdg.isValid, r->hdg.magnetic_heading_deg, r->hdg.magnetic_variation);
+}
+
+static void Replay_Format_ZDA(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "ZDA,%d,%02u:%02u:%06.3f,%02u.%02u.%04d,%d,%u\n",
+                r->zda.isValid, r->zda.hour, r->zda.minute, r->zda.second,
+                r->zda.day, r->zda.month, r->zda.year,
+                r->zda.t_zone_offset_hours, r->zda.t_zone_offset_minutes);
+}
+
+static void Replay_Format_MTW(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "MTW,%d,%.2f\n", r->mtw.isValid, r->mtw.mean_water_temperature_c);
+}
+
+static void Replay_Format_ACK(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "ACK,%c,%d\n", r->ack.sentenceID, (int)r->ack.errCode);
+}
+
+static void Replay_Format_RC_RESPONSE(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "RC_RESPONSE,%u,%d,%.5f,%.1f,%.3f,%.1f\n",
+                r->rc_response.txChID, (int)r->rc_response.rcCmdID,
+                r->rc_response.propTime_sec, r->rc_response.MSR_dB,
+                r->rc_response.value, r->rc_response.azimuth);
+}
+
+static void Replay_Format_RC_TIMEOUT(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "RC_TIMEOUT,%u,%d\n", r->rc_timeout.txChID, (int)r->rc_timeout.rcCmdID);
+}
+
+static void Replay_Format_RC_ASYNC_IN(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "RC_ASYNC_IN,%d,%.1f,%.1f\n",
+                (int)r->rc_async_in.rcCmdID, r->rc_async_in.MSR_dB, r->rc_async_in.azimuth);
+}
+
+static void Replay_Format_AMB_DTA(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "AMB_DTA,%.1f,%.1f,%.2f,%.1f\n",
+                r->amb_dta.prs_mBar, r->amb_dta.temp_C, r->amb_dta.dpt_m, r->amb_dta.batVoltage_V);
+}
+
+static void Replay_Format_INC_DTA(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "INC_DTA,%.1f,%.1f,%.1f\n",
+                r->inc_dta.heading, r->inc_dta.pitch, r->inc_dta.roll);
+}
+
+static void Replay_Format_PT_PACKET(std::string* out, const char* name, const uWAVE_PT_PACKET_Struct* p)
+{
+  byte i;
+
+  Replay_Printf(out, "%s,%u,%u,%.1f,", name, p->ptAddress, p->tries, p->azimuth);
+  for (i = 0; i < p->dataPacketSize; i++)
+    Replay_Printf(out, "%02X", p->dataPacket[i]);
+  out->push_back('\n');
+}
+
+static void Replay_Format_PT_FAILED(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Format_PT_PACKET(out, "PT_FAILED", &r->pt_packet);
+}
+
+static void Replay_Format_PT_DLVRD(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Format_PT_PACKET(out, "PT_DLVRD", &r->pt_packet);
+}
+
+static void Replay_Format_PT_RCVD(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Format_PT_PACKET(out, "PT_RCVD", &r->pt_packet);
+}
+
+static void Replay_Format_PT_TMO(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "PT_TMO,%u,%d\n", r->pt_itg.ptAddress, (int)r->pt_itg.pt_itg_dataID);
+}
+
+static void Replay_Format_PT_ITG_RESP(std::string* out, const Replay_Results_Struct* r)
+{
+  Replay_Printf(out, "PT_ITG_RESP,%u,%d,%.3f,%.5f,%.1f\n",
+                r->pt_itg_resp.target_ptAddress, (int)r->pt_itg_resp.pt_itg_dataID,
+                r->pt_itg_resp.dataValue, r->pt_itg_resp.pTime, r->pt_itg_resp.azimuth);
+}
+
+#define REPLAY_SENTENCE(id, name, member) \
+  { id, #name, offsetof(Replay_Results_Struct, member), sizeof(((Replay_Results_Struct*)0)->member), Replay_Format_##name }
+
+static const Replay_Sentence_Struct Replay_Sentences[] =
+{
+  REPLAY_SENTENCE(UCNL_NMEA_RMC_SNT_ID,   RMC,         rmc),
+  REPLAY_SENTENCE(UCNL_NMEA_GGA_SNT_ID,   GGA,         gga),
+  REPLAY_SENTENCE(UCNL_NMEA_GLL_SNT_ID,   GLL,         gll),
+  REPLAY_SENTENCE(UCNL_NMEA_VTG_SNT_ID,   VTG,         vtg),
+  REPLAY_SENTENCE(UCNL_NMEA_HDT_SNT_ID,   HDT,         hdt),
+  REPLAY_SENTENCE(UCNL_NMEA_HDG_SNT_ID,   HDG,         hdg),
+  REPLAY_SENTENCE(UCNL_NMEA_ZDA_SNT_ID,   ZDA,         zda),
+  REPLAY_SENTENCE(UCNL_NMEA_MTW_SNT_ID,   MTW,         mtw),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWV0_SNT_ID, ACK,         ack),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWV3_SNT_ID, RC_RESPONSE, rc_response),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWV4_SNT_ID, RC_TIMEOUT,  rc_timeout),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWV5_SNT_ID, RC_ASYNC_IN, rc_async_in),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWV7_SNT_ID, AMB_DTA,     amb_dta),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWV9_SNT_ID, INC_DTA,     inc_dta),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWVH_SNT_ID, PT_FAILED,   pt_packet),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWVI_SNT_ID, PT_DLVRD,    pt_packet),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWVJ_SNT_ID, PT_RCVD,     pt_packet),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWVL_SNT_ID, PT_TMO,      pt_itg),
+  REPLAY_SENTENCE(uWAVE_NMEA_UWVM_SNT_ID, PT_ITG_RESP, pt_itg_resp),
+};
+
+#define REPLAY_SENTENCES_NUM (sizeof(Replay_Sentences) / sizeof(Replay_Sentences[0]))
+
+
+
+/* Parses a sentence with its parser and appends the result to the chunk output.
+   The result structure is cleared before every sentence: the parsers only set the fields
+   present in a sentence, and leftovers of a previous sentence would depend on the chunk borders
+*/
+static void Replay_OnSentence(UCNL_NMEA_State_Struct* uState, void* param)
+{
+  Replay_Binding_Struct* binding = (Replay_Binding_Struct*)param;
+  Replay_Worker_Struct* worker = binding->worker;
+  void* rdata = (byte*)&worker->results + binding->sentence->offset;
+
+  memset(rdata, 0, binding->sentence->size);
+  memset(worker->pt_data, 0, sizeof(worker->pt_data));
+  worker->results.pt_packet.dataPacket = worker->pt_data;
+  worker->results.pt_packet.dataPacketSize = uWAVE_PKT_MAX_SIZE;
+
+  if (binding->parser(rdata, uState->buffer, &uState->fields))
+  {
+    binding->sentence->format(worker->out, &worker->results);
+    worker->sentences++;
+  }
+}
+
+static void Replay_Worker_Init(Replay_Worker_Struct* worker)
+{
+  const UCNL_NMEA_SntIDs_Entry_Struct* entry;
+  size_t i;
+
+  memset(worker, 0, sizeof(Replay_Worker_Struct));
+  UCNL_NMEA_SntIDs_Init(&worker->table);
+
+  for (i = 0; i < REPLAY_SENTENCES_NUM; i++)
+  {
+    UCNL_NMEA_SntIDs_Add(&worker->table, Replay_Sentences[i].sntID, Replay_OnSentence, NULL);
+    entry = UCNL_NMEA_SntIDs_Find(&worker->table, Replay_Sentences[i].sntID);
+
+    Replay_Binding_Struct* binding = &worker->bindings[entry - worker->table.entries];
+    binding->worker = worker;
+    binding->sentence = &Replay_Sentences[i];
+    binding->parser = uWAVE_Get_Parser(Replay_Sentences[i].sntID);
+
+    worker->table.entries[entry - worker->table.entries].param = binding;
+  }
+}
+
+// Parses one chunk from scratch, a chunk never depends on the state left by the previous one
+static void Replay_Process_Chunk(Replay_Worker_Struct* worker, const byte* data, const Replay_Chunk_Struct* chunk, std::string* out)
+{
+  UCNL_NMEA_InitStruct(&worker->uState, worker->buffer, sizeof(worker->buffer), NULL, 0);
+  UCNL_NMEA_Set_SntIDs_Table(&worker->uState, &worker->table);
+
+  worker->out = out;
+  UCNL_NMEA_Process_Buffer(&worker->uState, data + chunk->start, chunk->end - chunk->start, NULL, NULL);
+  worker->out = NULL;
+}
+
+// Splits the capture into chunks of about "chunk_size" bytes, every chunk but the first one starts with a '$'
+static void Replay_Split(const byte* data, size_t size, size_t chunk_size, std::vector<Replay_Chunk_Struct>* chunks)
+{
+  Replay_Chunk_Struct chunk;
+  const byte* next;
+  size_t pos = 0;
+
+  while (pos < size)
+  {
+    chunk.start = pos;
+    chunk.end = size;
+
+    if (size - pos > chunk_size)
+    {
+      next = (const byte*)memchr(data + pos + chunk_size, UCNL_NMEA_SNT_STR, size - pos - chunk_size);
+      if (next != NULL)
+        chunk.end = next - data;
+    }
+
+    chunks->push_back(chunk);
+    pos = chunk.end;
+  }
+}
+
+static void Replay_Worker_Run(Replay_Worker_Struct* worker, const byte* data,
+                              const std::vector<Replay_Chunk_Struct>* chunks, std::atomic<size_t>* next,
+                              Replay_Output_Struct* output)
+{
+  size_t window = output->slots.size();
+  size_t i;
+  std::string out;
+
+  Replay_Worker_Init(worker);
+
+  while ((i = next->fetch_add(1)) < chunks->size())
+  {
+    // do not run too far ahead of the writer, memory use stays bounded by the window
+    {
+      std::unique_lock<std::mutex> lock(output->lock);
+      output->changed.wait(lock, [&] { return i < output->written + window; });
+    }
+
+    out.clear();
+    Replay_Process_Chunk(worker, data, &(*chunks)[i], &out);
+
+    {
+      std::lock_guard<std::mutex> lock(output->lock);
+      output->slots[i % window].swap(out);
+      output->isReady[i % window] = true;
+    }
+    output->changed.notify_all();
+  }
+}
+
+static void Replay_Usage()
+{
+  fprintf(stderr, "usage: ucnl_replay [-j threads] [-c chunk_kbytes] capture.log\n");
+}
+
+int main(int argc, char** argv)
+{
+  unsigned threads = std::thread::hardware_concurrency();
+  size_t chunk_size = REPLAY_CHUNK_SIZE_DEFAULT;
+  const char* fileName = NULL;
+  int fd, i;
+  struct stat st;
+  const byte* data;
+  size_t size, c, window;
+  unsigned long sentences = 0;
+
+  for (i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "-j") == 0) && (i + 1 < argc))
+      threads = (unsigned)atoi(argv[++i]);
+    else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc))
+      chunk_size = (size_t)atol(argv[++i]) * 1024;
+    else if (fileName == NULL)
+      fileName = argv[i];
+    else
+    {
+      Replay_Usage();
+      return 1;
+    }
+  }
+
+  if ((fileName == NULL) || (chunk_size == 0))
+  {
+    Replay_Usage();
+    return 1;
+  }
+
+  if (threads == 0)
+    threads = 1;
+
+  fd = open(fileName, O_RDONLY);
+  if ((fd < 0) || (fstat(fd, &st) != 0))
+  {
+    perror(fileName);
+    return 1;
+  }
+
+  size = (size_t)st.st_size;
+  if (size == 0)
+  {
+    close(fd);
+    return 0;
+  }
+
+  data = (const byte*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == (const byte*)MAP_FAILED)
+  {
+    perror(fileName);
+    return 1;
+  }
+  madvise((void*)data, size, MADV_SEQUENTIAL);
+
+  std::chrono::steady_clock::time_point ts = std::chrono::steady_clock::now();
+
+  std::vector<Replay_Chunk_Struct> chunks;
+  Replay_Split(data, size, chunk_size, &chunks);
+
+  if (threads > chunks.size())
+    threads = (unsigned)chunks.size();
+
+  window = threads * REPLAY_WINDOW_PER_THREAD;
+  Replay_Output_Struct output;
+  output.slots.resize(window);
+  output.isReady.assign(window, false);
+  output.written = 0;
+
+  // the kernels are picked before the workers start, so they never race on the kernel pointers
+  UCNL_NMEA_Kernels_Init();
+  UCNL_STR_Kernels_Init();
+
+  std::vector<Replay_Worker_Struct> workers(threads);
+  std::vector<std::thread> pool;
+  std::atomic<size_t> next(0);
+
+  for (unsigned t = 0; t < threads; t++)
+    pool.push_back(std::thread(Replay_Worker_Run, &workers[t], data, &chunks, &next, &output));
+
+  // the main thread writes the chunks out in the capture order
+  std::string out;
+  for (c = 0; c < chunks.size(); c++)
+  {
+    {
+      std::unique_lock<std::mutex> lock(output.lock);
+      output.changed.wait(lock, [&] { return (bool)output.isReady[c % window]; });
+      out.swap(output.slots[c % window]);
+      output.isReady[c % window] = false;
+      output.written++;
+    }
+    output.changed.notify_all();
+
+    fwrite(out.data(), 1, out.size(), stdout);
+  }
+  fflush(stdout);
+
+  for (unsigned t = 0; t < threads; t++)
+  {
+    pool[t].join();
+    sentences += workers[t].sentences;
+  }
+
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+  fprintf(stderr, "%lu sentences, %zu bytes, %zu chunks, %u threads, %.3f s, %.1f MB/s\n",
+          sentences, size, chunks.size(), threads, elapsed, (elapsed > 0) ? (size / 1e6) / elapsed : 0.0);
+
+  munmap((void*)data, size);
+  return 0;
+}
@@ -0,0 +1,229 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// UCNL_MUX test on pty pairs and pipes: sentences reach the callback with their port IDs, an idle port
+// does not block UCNL_MUX_Poll, a hung up port is drained, closed and reported once, and UCNL_MUX_Wait
+// keeps waiting on the remaining ports instead of returning at once
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -fpermissive -I../common -I../../libs ucnl_mux_test.cpp
+//       ../../libs/ucnl_str.cpp ../../libs/ucnl_nmea.cpp ../../libs/ucnl_mux.cpp -lutil -o ucnl_mux_test
+//
+// Usage:
+//   ucnl_mux_test
+//
+// Prints every failed check, returns 0 if all the checks passed
+
+#include <stdio.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pty.h>
+#include <termios.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+#include "ucnl_nmea.h"
+#include "ucnl_mux.h"
+
+#define TEST_PORTS       (20)
+#define TEST_SENTENCES   (50)
+#define TEST_BUFFER_SIZE (128)
+
+static int failures = 0;
+
+#define TEST_CHECK(cond) do { if (!(cond)) { failures++; printf("FAILED %s:%d %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+static const char* TEST_RMC = "$GPRMC,230540.00,A,5312.1329616,N,15942.6950884,E,4.9,217.1,290421,999.9,E,D*3C\r\n";
+static const char* TEST_ACK = "$PUWV0,1,0\r\n";
+static const long  TEST_SNT_IDS[] = { UCNL_NMEA_RMC_SNT_ID, 0x55575630 };
+
+static std::vector<std::string> received[TEST_PORTS];
+static int closed_num[TEST_PORTS];
+
+static void Test_OnSentence(byte portID, UCNL_NMEA_State_Struct* uState, void* param)
+{
+  received[portID].push_back(std::string((char*)uState->buffer, uState->idx));
+}
+
+static void Test_OnClosed(byte portID, void* param)
+{
+  closed_num[portID]++;
+}
+
+static void Test_OnAlarm(int sig)
+{
+  printf("FAILED: the multiplexer blocked\n");
+  _exit(1);
+}
+
+static void Test_Reset()
+{
+  int i;
+  for (i = 0; i < TEST_PORTS; i++)
+  {
+    received[i].clear();
+    closed_num[i] = 0;
+  }
+}
+
+static bool Test_OpenPty(int* master, int* slave)
+{
+  struct termios t;
+
+  if (openpty(master, slave, NULL, NULL, NULL) != 0)
+    return false;
+
+  tcgetattr(*slave, &t);
+  cfmakeraw(&t);
+  tcsetattr(*slave, TCSANOW, &t);
+
+  return true;
+}
+
+static void Test_Write(int fd, const char* s)
+{
+  if (write(fd, s, strlen(s)) != (ssize_t)strlen(s))
+    printf("write failed\n");
+}
+
+int main()
+{
+  UCNL_MUX_Port_Struct ports[TEST_PORTS];
+  UCNL_MUX_State_Struct mux;
+  UCNL_NMEA_State_Struct states[TEST_PORTS];
+  byte buffers[TEST_PORTS][TEST_BUFFER_SIZE];
+  int masters[TEST_PORTS], slaves[TEST_PORTS];
+  int pipe_fds[2];
+  int i, r, n, total, returns;
+  std::chrono::steady_clock::time_point ts;
+  double elapsed;
+
+  signal(SIGALRM, Test_OnAlarm);
+
+  // Sentences of every pty port reach the callback with the port's ID
+  TEST_CHECK(UCNL_MUX_InitStruct(&mux, ports, TEST_PORTS, Test_OnSentence, NULL));
+  UCNL_MUX_Set_Closed_Callback(&mux, Test_OnClosed);
+
+  for (i = 0; i < TEST_PORTS; i++)
+  {
+    TEST_CHECK(Test_OpenPty(&masters[i], &slaves[i]));
+    UCNL_NMEA_InitStruct(&states[i], buffers[i], TEST_BUFFER_SIZE, (long*)TEST_SNT_IDS, 2);
+    TEST_CHECK(UCNL_MUX_Add_FD(&mux, &states[i], slaves[i]) == i);
+    TEST_CHECK((fcntl(slaves[i], F_GETFL) & O_NONBLOCK) != 0);
+  }
+
+  for (r = 0; r < TEST_SENTENCES; r++)
+    for (i = 0; i < TEST_PORTS; i++)
+      Test_Write(masters[i], ((i + r) % 2) ? TEST_RMC : TEST_ACK);
+
+  total = 0;
+  while ((n = UCNL_MUX_Wait(&mux, 100)) > 0)
+    total += n;
+
+  TEST_CHECK(n == 0);
+  TEST_CHECK(total == TEST_PORTS * TEST_SENTENCES);
+  for (i = 0; i < TEST_PORTS; i++)
+  {
+    TEST_CHECK(received[i].size() == TEST_SENTENCES);
+    TEST_CHECK(received[i].size() && (received[i][0] == std::string((i % 2) ? TEST_RMC : TEST_ACK, received[i][0].size())));
+  }
+
+  // Idle ports do not block the polling
+  alarm(5);
+  TEST_CHECK(UCNL_MUX_Poll(&mux) == 0);
+  Test_Write(masters[3], TEST_ACK);
+  TEST_CHECK(UCNL_MUX_Poll(&mux) == 1);
+  alarm(0);
+
+  // A hung up port is closed and reported once, the others are still read
+  Test_Reset();
+  close(masters[0]);
+  masters[0] = -1;
+  Test_Write(masters[1], TEST_ACK);
+
+  total = 0;
+  for (r = 0; r < 10; r++)
+  {
+    n = UCNL_MUX_Wait(&mux, 10);
+    TEST_CHECK(n >= 0);
+    total += (n > 0) ? n : 0;
+  }
+
+  TEST_CHECK(closed_num[0] == 1);
+  TEST_CHECK(!UCNL_MUX_Is_Open(&mux, 0));
+  TEST_CHECK(UCNL_MUX_Is_Open(&mux, 1));
+  TEST_CHECK(total == 1);
+  TEST_CHECK(received[1].size() == 1);
+  TEST_CHECK(mux.open == TEST_PORTS - 1);
+
+  // Nothing to read on the remaining ports: the calls wait out their timeouts instead of returning at once
+  returns = 0;
+  ts = std::chrono::steady_clock::now();
+  do
+  {
+    n = UCNL_MUX_Wait(&mux, 50);
+    TEST_CHECK(n == 0);
+    returns++;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - ts).count();
+  } while (elapsed < 0.3);
+
+  TEST_CHECK(returns <= 10);
+
+  // All the ports are gone: UCNL_MUX_Wait fails instead of waiting forever or spinning
+  for (i = 1; i < TEST_PORTS; i++)
+  {
+    close(masters[i]);
+    masters[i] = -1;
+  }
+
+  alarm(5);
+  for (r = 0; (r < 10) && (UCNL_MUX_Wait(&mux, -1) >= 0); r++);
+  alarm(0);
+
+  TEST_CHECK(mux.open == 0);
+  TEST_CHECK(UCNL_MUX_Wait(&mux, -1) == -1);
+  for (i = 0; i < TEST_PORTS; i++)
+    TEST_CHECK(closed_num[i] == 1);
+
+  UCNL_MUX_Release(&mux);
+  for (i = 0; i < TEST_PORTS; i++)
+    close(slaves[i]);
+
+  // The data written before the writer is gone is still delivered
+  Test_Reset();
+  TEST_CHECK(UCNL_MUX_InitStruct(&mux, ports, TEST_PORTS, Test_OnSentence, NULL));
+  UCNL_MUX_Set_Closed_Callback(&mux, Test_OnClosed);
+  UCNL_NMEA_InitStruct(&states[0], buffers[0], TEST_BUFFER_SIZE, (long*)TEST_SNT_IDS, 2);
+  TEST_CHECK(pipe(pipe_fds) == 0);
+  TEST_CHECK(UCNL_MUX_Add_FD(&mux, &states[0], pipe_fds[0]) == 0);
+
+  Test_Write(pipe_fds[1], TEST_RMC);
+  Test_Write(pipe_fds[1], TEST_ACK);
+  close(pipe_fds[1]);
+
+  alarm(5);
+  total = 0;
+  while ((n = UCNL_MUX_Wait(&mux, -1)) >= 0)
+    total += n;
+  alarm(0);
+
+  TEST_CHECK(total == 2);
+  TEST_CHECK(closed_num[0] == 1);
+
+  UCNL_MUX_Release(&mux);
+  close(pipe_fds[0]);
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// uWave sentence builders test: pins the bytes of $PUWV1 (settings write) and of the number formatting
+// it relies on. Salinity goes with zPad = 1 and no decimal places: the digit pair formatter writes every
+// digit of it and rounds, where the former one cut it to its first digit (35 PSU went as "3.0") and
+// truncated the fraction. The gravity acceleration is rounded to 4 places instead of truncated.
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -fpermissive -I../common -I../../libs ucnl_uwave_build_test.cpp
+//       ../../libs/ucnl_str.cpp ../../libs/ucnl_nmea.cpp ../../libs/ucnl_uwave.cpp -o ucnl_uwave_build_test
+//
+// Usage:
+//   ucnl_uwave_build_test
+//
+// Prints every failed check, returns 0 if all the checks passed
+
+#include <stdio.h>
+#include <string>
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+#include "ucnl_nmea.h"
+#include "ucnl_uwave.h"
+
+#define TEST_BUFFER_SIZE (127)
+
+static int failures = 0;
+
+#define TEST_CHECK(cond) do { if (!(cond)) { failures++; printf("FAILED %s:%d %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+static std::string Test_IntDec(long src, byte zPad)
+{
+  byte buffer[TEST_BUFFER_SIZE];
+  byte idx = 0;
+
+  UCNL_STR_WriteIntDec(buffer, &idx, src, zPad);
+  return std::string((char*)buffer, idx);
+}
+
+static std::string Test_Float(float f, byte dPlaces, byte zPad)
+{
+  byte buffer[TEST_BUFFER_SIZE];
+  byte idx = 0;
+
+  UCNL_STR_WriteFloat(buffer, &idx, f, dPlaces, zPad);
+  return std::string((char*)buffer, idx);
+}
+
+static std::string Test_Settings_Write(float styPSU, float gravityAcc)
+{
+  uWAVE_SETTINGS_WRITE_Struct sdata;
+  byte buffer[TEST_BUFFER_SIZE];
+  byte idx = 0;
+
+  sdata.rxChID = 0;
+  sdata.txChID = 0;
+  sdata.styPSU = styPSU;
+  sdata.isCmdMode = true;
+  sdata.isACKOnTXFinished = false;
+  sdata.gravityAcc = gravityAcc;
+
+  uWAVE_Build_SETTINGS_WRITE(&sdata, buffer, TEST_BUFFER_SIZE, &idx);
+  return std::string((char*)buffer, idx);
+}
+
+int main()
+{
+  // zPad shorter than the number: all the digits are written
+  TEST_CHECK(Test_IntDec(35, 1) == "35");
+  TEST_CHECK(Test_IntDec(1013, 2) == "1013");
+  TEST_CHECK(Test_IntDec(7, 3) == "007");
+  TEST_CHECK(Test_IntDec(0, 0) == "0");
+  TEST_CHECK(Test_IntDec(-42, 0) == "-42");
+
+  // no decimal places: rounded half away from zero, ".0" is still written
+  TEST_CHECK(Test_Float(35.0f, 0, 1) == "35.0");
+  TEST_CHECK(Test_Float(12.4f, 0, 1) == "12.0");
+  TEST_CHECK(Test_Float(12.7f, 0, 1) == "13.0");
+  TEST_CHECK(Test_Float(9.6f, 0, 1) == "10.0");
+  TEST_CHECK(Test_Float(12.5f, 0, 1) == "13.0");
+  TEST_CHECK(Test_Float(0.49999997f, 0, 1) == "0.0");
+  TEST_CHECK(Test_Float(-2.5f, 0, 1) == "-3.0");
+  TEST_CHECK(Test_Float(9.80665f, 4, 0) == "9.8067");
+
+  // $PUWV1: the former formatter cut the salinity to its first digit and truncated it ("3.0" for 35,
+  // "1.0" for 12.7, "9.0" for 9.6), the gravity acceleration went as "9.8066"
+  TEST_CHECK(Test_Settings_Write(0.0f, 9.80665f)  == "$PUWV1,0,0,0.0,1,0,9.8067*04\r\n");
+  TEST_CHECK(Test_Settings_Write(5.0f, 9.80665f)  == "$PUWV1,0,0,5.0,1,0,9.8067*01\r\n");
+  TEST_CHECK(Test_Settings_Write(9.6f, 9.80665f)  == "$PUWV1,0,0,10.0,1,0,9.8067*35\r\n");
+  TEST_CHECK(Test_Settings_Write(12.7f, 9.80665f) == "$PUWV1,0,0,13.0,1,0,9.8067*36\r\n");
+  TEST_CHECK(Test_Settings_Write(35.0f, 9.80665f) == "$PUWV1,0,0,35.0,1,0,9.8067*32\r\n");
+  TEST_CHECK(Test_Settings_Write(40.0f, 9.81f)    == "$PUWV1,0,0,40.0,1,0,9.8100*30\r\n");
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+
+  return failures ? 1 : 0;
+}
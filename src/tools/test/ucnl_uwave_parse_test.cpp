@@ -0,0 +1,101 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// uWave sentence parsers test: the optional fields of $PUWV3 (remote response). An empty field must
+// clear its flag, so that a value of a former response is not taken for a new one: the VLBL sketch
+// passes isAzimuth to the Kalman filter as it is.
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -fpermissive -I../common -I../../libs ucnl_uwave_parse_test.cpp
+//       ../../libs/ucnl_str.cpp ../../libs/ucnl_nmea.cpp ../../libs/ucnl_uwave.cpp -o ucnl_uwave_parse_test
+//
+// Usage:
+//   ucnl_uwave_parse_test
+//
+// Prints every failed check, returns 0 if all the checks passed
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+#include "ucnl_nmea.h"
+#include "ucnl_uwave.h"
+
+#define TEST_BUFFER_SIZE (127)
+
+static int failures = 0;
+
+#define TEST_CHECK(cond) do { if (!(cond)) { failures++; printf("FAILED %s:%d %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+static long sntIDs[] = { uWAVE_NMEA_UWV3_SNT_ID };
+static byte parser_buffer[TEST_BUFFER_SIZE];
+static UCNL_NMEA_State_Struct parser;
+
+// Feeds a sentence without its checksum to the parser, true if it got ready
+static bool Test_Feed(const char* s)
+{
+  char sentence[TEST_BUFFER_SIZE];
+  byte chk = 0;
+  size_t i;
+  bool result = false;
+
+  for (i = 1; s[i] != 0; i++)
+    chk ^= (byte)s[i];
+  snprintf(sentence, sizeof(sentence), "%s*%02X\r\n", s, chk);
+
+  for (i = 0; sentence[i] != 0; i++)
+    if (UCNL_NMEA_Process_Byte(&parser, (byte)sentence[i]) == UCNL_NMEA_RESULT_PACKET_READY)
+      result = true;
+
+  return result;
+}
+
+static bool Test_RC_RESPONSE(uWAVE_RC_RESPONSE_Struct* rdata, const char* s)
+{
+  bool result = Test_Feed(s) && uWAVE_Parse_RC_RESPONSE_Fields(rdata, parser.buffer, &parser.fields);
+
+  UCNL_NMEA_Release(&parser);
+  return result;
+}
+
+int main()
+{
+  uWAVE_RC_RESPONSE_Struct rsp;
+
+  UCNL_NMEA_InitStruct(&parser, parser_buffer, TEST_BUFFER_SIZE, sntIDs, sizeof(sntIDs) / sizeof(long));
+
+  // every field is there
+  TEST_CHECK(Test_RC_RESPONSE(&rsp, "$PUWV3,0,2,0.6667,42.5,23.5,137.2"));
+  TEST_CHECK(rsp.txChID == 0);
+  TEST_CHECK(rsp.rcCmdID == 2);
+  TEST_CHECK(rsp.isPropTime && (fabsf(rsp.propTime_sec - 0.6667f) < 1e-4f));
+  TEST_CHECK(fabsf(rsp.MSR_dB - 42.5f) < 1e-4f);
+  TEST_CHECK(rsp.isValue && (fabsf(rsp.value - 23.5f) < 1e-4f));
+  TEST_CHECK(rsp.isAzimuth && (fabsf(rsp.azimuth - 137.2f) < 1e-3f));
+
+  // the same structure gets a response with no azimuth and no value
+  TEST_CHECK(Test_RC_RESPONSE(&rsp, "$PUWV3,0,2,0.6667,42.5,,"));
+  TEST_CHECK(rsp.isPropTime);
+  TEST_CHECK(!rsp.isValue);
+  TEST_CHECK(!rsp.isAzimuth);
+
+  // no propagation time: a ping that was not answered in time
+  TEST_CHECK(Test_RC_RESPONSE(&rsp, "$PUWV3,0,2,,42.5,,"));
+  TEST_CHECK(!rsp.isPropTime);
+
+  // the command and the signal level are required
+  TEST_CHECK(!Test_RC_RESPONSE(&rsp, "$PUWV3,0,,0.6667,42.5,,"));
+  TEST_CHECK(!Test_RC_RESPONSE(&rsp, "$PUWV3,0,2,0.6667,,,"));
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+
+  return failures ? 1 : 0;
+}
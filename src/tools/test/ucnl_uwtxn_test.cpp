@@ -0,0 +1,266 @@
+/*
+Copyright (C) 2021, Underwater communication & navigation laboratory
+All rights reserved.
+
+www.unavlab.com
+hello@unavlab.com
+
+*/
+
+// uWAVE_TXN engine test on a simulated clock and modem: a remote's reply completes the request in flight,
+// the modem's own remote timeout report ($PUWV4, $PUWVL) is waited for even beyond the default range,
+// a silent modem gives NO_RESULT and LOC_TIMEOUT, a late reply goes to the unsolicited callback instead of
+// the next request, and busy ACKs are retried until the modem accepts the command or the retries run out
+//
+// Build (Linux):
+//   g++ -O2 -std=gnu++11 -fpermissive -I../common -I../../libs ucnl_uwtxn_test.cpp ../../libs/ucnl_str.cpp
+//       ../../libs/ucnl_nmea.cpp ../../libs/ucnl_uwave.cpp ../../libs/ucnl_wphx.cpp ../../libs/ucnl_uwtxn.cpp
+//       -o ucnl_uwtxn_test
+//
+// Usage:
+//   ucnl_uwtxn_test
+//
+// Prints every failed check, returns 0 if all the checks passed
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "ucnl_str.h"
+#include "ucnl_nmea.h"
+#include "ucnl_uwave.h"
+#include "ucnl_uwtxn.h"
+
+#define TEST_BUFFER_SIZE (127)
+#define TEST_TICK_MS     (10)
+
+static int failures = 0;
+
+#define TEST_CHECK(cond) do { if (!(cond)) { failures++; printf("FAILED %s:%d %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+static unsigned long test_clock;
+static std::vector<std::string> written;
+static std::vector<long> unsolicited;
+static int completed;
+
+static UCNL_NMEA_State_Struct parser;
+static UCNL_NMEA_Dispatcher_Struct dispatcher;
+static uWAVE_TXN_Engine_Struct engine;
+
+static unsigned long Test_Clock()
+{
+  return test_clock;
+}
+
+static void Test_Write(const byte* data, byte size, void* param)
+{
+  written.push_back(std::string((const char*)data, size));
+}
+
+static void Test_OnUnsolicited(UCNL_NMEA_State_Struct* uState, void* param)
+{
+  unsolicited.push_back(uState->sntID);
+}
+
+static void Test_OnComplete(uWAVE_TXN_Request_Struct* req, void* param)
+{
+  completed++;
+}
+
+// Feeds a sentence from the modem, "body" goes between '$' and the checksum
+static void Test_Feed(const char* body)
+{
+  UCNL_NMEA_Writer_Struct writer;
+  byte buffer[TEST_BUFFER_SIZE];
+  byte size;
+
+  UCNL_NMEA_Writer_Init(&writer, buffer, TEST_BUFFER_SIZE);
+  UCNL_NMEA_Writer_Str(&writer, body);
+  UCNL_NMEA_Writer_Finish(&writer, &size);
+  UCNL_NMEA_Process_Buffer(&parser, buffer, size, NULL, NULL);
+}
+
+// Moves the clock, polling the engine every tick as a main loop would
+static void Test_Advance(unsigned long ms)
+{
+  unsigned long t;
+
+  for (t = 0; t < ms; t += TEST_TICK_MS)
+  {
+    test_clock += TEST_TICK_MS;
+    uWAVE_TXN_Poll(&engine);
+  }
+}
+
+static bool Test_Last_Written(const char* prefix)
+{
+  return !written.empty() && (written.back().compare(0, strlen(prefix), prefix) == 0);
+}
+
+int main()
+{
+  byte in_buffer[TEST_BUFFER_SIZE];
+  byte out_buffer[TEST_BUFFER_SIZE];
+  uWAVE_TXN_Request_Struct rc, itg, dinfo;
+  uWAVE_RC_RESPONSE_Struct rcData;
+  uWAVE_PT_ITG_RESP_Struct itgData;
+  unsigned long wait_ms;
+  size_t n;
+  int i;
+
+  test_clock = (unsigned long)0 - 3000;   // runs over the wraparound
+
+  UCNL_NMEA_Dispatcher_Init(&dispatcher);
+  UCNL_NMEA_InitStruct(&parser, in_buffer, TEST_BUFFER_SIZE, NULL, 0);
+  UCNL_NMEA_Set_SntIDs_Table(&parser, &dispatcher.table);
+  uWAVE_TXN_InitStruct(&engine, out_buffer, TEST_BUFFER_SIZE, Test_Write, NULL, Test_Clock);
+  TEST_CHECK(uWAVE_TXN_Dispatcher_Add(&engine, &dispatcher, Test_OnUnsolicited, NULL));
+
+  uWAVE_TXN_Init_Request(&rc, IC_H2D_RC_REQUEST, &rcData, Test_OnComplete, NULL);
+  rc.sdata.rc_request.txChID = 0;
+  rc.sdata.rc_request.rxChID = 0;
+  rc.sdata.rc_request.rcCmdID = RC_DPT_GET;
+
+  uWAVE_TXN_Init_Request(&itg, IC_H2D_PT_ITG, &itgData, Test_OnComplete, NULL);
+  itg.sdata.pt_itg.ptAddress = 3;
+  itg.sdata.pt_itg.pt_itg_dataID = DID_TMP;
+
+  uWAVE_TXN_Init_Request(&dinfo, IC_H2D_DINFO_GET, NULL, Test_OnComplete, NULL);
+
+  // The result wait of an acoustic request is never shorter than the modem's own remote timeout
+  TEST_CHECK(uWAVE_TXN_RoundTrip_ms(&engine, &rc) >= uWAVE_TXN_REM_TIMEOUT_MS + uWAVE_TXN_GUARD_MS);
+  TEST_CHECK(uWAVE_TXN_RoundTrip_ms(&engine, &itg) >= uWAVE_TXN_REM_TIMEOUT_MS + uWAVE_TXN_GUARD_MS);
+  itg.range_m = 5000;
+  TEST_CHECK(uWAVE_TXN_RoundTrip_ms(&engine, &itg) > uWAVE_TXN_REM_TIMEOUT_MS + uWAVE_TXN_GUARD_MS);
+  itg.range_m = 0;
+  TEST_CHECK(uWAVE_TXN_RoundTrip_ms(&engine, &dinfo) == 0);
+
+  // Reply: the request is sent, acknowledged and completed by the remote's response
+  completed = 0;
+  TEST_CHECK(uWAVE_TXN_Submit(&engine, &rc));
+  TEST_CHECK(Test_Last_Written("$PUWV2,0,0,2"));
+  TEST_CHECK(engine.state == uWAVE_TXN_STATE_WAIT_ACK);
+  TEST_CHECK(!uWAVE_TXN_Submit(&engine, &rc));
+
+  Test_Advance(50);
+  Test_Feed("PUWV0,2,0");
+  TEST_CHECK(engine.state == uWAVE_TXN_STATE_WAIT_RESULT);
+  TEST_CHECK(rc.status == uWAVE_TXN_STATUS_PENDING);
+
+  Test_Advance(1500);
+  Test_Feed("PUWV3,0,2,0.6667,22.5,12.3,");
+  TEST_CHECK(rc.status == uWAVE_TXN_STATUS_OK);
+  TEST_CHECK(rc.resultSntID == uWAVE_NMEA_UWV3_SNT_ID);
+  TEST_CHECK(rcData.rcCmdID == RC_DPT_GET);
+  TEST_CHECK(rcData.isValue && (rcData.value > 12.29f) && (rcData.value < 12.31f));
+  TEST_CHECK(completed == 1);
+  TEST_CHECK(uWAVE_TXN_Is_Idle(&engine));
+  TEST_CHECK(unsolicited.empty());
+
+  // Remote timeout: the modem reports a silent remote after its own timeout, which is longer than the
+  // round trip over the default range, the engine waits for the report instead of giving up first
+  TEST_CHECK(uWAVE_TXN_Submit(&engine, &itg));
+  TEST_CHECK(Test_Last_Written("$PUWVK,3,1"));
+  Test_Feed("PUWV0,K,0");
+  Test_Advance(uWAVE_TXN_REM_TIMEOUT_MS);
+  TEST_CHECK(itg.status == uWAVE_TXN_STATUS_PENDING);
+  Test_Feed("PUWVL,3,1");
+  TEST_CHECK(itg.status == uWAVE_TXN_STATUS_REM_TIMEOUT);
+  TEST_CHECK(itg.resultSntID == uWAVE_NMEA_UWVL_SNT_ID);
+
+  // The remote's timeout report of another remote does not complete the request
+  TEST_CHECK(uWAVE_TXN_Submit(&engine, &itg));
+  Test_Feed("PUWV0,K,0");
+  Test_Feed("PUWVL,4,1");
+  TEST_CHECK(itg.status == uWAVE_TXN_STATUS_PENDING);
+  TEST_CHECK((unsolicited.size() == 1) && (unsolicited[0] == uWAVE_NMEA_UWVL_SNT_ID));
+  Test_Feed("PUWVM,3,1,12.5,0.6667,");
+  TEST_CHECK(itg.status == uWAVE_TXN_STATUS_OK);
+  TEST_CHECK(itgData.isValue && (itgData.dataValue > 12.49f) && (itgData.dataValue < 12.51f));
+  unsolicited.clear();
+
+  // No result: neither the reply nor the modem's report arrive, the next request waits until the
+  // engine gives up on the one in flight
+  TEST_CHECK(uWAVE_TXN_Submit(&engine, &rc));
+  TEST_CHECK(uWAVE_TXN_Submit(&engine, &dinfo));
+  n = written.size();
+  Test_Feed("PUWV0,2,0");
+  wait_ms = engine.timeout_ms;
+  TEST_CHECK(wait_ms == uWAVE_TXN_RoundTrip_ms(&engine, &rc));
+
+  Test_Advance(wait_ms - TEST_TICK_MS);
+  TEST_CHECK(rc.status == uWAVE_TXN_STATUS_PENDING);
+  TEST_CHECK(written.size() == n);
+  Test_Advance(TEST_TICK_MS);
+  TEST_CHECK(rc.status == uWAVE_TXN_STATUS_NO_RESULT);
+  TEST_CHECK(rc.resultSntID == 0);
+  TEST_CHECK((written.size() == n + 1) && Test_Last_Written("$PUWV?,0"));
+
+  // Late reply: it arrives while the next request is in flight and goes to the unsolicited callback
+  Test_Feed("PUWV3,0,2,0.6667,22.5,12.3,");
+  TEST_CHECK((unsolicited.size() == 1) && (unsolicited[0] == uWAVE_NMEA_UWV3_SNT_ID));
+  TEST_CHECK(dinfo.status == uWAVE_TXN_STATUS_PENDING);
+  TEST_CHECK(engine.state == uWAVE_TXN_STATE_WAIT_ACK);
+  Test_Feed("PUWV0,?,0");
+  TEST_CHECK(engine.state == uWAVE_TXN_STATE_WAIT_ACK);
+  Test_Feed("PUWV!,1,a,1,b,1,80,0,0,2,0,0,0");
+  TEST_CHECK(dinfo.status == uWAVE_TXN_STATUS_OK);
+  TEST_CHECK(dinfo.resultSntID == uWAVE_NMEA_UWV_EXCL_SNT_ID);
+  unsolicited.clear();
+
+  // Local timeout: the modem does not answer at all
+  TEST_CHECK(uWAVE_TXN_Submit(&engine, &dinfo));
+  Test_Advance(uWAVE_TXN_ACK_TIMEOUT_MS);
+  TEST_CHECK(dinfo.status == uWAVE_TXN_STATUS_LOC_TIMEOUT);
+
+  // Busy retry: the command is resent after the retry interval and completes once accepted
+  n = written.size();
+  TEST_CHECK(uWAVE_TXN_Submit(&engine, &rc));
+  Test_Feed("PUWV0,2,3");
+  TEST_CHECK(engine.state == uWAVE_TXN_STATE_WAIT_RETRY);
+  TEST_CHECK(written.size() == n + 1);
+  Test_Advance(uWAVE_TXN_BUSY_RETRY_MS - TEST_TICK_MS);
+  TEST_CHECK(written.size() == n + 1);
+  Test_Advance(TEST_TICK_MS);
+  TEST_CHECK((written.size() == n + 2) && Test_Last_Written("$PUWV2,0,0,2"));
+  TEST_CHECK(rc.retries == 1);
+  Test_Feed("PUWV0,2,8");
+  Test_Advance(uWAVE_TXN_BUSY_RETRY_MS);
+  TEST_CHECK(written.size() == n + 3);
+  Test_Feed("PUWV0,2,0");
+  TEST_CHECK(engine.state == uWAVE_TXN_STATE_WAIT_RESULT);
+  Test_Feed("PUWV3,0,2,0.6667,22.5,12.3,");
+  TEST_CHECK(rc.status == uWAVE_TXN_STATUS_OK);
+  TEST_CHECK(rc.retries == 2);
+
+  // Busy retries run out: the request fails with the modem's error code
+  n = written.size();
+  TEST_CHECK(uWAVE_TXN_Submit(&engine, &rc));
+  for (i = 0; i < uWAVE_TXN_BUSY_RETRIES; i++)
+  {
+    Test_Feed("PUWV0,2,3");
+    TEST_CHECK(rc.status == uWAVE_TXN_STATUS_PENDING);
+    Test_Advance(uWAVE_TXN_BUSY_RETRY_MS);
+  }
+  TEST_CHECK(written.size() == n + 1 + uWAVE_TXN_BUSY_RETRIES);
+  Test_Feed("PUWV0,2,3");
+  TEST_CHECK(rc.status == uWAVE_TXN_STATUS_ERROR);
+  TEST_CHECK(rc.errCode == LOC_ERR_TRANSMITTER_BUSY);
+  TEST_CHECK(rc.resultSntID == uWAVE_NMEA_UWV0_SNT_ID);
+  TEST_CHECK(uWAVE_TXN_Is_Idle(&engine));
+
+  // ACKs of other commands do not touch the request in flight
+  TEST_CHECK(uWAVE_TXN_Submit(&engine, &rc));
+  Test_Feed("PUWV0,K,3");
+  TEST_CHECK(engine.state == uWAVE_TXN_STATE_WAIT_ACK);
+  TEST_CHECK((unsolicited.size() == 1) && (unsolicited[0] == uWAVE_NMEA_UWV0_SNT_ID));
+  Test_Feed("PUWV0,2,0");
+  Test_Feed("PUWV4,0,2");
+  TEST_CHECK(rc.status == uWAVE_TXN_STATUS_REM_TIMEOUT);
+  TEST_CHECK(uWAVE_TXN_Is_Idle(&engine));
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+
+  return failures ? 1 : 0;
+}